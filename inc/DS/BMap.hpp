@@ -0,0 +1,389 @@
+#pragma once
+
+#include "../../src/DS/Container.tpp"
+#include "../../src/DS/BNode.tpp"
+#include "Random.hpp"
+
+namespace DS {
+
+/**
+ * @brief	Multi-index B+ tree implementation.
+ * @class	BMap BMap.hpp "DS/BMap.hpp"
+ * @tparam	K Key type of the mapped type to be stored in BMap
+ * @tparam	V Value type to be mapped by K in BMap
+ * @tparam	C Primary comparator
+ * @tparam	Cs Other comparators, followed by the policies (e.g. SlabPool<>)
+ * @details	Every index keeps its own copy of the keys contiguously in its leaves, so K must be copy constructible
+ * and nothrow move constructible. Values are allocated apart and shared by the indices, they are not moved by
+ * put and remove, but iterators are invalidated.
+ */
+template <typename K, typename V, typename C = std::less<>, typename ... Cs>
+class BMap : public Container<> {
+	static_assert(!IsPolicy<C> && PoliciesLast<Cs ...>, "Policies must follow the comparators");
+	static_assert(std::is_copy_constructible_v<K> && std::is_nothrow_move_constructible_v<K>);
+
+	using Value = BValue<V, C, Cs ...>;
+	using Node = BNode<K, Value*, C, Cs ...>;
+	using Leaf = BLeaf<K, Value*, C, Cs ...>;
+
+	Node* mRoot[Dimension<C, Cs ...>] = {};
+
+	// Copy key into the indices from N on but Skip, return the colliding key if any
+	template <std::size_t N, std::size_t Skip>
+	K const*
+	attach(K const& key, Value* value);
+
+	// Remove key from the indices from N on but Skip
+	template <std::size_t N, std::size_t Skip>
+	void
+	detach(K const& key) noexcept;
+
+	template <std::size_t N>
+	void
+	adopt(typename Node::Builder& builder);
+
+	template <std::size_t N = 0>
+	void
+	clear() noexcept;
+
+	void
+	read(Stream::Input& input, auto const& putKey, auto const& setValue);
+
+public:
+	template <Direction, Constness, std::size_t N = 0>
+	class Iterator;
+
+	template <std::size_t N = 0>
+	using iterator = Iterator<Direction::FORWARD, Constness::NCONST, N>;
+
+	template <std::size_t N = 0>
+	using reverse_iterator = Iterator<Direction::BACKWARD, Constness::NCONST, N>;
+
+	template <std::size_t N = 0>
+	using const_iterator = Iterator<Direction::FORWARD, Constness::CONST, N>;
+
+	template <std::size_t N = 0>
+	using const_reverse_iterator = Iterator<Direction::BACKWARD, Constness::CONST, N>;
+
+	template <std::size_t N = 0>
+	class BulkBuilder;
+
+	struct Exception : std::system_error
+	{ using std::system_error::system_error; };
+
+	template <std::size_t N = 0>
+	struct Difference {
+		BMap
+		operator()(BMap const& a, BMap const& b) const;
+	};//struct DS::BMap<K, V, C, Cs ...>::Difference<N>
+
+	template <typename S, std::size_t N = 0>
+	struct Intersection {
+		BMap
+		operator()(BMap const& a, BMap const& b, auto&& ... args) const
+		requires Selector<S, K, decltype(args) ...>;
+	};//struct DS::BMap<K, V, C, Cs ...>::Intersection<S, N>
+
+	template <typename S, std::size_t N = 0>
+	struct Join {
+		BMap
+		operator()(BMap const& a, BMap const& b, auto&& ... args) const
+		requires Selector<S, K, decltype(args) ...>;
+	};//struct DS::BMap<K, V, C, Cs ...>::Join<S, N>
+
+	template <typename S, std::size_t N = 0>
+	struct Union {
+		BMap
+		operator()(BMap const& a, BMap const& b, auto&& ... args) const
+		requires Selector<S, K, decltype(args) ...>;
+	};//struct DS::BMap<K, V, C, Cs ...>::Union<S, N>
+
+	template <typename k, typename v>
+	struct Entry {
+		k key;
+		v value;
+	};//struct DS::BMap<K, V, C, Cs ...>::Entry<k, v>
+
+	BMap() noexcept = default;
+
+	BMap(BMap const& other)
+	requires std::is_copy_constructible_v<V>;
+
+	BMap(BMap&& other) noexcept;
+
+	template <typename k, typename v, typename c, typename ... cs>
+	friend void
+	swap(BMap<k, v, c, cs ...>& a, BMap<k, v, c, cs ...>& b) noexcept;
+
+	BMap&
+	operator=(BMap value) noexcept;
+
+	/**
+	 * @brief	Construct K(input), V(input) in the order of the primary comparator.
+	 * @throws	BMap::Exception if the keys are not ordered
+	 */
+	explicit BMap(Stream::Input& input)
+	requires
+		Stream::Deserializable<K, decltype(input)> &&
+		Stream::Deserializable<V, decltype(input)>;
+
+	/**
+	 * @brief	Construct K(input), V(input, vArgs ...) in the order of the primary comparator.
+	 * @throws	BMap::Exception if the keys are not ordered
+	 */
+	template <typename ... VArgs>
+	BMap(Stream::Input& input, Pack<VArgs ...> vArgs)
+	requires
+		Stream::Deserializable<K, decltype(input)> &&
+		Stream::Deserializable<V, decltype(input), VArgs ...>;
+
+	/**
+	 * @brief	Construct K(input, kArgs ...), V(input) in the order of the primary comparator.
+	 * @throws	BMap::Exception if the keys are not ordered
+	 */
+	template <typename ... KArgs>
+	BMap(Pack<KArgs ...> kArgs, Stream::Input& input)
+	requires
+		Stream::Deserializable<K, decltype(input), KArgs ...> &&
+		Stream::Deserializable<V, decltype(input)>;
+
+	/**
+	 * @brief	Construct K(input, kArgs ...), V(input, vArgs ...) in the order of the primary comparator.
+	 * @throws	BMap::Exception if the keys are not ordered
+	 */
+	template <typename ... KArgs, typename ... VArgs>
+	BMap(Pack<KArgs ...> kArgs, Stream::Input& input, Pack<VArgs ...> vArgs)
+	requires
+		Stream::Deserializable<K, decltype(input), KArgs ...> &&
+		Stream::Deserializable<V, decltype(input), VArgs ...>;
+
+	template <typename k, typename v, typename c, typename ... cs>
+	friend Stream::Output&
+	operator<<(Stream::Output& output, BMap<k, v, c, cs ...> const& map)
+	requires
+		Stream::InsertableTo<k, decltype(output)> &&
+		Stream::InsertableTo<v, decltype(output)>;
+
+	~BMap();
+
+	/**
+	 * @brief	Construct K with kArgs.
+	 */
+	iterator<>
+	put(auto&& ... kArgs);
+
+	template <Direction d, Constness c, std::size_t N = 0>
+	bool
+	remove(Iterator<d, c, N> i) noexcept;
+
+	template <std::size_t N = 0>
+	bool
+	remove(auto&& ... args) noexcept;
+
+	template <std::size_t N = 0>
+	iterator<N>
+	get(auto&& ... args) noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	get(auto&& ... args) const noexcept;
+
+	/**
+	 * @brief	Element at position i in the order of the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	iterator<N>
+	at(std::uint64_t i) noexcept;
+
+	/**
+	 * @brief	Element at position i in the order of the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	const_iterator<N>
+	at(std::uint64_t i) const noexcept;
+
+	/**
+	 * @brief	Number of elements ordered before args by the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	std::uint64_t
+	rank(auto&& ... args) const noexcept;
+
+	/**
+	 * @brief	Number of elements in [lo, hi) by the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	std::uint64_t
+	count(auto const& lo, auto const& hi) const noexcept;
+
+	template <std::size_t N = 0>
+	iterator<N>
+	begin() noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	begin() const noexcept;
+
+	template <std::size_t N = 0>
+	iterator<N>
+	end() noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	end() const noexcept;
+
+	template <std::size_t N = 0>
+	reverse_iterator<N>
+	rbegin() noexcept;
+
+	template <std::size_t N = 0>
+	const_reverse_iterator<N>
+	rbegin() const noexcept;
+
+	template <std::size_t N = 0>
+	reverse_iterator<N>
+	rend() noexcept;
+
+	template <std::size_t N = 0>
+	const_reverse_iterator<N>
+	rend() const noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	cbegin() const noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	cend() const noexcept;
+
+	template <std::size_t N = 0>
+	const_reverse_iterator<N>
+	crbegin() const noexcept;
+
+	template <std::size_t N = 0>
+	const_reverse_iterator<N>
+	crend() const noexcept;
+};//class DS::BMap<K, V, C, Cs ...>
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t n>
+class BMap<K, V, C, Cs ...>::Iterator {
+	friend class BMap;
+
+	template <Direction, Constness, std::size_t>
+	friend class Iterator;
+
+protected:
+	BLeaf<K, BValue<V, C, Cs ...>*, C, Cs ...>* leaf;
+	std::uint32_t i;
+
+	Iterator(BLeaf<K, BValue<V, C, Cs ...>*, C, Cs ...>* leaf, std::uint32_t i) noexcept;
+
+public:
+	using Entry = BMap<K, V, C, Cs ...>::Entry<K const&, TConstness<V, c>&>;
+
+	struct Pointer {
+		Entry entry;
+
+		Entry const*
+		operator->() const noexcept
+		{ return &entry; }
+	};//struct DS::BMap<K, V, C, Cs ...>::Iterator<Direction, Constness, std::size_t>::Pointer
+
+	template <Direction od, Constness oc>
+	Iterator(Iterator<od, oc, n> const& other) noexcept
+	requires ConstCompat<c, oc>;
+
+	template <Direction od, Constness oc>
+	Iterator&
+	operator=(Iterator<od, oc, n> const& other) noexcept
+	requires ConstCompat<c, oc>;
+
+	[[nodiscard]] bool
+	hasValue() const noexcept;
+
+	void
+	unset() const noexcept
+	requires (c == Constness::NCONST);
+
+	/**
+	 * @brief	Construct V with vArgs, the current value is destroyed first.
+	 */
+	V&
+	set(auto&& ... vArgs) const
+	requires (c == Constness::NCONST);
+
+	Iterator&
+	operator++() noexcept;
+
+	Iterator
+	operator++(int) noexcept;
+
+	Iterator&
+	operator--() noexcept;
+
+	Iterator
+	operator--(int) noexcept;
+
+	/**
+	 * @brief	References to the key and the value, the value is valid only if hasValue().
+	 */
+	Entry
+	operator*() const noexcept;
+
+	Pointer
+	operator->() const noexcept;
+
+	template <Direction od, Constness oc>
+	bool
+	operator==(Iterator<od, oc, n> const& other) const noexcept;
+
+	explicit operator bool() const noexcept;
+};//class DS::BMap<K, V, C, Cs ...>::Iterator<Direction, Constness, std::size_t>
+
+/**
+ * @brief	Builds a BMap from keys appended in ascending order of the Nth comparator.
+ * @class	BulkBuilder BMap.hpp "DS/BMap.hpp"
+ * @details	The Nth index is built from full leaves in O(n), the other indices are attached one by one.
+ */
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+class BMap<K, V, C, Cs ...>::BulkBuilder {
+	friend class BMap;
+
+	typename BNode<K, BValue<V, C, Cs ...>*, C, Cs ...>::Builder mBuilder;
+
+	iterator<N>
+	push(K const& key, BValue<V, C, Cs ...> const* value);
+
+	bool
+	follows(auto&& ... args) const noexcept;
+
+public:
+	BulkBuilder() noexcept = default;
+
+	BulkBuilder(BulkBuilder const&) = delete;
+
+	BulkBuilder&
+	operator=(BulkBuilder const&) = delete;
+
+	~BulkBuilder();
+
+	/**
+	 * @brief	Construct K with kArgs and append it.
+	 * @return	Iterator to set the value, it must not be moved before build()
+	 * @throws	BMap::Exception if K is not ordered after the last appended key
+	 */
+	iterator<N>
+	put(auto&& ... kArgs);
+
+	/**
+	 * @brief	Move the appended entries into a BMap.
+	 */
+	BMap
+	build();
+};//class DS::BMap<K, V, C, Cs ...>::BulkBuilder<std::size_t>
+
+}//namespace DS
+
+#include "../../src/DS/BMap.tpp"
@@ -0,0 +1,278 @@
+#pragma once
+
+#include "../../src/DS/Container.tpp"
+#include "../../src/DS/BNode.tpp"
+#include "Random.hpp"
+
+namespace DS {
+
+/**
+ * @brief	Multi-index B+ tree implementation.
+ * @class	BSet BSet.hpp "DS/BSet.hpp"
+ * @tparam	K Key type to be stored in BSet
+ * @tparam	C Primary comparator
+ * @tparam	Cs Other comparators, followed by the policies (e.g. SlabPool<>)
+ * @details	Every index keeps its own copy of the keys contiguously in its leaves, so K must be copy constructible
+ * and nothrow move constructible. Iterators are invalidated by put and remove.
+ */
+template <typename K, typename C = std::less<>, typename ... Cs>
+class BSet : public Container<> {
+	static_assert(!IsPolicy<C> && PoliciesLast<Cs ...>, "Policies must follow the comparators");
+	static_assert(std::is_copy_constructible_v<K> && std::is_nothrow_move_constructible_v<K>);
+
+	BNode<K, void, C, Cs ...>* mRoot[Dimension<C, Cs ...>] = {};
+
+	// Copy key into the indices from N on but Skip, return the colliding key if any
+	template <std::size_t N, std::size_t Skip>
+	K const*
+	attach(K const& key);
+
+	// Remove key from the indices from N on but Skip
+	template <std::size_t N, std::size_t Skip>
+	void
+	detach(K const& key) noexcept;
+
+	template <std::size_t N>
+	void
+	adopt(typename BNode<K, void, C, Cs ...>::Builder& builder);
+
+	template <std::size_t N = 0>
+	void
+	copy(BSet const& other);
+
+	template <std::size_t N = 0>
+	void
+	clear() noexcept;
+
+public:
+	template <Direction, std::size_t N = 0>
+	class Iterator;
+
+	template <std::size_t N = 0>
+	using const_iterator = Iterator<Direction::FORWARD, N>;
+
+	template <std::size_t N = 0>
+	using const_reverse_iterator = Iterator<Direction::BACKWARD, N>;
+
+	template <std::size_t N = 0>
+	class BulkBuilder;
+
+	struct Exception : std::system_error
+	{ using std::system_error::system_error; };
+
+	template <std::size_t N = 0>
+	struct Difference {
+		BSet
+		operator()(BSet const& a, BSet const& b) const;
+	};//struct DS::BSet<K, C, Cs ...>::Difference<N>
+
+	template <typename S, std::size_t N = 0>
+	struct Intersection {
+		BSet
+		operator()(BSet const& a, BSet const& b, auto&& ... args) const
+		requires Selector<S, K, decltype(args) ...>;
+	};//struct DS::BSet<K, C, Cs ...>::Intersection<S, N>
+
+	template <typename S, std::size_t N = 0>
+	struct Join {
+		BSet
+		operator()(BSet const& a, BSet const& b, auto&& ... args) const
+		requires Selector<S, K, decltype(args) ...>;
+	};//struct DS::BSet<K, C, Cs ...>::Join<S, N>
+
+	template <typename S, std::size_t N = 0>
+	struct Union {
+		BSet
+		operator()(BSet const& a, BSet const& b, auto&& ... args) const
+		requires Selector<S, K, decltype(args) ...>;
+	};//struct DS::BSet<K, C, Cs ...>::Union<S, N>
+
+	BSet() noexcept = default;
+
+	BSet(BSet const& other);
+
+	BSet(BSet&& other) noexcept;
+
+	template <typename k, typename c, typename ... cs>
+	friend void
+	swap(BSet<k, c, cs ...>& a, BSet<k, c, cs ...>& b) noexcept;
+
+	BSet&
+	operator=(BSet value) noexcept;
+
+	/**
+	 * @brief	Construct the keys from input in the order of the primary comparator.
+	 * @throws	BSet::Exception if the keys are not ordered
+	 */
+	explicit BSet(Stream::Input& input, auto&& ... kArgs)
+	requires Stream::Deserializable<K, decltype(input), decltype(kArgs) ...>;
+
+	template <typename k, typename c, typename ... cs>
+	friend Stream::Output&
+	operator<<(Stream::Output& output, BSet<k, c, cs ...> const& set)
+	requires Stream::InsertableTo<k, decltype(output)>;
+
+	~BSet();
+
+	/**
+	 * @brief	Construct K with kArgs.
+	 */
+	const_iterator<>
+	put(auto&& ... kArgs);
+
+	template <Direction d, std::size_t N = 0>
+	bool
+	remove(Iterator<d, N> i) noexcept;
+
+	template <std::size_t N = 0>
+	bool
+	remove(auto&& ... args) noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	get(auto&& ... args) const noexcept;
+
+	/**
+	 * @brief	Element at position i in the order of the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	const_iterator<N>
+	at(std::uint64_t i) const noexcept;
+
+	/**
+	 * @brief	Number of elements ordered before args by the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	std::uint64_t
+	rank(auto&& ... args) const noexcept;
+
+	/**
+	 * @brief	Number of elements in [lo, hi) by the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	std::uint64_t
+	count(auto const& lo, auto const& hi) const noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	begin() const noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	end() const noexcept;
+
+	template <std::size_t N = 0>
+	const_reverse_iterator<N>
+	rbegin() const noexcept;
+
+	template <std::size_t N = 0>
+	const_reverse_iterator<N>
+	rend() const noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	cbegin() const noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	cend() const noexcept;
+
+	template <std::size_t N = 0>
+	const_reverse_iterator<N>
+	crbegin() const noexcept;
+
+	template <std::size_t N = 0>
+	const_reverse_iterator<N>
+	crend() const noexcept;
+};//class DS::BSet<K, C, Cs ...>
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+class BSet<K, C, Cs ...>::Iterator {
+	friend class BSet;
+
+	template <Direction, std::size_t>
+	friend class Iterator;
+
+protected:
+	BLeaf<K, void, C, Cs ...>* leaf;
+	std::uint32_t i;
+
+	Iterator(BLeaf<K, void, C, Cs ...>* leaf, std::uint32_t i) noexcept;
+
+public:
+	template <Direction od>
+	explicit Iterator(Iterator<od, n> const& other) noexcept;
+
+	template <Direction od>
+	Iterator&
+	operator=(Iterator<od, n> const& other) noexcept;
+
+	Iterator&
+	operator++() noexcept;
+
+	Iterator
+	operator++(int) noexcept;
+
+	Iterator&
+	operator--() noexcept;
+
+	Iterator
+	operator--(int) noexcept;
+
+	K const&
+	operator*() const noexcept;
+
+	K const*
+	operator->() const noexcept;
+
+	template <Direction od>
+	bool
+	operator==(Iterator<od, n> const& other) const noexcept;
+
+	explicit operator bool() const noexcept;
+};//class DS::BSet<K, C, Cs ...>::Iterator<Direction, std::size_t>
+
+/**
+ * @brief	Builds a BSet from keys appended in ascending order of the Nth comparator.
+ * @class	BulkBuilder BSet.hpp "DS/BSet.hpp"
+ * @details	The Nth index is built from full leaves in O(n), the other indices are attached one by one.
+ */
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+class BSet<K, C, Cs ...>::BulkBuilder {
+	friend class BSet;
+
+	typename BNode<K, void, C, Cs ...>::Builder mBuilder;
+
+	void
+	push(K const& key);
+
+	bool
+	follows(auto&& ... args) const noexcept;
+
+public:
+	BulkBuilder() noexcept = default;
+
+	BulkBuilder(BulkBuilder const&) = delete;
+
+	BulkBuilder&
+	operator=(BulkBuilder const&) = delete;
+
+	/**
+	 * @brief	Construct K with kArgs and append it.
+	 * @throws	BSet::Exception if K is not ordered after the last appended key
+	 */
+	void
+	put(auto&& ... kArgs);
+
+	/**
+	 * @brief	Move the appended keys into a BSet.
+	 */
+	BSet
+	build();
+};//class DS::BSet<K, C, Cs ...>::BulkBuilder<std::size_t>
+
+}//namespace DS
+
+#include "../../src/DS/BSet.tpp"
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "../../src/DS/Container.tpp"
+#include "../../src/DS/CSNode.tpp"
+#include "IntrusivePtr.hpp"
+
+namespace DS {
+
+/**
+ * @brief	Concurrent ordered map implementation.
+ * @class	CMap CMap.hpp "DS/CMap.hpp"
+ * @tparam	K Key type of the mapped type to be stored in CMap
+ * @tparam	V Value type to be mapped by K in CMap
+ * @tparam	C Comparator
+ * @details	Lazy skip list safe to update and read on any thread. put and remove lock the neighbours of the node
+ * they link or unlink, get takes no lock. Removed nodes are released once no thread may reach them, values got
+ * are kept by their references.
+ */
+template <typename K, typename V, typename C = std::less<>>
+class CMap : public Container<true> {
+	using List = CSList<K, V, C>;
+	using Node = typename List::Node;
+
+	List mList;
+
+public:
+	/**
+	 * @brief	Weakly consistent forward iterator, see CSList<K, V, C>::Cursor.
+	 */
+	class Iterator : public List::Cursor {
+		friend class CMap;
+
+		using List::Cursor::Cursor;
+
+	public:
+		struct Entry {
+			K const& key;
+			V& value;
+		};//struct DS::CMap<K, V, C>::Iterator::Entry
+
+		struct Pointer {
+			Entry entry;
+
+			Entry const*
+			operator->() const noexcept
+			{ return &entry; }
+		};//struct DS::CMap<K, V, C>::Iterator::Pointer
+
+		Iterator() noexcept = default;
+
+		Iterator&
+		operator++() noexcept;
+
+		/**
+		 * @brief	References to the key and the value, valid as long as the iterator is on the node.
+		 */
+		Entry
+		operator*() const noexcept;
+
+		Pointer
+		operator->() const noexcept;
+	};//class DS::CMap<K, V, C>::Iterator
+
+	CMap() = default;
+
+	/**
+	 * @brief	Copy constructor deleted
+	 */
+	CMap(CMap const&) = delete;
+
+	/**
+	 * @brief	Move constructor deleted
+	 */
+	CMap(CMap&&) = delete;
+
+	/**
+	 * @brief	Copy assignment deleted
+	 */
+	CMap&
+	operator=(CMap const&) = delete;
+
+	/**
+	 * @brief	Move assignment deleted
+	 */
+	CMap&
+	operator=(CMap&&) = delete;
+
+	/**
+	 * @brief	Destructor, no other thread may use the map.
+	 */
+	~CMap() = default;
+
+	/**
+	 * @brief	Put K(k) with V(vArgs ...) if no element is equal to k, in expected O(log n).
+	 * @return	true, if it is added
+	 */
+	bool
+	put(auto&& k, auto&& ... vArgs);
+
+	/**
+	 * @brief	Value of the element equal to args, or null, in expected O(log n) without locking.
+	 * @details	The value is kept after the element is removed, as long as it is referenced.
+	 */
+	IntrusivePtr<V>
+	get(auto const& ... args) const;
+
+	/**
+	 * @brief	Remove the element equal to args, in expected O(log n).
+	 * @return	true, if it is found and removed by this call
+	 */
+	bool
+	remove(auto const& ... args);
+
+	/**
+	 * @brief	First element not ordered before args.
+	 */
+	Iterator
+	lowerBound(auto const& ... args) const;
+
+	Iterator
+	begin() const noexcept;
+
+	Iterator
+	end() const noexcept;
+};//class DS::CMap<K, V, C>
+
+}//namespace DS
+
+#include "../../src/DS/CMap.tpp"
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "../../src/DS/Container.tpp"
+#include "../../src/DS/CSNode.tpp"
+
+namespace DS {
+
+/**
+ * @brief	Concurrent ordered set implementation.
+ * @class	CSet CSet.hpp "DS/CSet.hpp"
+ * @tparam	K Key type to be stored in CSet
+ * @tparam	C Comparator
+ * @details	Lazy skip list safe to update and read on any thread, see CMap.
+ */
+template <typename K, typename C = std::less<>>
+class CSet : public Container<true> {
+	using List = CSList<K, void, C>;
+
+	List mList;
+
+public:
+	/**
+	 * @brief	Weakly consistent forward iterator, see CSList<K, V, C>::Cursor.
+	 */
+	class Iterator : public List::Cursor {
+		friend class CSet;
+
+		using List::Cursor::Cursor;
+
+	public:
+		Iterator() noexcept = default;
+
+		Iterator&
+		operator++() noexcept;
+
+		/**
+		 * @brief	Key, valid as long as the iterator is on the node.
+		 */
+		K const&
+		operator*() const noexcept;
+
+		K const*
+		operator->() const noexcept;
+	};//class DS::CSet<K, C>::Iterator
+
+	CSet() = default;
+
+	/**
+	 * @brief	Copy constructor deleted
+	 */
+	CSet(CSet const&) = delete;
+
+	/**
+	 * @brief	Move constructor deleted
+	 */
+	CSet(CSet&&) = delete;
+
+	/**
+	 * @brief	Copy assignment deleted
+	 */
+	CSet&
+	operator=(CSet const&) = delete;
+
+	/**
+	 * @brief	Move assignment deleted
+	 */
+	CSet&
+	operator=(CSet&&) = delete;
+
+	/**
+	 * @brief	Destructor, no other thread may use the set.
+	 */
+	~CSet() = default;
+
+	/**
+	 * @brief	Put K(k) if no element is equal to k, in expected O(log n).
+	 * @return	true, if it is added
+	 */
+	bool
+	put(auto&& k);
+
+	/**
+	 * @brief	Element equal to args, or end(), in expected O(log n) without locking.
+	 */
+	Iterator
+	get(auto const& ... args) const;
+
+	/**
+	 * @brief	Remove the element equal to args, in expected O(log n).
+	 * @return	true, if it is found and removed by this call
+	 */
+	bool
+	remove(auto const& ... args);
+
+	/**
+	 * @brief	First element not ordered before args.
+	 */
+	Iterator
+	lowerBound(auto const& ... args) const;
+
+	Iterator
+	begin() const noexcept;
+
+	Iterator
+	end() const noexcept;
+};//class DS::CSet<K, C>
+
+}//namespace DS
+
+#include "../../src/DS/CSet.tpp"
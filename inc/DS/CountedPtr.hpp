@@ -32,7 +32,10 @@ namespace std {
 
 template <typename T>
 class atomic<DS::CountedPtr<T>> {
-	DS::CountedPtr<T> val;
+	std::uintptr_t val; // pointer and count, accessed through a single type
+
+	static std::uintptr_t
+	Raw(DS::CountedPtr<T> p) noexcept;
 
 public:
 	constexpr
@@ -0,0 +1,245 @@
+#pragma once
+
+#include "Map.hpp"
+#include "FrozenSet.hpp"
+
+namespace DS {
+
+/**
+ * @brief	Read-only multi-index map stored contiguously.
+ * @class	FrozenMap FrozenMap.hpp "DS/FrozenMap.hpp"
+ * @tparam	K Key type of the mapped type to be stored in FrozenMap
+ * @tparam	V Value type to be mapped by K in FrozenMap
+ * @tparam	C Primary comparator
+ * @tparam	Cs Other comparators, followed by the policies of the %Map it is frozen from
+ * @details	The keys are indexed as in FrozenSet and the values are kept in an array at the positions of their keys.
+ * K and V must be copy constructible and at most 2^32 - 1 entries can be stored.
+ */
+template <typename K, typename V, typename C, typename ... Cs>
+class FrozenMap : public Container<> {
+	static_assert(std::is_copy_constructible_v<V>);
+
+	FrozenSet<K, C, Cs ...> mKeys;
+	std::vector<Holder<V>> mValues;
+	std::vector<bool> mHasValue;
+
+	// Key of rank r in the order of the Nth comparator
+	template <std::size_t N>
+	K const&
+	key(std::uint64_t r) const noexcept;
+
+	// Position in mValues of the key of rank r in the order of the Nth comparator
+	template <std::size_t N>
+	std::uint64_t
+	position(std::uint64_t r) const noexcept;
+
+	// Append a copy of value, or no value if null
+	void
+	push(V const* value);
+
+	// Copy the values given in the primary order to the positions of their keys
+	void
+	copy(std::vector<V const*> const& values);
+
+	void
+	clear() noexcept;
+
+	// Freeze the entries of the algebra, ordered by the Nth comparator
+	template <std::size_t N>
+	static FrozenMap
+	Build(std::vector<std::pair<K const*, V const*>> const& entries);
+
+public:
+	template <Direction, std::size_t N = 0>
+	class Iterator;
+
+	template <std::size_t N = 0>
+	using const_iterator = Iterator<Direction::FORWARD, N>;
+
+	template <std::size_t N = 0>
+	using const_reverse_iterator = Iterator<Direction::BACKWARD, N>;
+
+	template <std::size_t N = 0>
+	struct Difference {
+		FrozenMap
+		operator()(FrozenMap const& a, FrozenMap const& b) const;
+	};//struct DS::FrozenMap<K, V, C, Cs ...>::Difference<N>
+
+	template <typename S, std::size_t N = 0>
+	struct Intersection {
+		FrozenMap
+		operator()(FrozenMap const& a, FrozenMap const& b, auto&& ... args) const
+		requires Selector<S, K, decltype(args) ...>;
+	};//struct DS::FrozenMap<K, V, C, Cs ...>::Intersection<S, N>
+
+	template <typename S, std::size_t N = 0>
+	struct Join {
+		FrozenMap
+		operator()(FrozenMap const& a, FrozenMap const& b, auto&& ... args) const
+		requires Selector<S, K, decltype(args) ...>;
+	};//struct DS::FrozenMap<K, V, C, Cs ...>::Join<S, N>
+
+	template <typename S, std::size_t N = 0>
+	struct Union {
+		FrozenMap
+		operator()(FrozenMap const& a, FrozenMap const& b, auto&& ... args) const
+		requires Selector<S, K, decltype(args) ...>;
+	};//struct DS::FrozenMap<K, V, C, Cs ...>::Union<S, N>
+
+	template <typename k, typename v>
+	struct Entry {
+		k key;
+		v value;
+	};//struct DS::FrozenMap<K, V, C, Cs ...>::Entry<k, v>
+
+	FrozenMap() noexcept = default;
+
+	/**
+	 * @brief	Copy the entries of map, in O(n log n).
+	 * @throws	std::length_error if map has more than 2^32 - 1 entries
+	 */
+	explicit FrozenMap(Map<K, V, C, Cs ...> const& map);
+
+	FrozenMap(FrozenMap const& other);
+
+	FrozenMap(FrozenMap&& other) noexcept;
+
+	template <typename k, typename v, typename c, typename ... cs>
+	friend void
+	swap(FrozenMap<k, v, c, cs ...>& a, FrozenMap<k, v, c, cs ...>& b) noexcept;
+
+	FrozenMap&
+	operator=(FrozenMap value) noexcept;
+
+	~FrozenMap();
+
+	/**
+	 * @brief	Copy the entries into a %Map.
+	 */
+	Map<K, V, C, Cs ...>
+	thaw() const;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	get(auto&& ... args) const noexcept;
+
+	/**
+	 * @brief	Element at position i in the order of the Nth comparator, in O(1).
+	 */
+	template <std::size_t N = 0>
+	const_iterator<N>
+	at(std::uint64_t i) const noexcept;
+
+	/**
+	 * @brief	Number of elements ordered before args by the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	std::uint64_t
+	rank(auto&& ... args) const noexcept;
+
+	/**
+	 * @brief	Number of elements in [lo, hi) by the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	std::uint64_t
+	count(auto const& lo, auto const& hi) const noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	begin() const noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	end() const noexcept;
+
+	template <std::size_t N = 0>
+	const_reverse_iterator<N>
+	rbegin() const noexcept;
+
+	template <std::size_t N = 0>
+	const_reverse_iterator<N>
+	rend() const noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	cbegin() const noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	cend() const noexcept;
+
+	template <std::size_t N = 0>
+	const_reverse_iterator<N>
+	crbegin() const noexcept;
+
+	template <std::size_t N = 0>
+	const_reverse_iterator<N>
+	crend() const noexcept;
+};//class DS::FrozenMap<K, V, C, Cs ...>
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+class FrozenMap<K, V, C, Cs ...>::Iterator {
+	friend class FrozenMap;
+
+	template <Direction, std::size_t>
+	friend class Iterator;
+
+protected:
+	FrozenMap const* map;
+	std::uint64_t i;
+
+	Iterator(FrozenMap const* map, std::uint64_t i) noexcept;
+
+public:
+	using Entry = FrozenMap<K, V, C, Cs ...>::Entry<K const&, V const&>;
+
+	struct Pointer {
+		Entry entry;
+
+		Entry const*
+		operator->() const noexcept
+		{ return &entry; }
+	};//struct DS::FrozenMap<K, V, C, Cs ...>::Iterator<Direction, std::size_t>::Pointer
+
+	template <Direction od>
+	explicit Iterator(Iterator<od, n> const& other) noexcept;
+
+	template <Direction od>
+	Iterator&
+	operator=(Iterator<od, n> const& other) noexcept;
+
+	[[nodiscard]] bool
+	hasValue() const noexcept;
+
+	Iterator&
+	operator++() noexcept;
+
+	Iterator
+	operator++(int) noexcept;
+
+	Iterator&
+	operator--() noexcept;
+
+	Iterator
+	operator--(int) noexcept;
+
+	/**
+	 * @brief	References to the key and the value, the value is valid only if hasValue().
+	 */
+	Entry
+	operator*() const noexcept;
+
+	Pointer
+	operator->() const noexcept;
+
+	template <Direction od>
+	bool
+	operator==(Iterator<od, n> const& other) const noexcept;
+
+	explicit operator bool() const noexcept;
+};//class DS::FrozenMap<K, V, C, Cs ...>::Iterator<Direction, std::size_t>
+
+}//namespace DS
+
+#include "../../src/DS/FrozenMap.tpp"
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "Set.hpp"
+#include "../../src/DS/Eytzinger.tpp"
+
+namespace DS {
+
+/**
+ * @brief	Read-only multi-index set stored contiguously.
+ * @class	FrozenSet FrozenSet.hpp "DS/FrozenSet.hpp"
+ * @tparam	K Key type to be stored in FrozenSet
+ * @tparam	C Primary comparator
+ * @tparam	Cs Other comparators, followed by the policies of the Set it is frozen from
+ * @details	The keys are copied into an array in the order of the primary comparator and every comparator indexes
+ * them with an Eytzinger search tree, so get and rank take O(log n) without chasing pointers and at takes O(1).
+ * K must be copy constructible and at most 2^32 - 1 keys can be stored.
+ */
+template <typename K, typename C, typename ... Cs>
+class FrozenSet : public Container<> {
+	static_assert(!IsPolicy<C> && PoliciesLast<Cs ...>, "Policies must follow the comparators");
+	static_assert(std::is_copy_constructible_v<K>);
+
+	template <typename, typename, typename, typename ...>
+	friend class FrozenMap;
+
+	template <std::size_t ... N>
+	static std::tuple<Eytzinger<K, TypeAt<N, C, Cs ...>, N == 0> ...>
+	Indices(std::index_sequence<N ...>);
+
+	std::vector<K> mKeys;
+	decltype(Indices(std::make_index_sequence<Dimension<C, Cs ...>>())) mIndex;
+
+	// Copy the keys of container by key(iterator) and index them
+	FrozenSet(auto const& container, auto const& key);
+
+	template <std::size_t N>
+	void
+	index(auto const& container, auto const& key);
+
+	// Freeze the keys of the algebra, ordered by the Nth comparator
+	template <std::size_t N>
+	static FrozenSet
+	Build(std::vector<K const*> const& keys);
+
+public:
+	template <Direction, std::size_t N = 0>
+	class Iterator;
+
+	template <std::size_t N = 0>
+	using const_iterator = Iterator<Direction::FORWARD, N>;
+
+	template <std::size_t N = 0>
+	using const_reverse_iterator = Iterator<Direction::BACKWARD, N>;
+
+	template <std::size_t N = 0>
+	struct Difference {
+		FrozenSet
+		operator()(FrozenSet const& a, FrozenSet const& b) const;
+	};//struct DS::FrozenSet<K, C, Cs ...>::Difference<N>
+
+	template <typename S, std::size_t N = 0>
+	struct Intersection {
+		FrozenSet
+		operator()(FrozenSet const& a, FrozenSet const& b, auto&& ... args) const
+		requires Selector<S, K, decltype(args) ...>;
+	};//struct DS::FrozenSet<K, C, Cs ...>::Intersection<S, N>
+
+	template <typename S, std::size_t N = 0>
+	struct Join {
+		FrozenSet
+		operator()(FrozenSet const& a, FrozenSet const& b, auto&& ... args) const
+		requires Selector<S, K, decltype(args) ...>;
+	};//struct DS::FrozenSet<K, C, Cs ...>::Join<S, N>
+
+	template <typename S, std::size_t N = 0>
+	struct Union {
+		FrozenSet
+		operator()(FrozenSet const& a, FrozenSet const& b, auto&& ... args) const
+		requires Selector<S, K, decltype(args) ...>;
+	};//struct DS::FrozenSet<K, C, Cs ...>::Union<S, N>
+
+	FrozenSet() noexcept = default;
+
+	/**
+	 * @brief	Copy the keys of set, in O(n log n).
+	 * @throws	std::length_error if set has more than 2^32 - 1 keys
+	 */
+	explicit FrozenSet(Set<K, C, Cs ...> const& set);
+
+	FrozenSet(FrozenSet const& other) = default;
+
+	FrozenSet(FrozenSet&& other) noexcept;
+
+	template <typename k, typename c, typename ... cs>
+	friend void
+	swap(FrozenSet<k, c, cs ...>& a, FrozenSet<k, c, cs ...>& b) noexcept;
+
+	FrozenSet&
+	operator=(FrozenSet value) noexcept;
+
+	/**
+	 * @brief	Copy the keys into a Set.
+	 */
+	Set<K, C, Cs ...>
+	thaw() const;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	get(auto&& ... args) const noexcept;
+
+	/**
+	 * @brief	Element at position i in the order of the Nth comparator, in O(1).
+	 */
+	template <std::size_t N = 0>
+	const_iterator<N>
+	at(std::uint64_t i) const noexcept;
+
+	/**
+	 * @brief	Number of elements ordered before args by the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	std::uint64_t
+	rank(auto&& ... args) const noexcept;
+
+	/**
+	 * @brief	Number of elements in [lo, hi) by the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	std::uint64_t
+	count(auto const& lo, auto const& hi) const noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	begin() const noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	end() const noexcept;
+
+	template <std::size_t N = 0>
+	const_reverse_iterator<N>
+	rbegin() const noexcept;
+
+	template <std::size_t N = 0>
+	const_reverse_iterator<N>
+	rend() const noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	cbegin() const noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	cend() const noexcept;
+
+	template <std::size_t N = 0>
+	const_reverse_iterator<N>
+	crbegin() const noexcept;
+
+	template <std::size_t N = 0>
+	const_reverse_iterator<N>
+	crend() const noexcept;
+};//class DS::FrozenSet<K, C, Cs ...>
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+class FrozenSet<K, C, Cs ...>::Iterator {
+	friend class FrozenSet;
+
+	template <Direction, std::size_t>
+	friend class Iterator;
+
+protected:
+	FrozenSet const* set;
+	std::uint64_t i;
+
+	Iterator(FrozenSet const* set, std::uint64_t i) noexcept;
+
+public:
+	template <Direction od>
+	explicit Iterator(Iterator<od, n> const& other) noexcept;
+
+	template <Direction od>
+	Iterator&
+	operator=(Iterator<od, n> const& other) noexcept;
+
+	Iterator&
+	operator++() noexcept;
+
+	Iterator
+	operator++(int) noexcept;
+
+	Iterator&
+	operator--() noexcept;
+
+	Iterator
+	operator--(int) noexcept;
+
+	K const&
+	operator*() const noexcept;
+
+	K const*
+	operator->() const noexcept;
+
+	template <Direction od>
+	bool
+	operator==(Iterator<od, n> const& other) const noexcept;
+
+	explicit operator bool() const noexcept;
+};//class DS::FrozenSet<K, C, Cs ...>::Iterator<Direction, std::size_t>
+
+}//namespace DS
+
+#include "../../src/DS/FrozenSet.tpp"
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../src/DS/Container.tpp"
+#include "../../src/DS/Hashed.tpp"
 #include "../../src/DS/MNode.tpp"
 #include "Random.hpp"
 #include <DP/Factory.hpp>
@@ -8,32 +9,91 @@
 
 namespace DS {
 
+template <typename K, typename V, typename C = std::less<>, typename ... Cs>
+class FrozenMap;
+
 /**
  * @brief	Balanced multi-index search tree implementation.
  * @class	Map Map.hpp "DS/Map.hpp"
  * @tparam	K Key type of the mapped type to be stored in %Map
  * @tparam	V Value type to be mapped by K in %Map
+ * @tparam	C Primary comparator
+ * @tparam	Cs Other comparators, followed by the policies (e.g. SlabPool<>, Hashed<H>)
  * @details	K and V can be any type, including abstract class
  */
 template <typename K, typename V, typename C = std::less<>, typename ... Cs>
 class Map : public Container<> {
-	TNode<sizeof...(Cs) + 1>* mRoot[sizeof...(Cs) + 1] = {};
+	static_assert(!IsPolicy<C> && PoliciesLast<Cs ...>, "Policies must follow the comparators");
 
-	template <std::size_t N = 0>
+	TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* mRoot[Dimension<C, Cs ...>] = {};
+	[[no_unique_address]] HashIndex<K, MNode<K, V, C, Cs ...>, PolicyOf<Hashing, Hashing, Cs ...>> mHash;
+
+	// Rebuild the hashed index of the elements after the trees are relinked at once
+	void
+	rehash() noexcept;
+
+	template <std::size_t N = 0, std::size_t Skip = Dimension<C, Cs ...>>
 	MNode<K, V, C, Cs ...>*
 	putAsRoot(MNode<K, V, C, Cs ...>* created) noexcept;
 
-	template <std::size_t N = 0>
+	template <std::size_t N = 0, std::size_t Skip = Dimension<C, Cs ...>>
 	MNode<K, V, C, Cs ...>*
 	putToRoot(MNode<K, V, C, Cs ...>* created) noexcept;
 
 	MNode<K, V, C, Cs ...>*
 	put(MNode<K, V, C, Cs ...>* created) noexcept;
 
+	// Put created next to hint on the Nth index, without comparing on the way down if created goes to one of its ends
+	template <std::size_t N>
+	MNode<K, V, C, Cs ...>*
+	put(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* hint, MNode<K, V, C, Cs ...>* created) noexcept;
+
+	// Find the node equal to k or put the one made by create(), allocating only on a miss
+	MNode<K, V, C, Cs ...>*
+	emplace(bool& created, auto const& create, auto const& k);
+
 	template <std::size_t N = 0>
 	MNode<K, V, C, Cs ...>*
 	remove(MNode<K, V, C, Cs ...>* toDel) noexcept;
 
+	template <std::size_t N>
+	void
+	adopt(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* root) noexcept;
+
+	// Aggregate of the single element t by the monoid of the Nth comparator, identity() if it has no value
+	template <std::size_t N>
+	static AggregateOf<N, C, Cs ...>
+	Of(SNode<K, C, Cs ...> const* t)
+	{
+		auto const* m = reinterpret_cast<MNode<K, V, C, Cs ...> const*>(t);
+		return m->d[0].hasValue
+			? MonoidOf<N, C, Cs ...>::of(static_cast<K const&>(m->key), static_cast<V const&>(m->val))
+			: MonoidOf<N, C, Cs ...>::identity();
+	}
+
+	// Mark the aggregates depending on the value of m to be recomputed on the augmented indices from the Nth one on
+	template <std::size_t N = 0>
+	void
+	invalidate(MNode<K, V, C, Cs ...> const* m) noexcept;
+
+	// Copy of the element of key, with its value if it has one
+	static MNode<K, V, C, Cs ...>*
+	Copy(K const& key);
+
+	template <std::size_t N, bool OnlyA, bool OnlyB, bool Both>
+	static Map
+	Merge(Map const& a, Map const& b, unsigned threads, auto const& select);
+
+	// Merge the tree b of the Nth index into this %Map without copying, see SNode::Merge
+	template <std::size_t N, bool OnlyA, bool OnlyB, bool Both, bool Move>
+	void
+	mergeInPlace(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* b, auto const& select);
+
+	// Report the elements of the subtree t of a and of b between lo and hi exclusive that differ, null bounds are open
+	template <std::size_t N>
+	static void
+	Diff(SNode<K, C, Cs ...>* t, Map& b, K const* lo, K const* hi, auto& out);
+
 	template <std::size_t N = 0>
 	Format::DotOutput&
 	toDot(Format::DotOutput& dotOutput) const
@@ -42,6 +102,11 @@ class Map : public Container<> {
 		Stream::InsertableTo<V, decltype(dotOutput)>;
 
 public:
+	/**
+	 * @brief	Index of the Hashed policy in Cs, e.g. get<HashedIndex>(key), it follows the comparators.
+	 */
+	static constexpr std::size_t HashedIndex{Dimension<C, Cs ...>};
+
 	template <Direction, Constness, std::size_t N = 0>
 	class Iterator;
 
@@ -57,17 +122,34 @@ public:
 	template <std::size_t N = 0>
 	using const_reverse_iterator = Iterator<Direction::BACKWARD, Constness::CONST, N>;
 
+	template <std::size_t N = 0>
+	class BulkBuilder;
+
+	class Loader;
+
 	struct Exception : std::system_error
 	{ using std::system_error::system_error; };
 
 	template <std::size_t N = 0>
 	struct Difference {
+		/**
+		 * @brief	Number of threads to split the work over, a and b are merged in
+		 * O(m log(n / m + 1)) work if more than 1.
+		 */
+		unsigned threads{1};
+
 		Map
 		operator()(Map const& a, Map const& b) const;
 	};//struct DS::Map<K, V, C, Cs ...>::Difference<N>
 
 	template <typename S, std::size_t N = 0>
 	struct Intersection {
+		/**
+		 * @brief	Number of threads to split the work over, a and b are merged in
+		 * O(m log(n / m + 1)) work if more than 1, S must then be safe to call concurrently.
+		 */
+		unsigned threads{1};
+
 		Map
 		operator()(Map const& a, Map const& b, auto&& ... args) const
 		requires Selector<S, K, decltype(args) ...>;
@@ -75,6 +157,12 @@ public:
 
 	template <typename S, std::size_t N = 0>
 	struct Join {
+		/**
+		 * @brief	Number of threads to split the work over, a and b are merged in
+		 * O(m log(n / m + 1)) work if more than 1, S must then be safe to call concurrently.
+		 */
+		unsigned threads{1};
+
 		Map
 		operator()(Map const& a, Map const& b, auto&& ... args) const
 		requires Selector<S, K, decltype(args) ...>;
@@ -82,6 +170,12 @@ public:
 
 	template <typename S, std::size_t N = 0>
 	struct Union {
+		/**
+		 * @brief	Number of threads to split the work over, a and b are merged in
+		 * O(m log(n / m + 1)) work if more than 1, S must then be safe to call concurrently.
+		 */
+		unsigned threads{1};
+
 		Map
 		operator()(Map const& a, Map const& b, auto&& ... args) const
 		requires Selector<S, K, decltype(args) ...>;
@@ -105,6 +199,12 @@ public:
 	Map(Map const& other)
 	requires std::is_copy_constructible_v<K> && std::is_copy_constructible_v<V>;
 
+	/**
+	 * @brief	Copy constructor copying the subtrees of at least TNode::Grain elements on separate threads while threads allow.
+	 */
+	Map(Map const& other, unsigned threads)
+	requires std::is_copy_constructible_v<K> && std::is_copy_constructible_v<V>;
+
 	/**
 	 * @brief	Move constructor
 	 */
@@ -206,9 +306,24 @@ public:
 
 	/**
 	 * @brief	Destructor
+	 * @details	The elements are destroyed by the Reclaimer policy in Cs, see BackgroundReclaimer.
 	 */
 	~Map();
 
+	/**
+	 * @brief	Remove every element, destroying the subtrees of at least TNode::Grain elements on separate threads
+	 * while threads allow.
+	 */
+	void
+	clear(unsigned threads = 1) noexcept;
+
+	/**
+	 * @brief	Copy the entries into a read-only FrozenMap, in O(n log n).
+	 */
+	FrozenMap<K, V, C, Cs ...>
+	freeze() const
+	requires std::is_copy_constructible_v<K> && std::is_copy_constructible_v<V>;
+
 	/**
 	 * @brief	Construct K with kArgs.
 	 */
@@ -230,6 +345,32 @@ public:
 	iterator<>
 	put(DP::CreateInfo<K, KArgs ...> const& kCreateInfo, auto&& ... kArgs);
 
+	/**
+	 * @brief	Construct K with kArgs and put it next to hint on the Nth comparator.
+	 * @details	If hint is the last element of the Nth index and K follows it, or hint is the first one and K precedes it,
+	 * K is attached along the outer spine with a single comparison on the Nth index, as for ascending or descending
+	 * keys, end() standing for the last element and rend() for the first one. Nodes have no parent links to rebalance
+	 * from, so a hint inside the index falls back to put, descending from the root.
+	 */
+	template <Direction d, Constness c, std::size_t N>
+	iterator<>
+	put(Iterator<d, c, N> hint, auto&& ... kArgs);
+
+	/**
+	 * @brief	Find the element equal to k or put K(k) with V(vArgs ...), in O(log n).
+	 * @return	The element and whether it is put
+	 * @details	The node is allocated only if k is missing, V is constructed only if vArgs are given.
+	 */
+	std::pair<iterator<>, bool>
+	tryPut(auto&& k, auto&& ... vArgs);
+
+	/**
+	 * @brief	Value of the element equal to k, constructed with vArgs if the element or its value is missing.
+	 * @details	The node is allocated only if k is missing.
+	 */
+	V&
+	getOrPut(auto&& k, auto&& ... vArgs);
+
 
 	/**
 	 * @brief	Allocate enough memory for DV and construct K with kArgs.
@@ -281,26 +422,216 @@ public:
 	bool
 	remove(Iterator<d, c, N> i) noexcept;
 
+	/**
+	 * @brief	Remove the element equal to args by the Nth comparator, or by the Hashed policy if N is HashedIndex.
+	 */
 	template <std::size_t N = 0>
 	bool
 	remove(auto&& ... args) noexcept;
 
+	/**
+	 * @brief	Element equal to args by the Nth comparator in O(log n), or by the Hashed policy in O(1) expected
+	 * if N is HashedIndex, iterating the first comparator then.
+	 */
 	template <std::size_t N = 0>
-	iterator<N>
+	iterator<OrderedIndex<N, C, Cs ...>>
 	get(auto&& ... args) noexcept;
 
 	template <std::size_t N = 0>
-	const_iterator<N>
+	const_iterator<OrderedIndex<N, C, Cs ...>>
 	get(auto&& ... args) const noexcept;
 
+	/**
+	 * @brief	Write get<N>(key) of each key in [first, last) to out, in O(m log n) for m keys.
+	 * @return	out past the last written iterator
+	 * @details	Lookups advance in lockstep groups with prefetching, which hides most of the cache misses of
+	 * large maps.
+	 */
+	template <std::size_t N = 0>
+	auto
+	getMany(auto first, auto last, auto out) noexcept;
+
+	template <std::size_t N = 0>
+	auto
+	getMany(auto first, auto last, auto out) const noexcept;
+
+	/**
+	 * @brief	Remove the elements in [first, last) of the Nth comparator.
+	 * @return	Number of removed elements
+	 * @details	The Nth index drops the range in O(log n), the other indices take O(m log n) for m elements
+	 * or O(n) if less.
+	 */
+	template <std::size_t N = 0, Constness c>
+	std::uint64_t
+	remove(Iterator<Direction::FORWARD, c, N> first, Iterator<Direction::FORWARD, c, N> last) noexcept;
+
+	/**
+	 * @brief	Move the elements not ordered before args by the Nth comparator to a new %Map.
+	 * @return	%Map of the moved elements
+	 * @details	Takes O(log n) on a single index. With more comparators, the other indices drop the m moved elements
+	 * in O(m log n) or O(n) if less, and the new %Map indexes them in O(m log m).
+	 */
+	template <std::size_t N = 0>
+	Map
+	splitAt(auto&& ... args) noexcept;
+
+	/**
+	 * @brief	Move the elements of other, which must all follow the ones of this %Map by the Nth comparator, to its end.
+	 * @return	false if other does not follow this %Map, then neither is changed
+	 * @details	Takes O(log n) on a single index. With more comparators, the m moved elements are put on the other
+	 * indices in O(m log n), the ones equal to an element of this %Map by another comparator are dropped.
+	 */
+	template <std::size_t N = 0>
+	bool
+	concat(Map&& other) noexcept;
+
+	/**
+	 * @brief	Move the elements of other into this %Map, keeping the one chosen by S for the keys in both.
+	 * @details	Relinks the nodes of other instead of copying them, in O(m log(n / m + 1)) on the Nth index for sizes
+	 * m <= n. With more comparators, the other indices are rebuilt in O(n log n), dropping the elements that collide
+	 * on them, and with the Hashed policy its index in O(n). If S throws, the merge still completes keeping the elements of this %Map for the keys in both and the
+	 * first exception is rethrown.
+	 */
+	template <typename S, std::size_t N = 0>
+	void
+	merge(Map&& other, auto&& ... args)
+	requires Selector<S, K, decltype(args) ...>;
+
+	/**
+	 * @brief	Remove the elements equal to an element of other by the Nth comparator.
+	 * @details	Takes O(m log(n / m + 1)) on the Nth index for sizes m <= n, with more comparators the other indices are
+	 * rebuilt in O(n log n) and with the Hashed policy its index in O(n).
+	 */
+	template <std::size_t N = 0>
+	void
+	subtract(Map const& other) noexcept;
+
+	/**
+	 * @brief	Remove the elements not equal to any element of other by the Nth comparator.
+	 * @details	Takes O(m log(n / m + 1)) on the Nth index for sizes m <= n, with more comparators the other indices are
+	 * rebuilt in O(n log n) and with the Hashed policy its index in O(n).
+	 */
+	template <std::size_t N = 0>
+	void
+	retain(Map const& other) noexcept;
+
+	/**
+	 * @brief	First element not ordered before args by the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	iterator<N>
+	lowerBound(auto&& ... args) noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	lowerBound(auto&& ... args) const noexcept;
+
+	/**
+	 * @brief	First element ordered after args by the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	iterator<N>
+	upperBound(auto&& ... args) noexcept;
+
+	template <std::size_t N = 0>
+	const_iterator<N>
+	upperBound(auto&& ... args) const noexcept;
+
+	/**
+	 * @brief	Elements equal to args by the Nth comparator as [lowerBound, upperBound), in O(log n).
+	 */
+	template <std::size_t N = 0>
+	std::pair<iterator<N>, iterator<N>>
+	equalRange(auto&& ... args) noexcept;
+
+	template <std::size_t N = 0>
+	std::pair<const_iterator<N>, const_iterator<N>>
+	equalRange(auto&& ... args) const noexcept;
+
+	/**
+	 * @brief	Element at position i in the order of the Nth comparator, in O(log n).
+	 */
 	template <std::size_t N = 0>
 	iterator<N>
 	at(std::uint64_t i) noexcept;
 
+	/**
+	 * @brief	Element at position i in the order of the Nth comparator, in O(log n).
+	 */
 	template <std::size_t N = 0>
 	const_iterator<N>
 	at(std::uint64_t i) const noexcept;
 
+	/**
+	 * @brief	Number of elements ordered before args by the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	std::uint64_t
+	rank(auto&& ... args) const noexcept;
+
+	/**
+	 * @brief	Number of elements in [lo, hi) by the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	std::uint64_t
+	count(auto const& lo, auto const& hi) const noexcept;
+
+	/**
+	 * @brief	Aggregate of all the elements by the monoid of the Nth comparator in the Augment policy.
+	 * @details	Aggregates changed since their last use are recomputed first, which is why the aggregate
+	 * functions are not const and must not run concurrently with the other calls on the same map.
+	 */
+	template <std::size_t N = 0>
+	AggregateOf<N, C, Cs ...>
+	aggregate()
+	requires (!std::is_void_v<MonoidOf<N, C, Cs ...>>);
+
+	/**
+	 * @brief	Aggregate of the elements in [lo, hi) of the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	AggregateOf<N, C, Cs ...>
+	aggregate(auto const& lo, auto const& hi)
+	requires (!std::is_void_v<MonoidOf<N, C, Cs ...>>);
+
+	/**
+	 * @brief	First element of the Nth comparator whose aggregate with the elements before it satisfies pred,
+	 * in O(log n).
+	 * @details	pred must be monotone, once it holds for a prefix it must hold for the longer ones. E.g. with
+	 * the intervals ordered by their start and aggregated by the maximum end, the first one ending after x
+	 * contains x if any interval does.
+	 */
+	template <std::size_t N = 0>
+	iterator<N>
+	search(auto const& pred)
+	requires (!std::is_void_v<MonoidOf<N, C, Cs ...>>);
+
+	/**
+	 * @brief	Call out(i, j) for each key whose elements in a and b differ by the monoid of the Nth comparator,
+	 * e.g. Merkle, i and j are null if the key is missing from a or b.
+	 * @details	Ranges of a and b of equal aggregates are skipped, so that d differences cost O(d log^2 n) and equal
+	 * maps O(1) once their aggregates are computed. Elements without a value aggregate to identity() and are not
+	 * told apart from the missing ones.
+	 */
+	template <std::size_t N = 0>
+	static void
+	diff(Map& a, Map& b, auto&& out)
+	requires (!std::is_void_v<MonoidOf<N, C, Cs ...>>);
+
+	/**
+	 * @brief	Recompute the aggregates of the element of i after its value is changed through i, in O(log n).
+	 */
+	template <Direction d, Constness c, std::size_t N = 0>
+	void
+	refresh(Iterator<d, c, N> i) noexcept;
+
+	/**
+	 * @brief	Counters of the Stats policy, shared by the containers using the same Stats type.
+	 */
+	static auto
+	stats() noexcept
+	requires (!std::is_same_v<PolicyOf<Stats, Stats, C, Cs ...>, Stats>);
+
 	template <std::size_t N = 0>
 	iterator<N>
 	begin() noexcept;
@@ -356,9 +687,9 @@ class Map<K, V, C, Cs ...>::Iterator {
 	friend class Map;
 
 protected:
-	TNode<sizeof...(Cs) + 1>* pos;
+	TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* pos;
 
-	Iterator(TNode<sizeof...(Cs) + 1>* pos) noexcept;
+	Iterator(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* pos) noexcept;
 
 public:
 	using Entry = Map<K, V, C, Cs ...>::Entry<
@@ -415,6 +746,82 @@ public:
 	explicit operator bool() const noexcept;
 };//class DS::Map<K, V, C, Cs ...>::Iterator<Direction, Constness, std::size_t>
 
+/**
+ * @brief	Builds a %Map from keys appended in ascending order of the Nth comparator.
+ * @class	BulkBuilder Map.hpp "DS/Map.hpp"
+ * @details	The Nth index is linked as a perfectly balanced tree in O(n),
+ * the other indices are merge sorted in O(n log n) and linked the same way.
+ */
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+class Map<K, V, C, Cs ...>::BulkBuilder {
+	friend class Map;
+
+	TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* mHead{nullptr};
+	TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* mTail{nullptr};
+	std::uint64_t mCount{0};
+
+	void
+	push(MNode<K, V, C, Cs ...>* created) noexcept;
+
+	bool
+	follows(auto&& ... args) const noexcept;
+
+public:
+	BulkBuilder() noexcept = default;
+
+	BulkBuilder(BulkBuilder const&) = delete;
+
+	BulkBuilder&
+	operator=(BulkBuilder const&) = delete;
+
+	~BulkBuilder();
+
+	/**
+	 * @brief	Construct K with kArgs and append it.
+	 * @return	Iterator to set the value, it must not be moved before build()
+	 * @throws	Map::Exception if K is not ordered after the last appended key
+	 */
+	iterator<N>
+	put(auto&& ... kArgs);
+
+	/**
+	 * @brief	Move the appended entries into a %Map.
+	 */
+	Map
+	build() noexcept;
+};//class DS::Map<K, V, C, Cs ...>::BulkBuilder<std::size_t>
+
+/**
+ * @brief	Puts keys into the first index of a %Map only, its other indices are rebuilt once the Loader is destroyed.
+ * @class	Loader Map.hpp "DS/Map.hpp"
+ * @details	Each other index of the n elements is then merge sorted in O(n log n) and linked as a balanced tree in
+ * O(n), rather than attached to n times. Elements equal on another index to one ordered before them by the first
+ * comparator are dropped then. The %Map must not be used but through the Loader until it is destroyed.
+ */
+template <typename K, typename V, typename C, typename ... Cs>
+class Map<K, V, C, Cs ...>::Loader {
+	Map& mMap;
+
+public:
+	explicit Loader(Map& map) noexcept;
+
+	Loader(Loader const&) = delete;
+
+	Loader&
+	operator=(Loader const&) = delete;
+
+	~Loader();
+
+	/**
+	 * @brief	Construct K with kArgs and put it into the first index.
+	 * @return	Iterator to set the value, the element may be dropped once the Loader is destroyed
+	 */
+	iterator<>
+	put(auto&& ... kArgs);
+};//class DS::Map<K, V, C, Cs ...>::Loader
+
 }//namespace DS
 
 #include "../../src/DS/Map.tpp"
+#include "FrozenMap.hpp"
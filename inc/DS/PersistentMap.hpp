@@ -0,0 +1,92 @@
+#pragma once
+
+#include "../../src/DS/Container.tpp"
+#include "../../src/DS/PNode.tpp"
+
+namespace DS {
+
+/**
+ * @brief	Persistent balanced search tree whose versions are read on any thread while one thread updates it.
+ * @class	PersistentMap PersistentMap.hpp "DS/PersistentMap.hpp"
+ * @tparam	K Key type of the mapped type to be stored in PersistentMap
+ * @tparam	V Value type to be mapped by K in PersistentMap
+ * @tparam	C Comparator
+ * @tparam	Ps Policies (e.g. SlabPool<>)
+ * @details	Updates copy the O(log n) nodes on the path they change and publish the new root atomically, so the
+ * snapshots taken before keep seeing their own version without any lock. Nodes are released with the last
+ * version reaching them. K and V must be copy constructible, they are copied along the changed paths.
+ */
+template <typename K, typename V, typename C = std::less<>, typename ... Ps>
+class PersistentMap : public Container<true> {
+	static_assert((IsPolicy<Ps> && ...), "Only policies may follow the comparator");
+	static_assert(std::is_copy_constructible_v<K> && std::is_copy_constructible_v<V>);
+
+	using Node = PNode<K, V, Ps ...>;
+	using Version = PVersion<K, V, Ps ...>;
+
+	std::atomic<CountedPtr<Version>> mutable mCurrent;
+
+	// Publish the tree root of size elements, taking its reference
+	void
+	publish(Node* root, std::uint64_t size);
+
+public:
+	using Snapshot = PSnapshot<K, V, C, Ps ...>;
+
+	PersistentMap();
+
+	/**
+	 * @brief	Copy constructor deleted
+	 */
+	PersistentMap(PersistentMap const&) = delete;
+
+	/**
+	 * @brief	Move constructor deleted
+	 */
+	PersistentMap(PersistentMap&&) = delete;
+
+	/**
+	 * @brief	Copy assignment deleted
+	 */
+	PersistentMap&
+	operator=(PersistentMap const&) = delete;
+
+	/**
+	 * @brief	Move assignment deleted
+	 */
+	PersistentMap&
+	operator=(PersistentMap&&) = delete;
+
+	/**
+	 * @brief	Destructor, the nodes still reached by snapshots are released with them.
+	 */
+	~PersistentMap();
+
+	/**
+	 * @brief	Put K(k) with V(vArgs ...), replacing the value of the element equal to k if any, in O(log n).
+	 * @return	true, if k is added
+	 * @details	Updates must not run concurrently with each other.
+	 */
+	bool
+	put(auto&& k, auto&& ... vArgs);
+
+	/**
+	 * @brief	Remove the element equal to args, in O(log n).
+	 * @return	true, if it is found
+	 */
+	bool
+	remove(auto const& ... args);
+
+	void
+	clear();
+
+	/**
+	 * @brief	Latest version, in O(1). Safe to call on any thread, concurrently with the updates.
+	 */
+	Snapshot
+	snapshot() const noexcept;
+};//class DS::PersistentMap<K, V, C, Ps ...>
+
+}//namespace DS
+
+#include "../../src/DS/PersistentMap.tpp"
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../../src/DS/Container.tpp"
+#include "../../src/DS/PNode.tpp"
+
+namespace DS {
+
+/**
+ * @brief	Persistent balanced search tree of keys whose versions are read on any thread while one thread updates it.
+ * @class	PersistentSet PersistentSet.hpp "DS/PersistentSet.hpp"
+ * @tparam	K Key type to be stored in PersistentSet
+ * @tparam	C Comparator
+ * @tparam	Ps Policies (e.g. SlabPool<>)
+ * @details	Updates copy the O(log n) nodes on the path they change and publish the new root atomically, so the
+ * snapshots taken before keep seeing their own version without any lock. Nodes are released with the last
+ * version reaching them. K must be copy constructible, it is copied along the changed paths.
+ */
+template <typename K, typename C = std::less<>, typename ... Ps>
+class PersistentSet : public Container<true> {
+	static_assert((IsPolicy<Ps> && ...), "Only policies may follow the comparator");
+	static_assert(std::is_copy_constructible_v<K>);
+
+	using Node = PNode<K, void, Ps ...>;
+	using Version = PVersion<K, void, Ps ...>;
+
+	std::atomic<CountedPtr<Version>> mutable mCurrent;
+
+	// Publish the tree root of size elements, taking its reference
+	void
+	publish(Node* root, std::uint64_t size);
+
+public:
+	using Snapshot = PSnapshot<K, void, C, Ps ...>;
+
+	PersistentSet();
+
+	/**
+	 * @brief	Copy constructor deleted
+	 */
+	PersistentSet(PersistentSet const&) = delete;
+
+	/**
+	 * @brief	Move constructor deleted
+	 */
+	PersistentSet(PersistentSet&&) = delete;
+
+	/**
+	 * @brief	Copy assignment deleted
+	 */
+	PersistentSet&
+	operator=(PersistentSet const&) = delete;
+
+	/**
+	 * @brief	Move assignment deleted
+	 */
+	PersistentSet&
+	operator=(PersistentSet&&) = delete;
+
+	/**
+	 * @brief	Destructor, the nodes still reached by snapshots are released with them.
+	 */
+	~PersistentSet();
+
+	/**
+	 * @brief	Put K(k) unless an element equal to k exists, in O(log n).
+	 * @return	true, if k is added
+	 * @details	Updates must not run concurrently with each other.
+	 */
+	bool
+	put(auto&& k);
+
+	/**
+	 * @brief	Remove the element equal to args, in O(log n).
+	 * @return	true, if it is found
+	 */
+	bool
+	remove(auto const& ... args);
+
+	void
+	clear();
+
+	/**
+	 * @brief	Latest version, in O(1). Safe to call on any thread, concurrently with the updates.
+	 */
+	Snapshot
+	snapshot() const noexcept;
+};//class DS::PersistentSet<K, C, Ps ...>
+
+}//namespace DS
+
+#include "../../src/DS/PersistentSet.tpp"
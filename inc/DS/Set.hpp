@@ -7,33 +7,62 @@
 
 namespace DS {
 
+template <typename K, typename C = std::less<>, typename ... Cs>
+class FrozenSet;
+
 /**
  * @brief	Balanced multi-index search tree implementation.
  * @class	Set Set.hpp "DS/Set.hpp"
  * @tparam	K Key type to be stored in Set
  * @tparam	C Primary comparator
- * @tparam	Cs Other comparators
+ * @tparam	Cs Other comparators, followed by the policies (e.g. SlabPool<>)
  * @details	K can be any type, including abstract class
  */
 template <typename K, typename C = std::less<>, typename ... Cs>
 class Set : public Container<> {
-	TNode<sizeof...(Cs) + 1>* mRoot[sizeof...(Cs) + 1] = {};
+	static_assert(!IsPolicy<C> && PoliciesLast<Cs ...>, "Policies must follow the comparators");
 
-	template <std::size_t N = 0>
+	TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* mRoot[Dimension<C, Cs ...>] = {};
+
+	template <std::size_t N = 0, std::size_t Skip = Dimension<C, Cs ...>>
 	SNode<K, C, Cs ...>*
 	putAsRoot(SNode<K, C, Cs ...>* created) noexcept;
 
-	template <std::size_t N = 0>
+	template <std::size_t N = 0, std::size_t Skip = Dimension<C, Cs ...>>
 	SNode<K, C, Cs ...>*
 	putToRoot(SNode<K, C, Cs ...>* created) noexcept;
 
 	SNode<K, C, Cs ...>*
 	put(SNode<K, C, Cs ...>* created) noexcept;
 
+	// Put created next to hint on the Nth index, without comparing on the way down if created goes to one of its ends
+	template <std::size_t N>
+	SNode<K, C, Cs ...>*
+	put(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* hint, SNode<K, C, Cs ...>* created) noexcept;
+
 	template <std::size_t N = 0>
 	SNode<K, C, Cs ...>*
 	remove(SNode<K, C, Cs ...>* toDel) noexcept;
 
+	template <std::size_t N>
+	void
+	adopt(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* root) noexcept;
+
+	// Aggregate of the single element t by the monoid of the Nth comparator
+	template <std::size_t N>
+	static AggregateOf<N, C, Cs ...>
+	Of(SNode<K, C, Cs ...> const* t)
+	{ return MonoidOf<N, C, Cs ...>::of(static_cast<K const&>(t->key)); }
+
+	template <std::size_t N, bool OnlyA, bool OnlyB, bool Both>
+	static Set
+	Merge(Set const& a, Set const& b, unsigned threads, auto const& select);
+
+	// Merge the tree b of the Nth index into this %Set without copying, see SNode::Merge
+	template <std::size_t N, bool OnlyA, bool OnlyB, bool Both, bool Move>
+	void
+	mergeInPlace(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* b, auto const& select);
+
 	template <std::size_t N = 0>
 	Format::DotOutput&
 	toDot(Format::DotOutput& dotOutput) const
@@ -49,17 +78,34 @@ public:
 	template <std::size_t N = 0>
 	using const_reverse_iterator = Iterator<Direction::BACKWARD, N>;
 
+	template <std::size_t N = 0>
+	class BulkBuilder;
+
+	class Loader;
+
 	struct Exception : std::system_error
 	{ using std::system_error::system_error; };
 
 	template <std::size_t N = 0>
 	struct Difference {
+		/**
+		 * @brief	Number of threads to split the work over, a and b are merged in
+		 * O(m log(n / m + 1)) work if more than 1.
+		 */
+		unsigned threads{1};
+
 		Set
 		operator()(Set const& a, Set const& b) const;
 	};//struct DS::Set<K, C, Cs ...>::Difference<N>
 
 	template <typename S, std::size_t N = 0>
 	struct Intersection {
+		/**
+		 * @brief	Number of threads to split the work over, a and b are merged in
+		 * O(m log(n / m + 1)) work if more than 1, S must then be safe to call concurrently.
+		 */
+		unsigned threads{1};
+
 		Set
 		operator()(Set const& a, Set const& b, auto&& ... args) const
 		requires Selector<S, K, decltype(args) ...>;
@@ -67,6 +113,12 @@ public:
 
 	template <typename S, std::size_t N = 0>
 	struct Join {
+		/**
+		 * @brief	Number of threads to split the work over, a and b are merged in
+		 * O(m log(n / m + 1)) work if more than 1, S must then be safe to call concurrently.
+		 */
+		unsigned threads{1};
+
 		Set
 		operator()(Set const& a, Set const& b, auto&& ... args) const
 		requires Selector<S, K, decltype(args) ...>;
@@ -74,6 +126,12 @@ public:
 
 	template <typename S, std::size_t N = 0>
 	struct Union {
+		/**
+		 * @brief	Number of threads to split the work over, a and b are merged in
+		 * O(m log(n / m + 1)) work if more than 1, S must then be safe to call concurrently.
+		 */
+		unsigned threads{1};
+
 		Set
 		operator()(Set const& a, Set const& b, auto&& ... args) const
 		requires Selector<S, K, decltype(args) ...>;
@@ -84,6 +142,12 @@ public:
 	Set(Set const& other)
 	requires std::is_copy_constructible_v<K>;
 
+	/**
+	 * @brief	Copy constructor copying the subtrees of at least TNode::Grain elements on separate threads while threads allow.
+	 */
+	Set(Set const& other, unsigned threads)
+	requires std::is_copy_constructible_v<K>;
+
 	Set(Set&& other) noexcept;
 
 	template <typename k, typename c, typename ... cs>
@@ -109,8 +173,25 @@ public:
 	operator<<(Format::DotOutput& dotOutput, Set<k, c, cs ...> const& set)
 	requires Stream::InsertableTo<k, decltype(dotOutput)>;
 
+	/**
+	 * @details	The elements are destroyed by the Reclaimer policy in Cs, see BackgroundReclaimer.
+	 */
 	~Set();
 
+	/**
+	 * @brief	Remove every element, destroying the subtrees of at least TNode::Grain elements on separate threads
+	 * while threads allow.
+	 */
+	void
+	clear(unsigned threads = 1) noexcept;
+
+	/**
+	 * @brief	Copy the keys into a read-only FrozenSet, in O(n log n).
+	 */
+	FrozenSet<K, C, Cs ...>
+	freeze() const
+	requires std::is_copy_constructible_v<K>;
+
 	/**
 	 * @brief	Construct K with kArgs.
 	 */
@@ -131,6 +212,17 @@ public:
 	const_iterator<>
 	put(DP::CreateInfo<K, Args ...> const& createInfo, auto&& ... args);
 
+	/**
+	 * @brief	Construct K with kArgs and put it next to hint on the Nth comparator.
+	 * @details	If hint is the last element of the Nth index and K follows it, or hint is the first one and K precedes it,
+	 * K is attached along the outer spine with a single comparison on the Nth index, as for ascending or descending
+	 * keys, end() standing for the last element and rend() for the first one. Nodes have no parent links to rebalance
+	 * from, so a hint inside the index falls back to put, descending from the root.
+	 */
+	template <Direction d, std::size_t N>
+	const_iterator<>
+	put(Iterator<d, N> hint, auto&& ... kArgs);
+
 	template <Direction d, std::size_t N = 0>
 	bool
 	remove(Iterator<d, N> i) noexcept;
@@ -139,14 +231,159 @@ public:
 	bool
 	remove(auto&& ... args) noexcept;
 
+	/**
+	 * @brief	Remove the elements in [first, last) of the Nth comparator.
+	 * @return	Number of removed elements
+	 * @details	The Nth index drops the range in O(log n), the other indices take O(m log n) for m elements
+	 * or O(n) if less.
+	 */
+	template <std::size_t N = 0>
+	std::uint64_t
+	remove(const_iterator<N> first, const_iterator<N> last) noexcept;
+
+	/**
+	 * @brief	Move the elements not ordered before args by the Nth comparator to a new %Set.
+	 * @return	%Set of the moved elements
+	 * @details	Takes O(log n) on a single index. With more comparators, the other indices drop the m moved elements
+	 * in O(m log n) or O(n) if less, and the new %Set indexes them in O(m log m).
+	 */
+	template <std::size_t N = 0>
+	Set
+	splitAt(auto&& ... args) noexcept;
+
+	/**
+	 * @brief	Move the elements of other, which must all follow the ones of this %Set by the Nth comparator, to its end.
+	 * @return	false if other does not follow this %Set, then neither is changed
+	 * @details	Takes O(log n) on a single index. With more comparators, the m moved elements are put on the other
+	 * indices in O(m log n), the ones equal to an element of this %Set by another comparator are dropped.
+	 */
+	template <std::size_t N = 0>
+	bool
+	concat(Set&& other) noexcept;
+
+	/**
+	 * @brief	Move the elements of other into this %Set, keeping the one chosen by S for the keys in both.
+	 * @details	Relinks the nodes of other instead of copying them, in O(m log(n / m + 1)) on the Nth index for sizes
+	 * m <= n. With more comparators, the other indices are rebuilt in O(n log n), dropping the elements that collide
+	 * on them. If S throws, the merge still completes keeping the elements of this %Set for the keys in both and the
+	 * first exception is rethrown.
+	 */
+	template <typename S, std::size_t N = 0>
+	void
+	merge(Set&& other, auto&& ... args)
+	requires Selector<S, K, decltype(args) ...>;
+
+	/**
+	 * @brief	Remove the elements equal to an element of other by the Nth comparator.
+	 * @details	Takes O(m log(n / m + 1)) on the Nth index for sizes m <= n, with more comparators the other indices are
+	 * rebuilt in O(n log n).
+	 */
+	template <std::size_t N = 0>
+	void
+	subtract(Set const& other) noexcept;
+
+	/**
+	 * @brief	Remove the elements not equal to any element of other by the Nth comparator.
+	 * @details	Takes O(m log(n / m + 1)) on the Nth index for sizes m <= n, with more comparators the other indices are
+	 * rebuilt in O(n log n).
+	 */
+	template <std::size_t N = 0>
+	void
+	retain(Set const& other) noexcept;
+
 	template <std::size_t N = 0>
 	const_iterator<N>
 	get(auto&& ... args) const noexcept;
 
+	/**
+	 * @brief	Write get<N>(key) of each key in [first, last) to out, in O(m log n) for m keys.
+	 * @return	out past the last written iterator
+	 * @details	Lookups advance in lockstep groups with prefetching, which hides most of the cache misses of
+	 * large sets.
+	 */
+	template <std::size_t N = 0>
+	auto
+	getMany(auto first, auto last, auto out) const noexcept;
+
+	/**
+	 * @brief	First element not ordered before args by the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	const_iterator<N>
+	lowerBound(auto&& ... args) const noexcept;
+
+	/**
+	 * @brief	First element ordered after args by the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	const_iterator<N>
+	upperBound(auto&& ... args) const noexcept;
+
+	/**
+	 * @brief	Elements equal to args by the Nth comparator as [lowerBound, upperBound), in O(log n).
+	 */
+	template <std::size_t N = 0>
+	std::pair<const_iterator<N>, const_iterator<N>>
+	equalRange(auto&& ... args) const noexcept;
+
+	/**
+	 * @brief	Element at position i in the order of the Nth comparator, in O(log n).
+	 */
 	template <std::size_t N = 0>
 	const_iterator<N>
 	at(std::uint64_t i) const noexcept;
 
+	/**
+	 * @brief	Number of elements ordered before args by the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	std::uint64_t
+	rank(auto&& ... args) const noexcept;
+
+	/**
+	 * @brief	Number of elements in [lo, hi) by the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	std::uint64_t
+	count(auto const& lo, auto const& hi) const noexcept;
+
+	/**
+	 * @brief	Aggregate of all the elements by the monoid of the Nth comparator in the Augment policy.
+	 * @details	Aggregates changed since their last use are recomputed first, which is why the aggregate
+	 * functions are not const and must not run concurrently with the other calls on the same set.
+	 */
+	template <std::size_t N = 0>
+	AggregateOf<N, C, Cs ...>
+	aggregate()
+	requires (!std::is_void_v<MonoidOf<N, C, Cs ...>>);
+
+	/**
+	 * @brief	Aggregate of the elements in [lo, hi) of the Nth comparator, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	AggregateOf<N, C, Cs ...>
+	aggregate(auto const& lo, auto const& hi)
+	requires (!std::is_void_v<MonoidOf<N, C, Cs ...>>);
+
+	/**
+	 * @brief	First element of the Nth comparator whose aggregate with the elements before it satisfies pred,
+	 * in O(log n).
+	 * @details	pred must be monotone, once it holds for a prefix it must hold for the longer ones. E.g. with
+	 * the intervals ordered by their start and aggregated by the maximum end, the first one ending after x
+	 * contains x if any interval does.
+	 */
+	template <std::size_t N = 0>
+	const_iterator<N>
+	search(auto const& pred)
+	requires (!std::is_void_v<MonoidOf<N, C, Cs ...>>);
+
+	/**
+	 * @brief	Counters of the Stats policy, shared by the containers using the same Stats type.
+	 */
+	static auto
+	stats() noexcept
+	requires (!std::is_same_v<PolicyOf<Stats, Stats, C, Cs ...>, Stats>);
+
 	template <std::size_t N = 0>
 	const_iterator<N>
 	begin() const noexcept;
@@ -186,9 +423,9 @@ class Set<K, C, Cs ...>::Iterator {
 	friend class Set;
 
 protected:
-	TNode<sizeof...(Cs) + 1>* pos;
+	TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* pos;
 
-	Iterator(TNode<sizeof...(Cs) + 1>* pos) noexcept;
+	Iterator(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* pos) noexcept;
 
 public:
 	template <Direction od, std::size_t on>
@@ -223,6 +460,80 @@ public:
 	explicit operator bool() const noexcept;
 };//class DS::Set<K, C, Cs ...>::Iterator<Direction, std::size_t>
 
+/**
+ * @brief	Builds a Set from keys appended in ascending order of the Nth comparator.
+ * @class	BulkBuilder Set.hpp "DS/Set.hpp"
+ * @details	The Nth index is linked as a perfectly balanced tree in O(n),
+ * the other indices are merge sorted in O(n log n) and linked the same way.
+ */
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+class Set<K, C, Cs ...>::BulkBuilder {
+	friend class Set;
+
+	TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* mHead{nullptr};
+	TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* mTail{nullptr};
+	std::uint64_t mCount{0};
+
+	void
+	push(SNode<K, C, Cs ...>* created) noexcept;
+
+	bool
+	follows(auto&& ... args) const noexcept;
+
+public:
+	BulkBuilder() noexcept = default;
+
+	BulkBuilder(BulkBuilder const&) = delete;
+
+	BulkBuilder&
+	operator=(BulkBuilder const&) = delete;
+
+	~BulkBuilder();
+
+	/**
+	 * @brief	Construct K with kArgs and append it.
+	 * @throws	Set::Exception if K is not ordered after the last appended key
+	 */
+	void
+	put(auto&& ... kArgs);
+
+	/**
+	 * @brief	Move the appended keys into a Set.
+	 */
+	Set
+	build() noexcept;
+};//class DS::Set<K, C, Cs ...>::BulkBuilder<std::size_t>
+
+/**
+ * @brief	Puts keys into the first index of a Set only, its other indices are rebuilt once the Loader is destroyed.
+ * @class	Loader Set.hpp "DS/Set.hpp"
+ * @details	Each other index of the n elements is then merge sorted in O(n log n) and linked as a balanced tree in
+ * O(n), rather than attached to n times. Elements equal on another index to one ordered before them by the first
+ * comparator are dropped then. The Set must not be used but through the Loader until it is destroyed.
+ */
+template <typename K, typename C, typename ... Cs>
+class Set<K, C, Cs ...>::Loader {
+	Set& mSet;
+
+public:
+	explicit Loader(Set& set) noexcept;
+
+	Loader(Loader const&) = delete;
+
+	Loader&
+	operator=(Loader const&) = delete;
+
+	~Loader();
+
+	/**
+	 * @brief	Construct K with kArgs and put it into the first index.
+	 */
+	void
+	put(auto&& ... kArgs);
+};//class DS::Set<K, C, Cs ...>::Loader
+
 }//namespace DS
 
 #include "../../src/DS/Set.tpp"
+#include "FrozenSet.hpp"
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Policy.tpp"
+#include <cstdint>
+#include <tuple>
+#include <utility>
+
+namespace DS {
+
+/**
+ * @brief	Base of the augmentation policies.
+ */
+struct Augmentation : Policy {};
+
+template <std::size_t N, typename ... Ms>
+struct monoidAt
+{ using type = void; };
+
+template <std::size_t N, typename M, typename ... Ms>
+struct monoidAt<N, M, Ms ...>
+{ using type = typename monoidAt<N - 1, Ms ...>::type; };
+
+template <typename M, typename ... Ms>
+struct monoidAt<0, M, Ms ...>
+{ using type = M; };
+
+/**
+ * @brief	Augmentation policy keeping an aggregate of every subtree, for range aggregates in O(log n).
+ * @tparam	Ms Monoid of each index in the order of the comparators, void for an index that is not augmented
+ * @details	A monoid has the static identity(), combine(a, b) and of(key) for Set or of(key, value) for Map.
+ * combine must be associative with identity() as its identity element. Elements of a Map without a value
+ * aggregate to identity(). Aggregates are recomputed lazily, only for the subtrees changed since their last use.
+ */
+template <typename ... Ms>
+struct Augment : Augmentation {
+	template <std::size_t N>
+	using Monoid = typename monoidAt<N, Ms ...>::type;
+};//struct DS::Augment<Ms ...>
+
+/**
+ * @brief	Monoid hashing the elements for Augment, e.g. Augment<Merkle<std::hash<K>, std::hash<V>>> of a Map.
+ * @details	The aggregate of a subtree is the sum of the hashes of its elements modulo 2^64. It does not depend on the
+ * shape of the tree, so that two containers holding the same elements have the same root hash and their ranges
+ * of equal hashes hold the same elements with high probability. KH hashes the keys and VH the values.
+ */
+template <typename KH, typename VH = KH>
+struct Merkle {
+	// Step of SplitMix64, so that no small hash maps to identity()
+	static std::uint64_t
+	Mix(std::uint64_t h) noexcept
+	{
+		h += 0x9E3779B97F4A7C15;
+		h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9;
+		h = (h ^ (h >> 27)) * 0x94D049BB133111EB;
+		return h ^ (h >> 31);
+	}
+
+	static std::uint64_t
+	identity() noexcept
+	{ return 0; }
+
+	static std::uint64_t
+	combine(std::uint64_t a, std::uint64_t b) noexcept
+	{ return a + b; }
+
+	static std::uint64_t
+	of(auto const& key)
+	{ return Mix(KH{}(key)); }
+
+	static std::uint64_t
+	of(auto const& key, auto const& value)
+	{ return Mix(Mix(KH{}(key)) ^ VH{}(value)); }
+};//struct DS::Merkle<KH, VH>
+
+// Aggregate of an index that is not augmented
+struct NoAggregate {};
+
+template <typename M>
+struct aggregateOf
+{ using type = decltype(M::identity()); };
+
+template <>
+struct aggregateOf<void>
+{ using type = NoAggregate; };
+
+// Monoid of the Nth index by the Augment policy in Cs, void if there is none
+template <std::size_t N, typename ... Cs>
+using MonoidOf = typename PolicyOf<Augmentation, Augment<>, Cs ...>::template Monoid<N>;
+
+// Type of the aggregates of the Nth index by the Augment policy in Cs
+template <std::size_t N, typename ... Cs>
+using AggregateOf = typename aggregateOf<MonoidOf<N, Cs ...>>::type;
+
+template <typename ... Cs, std::size_t ... N>
+constexpr bool
+Augmented(std::index_sequence<N ...>) noexcept
+{ return (!std::is_void_v<MonoidOf<N, Cs ...>> || ...); }
+
+// true, if any index is augmented by the Augment policy in Cs
+template <typename ... Cs>
+inline constexpr bool IsAugmented = Augmented<Cs ...>(std::make_index_sequence<Dimension<Cs ...>>());
+
+}//namespace DS
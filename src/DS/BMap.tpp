@@ -0,0 +1,848 @@
+#pragma once
+
+#include "DS/BMap.hpp"
+
+namespace DS {
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N, std::size_t Skip>
+K const*
+BMap<K, V, C, Cs ...>::attach(K const& key, Value* value)
+{
+	if constexpr (N == Skip) {
+		if constexpr (N + 1 < Dimension<C, Cs ...>)
+			return attach<N + 1, Skip>(key, value);
+		return nullptr;
+	} else {
+		Holder<K> created(key);
+		std::uint32_t i;
+		Leaf* l;
+		try {
+			l = Node::template Insert<TypeAt<N, C, Cs ...>>(mRoot[N], mSize, i, created);
+		} catch (...) {
+			created->~K();
+			throw;
+		}
+		if (!l) { // found an existing key
+			created->~K();
+			return &static_cast<K const&>(Node::template Find<TypeAt<N, C, Cs ...>>(mRoot[N], i, key)->keys[i]);
+		}
+		l->payload[i] = value;
+		if constexpr (N + 1 < Dimension<C, Cs ...>) {
+			K const* found;
+			try {
+				found = attach<N + 1, Skip>(key, value);
+			} catch (...) {
+				Node::template Erase<TypeAt<N, C, Cs ...>>(mRoot[N], [](auto*, auto) {}, key);
+				throw;
+			}
+			if (found) // rollback last attachment
+				Node::template Erase<TypeAt<N, C, Cs ...>>(mRoot[N], [](auto*, auto) {}, key);
+			return found;
+		}
+		return nullptr;
+	}
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N, std::size_t Skip>
+void
+BMap<K, V, C, Cs ...>::detach(K const& key) noexcept
+{
+	if constexpr (N != Skip)
+		Node::template Erase<TypeAt<N, C, Cs ...>>(mRoot[N], [](auto*, auto) {}, key);
+	if constexpr (N + 1 < Dimension<C, Cs ...>)
+		detach<N + 1, Skip>(key);
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+void
+BMap<K, V, C, Cs ...>::adopt(typename Node::Builder& builder)
+{
+	if constexpr (Dimension<C, Cs ...> == 1) {
+		mSize = builder.count();
+		mRoot[N] = builder.build();
+	} else {
+		typename Node::Builder kept;
+		try {
+			while (auto* l = builder.head()) {
+				std::uint32_t k{0};
+				try {
+					for (; k < l->size; ++k) {
+						auto* s = kept.slot();
+						if (attach<0, N>(static_cast<K const&>(l->keys[k]), l->payload[k])) { // other comparators found an existing key
+							l->keys[k]->~K();
+							delete l->payload[k];
+						} else {
+							Node::Relocate(s, &l->keys[k]);
+							auto* t = kept.commit();
+							t->payload[t->size - 1] = l->payload[k];
+							++mSize;
+						}
+					}
+				} catch (...) {
+					// the first k entries are released already
+					Node::Move(l, 0, l, k, l->size - k);
+					l->size -= k;
+					throw;
+				}
+				l->size = 0;
+				builder.pop();
+			}
+			mRoot[N] = kept.build();
+		} catch (...) {
+			if constexpr (N == 0) { // the values are not owned by an index yet
+				for (auto* l = kept.head(); l; l = l->next) {
+					for (std::uint32_t k = 0; k < l->size; ++k)
+						delete l->payload[k];
+				}
+			}
+			clear();
+			mSize = 0;
+			throw;
+		}
+	}
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+void
+BMap<K, V, C, Cs ...>::clear() noexcept
+{
+	if (mRoot[N]) {
+		if constexpr (N == 0) { // the primary index owns the values
+			for (auto* l = Node::LeftMost(mRoot[N]); l; l = l->next) {
+				for (std::uint32_t k = 0; k < l->size; ++k)
+					delete l->payload[k];
+			}
+		}
+		Node::DeleteTree(std::exchange(mRoot[N], nullptr));
+	}
+	if constexpr (N + 1 < Dimension<C, Cs ...>)
+		clear<N + 1>();
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+void
+BMap<K, V, C, Cs ...>::read(Stream::Input& input, auto const& putKey, auto const& setValue)
+{
+	BulkBuilder<> builder;
+	for (auto size = Stream::Get<std::uint64_t>(input); size; --size) {
+		auto i = putKey(builder);
+		if (Stream::Get<std::uint8_t>(input))
+			setValue(i);
+	}
+	auto map = builder.build();
+	swap(*this, map);
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+BMap<K, V, C, Cs ...>::BMap(BMap const& other)
+requires std::is_copy_constructible_v<V>
+		: Container()
+{
+	BulkBuilder<> builder;
+	for (auto i = other.begin(); i; ++i)
+		builder.push(i->key, i.leaf->payload[i.i]);
+	auto map = builder.build();
+	swap(*this, map);
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+BMap<K, V, C, Cs ...>::BMap(BMap&& other) noexcept
+{ swap(*this, other); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+void
+swap(BMap<K, V, C, Cs ...>& a, BMap<K, V, C, Cs ...>& b) noexcept
+{
+	std::swap(a.mSize, b.mSize);
+	std::swap_ranges(a.mRoot, a.mRoot + Dimension<C, Cs ...>, b.mRoot);
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+BMap<K, V, C, Cs ...>&
+BMap<K, V, C, Cs ...>::operator=(BMap value) noexcept
+{
+	swap(*this, value);
+	return *this;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+BMap<K, V, C, Cs ...>::BMap(Stream::Input& input)
+requires
+	Stream::Deserializable<K, decltype(input)> &&
+	Stream::Deserializable<V, decltype(input)>
+{
+	read(input,
+		[&](auto& builder) { return builder.put(input); },
+		[&](auto const& i) { i.set(input); });
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <typename ... VArgs>
+BMap<K, V, C, Cs ...>::BMap(Stream::Input& input, Pack<VArgs ...> vArgs)
+requires
+	Stream::Deserializable<K, decltype(input)> &&
+	Stream::Deserializable<V, decltype(input), VArgs ...>
+{
+	read(input,
+		[&](auto& builder) { return builder.put(input); },
+		[&](auto const& i) {
+			[&]<std::size_t ... I>(std::index_sequence<I ...>) { i.set(input, GetAt<I>(vArgs) ...); }(std::make_index_sequence<sizeof...(VArgs)>{});
+		});
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <typename ... KArgs>
+BMap<K, V, C, Cs ...>::BMap(Pack<KArgs ...> kArgs, Stream::Input& input)
+requires
+	Stream::Deserializable<K, decltype(input), KArgs ...> &&
+	Stream::Deserializable<V, decltype(input)>
+{
+	read(input,
+		[&](auto& builder) {
+			return [&]<std::size_t ... I>(std::index_sequence<I ...>) { return builder.put(input, GetAt<I>(kArgs) ...); }(std::make_index_sequence<sizeof...(KArgs)>{});
+		},
+		[&](auto const& i) { i.set(input); });
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <typename ... KArgs, typename ... VArgs>
+BMap<K, V, C, Cs ...>::BMap(Pack<KArgs ...> kArgs, Stream::Input& input, Pack<VArgs ...> vArgs)
+requires
+	Stream::Deserializable<K, decltype(input), KArgs ...> &&
+	Stream::Deserializable<V, decltype(input), VArgs ...>
+{
+	read(input,
+		[&](auto& builder) {
+			return [&]<std::size_t ... I>(std::index_sequence<I ...>) { return builder.put(input, GetAt<I>(kArgs) ...); }(std::make_index_sequence<sizeof...(KArgs)>{});
+		},
+		[&](auto const& i) {
+			[&]<std::size_t ... I>(std::index_sequence<I ...>) { i.set(input, GetAt<I>(vArgs) ...); }(std::make_index_sequence<sizeof...(VArgs)>{});
+		});
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+Stream::Output&
+operator<<(Stream::Output& output, BMap<K, V, C, Cs ...> const& map)
+requires
+	Stream::InsertableTo<K, decltype(output)> &&
+	Stream::InsertableTo<V, decltype(output)>
+{
+	output << map.mSize;
+	for (auto i = map.begin(); i; ++i) {
+		output << i->key << static_cast<std::uint8_t>(i.hasValue());
+		if (i.hasValue())
+			output << i->value;
+	}
+	return output;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+BMap<K, V, C, Cs ...>::~BMap()
+{ clear(); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+typename BMap<K, V, C, Cs ...>::template iterator<>
+BMap<K, V, C, Cs ...>::put(auto&& ... kArgs)
+{
+	auto* value = new Value;
+	Holder<K> created;
+	std::uint32_t i;
+	Leaf* l;
+	try {
+		::new(static_cast<void*>(&created)) Holder<K>(std::forward<decltype(kArgs)>(kArgs) ...);
+	} catch (...) {
+		delete value;
+		throw;
+	}
+	try {
+		l = Node::template Insert<C>(mRoot[0], mSize, i, created);
+	} catch (...) {
+		created->~K();
+		delete value;
+		throw;
+	}
+	if (!l) { // found an existing key
+		l = Node::template Find<C>(mRoot[0], i, static_cast<K const&>(created));
+		created->~K();
+		delete value;
+		return {l, i};
+	}
+	l->payload[i] = value;
+	if constexpr (Dimension<C, Cs ...> > 1) {
+		K const* found;
+		try {
+			found = attach<1, 0>(static_cast<K const&>(l->keys[i]), value);
+		} catch (...) {
+			Node::template Erase<C>(mRoot[0], [](auto*, auto) {}, static_cast<K const&>(l->keys[i]));
+			delete value;
+			throw;
+		}
+		if (found) { // later comparators found an existing key
+			Node::template Erase<C>(mRoot[0], [](auto*, auto) {}, static_cast<K const&>(l->keys[i]));
+			delete value;
+			l = Node::template Find<C>(mRoot[0], i, *found);
+			return {l, i};
+		}
+	}
+	++mSize;
+	return {l, i};
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t N>
+bool
+BMap<K, V, C, Cs ...>::remove(Iterator<d, c, N> i) noexcept
+{ return i && remove<N>(i->key); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+bool
+BMap<K, V, C, Cs ...>::remove(auto&& ... args) noexcept
+{
+	std::uint32_t i;
+	if (auto* l = mRoot[N] ? Node::template Find<TypeAt<N, C, Cs ...>>(mRoot[N], i, args ...) : nullptr) {
+		auto* value = l->payload[i];
+		auto const& key = static_cast<K const&>(l->keys[i]);
+		if constexpr (Dimension<C, Cs ...> > 1)
+			detach<0, N>(key);
+		Node::template Erase<TypeAt<N, C, Cs ...>>(mRoot[N], [](auto*, auto) {}, key);
+		delete value;
+		--mSize;
+		return true;
+	}
+	return false;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template iterator<N>
+BMap<K, V, C, Cs ...>::get(auto&& ... args) noexcept
+{
+	std::uint32_t i;
+	auto* l = mRoot[N] ? Node::template Find<TypeAt<N, C, Cs ...>>(mRoot[N], i, args ...) : nullptr;
+	return {l, l ? i : 0};
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template const_iterator<N>
+BMap<K, V, C, Cs ...>::get(auto&& ... args) const noexcept
+{
+	std::uint32_t i;
+	auto* l = mRoot[N] ? Node::template Find<TypeAt<N, C, Cs ...>>(mRoot[N], i, args ...) : nullptr;
+	return {l, l ? i : 0};
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template iterator<N>
+BMap<K, V, C, Cs ...>::at(std::uint64_t i) noexcept
+{
+	if (i >= mSize)
+		return {nullptr, 0};
+	auto* l = Node::At(mRoot[N], i);
+	return {l, static_cast<std::uint32_t>(i)};
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template const_iterator<N>
+BMap<K, V, C, Cs ...>::at(std::uint64_t i) const noexcept
+{
+	if (i >= mSize)
+		return {nullptr, 0};
+	auto* l = Node::At(mRoot[N], i);
+	return {l, static_cast<std::uint32_t>(i)};
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+std::uint64_t
+BMap<K, V, C, Cs ...>::rank(auto&& ... args) const noexcept
+{ return mRoot[N] ? Node::template Rank<TypeAt<N, C, Cs ...>>(mRoot[N], args ...) : 0; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+std::uint64_t
+BMap<K, V, C, Cs ...>::count(auto const& lo, auto const& hi) const noexcept
+{
+	auto l = rank<N>(lo);
+	auto h = rank<N>(hi);
+	return l < h ? h - l : 0;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template iterator<N>
+BMap<K, V, C, Cs ...>::begin() noexcept
+{ return {mRoot[N] ? Node::LeftMost(mRoot[N]) : nullptr, 0}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template const_iterator<N>
+BMap<K, V, C, Cs ...>::begin() const noexcept
+{ return {mRoot[N] ? Node::LeftMost(mRoot[N]) : nullptr, 0}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template iterator<N>
+BMap<K, V, C, Cs ...>::end() noexcept
+{ return {nullptr, 0}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template const_iterator<N>
+BMap<K, V, C, Cs ...>::end() const noexcept
+{ return {nullptr, 0}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template reverse_iterator<N>
+BMap<K, V, C, Cs ...>::rbegin() noexcept
+{
+	if (!mRoot[N])
+		return {nullptr, 0};
+	auto* l = Node::RightMost(mRoot[N]);
+	return {l, l->size - 1};
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template const_reverse_iterator<N>
+BMap<K, V, C, Cs ...>::rbegin() const noexcept
+{
+	if (!mRoot[N])
+		return {nullptr, 0};
+	auto* l = Node::RightMost(mRoot[N]);
+	return {l, l->size - 1};
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template reverse_iterator<N>
+BMap<K, V, C, Cs ...>::rend() noexcept
+{ return {nullptr, 0}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template const_reverse_iterator<N>
+BMap<K, V, C, Cs ...>::rend() const noexcept
+{ return {nullptr, 0}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template const_iterator<N>
+BMap<K, V, C, Cs ...>::cbegin() const noexcept
+{ return begin<N>(); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template const_iterator<N>
+BMap<K, V, C, Cs ...>::cend() const noexcept
+{ return end<N>(); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template const_reverse_iterator<N>
+BMap<K, V, C, Cs ...>::crbegin() const noexcept
+{ return rbegin<N>(); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template const_reverse_iterator<N>
+BMap<K, V, C, Cs ...>::crend() const noexcept
+{ return rend<N>(); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t n>
+BMap<K, V, C, Cs ...>::Iterator<d, c, n>::Iterator(BLeaf<K, BValue<V, C, Cs ...>*, C, Cs ...>* leaf, std::uint32_t i) noexcept
+		: leaf(leaf)
+		, i(i)
+{}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t n>
+template <Direction od, Constness oc>
+BMap<K, V, C, Cs ...>::Iterator<d, c, n>::Iterator(Iterator<od, oc, n> const& other) noexcept
+requires ConstCompat<c, oc>
+		: leaf(other.leaf)
+		, i(other.i)
+{}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t n>
+template <Direction od, Constness oc>
+class BMap<K, V, C, Cs ...>::Iterator<d, c, n>&
+BMap<K, V, C, Cs ...>::Iterator<d, c, n>::operator=(Iterator<od, oc, n> const& other) noexcept
+requires ConstCompat<c, oc>
+{
+	leaf = other.leaf;
+	i = other.i;
+	return *this;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t n>
+bool
+BMap<K, V, C, Cs ...>::Iterator<d, c, n>::hasValue() const noexcept
+{ return leaf->payload[i]->hasValue; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t n>
+void
+BMap<K, V, C, Cs ...>::Iterator<d, c, n>::unset() const noexcept
+requires (c == Constness::NCONST)
+{
+	if (auto* value = leaf->payload[i]; value->hasValue) {
+		value->hasValue = false;
+		value->val->~V();
+	}
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t n>
+V&
+BMap<K, V, C, Cs ...>::Iterator<d, c, n>::set(auto&& ... vArgs) const
+requires (c == Constness::NCONST)
+{
+	unset();
+	auto* value = leaf->payload[i];
+	::new(static_cast<void*>(&value->val)) Holder<V>(std::forward<decltype(vArgs)>(vArgs) ...);
+	value->hasValue = true;
+	return static_cast<V&>(value->val);
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t n>
+class BMap<K, V, C, Cs ...>::Iterator<d, c, n>&
+BMap<K, V, C, Cs ...>::Iterator<d, c, n>::operator++() noexcept
+{
+	if constexpr (d == Direction::FORWARD) {
+		if (++i == leaf->size) {
+			leaf = leaf->next;
+			i = 0;
+		}
+	} else if (i)
+		--i;
+	else if ((leaf = leaf->prev))
+		i = leaf->size - 1;
+	return *this;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t n>
+class BMap<K, V, C, Cs ...>::Iterator<d, c, n>
+BMap<K, V, C, Cs ...>::Iterator<d, c, n>::operator++(int) noexcept
+{
+	auto r = *this;
+	++*this;
+	return r;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t n>
+class BMap<K, V, C, Cs ...>::Iterator<d, c, n>&
+BMap<K, V, C, Cs ...>::Iterator<d, c, n>::operator--() noexcept
+{
+	if constexpr (d == Direction::BACKWARD) {
+		if (++i == leaf->size) {
+			leaf = leaf->next;
+			i = 0;
+		}
+	} else if (i)
+		--i;
+	else if ((leaf = leaf->prev))
+		i = leaf->size - 1;
+	return *this;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t n>
+class BMap<K, V, C, Cs ...>::Iterator<d, c, n>
+BMap<K, V, C, Cs ...>::Iterator<d, c, n>::operator--(int) noexcept
+{
+	auto r = *this;
+	--*this;
+	return r;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t n>
+typename BMap<K, V, C, Cs ...>::template Iterator<d, c, n>::Entry
+BMap<K, V, C, Cs ...>::Iterator<d, c, n>::operator*() const noexcept
+{ return {static_cast<K const&>(leaf->keys[i]), static_cast<TConstness<V, c>&>(leaf->payload[i]->val)}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t n>
+typename BMap<K, V, C, Cs ...>::template Iterator<d, c, n>::Pointer
+BMap<K, V, C, Cs ...>::Iterator<d, c, n>::operator->() const noexcept
+{ return {**this}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t n>
+template <Direction od, Constness oc>
+bool
+BMap<K, V, C, Cs ...>::Iterator<d, c, n>::operator==(Iterator<od, oc, n> const& other) const noexcept
+{ return leaf == other.leaf && i == other.i; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t n>
+BMap<K, V, C, Cs ...>::Iterator<d, c, n>::operator bool() const noexcept
+{ return leaf; }
+
+template <typename K, typename V, typename C, typename... Cs>
+template <std::size_t N>
+BMap<K, V, C, Cs...>
+BMap<K, V, C, Cs...>::Difference<N>::operator()(BMap const& a, BMap const& b) const
+{
+	BulkBuilder<N> builder;
+	if (a) {
+		if (b) {
+			// look the keys of a up in b if cheaper than walking both
+			if (a.size() * std::bit_width(b.size()) < b.size()) {
+				for (auto i = a.template begin<N>(); i; ++i) {
+					if (!b.template get<N>(i->key))
+						builder.push(i->key, i.leaf->payload[i.i]);
+				}
+				return builder.build();
+			}
+
+			TypeAt<N, C, Cs ...> cmp;
+			auto i = a.template begin<N>();
+			auto j = b.template begin<N>();
+
+			do {
+				auto const order = Compare(cmp, i->key, j->key);
+				if (order < 0) {
+					builder.push(i->key, i.leaf->payload[i.i]);
+					++i;
+					continue;
+				}
+				if (order > 0) {
+					++j;
+					continue;
+				}
+				++i;
+				++j;
+			} while (i && j);
+
+			for (; i; ++i)
+				builder.push(i->key, i.leaf->payload[i.i]);
+		} else
+			return a;
+	}
+	return builder.build();
+}
+
+template <typename K, typename V, typename C, typename... Cs>
+template <typename S, std::size_t N>
+BMap<K, V, C, Cs...>
+BMap<K, V, C, Cs...>::Intersection<S, N>::operator()(BMap const& a, BMap const& b, auto&& ... args) const
+requires Selector<S, K, decltype(args) ...>
+{
+	BulkBuilder<N> builder;
+	if (a && b) {
+		TypeAt<N, C, Cs ...> cmp;
+		S selector;
+		auto select = [&](auto const& i, auto const& j) {
+			auto const& key = selector(i->key, j->key, std::forward<decltype(args)>(args) ...);
+			builder.push(key, &key == &i->key ? i.leaf->payload[i.i] : j.leaf->payload[j.i]);
+		};
+		// look the keys of the smaller one up in the larger one if cheaper than walking both
+		if (a.size() * std::bit_width(b.size()) < b.size()) {
+			for (auto i = a.template begin<N>(); i; ++i) {
+				if (auto j = b.template get<N>(i->key))
+					select(i, j);
+			}
+			return builder.build();
+		}
+		if (b.size() * std::bit_width(a.size()) < a.size()) {
+			for (auto j = b.template begin<N>(); j; ++j) {
+				if (auto i = a.template get<N>(j->key))
+					select(i, j);
+			}
+			return builder.build();
+		}
+
+		auto i = a.template begin<N>();
+		auto j = b.template begin<N>();
+
+		do {
+			auto const order = Compare(cmp, i->key, j->key);
+			if (order < 0) {
+				++i;
+				continue;
+			}
+			if (order > 0) {
+				++j;
+				continue;
+			}
+			select(i, j);
+			++i;
+			++j;
+		} while (i && j);
+	}
+	return builder.build();
+}
+
+template <typename K, typename V, typename C, typename... Cs>
+template <typename S, std::size_t N>
+BMap<K, V, C, Cs...>
+BMap<K, V, C, Cs...>::Join<S, N>::operator()(BMap const& a, BMap const& b, auto&& ... args) const
+requires Selector<S, K, decltype(args) ...>
+{
+	BulkBuilder<N> builder;
+	if (a) {
+		if (b) {
+			TypeAt<N, C, Cs ...> cmp;
+			S selector;
+			auto i = a.template begin<N>();
+			auto j = b.template begin<N>();
+
+			do {
+				auto const order = Compare(cmp, i->key, j->key);
+				if (order < 0) {
+					builder.push(i->key, i.leaf->payload[i.i]);
+					++i;
+					continue;
+				}
+				if (order > 0) {
+					++j;
+					continue;
+				}
+				auto const& key = selector(i->key, j->key, std::forward<decltype(args)>(args) ...);
+				builder.push(key, &key == &i->key ? i.leaf->payload[i.i] : j.leaf->payload[j.i]);
+				++i;
+				++j;
+			} while (i && j);
+
+			for (; i; ++i)
+				builder.push(i->key, i.leaf->payload[i.i]);
+		} else
+			return a;
+	}
+	return builder.build();
+}
+
+template <typename K, typename V, typename C, typename... Cs>
+template <typename S, std::size_t N>
+BMap<K, V, C, Cs...>
+BMap<K, V, C, Cs...>::Union<S, N>::operator()(BMap const& a, BMap const& b, auto&& ... args) const
+requires Selector<S, K, decltype(args) ...>
+{
+	BulkBuilder<N> builder;
+	if (a) {
+		if (b) {
+			TypeAt<N, C, Cs ...> cmp;
+			S selector;
+			auto i = a.template begin<N>();
+			auto j = b.template begin<N>();
+
+			do {
+				auto const order = Compare(cmp, i->key, j->key);
+				if (order < 0) {
+					builder.push(i->key, i.leaf->payload[i.i]);
+					++i;
+					continue;
+				}
+				if (order > 0) {
+					builder.push(j->key, j.leaf->payload[j.i]);
+					++j;
+					continue;
+				}
+				auto const& key = selector(i->key, j->key, std::forward<decltype(args)>(args) ...);
+				builder.push(key, &key == &i->key ? i.leaf->payload[i.i] : j.leaf->payload[j.i]);
+				++i;
+				++j;
+			} while (i && j);
+
+			for (; i; ++i)
+				builder.push(i->key, i.leaf->payload[i.i]);
+			for (; j; ++j)
+				builder.push(j->key, j.leaf->payload[j.i]);
+		} else
+			return a;
+	} else if (b)
+		return b;
+	return builder.build();
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+BMap<K, V, C, Cs ...>::BulkBuilder<N>::~BulkBuilder()
+{
+	for (auto* l = mBuilder.head(); l; l = l->next) {
+		for (std::uint32_t k = 0; k < l->size; ++k)
+			delete l->payload[k];
+	}
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template iterator<N>
+BMap<K, V, C, Cs ...>::BulkBuilder<N>::push(K const& key, BValue<V, C, Cs ...> const* value)
+{
+	auto* created = new BValue<V, C, Cs ...>;
+	try {
+		if (value->hasValue) {
+			::new(static_cast<void*>(&created->val)) Holder<V>(static_cast<V const&>(value->val));
+			created->hasValue = true;
+		}
+		::new(static_cast<void*>(mBuilder.slot())) Holder<K>(key);
+	} catch (...) {
+		delete created;
+		throw;
+	}
+	auto* l = mBuilder.commit();
+	l->payload[l->size - 1] = created;
+	return {l, l->size - 1};
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+bool
+BMap<K, V, C, Cs ...>::BulkBuilder<N>::follows(auto&& ... args) const noexcept
+{
+	auto* last = mBuilder.last();
+	return !last || Precedes(TypeAt<N, C, Cs ...>{}, *last, args ...);
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename BMap<K, V, C, Cs ...>::template iterator<N>
+BMap<K, V, C, Cs ...>::BulkBuilder<N>::put(auto&& ... kArgs)
+{
+	auto* created = new BValue<V, C, Cs ...>;
+	Holder<K>* key;
+	try {
+		key = mBuilder.slot();
+		::new(static_cast<void*>(key)) Holder<K>(std::forward<decltype(kArgs)>(kArgs) ...);
+	} catch (...) {
+		delete created;
+		throw;
+	}
+	if (!follows(static_cast<K const&>(*key))) {
+		(*key)->~K();
+		delete created;
+		throw Exception(SException::Code::UnorderedKey, std::to_string(N + 1) + ". comparator");
+	}
+	auto* l = mBuilder.commit();
+	l->payload[l->size - 1] = created;
+	return {l, l->size - 1};
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+BMap<K, V, C, Cs ...>
+BMap<K, V, C, Cs ...>::BulkBuilder<N>::build()
+{
+	BMap map;
+	map.template adopt<N>(mBuilder);
+	return map;
+}
+
+}//namespace DS
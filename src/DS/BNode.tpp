@@ -0,0 +1,677 @@
+#pragma once
+
+#include "SNode.tpp"
+#include <vector>
+
+namespace DS {
+
+template <typename P, std::uint32_t Size>
+struct BPayload {
+	P payload[Size];
+};
+
+template <std::uint32_t Size>
+struct BPayload<void, Size> {};
+
+template <typename K, typename P, typename ... Cs>
+struct BLeaf;
+
+template <typename K, typename P, typename ... Cs>
+struct BInner;
+
+/**
+ * @brief	Node of a B+ tree index.
+ * @details	Nodes span 8 cache lines. Leaves keep the keys of an index (and their payloads) contiguously and are
+ * linked in key order. Inner nodes keep copies of the separator keys, the children and the number of elements
+ * under each child.
+ */
+template <typename K, typename P, typename ... Cs>
+struct BNode {
+	using Leaf = BLeaf<K, P, Cs ...>;
+	using Inner = BInner<K, P, Cs ...>;
+
+	static constexpr std::size_t Bytes{512};
+	static constexpr std::size_t PayloadSize{[] { if constexpr (std::is_void_v<P>) return 0; else return sizeof(P); }()};
+	static constexpr std::uint32_t LeafSize{static_cast<std::uint32_t>(std::max<std::size_t>(4, (Bytes - 32) / (sizeof(K) + PayloadSize)))};
+	static constexpr std::uint32_t InnerSize{static_cast<std::uint32_t>(std::max<std::size_t>(4, (Bytes - 16) / (sizeof(K) + sizeof(void*) + sizeof(std::uint64_t))))};
+	static constexpr std::uint32_t LeafMin{std::max<std::uint32_t>(1, LeafSize / 3)};
+	static constexpr std::uint32_t InnerMin{std::max<std::uint32_t>(2, InnerSize / 3)};
+
+	std::uint32_t size{0}; // keys of a leaf, children of an inner node
+	bool const leaf;
+
+	explicit BNode(bool leaf) noexcept
+			: leaf{leaf}
+	{}
+
+	static void*
+	operator new(std::size_t size)
+	{ return PolicyOf<Allocator, Allocator, Cs ...>::allocate(size); }
+
+	static void
+	operator delete(void* ptr)
+	{ PolicyOf<Allocator, Allocator, Cs ...>::deallocate(ptr); }
+
+	[[nodiscard]] bool
+	full() const noexcept
+	{ return size == (leaf ? LeafSize : InnerSize); }
+
+	[[nodiscard]] bool
+	underflow() const noexcept
+	{ return size < (leaf ? LeafMin : InnerMin); }
+
+	static void
+	Relocate(Holder<K>* to, Holder<K>* from) noexcept
+	{
+		::new(static_cast<void*>(to)) Holder<K>(std::move(static_cast<K&>(*from)));
+		(*from)->~K();
+	}
+
+	// Relocate n keys and payloads of from, starting at f, to to, starting at t
+	static void
+	Move(Leaf* to, std::uint32_t t, Leaf* from, std::uint32_t f, std::uint32_t n) noexcept
+	{
+		if (to == from && t > f) {
+			while (n--) {
+				Relocate(&to->keys[t + n], &from->keys[f + n]);
+				if constexpr (!std::is_void_v<P>)
+					to->payload[t + n] = from->payload[f + n];
+			}
+		} else {
+			for (std::uint32_t i = 0; i < n; ++i) {
+				Relocate(&to->keys[t + i], &from->keys[f + i]);
+				if constexpr (!std::is_void_v<P>)
+					to->payload[t + i] = from->payload[f + i];
+			}
+		}
+	}
+
+	template <typename Cmp>
+	static std::uint32_t
+	LowerBound(Holder<K> const* keys, std::uint32_t n, auto const& ... args) noexcept
+	{
+		Cmp cmp;
+		std::uint32_t i{0};
+		while (n) {
+			std::uint32_t half = n / 2;
+			if (Precedes(cmp, static_cast<K const&>(keys[i + half]), args ...)) {
+				i += half + 1;
+				n -= half + 1;
+			} else
+				n = half;
+		}
+		return i;
+	}
+
+	template <typename Cmp>
+	static std::uint32_t
+	UpperBound(Holder<K> const* keys, std::uint32_t n, auto const& ... args) noexcept
+	{
+		Cmp cmp;
+		std::uint32_t i{0};
+		while (n) {
+			std::uint32_t half = n / 2;
+			if (Precedes(cmp, args ..., static_cast<K const&>(keys[i + half])))
+				n = half;
+			else {
+				i += half + 1;
+				n -= half + 1;
+			}
+		}
+		return i;
+	}
+
+	static void
+	DeleteTree(BNode* t) noexcept
+	{
+		if (t->leaf)
+			delete static_cast<Leaf*>(t);
+		else {
+			auto* n = static_cast<Inner*>(t);
+			for (std::uint32_t c = 0; c < n->size; ++c)
+				DeleteTree(n->children[c]);
+			delete n;
+		}
+	}
+
+	static Leaf*
+	LeftMost(BNode* t) noexcept
+	{
+		while (!t->leaf)
+			t = static_cast<Inner*>(t)->children[0];
+		return static_cast<Leaf*>(t);
+	}
+
+	static Leaf*
+	RightMost(BNode* t) noexcept
+	{
+		while (!t->leaf)
+			t = static_cast<Inner*>(t)->children[t->size - 1];
+		return static_cast<Leaf*>(t);
+	}
+
+	/**
+	 * @return	Leaf of the key equal to args and its slot in i, or nullptr
+	 */
+	template <typename Cmp>
+	static Leaf*
+	Find(BNode* t, std::uint32_t& i, auto const& ... args) noexcept
+	{
+		while (!t->leaf) {
+			auto* n = static_cast<Inner*>(t);
+			t = n->children[UpperBound<Cmp>(n->keys, n->size - 1, args ...)];
+		}
+		auto* l = static_cast<Leaf*>(t);
+		i = LowerBound<Cmp>(l->keys, l->size, args ...);
+		return i < l->size && !Precedes(Cmp{}, args ..., static_cast<K const&>(l->keys[i])) ? l : nullptr;
+	}
+
+	/**
+	 * @return	Leaf of the ith key and its slot in i
+	 */
+	static Leaf*
+	At(BNode* t, std::uint64_t& i) noexcept
+	{
+		while (!t->leaf) {
+			auto* n = static_cast<Inner*>(t);
+			std::uint32_t c{0};
+			while (i >= n->counts[c])
+				i -= n->counts[c++];
+			t = n->children[c];
+		}
+		return static_cast<Leaf*>(t);
+	}
+
+	/**
+	 * @return	Number of keys ordered before args
+	 */
+	template <typename Cmp>
+	static std::uint64_t
+	Rank(BNode* t, auto const& ... args) noexcept
+	{
+		std::uint64_t r{0};
+		while (!t->leaf) {
+			auto* n = static_cast<Inner*>(t);
+			std::uint32_t c = UpperBound<Cmp>(n->keys, n->size - 1, args ...);
+			for (std::uint32_t j = 0; j < c; ++j)
+				r += n->counts[j];
+			t = n->children[c];
+		}
+		return r + LowerBound<Cmp>(static_cast<Leaf*>(t)->keys, t->size, args ...);
+	}
+
+	/**
+	 * @brief	Split the full child c of the non-full t.
+	 * @details	The tree is left unchanged if an exception is thrown.
+	 */
+	static void
+	SplitChild(Inner* t, std::uint32_t c)
+	{
+		Holder<K> sep;
+		BNode* r;
+		std::uint64_t cr{0};
+		if (t->children[c]->leaf) {
+			auto* l = static_cast<Leaf*>(t->children[c]);
+			std::uint32_t h = l->size / 2;
+			::new(static_cast<void*>(&sep)) Holder<K>(static_cast<K const&>(l->keys[h]));
+			Leaf* n;
+			try {
+				n = new Leaf;
+			} catch (...) {
+				sep->~K();
+				throw;
+			}
+			Move(n, 0, l, h, l->size - h);
+			n->size = cr = l->size - h;
+			l->size = h;
+			if ((n->next = l->next))
+				n->next->prev = n;
+			n->prev = l;
+			l->next = n;
+			r = n;
+		} else {
+			auto* a = static_cast<Inner*>(t->children[c]);
+			auto* n = new Inner;
+			std::uint32_t h = a->size / 2;
+			for (std::uint32_t k = h; k + 1 < a->size; ++k)
+				Relocate(&n->keys[k - h], &a->keys[k]);
+			for (std::uint32_t k = h; k < a->size; ++k) {
+				n->children[k - h] = a->children[k];
+				cr += n->counts[k - h] = a->counts[k];
+			}
+			Relocate(&sep, &a->keys[h - 1]);
+			n->size = a->size - h;
+			a->size = h;
+			r = n;
+		}
+		for (std::uint32_t k = t->size - 1; k > c; --k)
+			Relocate(&t->keys[k], &t->keys[k - 1]);
+		for (std::uint32_t k = t->size; k > c + 1; --k) {
+			t->children[k] = t->children[k - 1];
+			t->counts[k] = t->counts[k - 1];
+		}
+		Relocate(&t->keys[c], &sep);
+		t->children[c + 1] = r;
+		t->counts[c + 1] = cr;
+		t->counts[c] -= cr;
+		++t->size;
+	}
+
+	/**
+	 * @brief	Relocate key into the index, splitting the full nodes on the way down.
+	 * @param	count Number of keys in the index
+	 * @return	Leaf of the inserted key and its slot in i, or nullptr if an equal key exists and key is kept
+	 */
+	template <typename Cmp>
+	static Leaf*
+	Insert(BNode*& root, std::uint64_t count, std::uint32_t& i, Holder<K>& key)
+	{
+		if (!root)
+			root = new Leaf;
+		else if (root->full()) {
+			auto* t = new Inner;
+			t->children[0] = root;
+			t->counts[0] = count;
+			t->size = 1;
+			try {
+				SplitChild(t, 0);
+			} catch (...) {
+				delete t;
+				throw;
+			}
+			root = t;
+		}
+
+		Cmp cmp;
+		std::uint64_t* path[64];
+		unsigned depth{0};
+		auto* t = root;
+		while (!t->leaf) {
+			auto* n = static_cast<Inner*>(t);
+			std::uint32_t c = UpperBound<Cmp>(n->keys, n->size - 1, static_cast<K const&>(key));
+			if (n->children[c]->full()) {
+				SplitChild(n, c);
+				if (!Precedes(cmp, static_cast<K const&>(key), static_cast<K const&>(n->keys[c])))
+					++c;
+			}
+			path[depth++] = &n->counts[c];
+			t = n->children[c];
+		}
+
+		auto* l = static_cast<Leaf*>(t);
+		i = LowerBound<Cmp>(l->keys, l->size, static_cast<K const&>(key));
+		if (i < l->size && !Precedes(cmp, static_cast<K const&>(key), static_cast<K const&>(l->keys[i])))
+			return nullptr;
+		Move(l, i + 1, l, i, l->size - i);
+		Relocate(&l->keys[i], &key);
+		++l->size;
+		while (depth)
+			++*path[--depth];
+		return l;
+	}
+
+	// Remove the child c + 1 of t whose separator c is already released
+	static void
+	RemoveChild(Inner* t, std::uint32_t c) noexcept
+	{
+		for (std::uint32_t k = c; k + 2 < t->size; ++k)
+			Relocate(&t->keys[k], &t->keys[k + 1]);
+		t->counts[c] += t->counts[c + 1];
+		for (std::uint32_t k = c + 1; k + 1 < t->size; ++k) {
+			t->children[k] = t->children[k + 1];
+			t->counts[k] = t->counts[k + 1];
+		}
+		--t->size;
+	}
+
+	/**
+	 * @brief	Merge the underflowing child c of t with a sibling, or borrow from it.
+	 * @details	If a new separator cannot be copied, the child is left underfull.
+	 */
+	static void
+	Rebalance(Inner* t, std::uint32_t c) noexcept
+	{
+		std::uint32_t j = c ? c - 1 : c;
+		if (t->children[j]->leaf) {
+			auto* a = static_cast<Leaf*>(t->children[j]);
+			auto* b = static_cast<Leaf*>(t->children[j + 1]);
+			if (a->size + b->size <= LeafSize) {
+				Move(a, a->size, b, 0, b->size);
+				a->size += b->size;
+				b->size = 0;
+				if ((a->next = b->next))
+					a->next->prev = a;
+				delete b;
+				t->keys[j]->~K();
+				RemoveChild(t, j);
+				return;
+			}
+			std::uint32_t half = (a->size + b->size) / 2;
+			Holder<K> sep;
+			try {
+				::new(static_cast<void*>(&sep)) Holder<K>(static_cast<K const&>(a->size > half ? a->keys[half] : b->keys[half - a->size]));
+			} catch (...) {
+				return;
+			}
+			if (a->size > half) {
+				std::uint32_t m = a->size - half;
+				Move(b, m, b, 0, b->size);
+				Move(b, 0, a, half, m);
+				a->size -= m;
+				b->size += m;
+			} else {
+				std::uint32_t m = half - a->size;
+				Move(a, a->size, b, 0, m);
+				Move(b, 0, b, m, b->size - m);
+				a->size += m;
+				b->size -= m;
+			}
+			t->keys[j]->~K();
+			Relocate(&t->keys[j], &sep);
+			t->counts[j] = a->size;
+			t->counts[j + 1] = b->size;
+		} else {
+			auto* a = static_cast<Inner*>(t->children[j]);
+			auto* b = static_cast<Inner*>(t->children[j + 1]);
+			if (a->size + b->size <= InnerSize) {
+				Relocate(&a->keys[a->size - 1], &t->keys[j]);
+				for (std::uint32_t k = 0; k + 1 < b->size; ++k)
+					Relocate(&a->keys[a->size + k], &b->keys[k]);
+				for (std::uint32_t k = 0; k < b->size; ++k) {
+					a->children[a->size + k] = b->children[k];
+					a->counts[a->size + k] = b->counts[k];
+				}
+				a->size += b->size;
+				b->size = 0;
+				delete b;
+				RemoveChild(t, j);
+				return;
+			}
+			std::uint32_t half = (a->size + b->size) / 2;
+			while (a->size < half) { // rotate left
+				Relocate(&a->keys[a->size - 1], &t->keys[j]);
+				Relocate(&t->keys[j], &b->keys[0]);
+				a->children[a->size] = b->children[0];
+				a->counts[a->size] = b->counts[0];
+				t->counts[j] += b->counts[0];
+				t->counts[j + 1] -= b->counts[0];
+				++a->size;
+				for (std::uint32_t k = 0; k + 2 < b->size; ++k)
+					Relocate(&b->keys[k], &b->keys[k + 1]);
+				for (std::uint32_t k = 0; k + 1 < b->size; ++k) {
+					b->children[k] = b->children[k + 1];
+					b->counts[k] = b->counts[k + 1];
+				}
+				--b->size;
+			}
+			while (a->size > half) { // rotate right
+				for (std::uint32_t k = b->size - 1; k > 0; --k)
+					Relocate(&b->keys[k], &b->keys[k - 1]);
+				for (std::uint32_t k = b->size; k > 0; --k) {
+					b->children[k] = b->children[k - 1];
+					b->counts[k] = b->counts[k - 1];
+				}
+				Relocate(&b->keys[0], &t->keys[j]);
+				b->children[0] = a->children[a->size - 1];
+				b->counts[0] = a->counts[a->size - 1];
+				t->counts[j] -= b->counts[0];
+				t->counts[j + 1] += b->counts[0];
+				++b->size;
+				Relocate(&t->keys[j], &a->keys[a->size - 2]);
+				--a->size;
+			}
+		}
+	}
+
+	template <typename Cmp>
+	static bool
+	EraseFrom(BNode* t, auto const& extract, auto const& ... args) noexcept
+	{
+		if (t->leaf) {
+			auto* l = static_cast<Leaf*>(t);
+			std::uint32_t i = LowerBound<Cmp>(l->keys, l->size, args ...);
+			if (i == l->size || Precedes(Cmp{}, args ..., static_cast<K const&>(l->keys[i])))
+				return false;
+			extract(l, i);
+			l->keys[i]->~K();
+			Move(l, i, l, i + 1, l->size - i - 1);
+			--l->size;
+			return true;
+		}
+		auto* n = static_cast<Inner*>(t);
+		std::uint32_t c = UpperBound<Cmp>(n->keys, n->size - 1, args ...);
+		if (!EraseFrom<Cmp>(n->children[c], extract, args ...))
+			return false;
+		--n->counts[c];
+		if (n->children[c]->underflow())
+			Rebalance(n, c);
+		return true;
+	}
+
+	/**
+	 * @brief	Remove the key equal to args, args may refer to the key itself.
+	 * @param	extract Called with the leaf and the slot of the key before it is destroyed
+	 */
+	template <typename Cmp>
+	static bool
+	Erase(BNode*& root, auto const& extract, auto const& ... args) noexcept
+	{
+		if (!root || !EraseFrom<Cmp>(root, extract, args ...))
+			return false;
+		if (root->leaf) {
+			if (!root->size) {
+				delete static_cast<Leaf*>(root);
+				root = nullptr;
+			}
+		} else if (root->size == 1) {
+			auto* t = static_cast<Inner*>(root);
+			root = t->children[0];
+			delete t;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief	Links keys appended in order into an index.
+	 * @details	Leaves are filled up, inner levels are built from the leaves in O(n).
+	 */
+	class Builder {
+		Leaf* mHead{nullptr};
+		Leaf* mTail{nullptr};
+		std::uint64_t mCount{0};
+
+	public:
+		Builder() noexcept = default;
+
+		Builder(Builder const&) = delete;
+
+		Builder&
+		operator=(Builder const&) = delete;
+
+		~Builder()
+		{
+			while (mHead)
+				delete std::exchange(mHead, mHead->next);
+		}
+
+		[[nodiscard]] std::uint64_t
+		count() const noexcept
+		{ return mCount; }
+
+		[[nodiscard]] Leaf*
+		head() const noexcept
+		{ return mHead; }
+
+		// Unlink and delete the head leaf
+		void
+		pop() noexcept
+		{
+			auto* l = std::exchange(mHead, mHead->next);
+			if (mHead)
+				mHead->prev = nullptr;
+			else
+				mTail = nullptr;
+			mCount -= l->size;
+			delete l;
+		}
+
+		[[nodiscard]] K const*
+		last() const noexcept
+		{
+			if (mTail && mTail->size)
+				return &static_cast<K const&>(mTail->keys[mTail->size - 1]);
+			if (mTail && mTail->prev)
+				return &static_cast<K const&>(mTail->prev->keys[mTail->prev->size - 1]);
+			return nullptr;
+		}
+
+		/**
+		 * @return	Slot of the next key, to be constructed by the caller before commit()
+		 */
+		Holder<K>*
+		slot()
+		{
+			if (!mTail || mTail->full()) {
+				auto* l = new Leaf;
+				if ((l->prev = mTail))
+					mTail->next = l;
+				else
+					mHead = l;
+				mTail = l;
+			}
+			return &mTail->keys[mTail->size];
+		}
+
+		Leaf*
+		commit() noexcept
+		{
+			++mTail->size;
+			++mCount;
+			return mTail;
+		}
+
+		/**
+		 * @return	Root of the index, the builder is left empty
+		 */
+		BNode*
+		build()
+		{
+			if (mTail && !mTail->size) {
+				auto* l = std::exchange(mTail, mTail->prev);
+				if (mTail)
+					mTail->next = nullptr;
+				else
+					mHead = nullptr;
+				delete l;
+			}
+			if (!mHead)
+				return nullptr;
+			if (auto* p = mTail->prev; p && mTail->underflow()) {
+				std::uint32_t m = p->size - (p->size + mTail->size) / 2;
+				Move(mTail, m, mTail, 0, mTail->size);
+				Move(mTail, 0, p, p->size - m, m);
+				p->size -= m;
+				mTail->size += m;
+			}
+
+			std::vector<BNode*> level;
+			std::vector<std::uint64_t> counts;
+			std::vector<Inner*> inners;
+			try {
+				for (auto* l = mHead; l; l = l->next) {
+					level.push_back(l);
+					counts.push_back(l->size);
+				}
+				while (level.size() > 1) {
+					std::size_t groups = (level.size() + InnerSize - 1) / InnerSize;
+					std::vector<BNode*> upper;
+					std::vector<std::uint64_t> upperCounts;
+					for (std::size_t g = 0, k = 0; g < groups; ++g) {
+						std::size_t end = level.size() * (g + 1) / groups;
+						inners.push_back(nullptr);
+						auto* n = inners.back() = new Inner;
+						upper.push_back(n);
+						upperCounts.push_back(0);
+						for (; k < end; ++k) {
+							if (n->size)
+								::new(static_cast<void*>(&n->keys[n->size - 1])) Holder<K>(static_cast<K const&>(LeftMost(level[k])->keys[0]));
+							n->children[n->size] = level[k];
+							upperCounts.back() += n->counts[n->size] = counts[k];
+							++n->size;
+						}
+					}
+					level = std::move(upper);
+					counts = std::move(upperCounts);
+				}
+			} catch (...) {
+				for (auto* n : inners)
+					delete n;
+				throw;
+			}
+			mHead = mTail = nullptr;
+			mCount = 0;
+			return level[0];
+		}
+	};//class DS::BNode<K, P, Cs ...>::Builder
+};//struct DS::BNode<K, P, Cs ...>
+
+template <typename K, typename P, typename ... Cs>
+struct BLeaf : BNode<K, P, Cs ...>, BPayload<P, BNode<K, P, Cs ...>::LeafSize> {
+	BLeaf* prev{nullptr};
+	BLeaf* next{nullptr};
+	Holder<K> keys[BNode<K, P, Cs ...>::LeafSize];
+
+	BLeaf() noexcept
+			: BNode<K, P, Cs ...>(true)
+	{}
+
+	~BLeaf()
+	{
+		for (std::uint32_t i = 0; i < this->size; ++i)
+			keys[i]->~K();
+	}
+};//struct DS::BLeaf<K, P, Cs ...>
+
+template <typename K, typename P, typename ... Cs>
+struct BInner : BNode<K, P, Cs ...> {
+	Holder<K> keys[BNode<K, P, Cs ...>::InnerSize - 1];
+	BNode<K, P, Cs ...>* children[BNode<K, P, Cs ...>::InnerSize];
+	std::uint64_t counts[BNode<K, P, Cs ...>::InnerSize];
+
+	BInner() noexcept
+			: BNode<K, P, Cs ...>(false)
+	{}
+
+	~BInner()
+	{
+		for (std::uint32_t i = 0; i + 1 < this->size; ++i)
+			keys[i]->~K();
+	}
+};//struct DS::BInner<K, P, Cs ...>
+
+/**
+ * @brief	Value of a BMap entry, shared by the leaves of all indices.
+ */
+template <typename V, typename ... Cs>
+struct BValue {
+	Holder<V> val;
+	bool hasValue{false};
+
+	static void*
+	operator new(std::size_t size)
+	{ return PolicyOf<Allocator, Allocator, Cs ...>::allocate(size); }
+
+	static void
+	operator delete(void* ptr)
+	{ PolicyOf<Allocator, Allocator, Cs ...>::deallocate(ptr); }
+
+	BValue() noexcept = default;
+
+	~BValue()
+	{
+		if (hasValue)
+			val->~V();
+	}
+};//struct DS::BValue<V, Cs ...>
+
+}//namespace DS
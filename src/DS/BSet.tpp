@@ -0,0 +1,653 @@
+#pragma once
+
+#include "DS/BSet.hpp"
+
+namespace DS {
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N, std::size_t Skip>
+K const*
+BSet<K, C, Cs ...>::attach(K const& key)
+{
+	if constexpr (N == Skip) {
+		if constexpr (N + 1 < Dimension<C, Cs ...>)
+			return attach<N + 1, Skip>(key);
+		return nullptr;
+	} else {
+		Holder<K> created(key);
+		std::uint32_t i;
+		BLeaf<K, void, C, Cs ...>* l;
+		try {
+			l = BNode<K, void, C, Cs ...>::template Insert<TypeAt<N, C, Cs ...>>(mRoot[N], mSize, i, created);
+		} catch (...) {
+			created->~K();
+			throw;
+		}
+		if (!l) { // found an existing key
+			created->~K();
+			return &static_cast<K const&>(BNode<K, void, C, Cs ...>::template Find<TypeAt<N, C, Cs ...>>(mRoot[N], i, key)->keys[i]);
+		}
+		if constexpr (N + 1 < Dimension<C, Cs ...>) {
+			K const* found;
+			try {
+				found = attach<N + 1, Skip>(key);
+			} catch (...) {
+				BNode<K, void, C, Cs ...>::template Erase<TypeAt<N, C, Cs ...>>(mRoot[N], [](auto*, auto) {}, key);
+				throw;
+			}
+			if (found) // rollback last attachment
+				BNode<K, void, C, Cs ...>::template Erase<TypeAt<N, C, Cs ...>>(mRoot[N], [](auto*, auto) {}, key);
+			return found;
+		}
+		return nullptr;
+	}
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N, std::size_t Skip>
+void
+BSet<K, C, Cs ...>::detach(K const& key) noexcept
+{
+	if constexpr (N != Skip)
+		BNode<K, void, C, Cs ...>::template Erase<TypeAt<N, C, Cs ...>>(mRoot[N], [](auto*, auto) {}, key);
+	if constexpr (N + 1 < Dimension<C, Cs ...>)
+		detach<N + 1, Skip>(key);
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+void
+BSet<K, C, Cs ...>::adopt(typename BNode<K, void, C, Cs ...>::Builder& builder)
+{
+	if constexpr (Dimension<C, Cs ...> == 1) {
+		mSize = builder.count();
+		mRoot[N] = builder.build();
+	} else {
+		try {
+			typename BNode<K, void, C, Cs ...>::Builder kept;
+			while (auto* l = builder.head()) {
+				std::uint32_t k{0};
+				try {
+					for (; k < l->size; ++k) {
+						auto* s = kept.slot();
+						if (attach<0, N>(static_cast<K const&>(l->keys[k]))) // other comparators found an existing key
+							l->keys[k]->~K();
+						else {
+							BNode<K, void, C, Cs ...>::Relocate(s, &l->keys[k]);
+							kept.commit();
+							++mSize;
+						}
+					}
+				} catch (...) {
+					// the first k keys are released already
+					BNode<K, void, C, Cs ...>::Move(l, 0, l, k, l->size - k);
+					l->size -= k;
+					throw;
+				}
+				l->size = 0;
+				builder.pop();
+			}
+			mRoot[N] = kept.build();
+		} catch (...) {
+			clear();
+			mSize = 0;
+			throw;
+		}
+	}
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+void
+BSet<K, C, Cs ...>::copy(BSet const& other)
+{
+	if (other.mRoot[N]) {
+		typename BNode<K, void, C, Cs ...>::Builder builder;
+		for (auto* l = BNode<K, void, C, Cs ...>::LeftMost(other.mRoot[N]); l; l = l->next) {
+			for (std::uint32_t k = 0; k < l->size; ++k) {
+				::new(static_cast<void*>(builder.slot())) Holder<K>(static_cast<K const&>(l->keys[k]));
+				builder.commit();
+			}
+		}
+		mRoot[N] = builder.build();
+	}
+	if constexpr (N + 1 < Dimension<C, Cs ...>)
+		copy<N + 1>(other);
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+void
+BSet<K, C, Cs ...>::clear() noexcept
+{
+	if (mRoot[N])
+		BNode<K, void, C, Cs ...>::DeleteTree(std::exchange(mRoot[N], nullptr));
+	if constexpr (N + 1 < Dimension<C, Cs ...>)
+		clear<N + 1>();
+}
+
+template <typename K, typename C, typename ... Cs>
+BSet<K, C, Cs ...>::BSet(BSet const& other)
+		: Container(other.mSize)
+{
+	try {
+		copy(other);
+	} catch (...) {
+		clear();
+		throw;
+	}
+}
+
+template <typename K, typename C, typename ... Cs>
+BSet<K, C, Cs ...>::BSet(BSet&& other) noexcept
+{ swap(*this, other); }
+
+template <typename K, typename C, typename ... Cs>
+void
+swap(BSet<K, C, Cs ...>& a, BSet<K, C, Cs ...>& b) noexcept
+{
+	std::swap(a.mSize, b.mSize);
+	std::swap_ranges(a.mRoot, a.mRoot + Dimension<C, Cs ...>, b.mRoot);
+}
+
+template <typename K, typename C, typename ... Cs>
+BSet<K, C, Cs ...>&
+BSet<K, C, Cs ...>::operator=(BSet value) noexcept
+{
+	swap(*this, value);
+	return *this;
+}
+
+template <typename K, typename C, typename ... Cs>
+BSet<K, C, Cs ...>::BSet(Stream::Input& input, auto&& ... kArgs)
+requires Stream::Deserializable<K, decltype(input), decltype(kArgs) ...>
+{
+	BulkBuilder<> builder;
+	for (auto size = Stream::Get<std::uint64_t>(input); size; --size)
+		builder.put(input, kArgs ...);
+	auto set = builder.build();
+	swap(*this, set);
+}
+
+template <typename K, typename C, typename ... Cs>
+Stream::Output&
+operator<<(Stream::Output& output, BSet<K, C, Cs ...> const& set)
+requires Stream::InsertableTo<K, decltype(output)>
+{
+	output << set.mSize;
+	for (auto i = set.begin(); i; ++i)
+		output << *i;
+	return output;
+}
+
+template <typename K, typename C, typename ... Cs>
+BSet<K, C, Cs ...>::~BSet()
+{ clear(); }
+
+template <typename K, typename C, typename ... Cs>
+typename BSet<K, C, Cs ...>::template const_iterator<>
+BSet<K, C, Cs ...>::put(auto&& ... kArgs)
+{
+	Holder<K> created(std::forward<decltype(kArgs)>(kArgs) ...);
+	std::uint32_t i;
+	BLeaf<K, void, C, Cs ...>* l;
+	try {
+		l = BNode<K, void, C, Cs ...>::template Insert<C>(mRoot[0], mSize, i, created);
+	} catch (...) {
+		created->~K();
+		throw;
+	}
+	if (!l) { // found an existing key
+		l = BNode<K, void, C, Cs ...>::template Find<C>(mRoot[0], i, static_cast<K const&>(created));
+		created->~K();
+		return {l, i};
+	}
+	if constexpr (Dimension<C, Cs ...> > 1) {
+		K const* found;
+		try {
+			found = attach<1, 0>(static_cast<K const&>(l->keys[i]));
+		} catch (...) {
+			BNode<K, void, C, Cs ...>::template Erase<C>(mRoot[0], [](auto*, auto) {}, static_cast<K const&>(l->keys[i]));
+			throw;
+		}
+		if (found) { // later comparators found an existing key
+			BNode<K, void, C, Cs ...>::template Erase<C>(mRoot[0], [](auto*, auto) {}, static_cast<K const&>(l->keys[i]));
+			l = BNode<K, void, C, Cs ...>::template Find<C>(mRoot[0], i, *found);
+			return {l, i};
+		}
+	}
+	++mSize;
+	return {l, i};
+}
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t N>
+bool
+BSet<K, C, Cs ...>::remove(Iterator<d, N> i) noexcept
+{ return i && remove<N>(*i); }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+bool
+BSet<K, C, Cs ...>::remove(auto&& ... args) noexcept
+{
+	std::uint32_t i;
+	if (auto* l = mRoot[N] ? BNode<K, void, C, Cs ...>::template Find<TypeAt<N, C, Cs ...>>(mRoot[N], i, args ...) : nullptr) {
+		auto const& key = static_cast<K const&>(l->keys[i]);
+		if constexpr (Dimension<C, Cs ...> > 1)
+			detach<0, N>(key);
+		BNode<K, void, C, Cs ...>::template Erase<TypeAt<N, C, Cs ...>>(mRoot[N], [](auto*, auto) {}, key);
+		--mSize;
+		return true;
+	}
+	return false;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename BSet<K, C, Cs ...>::template const_iterator<N>
+BSet<K, C, Cs ...>::get(auto&& ... args) const noexcept
+{
+	std::uint32_t i;
+	auto* l = mRoot[N] ? BNode<K, void, C, Cs ...>::template Find<TypeAt<N, C, Cs ...>>(mRoot[N], i, args ...) : nullptr;
+	return {l, l ? i : 0};
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename BSet<K, C, Cs ...>::template const_iterator<N>
+BSet<K, C, Cs ...>::at(std::uint64_t i) const noexcept
+{
+	if (i >= mSize)
+		return {nullptr, 0};
+	auto* l = BNode<K, void, C, Cs ...>::At(mRoot[N], i);
+	return {l, static_cast<std::uint32_t>(i)};
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+std::uint64_t
+BSet<K, C, Cs ...>::rank(auto&& ... args) const noexcept
+{ return mRoot[N] ? BNode<K, void, C, Cs ...>::template Rank<TypeAt<N, C, Cs ...>>(mRoot[N], args ...) : 0; }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+std::uint64_t
+BSet<K, C, Cs ...>::count(auto const& lo, auto const& hi) const noexcept
+{
+	auto l = rank<N>(lo);
+	auto h = rank<N>(hi);
+	return l < h ? h - l : 0;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename BSet<K, C, Cs ...>::template const_iterator<N>
+BSet<K, C, Cs ...>::begin() const noexcept
+{ return {mRoot[N] ? BNode<K, void, C, Cs ...>::LeftMost(mRoot[N]) : nullptr, 0}; }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename BSet<K, C, Cs ...>::template const_iterator<N>
+BSet<K, C, Cs ...>::end() const noexcept
+{ return {nullptr, 0}; }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename BSet<K, C, Cs ...>::template const_reverse_iterator<N>
+BSet<K, C, Cs ...>::rbegin() const noexcept
+{
+	if (!mRoot[N])
+		return {nullptr, 0};
+	auto* l = BNode<K, void, C, Cs ...>::RightMost(mRoot[N]);
+	return {l, l->size - 1};
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename BSet<K, C, Cs ...>::template const_reverse_iterator<N>
+BSet<K, C, Cs ...>::rend() const noexcept
+{ return {nullptr, 0}; }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename BSet<K, C, Cs ...>::template const_iterator<N>
+BSet<K, C, Cs ...>::cbegin() const noexcept
+{ return begin<N>(); }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename BSet<K, C, Cs ...>::template const_iterator<N>
+BSet<K, C, Cs ...>::cend() const noexcept
+{ return end<N>(); }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename BSet<K, C, Cs ...>::template const_reverse_iterator<N>
+BSet<K, C, Cs ...>::crbegin() const noexcept
+{ return rbegin<N>(); }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename BSet<K, C, Cs ...>::template const_reverse_iterator<N>
+BSet<K, C, Cs ...>::crend() const noexcept
+{ return rend<N>(); }
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+BSet<K, C, Cs ...>::Iterator<d, n>::Iterator(BLeaf<K, void, C, Cs ...>* leaf, std::uint32_t i) noexcept
+		: leaf(leaf)
+		, i(i)
+{}
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+template <Direction od>
+BSet<K, C, Cs ...>::Iterator<d, n>::Iterator(Iterator<od, n> const& other) noexcept
+		: leaf(other.leaf)
+		, i(other.i)
+{}
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+template <Direction od>
+class BSet<K, C, Cs ...>::Iterator<d, n>&
+BSet<K, C, Cs ...>::Iterator<d, n>::operator=(Iterator<od, n> const& other) noexcept
+{
+	leaf = other.leaf;
+	i = other.i;
+	return *this;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+class BSet<K, C, Cs ...>::Iterator<d, n>&
+BSet<K, C, Cs ...>::Iterator<d, n>::operator++() noexcept
+{
+	if constexpr (d == Direction::FORWARD) {
+		if (++i == leaf->size) {
+			leaf = leaf->next;
+			i = 0;
+		}
+	} else if (i)
+		--i;
+	else if ((leaf = leaf->prev))
+		i = leaf->size - 1;
+	return *this;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+class BSet<K, C, Cs ...>::Iterator<d, n>
+BSet<K, C, Cs ...>::Iterator<d, n>::operator++(int) noexcept
+{
+	auto r = *this;
+	++*this;
+	return r;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+class BSet<K, C, Cs ...>::Iterator<d, n>&
+BSet<K, C, Cs ...>::Iterator<d, n>::operator--() noexcept
+{
+	if constexpr (d == Direction::BACKWARD) {
+		if (++i == leaf->size) {
+			leaf = leaf->next;
+			i = 0;
+		}
+	} else if (i)
+		--i;
+	else if ((leaf = leaf->prev))
+		i = leaf->size - 1;
+	return *this;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+class BSet<K, C, Cs ...>::Iterator<d, n>
+BSet<K, C, Cs ...>::Iterator<d, n>::operator--(int) noexcept
+{
+	auto r = *this;
+	--*this;
+	return r;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+K const&
+BSet<K, C, Cs ...>::Iterator<d, n>::operator*() const noexcept
+{ return static_cast<K const&>(leaf->keys[i]); }
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+K const*
+BSet<K, C, Cs ...>::Iterator<d, n>::operator->() const noexcept
+{ return &static_cast<K const&>(leaf->keys[i]); }
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+template <Direction od>
+bool
+BSet<K, C, Cs ...>::Iterator<d, n>::operator==(Iterator<od, n> const& other) const noexcept
+{ return leaf == other.leaf && i == other.i; }
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+BSet<K, C, Cs ...>::Iterator<d, n>::operator bool() const noexcept
+{ return leaf; }
+
+template <typename K, typename C, typename... Cs>
+template <std::size_t N>
+BSet<K, C, Cs...>
+BSet<K, C, Cs...>::Difference<N>::operator()(BSet const& a, BSet const& b) const
+{
+	BulkBuilder<N> builder;
+	if (a) {
+		if (b) {
+			// look the keys of a up in b if cheaper than walking both
+			if (a.size() * std::bit_width(b.size()) < b.size()) {
+				for (auto i = a.template begin<N>(); i; ++i) {
+					if (!b.template get<N>(*i))
+						builder.push(*i);
+				}
+				return builder.build();
+			}
+
+			TypeAt<N, C, Cs ...> cmp;
+			auto i = a.template begin<N>();
+			auto j = b.template begin<N>();
+
+			do {
+				auto const order = Compare(cmp, *i, *j);
+				if (order < 0) {
+					builder.push(*i);
+					++i;
+					continue;
+				}
+				if (order > 0) {
+					++j;
+					continue;
+				}
+				++i;
+				++j;
+			} while (i && j);
+
+			for (; i; ++i)
+				builder.push(*i);
+		} else
+			return a;
+	}
+	return builder.build();
+}
+
+template <typename K, typename C, typename... Cs>
+template <typename S, std::size_t N>
+BSet<K, C, Cs...>
+BSet<K, C, Cs...>::Intersection<S, N>::operator()(BSet const& a, BSet const& b, auto&& ... args) const
+requires Selector<S, K, decltype(args) ...>
+{
+	BulkBuilder<N> builder;
+	if (a && b) {
+		TypeAt<N, C, Cs ...> cmp;
+		S selector;
+		// look the keys of the smaller one up in the larger one if cheaper than walking both
+		if (a.size() * std::bit_width(b.size()) < b.size()) {
+			for (auto i = a.template begin<N>(); i; ++i) {
+				if (auto j = b.template get<N>(*i))
+					builder.push(selector(*i, *j, std::forward<decltype(args)>(args) ...));
+			}
+			return builder.build();
+		}
+		if (b.size() * std::bit_width(a.size()) < a.size()) {
+			for (auto j = b.template begin<N>(); j; ++j) {
+				if (auto i = a.template get<N>(*j))
+					builder.push(selector(*i, *j, std::forward<decltype(args)>(args) ...));
+			}
+			return builder.build();
+		}
+
+		auto i = a.template begin<N>();
+		auto j = b.template begin<N>();
+
+		do {
+			auto const order = Compare(cmp, *i, *j);
+			if (order < 0) {
+				++i;
+				continue;
+			}
+			if (order > 0) {
+				++j;
+				continue;
+			}
+			builder.push(selector(*i, *j, std::forward<decltype(args)>(args) ...));
+			++i;
+			++j;
+		} while (i && j);
+	}
+	return builder.build();
+}
+
+template <typename K, typename C, typename... Cs>
+template <typename S, std::size_t N>
+BSet<K, C, Cs...>
+BSet<K, C, Cs...>::Join<S, N>::operator()(BSet const& a, BSet const& b, auto&& ... args) const
+requires Selector<S, K, decltype(args) ...>
+{
+	BulkBuilder<N> builder;
+	if (a) {
+		if (b) {
+			TypeAt<N, C, Cs ...> cmp;
+			S selector;
+			auto i = a.template begin<N>();
+			auto j = b.template begin<N>();
+
+			do {
+				auto const order = Compare(cmp, *i, *j);
+				if (order < 0) {
+					builder.push(*i);
+					++i;
+					continue;
+				}
+				if (order > 0) {
+					++j;
+					continue;
+				}
+				builder.push(selector(*i, *j, std::forward<decltype(args)>(args) ...));
+				++i;
+				++j;
+			} while (i && j);
+
+			for (; i; ++i)
+				builder.push(*i);
+		} else
+			return a;
+	}
+	return builder.build();
+}
+
+template <typename K, typename C, typename... Cs>
+template <typename S, std::size_t N>
+BSet<K, C, Cs...>
+BSet<K, C, Cs...>::Union<S, N>::operator()(BSet const& a, BSet const& b, auto&& ... args) const
+requires Selector<S, K, decltype(args) ...>
+{
+	BulkBuilder<N> builder;
+	if (a) {
+		if (b) {
+			TypeAt<N, C, Cs ...> cmp;
+			S selector;
+			auto i = a.template begin<N>();
+			auto j = b.template begin<N>();
+
+			do {
+				auto const order = Compare(cmp, *i, *j);
+				if (order < 0) {
+					builder.push(*i);
+					++i;
+					continue;
+				}
+				if (order > 0) {
+					builder.push(*j);
+					++j;
+					continue;
+				}
+				builder.push(selector(*i, *j, std::forward<decltype(args)>(args) ...));
+				++i;
+				++j;
+			} while (i && j);
+
+			for (; i; ++i)
+				builder.push(*i);
+			for (; j; ++j)
+				builder.push(*j);
+		} else
+			return a;
+	} else if (b)
+		return b;
+	return builder.build();
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+void
+BSet<K, C, Cs ...>::BulkBuilder<N>::push(K const& key)
+{
+	::new(static_cast<void*>(mBuilder.slot())) Holder<K>(key);
+	mBuilder.commit();
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+bool
+BSet<K, C, Cs ...>::BulkBuilder<N>::follows(auto&& ... args) const noexcept
+{
+	auto* last = mBuilder.last();
+	return !last || Precedes(TypeAt<N, C, Cs ...>{}, *last, args ...);
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+void
+BSet<K, C, Cs ...>::BulkBuilder<N>::put(auto&& ... kArgs)
+{
+	auto* created = mBuilder.slot();
+	::new(static_cast<void*>(created)) Holder<K>(std::forward<decltype(kArgs)>(kArgs) ...);
+	if (!follows(static_cast<K const&>(*created))) {
+		(*created)->~K();
+		throw Exception(SException::Code::UnorderedKey, std::to_string(N + 1) + ". comparator");
+	}
+	mBuilder.commit();
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+BSet<K, C, Cs ...>
+BSet<K, C, Cs ...>::BulkBuilder<N>::build()
+{
+	BSet set;
+	set.template adopt<N>(mBuilder);
+	return set;
+}
+
+}//namespace DS
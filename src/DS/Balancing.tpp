@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Policy.tpp"
+#include <cstdint>
+
+namespace DS {
+
+/**
+ * @brief	Base of the balancing policies of Set and Map.
+ */
+struct Balancing : Policy {};
+
+/**
+ * @brief	Default balancing policy, height balanced trees.
+ * @details	A remove may rotate every node on its path, O(log n) rotations in the worst case.
+ */
+struct AVL : Balancing {};
+
+/**
+ * @brief	Weak AVL balancing policy, rank balanced trees rotated at most twice by a put or a remove.
+ * @details	Each node keeps the rank differences to its children, 1 or 2, in the bits of the AVL balance factor.
+ * Puts rebalance as in AVL, so that a tree only grown by puts is an AVL tree, while removes demote ranks instead of
+ * rotating, in O(1) amortized time. Ranks take the place of the heights, at most 2 log n.
+ */
+struct WAVL : Balancing {};
+
+/**
+ * @brief	Weight balanced policy, trees balanced by the counts of their subtrees.
+ * @details	The weights (counts + 1) of the siblings are within a factor of Delta, rebalanced by single or double
+ * rotations chosen by Gamma. Puts and removes check each node on their path, joins each node on the spine they
+ * descend, regardless of the heights.
+ */
+struct WeightBalanced : Balancing {
+	static constexpr std::uint64_t Delta{3};
+	static constexpr std::uint64_t Gamma{2};
+};
+
+// Balancing policy of Cs
+template <typename ... Cs>
+using BalancingOf = PolicyOf<Balancing, AVL, Cs ...>;
+
+}//namespace DS
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "DS/CMap.hpp"
+
+namespace DS {
+
+template <typename K, typename V, typename C>
+bool
+CMap<K, V, C>::put(auto&& k, auto&& ... vArgs)
+{
+	if (!mList.insert(std::forward<decltype(k)>(k), std::forward<decltype(vArgs)>(vArgs) ...))
+		return false;
+	std::atomic_ref{mSize}.fetch_add(1, std::memory_order::relaxed);
+	return true;
+}
+
+template <typename K, typename V, typename C>
+IntrusivePtr<V>
+CMap<K, V, C>::get(auto const& ... args) const
+{
+	auto* n = mList.get(args ...);
+	return n ? IntrusivePtr<V>{static_cast<V*>(n->val), Offset(&Node::val)} : IntrusivePtr<V>{};
+}
+
+template <typename K, typename V, typename C>
+bool
+CMap<K, V, C>::remove(auto const& ... args)
+{
+	if (!mList.erase(args ...))
+		return false;
+	std::atomic_ref{mSize}.fetch_sub(1, std::memory_order::relaxed);
+	return true;
+}
+
+template <typename K, typename V, typename C>
+typename CMap<K, V, C>::Iterator
+CMap<K, V, C>::lowerBound(auto const& ... args) const
+{ return {&mList, mList.lowerBound(args ...)}; }
+
+template <typename K, typename V, typename C>
+typename CMap<K, V, C>::Iterator
+CMap<K, V, C>::begin() const noexcept
+{ return {&mList, mList.first()}; }
+
+template <typename K, typename V, typename C>
+typename CMap<K, V, C>::Iterator
+CMap<K, V, C>::end() const noexcept
+{ return {}; }
+
+template <typename K, typename V, typename C>
+typename CMap<K, V, C>::Iterator&
+CMap<K, V, C>::Iterator::operator++() noexcept
+{
+	List::Cursor::operator++();
+	return *this;
+}
+
+template <typename K, typename V, typename C>
+typename CMap<K, V, C>::Iterator::Entry
+CMap<K, V, C>::Iterator::operator*() const noexcept
+{ return {*this->mNode->key, *this->mNode->val}; }
+
+template <typename K, typename V, typename C>
+typename CMap<K, V, C>::Iterator::Pointer
+CMap<K, V, C>::Iterator::operator->() const noexcept
+{ return {**this}; }
+
+}//namespace DS
@@ -0,0 +1,470 @@
+#pragma once
+
+#include "Compare.tpp"
+#include "Epoch.tpp"
+#include "Holder.tpp"
+#include "DS/RefCounter.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+namespace DS {
+
+/**
+ * @brief	Node of a concurrent skip list, followed by its links on level many levels.
+ * @details	The list references the node until it is unlinked and released by the epoch, readers reference it to
+ * keep it after. The head sentinel has no key nor value. V is void for sets.
+ */
+template <typename K, typename V>
+struct CSNode : RefCounter {
+	struct NoValue {};
+
+	using Value = std::conditional_t<std::is_void_v<V>, NoValue, V>;
+	using Link = std::atomic<CSNode*>;
+
+	static constexpr std::uint8_t MaxLevel{24}; // a level is a quarter of the one below, enough for 4^24 nodes
+
+	CSNode* retired{nullptr}; // next one retired in the same epoch
+	std::uint8_t const level;
+	bool const head;
+	std::atomic<bool> marked{false}; // removed, being unlinked
+	std::atomic<bool> linked{false}; // linked on every level
+	std::atomic_flag locked;
+	Holder<K> key;
+	Holder<Value> val;
+
+	// Custom delete operator for the nodes created by Create, also used by RefCounter::onDestroy
+	static void
+	operator delete(void* ptr)
+	{ ::operator delete(ptr, std::align_val_t{alignof(CSNode)}); }
+
+	explicit CSNode(std::uint8_t level) noexcept
+			: RefCounter(1)
+			, level(level)
+			, head(true)
+	{}
+
+	CSNode(std::uint8_t level, auto&& key, auto&& ... vArgs)
+			: RefCounter(1)
+			, level(level)
+			, head(false)
+			, key(std::forward<decltype(key)>(key))
+			, val(std::forward<decltype(vArgs)>(vArgs) ...)
+	{
+		if constexpr (sizeof...(vArgs) == 0 && !std::is_void_v<V>)
+			::new(static_cast<void*>(val)) Value();
+	}
+
+	~CSNode() override
+	{
+		if (!head) {
+			key->~K();
+			val->~Value();
+		}
+	}
+
+	// Node with level links, args are passed to the constructor
+	static CSNode*
+	Create(std::uint8_t level, auto&& ... args)
+	{
+		void* ptr = ::operator new(sizeof(CSNode) + level * sizeof(Link), std::align_val_t{alignof(CSNode)});
+		CSNode* n;
+		try {
+			n = ::new(ptr) CSNode(level, std::forward<decltype(args)>(args) ...);
+		} catch (...) {
+			::operator delete(ptr, std::align_val_t{alignof(CSNode)});
+			throw;
+		}
+		for (std::uint8_t l = 0; l < level; ++l)
+			::new(n->next() + l) Link{nullptr};
+		return n;
+	}
+
+	// Level of a new node, 1 + l with probability 3/4^(l + 1)
+	static std::uint8_t
+	RandomLevel() noexcept
+	{
+		thread_local std::uint64_t state{std::hash<std::thread::id>{}(std::this_thread::get_id()) | 1};
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return 1 + std::min(std::countr_zero(state) / 2, MaxLevel - 1);
+	}
+
+	Link*
+	next() noexcept
+	{ return reinterpret_cast<Link*>(this + 1); }
+
+	void
+	lock() noexcept
+	{
+		for (unsigned spins{1}; locked.test_and_set(std::memory_order::acquire); ++spins) {
+			if (!(spins % 64)) // the holder may be preempted
+				std::this_thread::yield();
+		}
+	}
+
+	void
+	unlock() noexcept
+	{ locked.clear(std::memory_order::release); }
+};//struct DS::CSNode<K, V>
+
+/**
+ * @brief	Lazy skip list, the base of CMap and CSet.
+ * @details	Updates lock the predecessors of the node on each level and validate them before linking or unlinking
+ * it, get and the traversals take no lock. Removed nodes are marked before they are unlinked and released by an
+ * Epoch once no traversal may reach them.
+ */
+template <typename K, typename V, typename C>
+class CSList {
+public:
+	using Node = CSNode<K, V>;
+
+private:
+	using Guard = typename Epoch<Node>::Guard;
+
+	Node* const mHead;
+	Epoch<Node> mutable mEpoch;
+
+	// Unlock the distinct nodes of the first n preds
+	static void
+	Unlock(Node* const* preds, int n) noexcept
+	{
+		for (int l = 0; l < n; ++l) {
+			if (!l || preds[l] != preds[l - 1])
+				preds[l]->unlock();
+		}
+	}
+
+	// Level the node equal to args is found on first or -1, with its predecessor and successor on each level
+	int
+	find(Node** preds, Node** succs, auto const& ... args) const;
+
+	// First node not ordered before args, or after them if After, inside a guard
+	template <bool After>
+	Node*
+	search(auto const& ... args) const;
+
+	// Referenced first linked node from n on
+	static Node*
+	Acquire(Node* n) noexcept;
+
+public:
+	/**
+	 * @brief	Weakly consistent forward traversal, referencing the node it is on.
+	 * @details	Reflects the updates made after it is created or not, a node removed is skipped as soon as it is
+	 * marked. Stepping from a node removed meanwhile continues from the next one in the order.
+	 */
+	class Cursor {
+	protected:
+		CSList const* mList{nullptr};
+		Node* mNode{nullptr};
+
+	public:
+		Cursor() noexcept = default;
+
+		// Takes the reference of node
+		Cursor(CSList const* list, Node* node) noexcept
+				: mList(list)
+				, mNode(node)
+		{}
+
+		Cursor(Cursor const& other) noexcept
+				: mList(other.mList)
+				, mNode(other.mNode)
+		{
+			if (mNode)
+				mNode->addRef();
+		}
+
+		Cursor(Cursor&& other) noexcept
+				: mList(other.mList)
+				, mNode(std::exchange(other.mNode, nullptr))
+		{}
+
+		Cursor&
+		operator=(Cursor other) noexcept
+		{
+			std::swap(mList, other.mList);
+			std::swap(mNode, other.mNode);
+			return *this;
+		}
+
+		~Cursor()
+		{
+			if (mNode)
+				mNode->subRef();
+		}
+
+		Cursor&
+		operator++() noexcept
+		{
+			auto* n = mList->next(mNode);
+			mNode->subRef();
+			mNode = n;
+			return *this;
+		}
+
+		bool
+		operator==(Cursor const& other) const noexcept
+		{ return mNode == other.mNode; }
+
+		explicit operator bool() const noexcept
+		{ return mNode; }
+	};//class DS::CSList<K, V, C>::Cursor
+
+	CSList();
+
+	CSList(CSList const&) = delete;
+
+	CSList&
+	operator=(CSList const&) = delete;
+
+	~CSList();
+
+	/**
+	 * @brief	Link a node of K(k) and V(vArgs ...) if no node is equal to k.
+	 * @return	true, if it is linked
+	 */
+	bool
+	insert(auto&& k, auto&& ... vArgs);
+
+	/**
+	 * @brief	Unlink the node equal to args.
+	 * @return	true, if it is found and this call removed it
+	 */
+	bool
+	erase(auto const& ... args);
+
+	/**
+	 * @brief	Referenced node equal to args or null, wait-free.
+	 */
+	Node*
+	get(auto const& ... args) const;
+
+	/**
+	 * @brief	Referenced first node not ordered before args or null.
+	 */
+	Node*
+	lowerBound(auto const& ... args) const;
+
+	/**
+	 * @brief	Referenced first node or null.
+	 */
+	Node*
+	first() const noexcept;
+
+	/**
+	 * @brief	Referenced node following n, which the caller references, or null.
+	 */
+	Node*
+	next(Node* n) const noexcept;
+};//class DS::CSList<K, V, C>
+
+template <typename K, typename V, typename C>
+CSList<K, V, C>::CSList()
+		: mHead(Node::Create(Node::MaxLevel))
+{}
+
+template <typename K, typename V, typename C>
+CSList<K, V, C>::~CSList()
+{
+	for (auto* n = mHead; n;) {
+		auto* next = n->next()[0].load(std::memory_order::relaxed);
+		n->subRef();
+		n = next;
+	}
+}
+
+template <typename K, typename V, typename C>
+int
+CSList<K, V, C>::find(Node** preds, Node** succs, auto const& ... args) const
+{
+	int found{-1};
+	Node* pred{mHead};
+	for (int l = Node::MaxLevel - 1; l >= 0; --l) {
+		Node* curr{pred->next()[l].load(std::memory_order::acquire)};
+		auto order{std::weak_ordering::greater};
+		while (curr && (order = Compare(C{}, *curr->key, args ...)) < 0) {
+			pred = curr;
+			curr = pred->next()[l].load(std::memory_order::acquire);
+		}
+		if (found < 0 && curr && order == 0)
+			found = l;
+		preds[l] = pred;
+		succs[l] = curr;
+	}
+	return found;
+}
+
+template <typename K, typename V, typename C>
+template <bool After>
+typename CSList<K, V, C>::Node*
+CSList<K, V, C>::search(auto const& ... args) const
+{
+	Node* pred{mHead};
+	Node* curr{nullptr};
+	for (int l = Node::MaxLevel - 1; l >= 0; --l) {
+		curr = pred->next()[l].load(std::memory_order::acquire);
+		while (curr && (After ? !Precedes(C{}, args ..., *curr->key) : Precedes(C{}, *curr->key, args ...))) {
+			pred = curr;
+			curr = pred->next()[l].load(std::memory_order::acquire);
+		}
+	}
+	return curr;
+}
+
+template <typename K, typename V, typename C>
+typename CSList<K, V, C>::Node*
+CSList<K, V, C>::Acquire(Node* n) noexcept
+{
+	while (n && (n->marked.load(std::memory_order::acquire) || !n->linked.load(std::memory_order::acquire)))
+		n = n->next()[0].load(std::memory_order::acquire);
+	if (n)
+		n->addRef();
+	return n;
+}
+
+template <typename K, typename V, typename C>
+bool
+CSList<K, V, C>::insert(auto&& k, auto&& ... vArgs)
+{
+	Node* preds[Node::MaxLevel];
+	Node* succs[Node::MaxLevel];
+	Node* node{nullptr}; // created once k is not found, k is moved into it
+	Guard const guard(mEpoch);
+	while (true) {
+		int const found{node ? find(preds, succs, *node->key) : find(preds, succs, k)};
+		if (found >= 0) {
+			auto* f = succs[found];
+			if (!f->marked.load(std::memory_order::acquire)) {
+				while (!f->linked.load(std::memory_order::acquire))
+					std::this_thread::yield();
+				if (node)
+					node->subRef();
+				return false;
+			}
+			std::this_thread::yield(); // until it is unlinked
+			continue;
+		}
+		if (!node)
+			node = Node::Create(Node::RandomLevel(), std::forward<decltype(k)>(k), std::forward<decltype(vArgs)>(vArgs) ...);
+
+		int const top{node->level};
+		int l{0};
+		bool valid{true};
+		for (; valid && l < top; ++l) {
+			if (!l || preds[l] != preds[l - 1])
+				preds[l]->lock();
+			valid = !preds[l]->marked.load(std::memory_order::acquire)
+				&& (!succs[l] || !succs[l]->marked.load(std::memory_order::acquire))
+				&& preds[l]->next()[l].load(std::memory_order::acquire) == succs[l];
+		}
+		if (!valid) {
+			Unlock(preds, l);
+			continue;
+		}
+		for (l = 0; l < top; ++l)
+			node->next()[l].store(succs[l], std::memory_order::relaxed);
+		for (l = 0; l < top; ++l)
+			preds[l]->next()[l].store(node, std::memory_order::release);
+		node->linked.store(true, std::memory_order::release);
+		Unlock(preds, top);
+		return true;
+	}
+}
+
+template <typename K, typename V, typename C>
+bool
+CSList<K, V, C>::erase(auto const& ... args)
+{
+	Node* preds[Node::MaxLevel];
+	Node* succs[Node::MaxLevel];
+	Node* victim{nullptr}; // marked by this call
+	Guard const guard(mEpoch);
+	while (true) {
+		int const found{find(preds, succs, args ...)};
+		if (!victim) {
+			if (found < 0)
+				return false;
+			auto* v = succs[found];
+			// a node being linked is not added yet
+			if (!v->linked.load(std::memory_order::acquire) || v->level - 1 != found || v->marked.load(std::memory_order::acquire))
+				return false;
+			v->lock();
+			if (v->marked.load(std::memory_order::relaxed)) {
+				v->unlock();
+				return false;
+			}
+			v->marked.store(true, std::memory_order::release);
+			victim = v;
+		}
+
+		int const top{victim->level};
+		int l{0};
+		bool valid{true};
+		for (; valid && l < top; ++l) {
+			if (!l || preds[l] != preds[l - 1])
+				preds[l]->lock();
+			valid = !preds[l]->marked.load(std::memory_order::acquire)
+				&& preds[l]->next()[l].load(std::memory_order::acquire) == victim;
+		}
+		if (!valid) {
+			Unlock(preds, l);
+			continue;
+		}
+		for (l = top - 1; l >= 0; --l)
+			preds[l]->next()[l].store(victim->next()[l].load(std::memory_order::relaxed), std::memory_order::release);
+		victim->unlock();
+		Unlock(preds, top);
+		mEpoch.retire(victim);
+		return true;
+	}
+}
+
+template <typename K, typename V, typename C>
+typename CSList<K, V, C>::Node*
+CSList<K, V, C>::get(auto const& ... args) const
+{
+	Guard const guard(mEpoch);
+	auto* n = search<false>(args ...);
+	if (!n || Compare(C{}, *n->key, args ...) != 0
+			|| n->marked.load(std::memory_order::acquire) || !n->linked.load(std::memory_order::acquire))
+		return nullptr;
+	n->addRef();
+	return n;
+}
+
+template <typename K, typename V, typename C>
+typename CSList<K, V, C>::Node*
+CSList<K, V, C>::lowerBound(auto const& ... args) const
+{
+	Guard const guard(mEpoch);
+	return Acquire(search<false>(args ...));
+}
+
+template <typename K, typename V, typename C>
+typename CSList<K, V, C>::Node*
+CSList<K, V, C>::first() const noexcept
+{
+	Guard const guard(mEpoch);
+	return Acquire(mHead->next()[0].load(std::memory_order::acquire));
+}
+
+template <typename K, typename V, typename C>
+typename CSList<K, V, C>::Node*
+CSList<K, V, C>::next(Node* n) const noexcept
+{
+	Guard const guard(mEpoch);
+	// the successor is still in the list if n is, otherwise n may be unlinked and its successor released
+	auto* s = n->next()[0].load(std::memory_order::acquire);
+	if (n->marked.load(std::memory_order::seq_cst))
+		s = search<true>(*n->key);
+	return Acquire(s);
+}
+
+}//namespace DS
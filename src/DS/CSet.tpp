@@ -0,0 +1,65 @@
+#pragma once
+
+#include "DS/CSet.hpp"
+
+namespace DS {
+
+template <typename K, typename C>
+bool
+CSet<K, C>::put(auto&& k)
+{
+	if (!mList.insert(std::forward<decltype(k)>(k)))
+		return false;
+	std::atomic_ref{mSize}.fetch_add(1, std::memory_order::relaxed);
+	return true;
+}
+
+template <typename K, typename C>
+typename CSet<K, C>::Iterator
+CSet<K, C>::get(auto const& ... args) const
+{ return {&mList, mList.get(args ...)}; }
+
+template <typename K, typename C>
+bool
+CSet<K, C>::remove(auto const& ... args)
+{
+	if (!mList.erase(args ...))
+		return false;
+	std::atomic_ref{mSize}.fetch_sub(1, std::memory_order::relaxed);
+	return true;
+}
+
+template <typename K, typename C>
+typename CSet<K, C>::Iterator
+CSet<K, C>::lowerBound(auto const& ... args) const
+{ return {&mList, mList.lowerBound(args ...)}; }
+
+template <typename K, typename C>
+typename CSet<K, C>::Iterator
+CSet<K, C>::begin() const noexcept
+{ return {&mList, mList.first()}; }
+
+template <typename K, typename C>
+typename CSet<K, C>::Iterator
+CSet<K, C>::end() const noexcept
+{ return {}; }
+
+template <typename K, typename C>
+typename CSet<K, C>::Iterator&
+CSet<K, C>::Iterator::operator++() noexcept
+{
+	List::Cursor::operator++();
+	return *this;
+}
+
+template <typename K, typename C>
+K const&
+CSet<K, C>::Iterator::operator*() const noexcept
+{ return *this->mNode->key; }
+
+template <typename K, typename C>
+K const*
+CSet<K, C>::Iterator::operator->() const noexcept
+{ return &*this->mNode->key; }
+
+}//namespace DS
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "Policy.tpp"
+#include <bit>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace DS {
+
+/**
+ * @brief	Node allocation policy linking the nodes of Set and Map by 32 bit handles instead of pointers.
+ * @details	Each index of a node keeps its links and its count in three 32 bit words instead of three 64 bit ones.
+ * A handle is the index of the slab a node is in and its offset in Units, 28 bits in all, next to the 4 bits
+ * of node state, so that the containers using the same Compact hold up to 2^28 Units of nodes. Blocks are
+ * served from slabs as in SlabPool, rounded up to Unit, which must not be less than the alignment of the nodes,
+ * and the ones larger than MaxBlock are pooled by powers of 2 up to half a slab.
+ * Slabs are reused, but never returned to the system, except the ones of the blocks larger than that.
+ * @tparam	SlabSize Size and alignment of a slab, a power of 2
+ * @tparam	Unit Granularity of the offsets
+ * @tparam	MaxBlock Largest block size kept per thread
+ * @tparam	Tag Type telling the slabs of different containers apart
+ */
+template <std::size_t SlabSize = 1 << 20, std::size_t Unit = 8, std::size_t MaxBlock = 512, typename Tag = void>
+class Compact : public Allocator {
+	static constexpr int OffsetBits{std::countr_zero(SlabSize / Unit)};
+	static constexpr std::size_t MaxSlabs{std::size_t{1} << (28 - OffsetBits)};
+	static constexpr std::size_t Small{MaxBlock / Unit};
+	static constexpr int FirstLarge{std::bit_width(MaxBlock)};
+	static constexpr std::size_t Large{std::countr_zero(SlabSize) - FirstLarge};
+
+	static_assert(std::has_single_bit(SlabSize) && std::has_single_bit(Unit) && Unit >= sizeof(void*));
+	static_assert(MaxBlock % Unit == 0 && MaxBlock + Unit <= SlabSize && OffsetBits < 28);
+
+	struct Slab {
+		std::uint32_t index;
+		std::uint32_t blockSize; // 0 if the slab holds a single large block
+	};
+
+	static constexpr std::size_t Header{(sizeof(Slab) + Unit - 1) & ~(Unit - 1)};
+
+	struct Class {
+		void* free{nullptr};
+		std::byte* next{nullptr};
+		std::byte* end{nullptr};
+
+		// Released block, or the next one of the last slab, nullptr if neither is left
+		void*
+		take(std::size_t size) noexcept
+		{
+			if (free)
+				return std::exchange(free, *static_cast<void**>(free));
+			if (next != end)
+				return std::exchange(next, next + size);
+			return nullptr;
+		}
+
+		void
+		give(void* ptr) noexcept
+		{
+			*static_cast<void**>(ptr) = free;
+			free = ptr;
+		}
+	};
+
+	struct Cache {
+		Class classes[Small];
+
+		~Cache()
+		{
+			Exited = true;
+			std::scoped_lock lock(Shared);
+			for (std::size_t i = 0; i < Small; ++i) {
+				auto& c = classes[i];
+				if (Pool[i].next == Pool[i].end)
+					std::swap(c.next, Pool[i].next), std::swap(c.end, Pool[i].end);
+				for (; c.next != c.end; c.next += (i + 1) * Unit)
+					Pool[i].give(c.next);
+				while (c.free)
+					Pool[i].give(std::exchange(c.free, *static_cast<void**>(c.free)));
+			}
+		}
+	};
+
+	static inline thread_local Cache Local;
+	static inline thread_local bool Exited{false}; // Local is destroyed, the blocks go through Pool
+	static inline std::mutex Shared;
+	static inline Class Pool[Small + Large];
+	static inline std::byte* Slabs[MaxSlabs]{}; // the first one is null, so that the handle 0 decodes to null
+	static inline std::uint32_t SlabCount{1};
+	static inline std::vector<std::uint32_t> Released; // indices of the slabs of the large blocks released
+
+	// New slab of size bytes, Shared must be locked
+	static Slab*
+	NewSlab(std::size_t size, std::size_t blockSize)
+	{
+		if (Released.empty() && SlabCount == MaxSlabs)
+			throw std::bad_alloc();
+		auto* slab = static_cast<Slab*>(::operator new(size, std::align_val_t{SlabSize}));
+		if (Released.empty())
+			slab->index = SlabCount++;
+		else {
+			slab->index = Released.back();
+			Released.pop_back();
+		}
+		slab->blockSize = blockSize;
+		Slabs[slab->index] = reinterpret_cast<std::byte*>(slab);
+		return slab;
+	}
+
+	// Class of the blocks of size bytes, rounded up to Unit
+	static std::size_t
+	ClassOf(std::size_t size) noexcept
+	{ return size <= MaxBlock ? size / Unit - 1 : Small + std::bit_width(size - 1) - FirstLarge; }
+
+	// Carve the blocks of size bytes of c from the rest of the slab of pool or from a new slab, c is empty and
+	// Shared must be locked
+	static void
+	Refill(Class& c, Class& pool, std::size_t size)
+	{
+		if (pool.next != pool.end) {
+			c.next = std::exchange(pool.next, nullptr);
+			c.end = std::exchange(pool.end, nullptr);
+			return;
+		}
+		c.next = reinterpret_cast<std::byte*>(NewSlab(SlabSize, size)) + Header;
+		c.end = c.next + (SlabSize - Header) / size * size;
+	}
+
+public:
+	using Word = std::uint32_t;
+	using Count = std::uint32_t;
+
+	static void*
+	allocate(std::size_t size)
+	{
+		size = (size + Unit - 1) & ~(Unit - 1);
+		if (size <= MaxBlock && !Exited) {
+			auto& c = Local.classes[size / Unit - 1];
+			if (auto* ptr = c.take(size))
+				return ptr;
+			std::scoped_lock lock(Shared);
+			c.free = std::exchange(Pool[size / Unit - 1].free, nullptr);
+			if (!c.free)
+				Refill(c, Pool[size / Unit - 1], size);
+			return c.take(size);
+		}
+		std::scoped_lock lock(Shared);
+		if (size > SlabSize / 2) {
+			Released.reserve(SlabCount); // so that deallocate does not throw
+			return reinterpret_cast<std::byte*>(NewSlab(Header + size, 0)) + Header;
+		}
+		if (size > MaxBlock)
+			size = std::bit_ceil(size);
+		auto& c = Pool[ClassOf(size)];
+		if (auto* ptr = c.take(size))
+			return ptr;
+		Refill(c, c, size);
+		return c.take(size);
+	}
+
+	static void
+	deallocate(void* ptr) noexcept
+	{
+		auto* slab = reinterpret_cast<Slab*>(reinterpret_cast<std::uintptr_t>(ptr) & ~(SlabSize - 1));
+		if (!slab->blockSize) {
+			std::scoped_lock lock(Shared);
+			Slabs[slab->index] = nullptr;
+			Released.push_back(slab->index);
+			::operator delete(slab, std::align_val_t{SlabSize});
+		} else if (slab->blockSize <= MaxBlock && !Exited)
+			Local.classes[slab->blockSize / Unit - 1].give(ptr);
+		else {
+			std::scoped_lock lock(Shared);
+			Pool[ClassOf(slab->blockSize)].give(ptr);
+		}
+	}
+
+	/**
+	 * @brief	Handle of the block ptr, shifted over the 4 bits of node state.
+	 */
+	static Word
+	Encode(void const* ptr) noexcept
+	{
+		if (!ptr)
+			return 0;
+		auto const p = reinterpret_cast<std::uintptr_t>(ptr);
+		auto const* slab = reinterpret_cast<Slab const*>(p & ~(SlabSize - 1));
+		return (slab->index << OffsetBits | static_cast<Word>((p & (SlabSize - 1)) / Unit)) << 4;
+	}
+
+	/**
+	 * @brief	Block of the handle word, its lowest 4 bits are ignored.
+	 */
+	static void*
+	Decode(Word word) noexcept
+	{
+		word >>= 4;
+		return Slabs[word >> OffsetBits] + (word & (SlabSize / Unit - 1)) * Unit;
+	}
+};//class DS::Compact<SlabSize, Unit, MaxBlock, Tag>
+
+}//namespace DS
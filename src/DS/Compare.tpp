@@ -0,0 +1,63 @@
+#pragma once
+
+#include <compare>
+#include <functional>
+
+namespace DS {
+
+/**
+ * @brief	Comparator returning std::weak_ordering or a stronger ordering for args.
+ */
+template <typename Cmp, typename ... Args>
+concept ThreeWayComparator = requires(Cmp const& cmp, Args const& ... args) {
+	{ cmp(args ...) } -> std::convertible_to<std::weak_ordering>;
+};
+
+/**
+ * @brief	std::less or std::greater of K and an operand weakly ordered with it by operator<=>.
+ */
+template <typename Cmp, typename K, typename ... Args>
+concept StandardOrder = sizeof...(Args) == 1 &&
+	(std::is_same_v<Cmp, std::less<>> || std::is_same_v<Cmp, std::less<K>> ||
+	std::is_same_v<Cmp, std::greater<>> || std::is_same_v<Cmp, std::greater<K>>) &&
+	(std::three_way_comparable_with<K, Args, std::weak_ordering> && ...);
+
+/**
+ * @brief	Whether cmp orders its first argument before the others, for both kinds of comparators.
+ */
+template <typename Cmp>
+bool
+Precedes(Cmp const& cmp, auto const& ... args)
+{
+	if constexpr (ThreeWayComparator<Cmp, std::remove_cvref_t<decltype(args)> ...>)
+		return cmp(args ...) < 0;
+	else
+		return cmp(args ...);
+}
+
+/**
+ * @brief	Order of key against args by cmp.
+ * @details	Takes a single comparison if cmp is a ThreeWayComparator, or std::less / std::greater of operands
+ * weakly ordered by operator<=> that are then compared by std::compare_three_way, two comparisons otherwise.
+ */
+template <typename Cmp, typename K>
+std::weak_ordering
+Compare(Cmp const& cmp, K const& key, auto const& ... args)
+{
+	if constexpr (ThreeWayComparator<Cmp, K, std::remove_cvref_t<decltype(args)> ...>)
+		return cmp(key, args ...);
+	else if constexpr (StandardOrder<Cmp, K, std::remove_cvref_t<decltype(args)> ...>) {
+		if constexpr (std::is_same_v<Cmp, std::less<>> || std::is_same_v<Cmp, std::less<K>>)
+			return std::compare_three_way{}(key, args ...);
+		else
+			return std::compare_three_way{}(args ..., key);
+	} else {
+		if (cmp(key, args ...))
+			return std::weak_ordering::less;
+		if (cmp(args ..., key))
+			return std::weak_ordering::greater;
+		return std::weak_ordering::equivalent;
+	}
+}
+
+}//namespace DS
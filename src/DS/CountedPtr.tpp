@@ -6,7 +6,9 @@ namespace DS {
 
 template <typename T>
 CountedPtr<T>::CountedPtr(T* ptr) noexcept
-{ reinterpret_cast<T*&>(*this) = ptr; }
+		: ptr{reinterpret_cast<std::uintptr_t>(ptr)}
+		, cnt{reinterpret_cast<std::uintptr_t>(ptr) >> 48}
+{}
 
 template <typename T>
 T&
@@ -35,9 +37,14 @@ CountedPtr<T>::operator==(CountedPtr const& other) const noexcept
 
 namespace std {
 
+template <typename T>
+std::uintptr_t
+atomic<DS::CountedPtr<T>>::Raw(DS::CountedPtr<T> p) noexcept
+{ return p.ptr | std::uintptr_t{p.cnt} << 48; }
+
 template <typename T>
 constexpr atomic<DS::CountedPtr<T>>::atomic(DS::CountedPtr<T> desired) noexcept
-		: val{desired}
+		: val{Raw(desired)}
 {}
 
 template <typename T>
@@ -56,12 +63,12 @@ atomic<DS::CountedPtr<T>>::is_lock_free() const noexcept
 template <typename T>
 void
 atomic<DS::CountedPtr<T>>::store(DS::CountedPtr<T> desired, std::memory_order order) noexcept
-{ std::atomic_ref{val}.store(desired, order); }
+{ std::atomic_ref{val}.store(Raw(desired), order); }
 
 template <typename T>
 DS::CountedPtr<T>
 atomic<DS::CountedPtr<T>>::load(std::memory_order order) const noexcept
-{ return std::atomic_ref{val}.load(order); }
+{ return reinterpret_cast<T*>(std::atomic_ref{val}.load(order)); }
 
 template <typename T>
 atomic<DS::CountedPtr<T>>::operator DS::CountedPtr<T>() const noexcept
@@ -70,36 +77,56 @@ atomic<DS::CountedPtr<T>>::operator DS::CountedPtr<T>() const noexcept
 template <typename T>
 DS::CountedPtr<T>
 atomic<DS::CountedPtr<T>>::exchange(DS::CountedPtr<T> desired, std::memory_order order) noexcept
-{ return std::atomic_ref{val}.exchange(desired, order); }
+{ return reinterpret_cast<T*>(std::atomic_ref{val}.exchange(Raw(desired), order)); }
 
 template <typename T>
 bool
 atomic<DS::CountedPtr<T>>::compare_exchange_weak(DS::CountedPtr<T>& expected, DS::CountedPtr<T> desired,
 	std::memory_order success, std::memory_order failure) noexcept
-{ return std::atomic_ref{val}.compare_exchange_weak(expected, desired, success, failure); }
+{
+	auto raw = Raw(expected);
+	bool const exchanged = std::atomic_ref{val}.compare_exchange_weak(raw, Raw(desired), success, failure);
+	expected = reinterpret_cast<T*>(raw);
+	return exchanged;
+}
 
 template <typename T>
 bool
 atomic<DS::CountedPtr<T>>::compare_exchange_weak(DS::CountedPtr<T>& expected, DS::CountedPtr<T> desired,
 	std::memory_order order) noexcept
-{ return std::atomic_ref{val}.compare_exchange_weak(expected, desired, order); }
+{
+	auto raw = Raw(expected);
+	bool const exchanged = std::atomic_ref{val}.compare_exchange_weak(raw, Raw(desired), order);
+	expected = reinterpret_cast<T*>(raw);
+	return exchanged;
+}
 
 template <typename T>
 bool
 atomic<DS::CountedPtr<T>>::compare_exchange_strong(DS::CountedPtr<T>& expected, DS::CountedPtr<T> desired,
 	std::memory_order success, std::memory_order failure) noexcept
-{ return std::atomic_ref{val}.compare_exchange_strong(expected, desired, success, failure); }
+{
+	auto raw = Raw(expected);
+	bool const exchanged = std::atomic_ref{val}.compare_exchange_strong(raw, Raw(desired), success, failure);
+	expected = reinterpret_cast<T*>(raw);
+	return exchanged;
+}
 
 template <typename T>
 bool
 atomic<DS::CountedPtr<T>>::compare_exchange_strong(DS::CountedPtr<T>& expected, DS::CountedPtr<T> desired,
 	std::memory_order order) noexcept
-{ return std::atomic_ref{val}.compare_exchange_strong(expected, desired, order); }
+{
+	auto raw = Raw(expected);
+	bool const exchanged = std::atomic_ref{val}.compare_exchange_strong(raw, Raw(desired), order);
+	expected = reinterpret_cast<T*>(raw);
+	return exchanged;
+}
 
 template <typename T>
 void
 atomic<DS::CountedPtr<T>>::wait(DS::CountedPtr<T> old, std::memory_order order) const noexcept
-{ std::atomic_ref{val}.wait(old, order); }
+{ std::atomic_ref{val}.wait(Raw(old), order); }
 
 template <typename T>
 void
@@ -114,21 +141,21 @@ atomic<DS::CountedPtr<T>>::notify_all() const noexcept
 template <typename T>
 void
 atomic<DS::CountedPtr<T>>::storeExclusively(DS::CountedPtr<T> desired) noexcept
-{ val = desired; }
+{ val = Raw(desired); }
 
 template <typename T>
 DS::CountedPtr<T>
 atomic<DS::CountedPtr<T>>::loadExclusively() const noexcept
-{ return val; }
+{ return reinterpret_cast<T*>(val); }
 
 template <typename T>
 DS::CountedPtr<T>
 atomic<DS::CountedPtr<T>>::fetchAddCount(std::size_t count, std::memory_order order) noexcept
-{ return reinterpret_cast<T*>(std::atomic_ref{reinterpret_cast<std::uintptr_t&>(val)}.fetch_add(count << 48, order)); }
+{ return reinterpret_cast<T*>(std::atomic_ref{val}.fetch_add(count << 48, order)); }
 
 template <typename T>
 DS::CountedPtr<T>
 atomic<DS::CountedPtr<T>>::fetchSubCount(std::size_t count, std::memory_order order) noexcept
-{ return reinterpret_cast<T*>(std::atomic_ref{reinterpret_cast<std::uintptr_t&>(val)}.fetch_sub(count << 48, order)); }
+{ return reinterpret_cast<T*>(std::atomic_ref{val}.fetch_sub(count << 48, order)); }
 
 }//namespace std
\ No newline at end of file
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace DS {
+
+/**
+ * @brief	Epoch based reclamation of the nodes unlinked from a concurrent container.
+ * @tparam	N Node type with an N* retired link and subRef()
+ * @details	Threads read the nodes inside a Guard without referencing them. A node retired while the epoch is e is
+ * released once the epoch reaches e + 2, which it only does after the guards entered in e and before are left.
+ * Guards are counted per epoch parity in cache line sized stripes picked by the thread id.
+ */
+template <typename N>
+class Epoch {
+	static constexpr std::size_t Stripes{64};
+	static constexpr std::uint32_t Period{64}; // retires of a stripe between two attempts to advance
+
+	struct alignas(64 /* std::hardware_destructive_interference_size */) Stripe {
+		std::atomic<std::uint64_t> active[2]{}; // guards entered in an even and an odd epoch
+		std::atomic<std::uint32_t> retires{0};
+	};
+
+	alignas(64 /* std::hardware_destructive_interference_size */) std::atomic<std::uint64_t> mEpoch{0};
+	std::atomic<N*> mRetired[3]{}; // by the epoch they are retired in, modulo 3
+	std::mutex mAdvance;
+	Stripe mStripes[Stripes];
+
+	// Stripe of the calling thread
+	Stripe&
+	stripe() noexcept
+	{
+		thread_local std::size_t const index{std::hash<std::thread::id>{}(std::this_thread::get_id()) % Stripes};
+		return mStripes[index];
+	}
+
+	static void
+	Release(N* n) noexcept
+	{
+		while (n) {
+			auto* next = n->retired;
+			n->subRef();
+			n = next;
+		}
+	}
+
+	// Advance the epoch if no guard is left in the previous one, releasing the nodes retired before it
+	void
+	tryAdvance() noexcept
+	{
+		std::unique_lock lock(mAdvance, std::try_to_lock);
+		if (!lock)
+			return;
+		auto const e = mEpoch.load(std::memory_order::relaxed);
+		for (auto const& s : mStripes) {
+			if (s.active[(e + 1) & 1].load(std::memory_order::seq_cst))
+				return;
+		}
+		mEpoch.store(e + 1, std::memory_order::seq_cst);
+		auto* released = mRetired[(e + 2) % 3].exchange(nullptr, std::memory_order::acquire);
+		lock.unlock();
+		Release(released);
+	}
+
+public:
+	/**
+	 * @brief	Scope in which the nodes reached are not released.
+	 */
+	class Guard {
+		Stripe& mStripe;
+		std::uint64_t mParity;
+
+	public:
+		explicit Guard(Epoch& epoch) noexcept
+				: mStripe(epoch.stripe())
+		{
+			for (auto e = epoch.mEpoch.load(std::memory_order::seq_cst);;) {
+				mParity = e & 1;
+				mStripe.active[mParity].fetch_add(1, std::memory_order::seq_cst);
+				auto const current = epoch.mEpoch.load(std::memory_order::seq_cst);
+				if (current == e)
+					break;
+				mStripe.active[mParity].fetch_sub(1, std::memory_order::release);
+				e = current;
+			}
+		}
+
+		Guard(Guard const&) = delete;
+
+		Guard&
+		operator=(Guard const&) = delete;
+
+		~Guard()
+		{ mStripe.active[mParity].fetch_sub(1, std::memory_order::release); }
+	};//class DS::Epoch<N>::Guard
+
+	Epoch() noexcept = default;
+
+	Epoch(Epoch const&) = delete;
+
+	Epoch&
+	operator=(Epoch const&) = delete;
+
+	/**
+	 * @brief	Release every node retired, no guard may be left.
+	 */
+	~Epoch()
+	{
+		for (auto& r : mRetired)
+			Release(r.load(std::memory_order::acquire));
+	}
+
+	/**
+	 * @brief	Release n once no guard may reach it, it must be unlinked inside a guard.
+	 */
+	void
+	retire(N* n) noexcept
+	{
+		auto& retired = mRetired[mEpoch.load(std::memory_order::seq_cst) % 3];
+		n->retired = retired.load(std::memory_order::relaxed);
+		while (!retired.compare_exchange_weak(n->retired, n, std::memory_order::release, std::memory_order::relaxed));
+		if ((stripe().retires.fetch_add(1, std::memory_order::relaxed) + 1) % Period == 0)
+			tryAdvance();
+	}
+};//class DS::Epoch<N>
+
+}//namespace DS
@@ -0,0 +1,309 @@
+#pragma once
+
+#include "Compare.tpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace DS {
+
+/**
+ * @brief	Static search index over the keys of a frozen container in the order of Cmp.
+ * @class	Eytzinger Eytzinger.tpp "DS/Eytzinger.tpp"
+ * @details	The search tree is implicit and laid out in BFS order, node k has its children at 2k and 2k + 1,
+ * so a lookup descends it while prefetching the descendants a cache line below.
+ * Arithmetic keys ordered by std::less or std::greater are searched without branches by blocks of a cache line:
+ * the tree holds the first key of every block and the block is counted with SSE2 or AVX2 if enabled.
+ * Otherwise the primary index keeps the keys of the container in its BFS order and the other indices
+ * refer to them by their 32-bit positions, the descent branches on the comparator there since speculating
+ * past it overlaps the loads of the keys.
+ */
+template <typename K, typename Cmp, bool Primary>
+class Eytzinger {
+public:
+	/**
+	 * @brief	1 if Cmp is std::less, -1 if std::greater, 0 otherwise.
+	 */
+	static constexpr int Sign =
+		std::is_same_v<Cmp, std::less<>> || std::is_same_v<Cmp, std::less<K>> ? 1 :
+		std::is_same_v<Cmp, std::greater<>> || std::is_same_v<Cmp, std::greater<K>> ? -1 : 0;
+
+	static constexpr bool Blocked = std::is_arithmetic_v<K> && Sign != 0;
+
+	/**
+	 * @brief	Number of keys in a block, blocks of the primary index are the keys of the container.
+	 */
+	static constexpr std::uint64_t Width = Blocked ? std::max<std::uint64_t>(64 / sizeof(K), 1) : 1;
+
+private:
+	struct Slot {
+		std::uint32_t pos;
+		std::uint32_t rank;
+	};//struct DS::Eytzinger<K, Cmp, Primary>::Slot
+
+	// Position in keys of the key of each rank, unless this is a blocked primary index
+	std::vector<std::uint32_t> mOrder;
+
+	// Rank of the key at each position, if this is the primary index and not blocked
+	std::vector<std::uint32_t> mRank;
+
+	// Positions in keys in the BFS order of Cmp, if this is a secondary index and not blocked
+	std::vector<Slot> mTree;
+
+	// Keys of a blocked secondary index in its order, padded to whole blocks
+	std::vector<K> mKeys;
+
+	// First keys of the blocks in BFS order and the block they start
+	std::vector<K> mFirst;
+	std::vector<std::uint32_t> mBlock;
+
+	static K
+	Padding() noexcept
+	{
+		if constexpr (std::numeric_limits<K>::has_infinity)
+			return Sign > 0 ? std::numeric_limits<K>::infinity() : -std::numeric_limits<K>::infinity();
+		else
+			return Sign > 0 ? std::numeric_limits<K>::max() : std::numeric_limits<K>::lowest();
+	}
+
+	// Visit the nodes of the implicit tree of n nodes rooted at k in order
+	static void
+	Fill(std::uint64_t k, std::uint64_t n, auto const& visit)
+	{
+		if (k <= n) {
+			Fill(2 * k, n, visit);
+			visit(k);
+			Fill(2 * k + 1, n, visit);
+		}
+	}
+
+	// Number of the keys in block ordered before x
+	static std::uint64_t
+	Before(K const* block, K const& x) noexcept
+	{
+#if defined(__AVX2__)
+		if constexpr (std::is_integral_v<K> && std::is_signed_v<K> && sizeof(K) == 4) {
+			auto v = _mm256_set1_epi32(x);
+			auto a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block));
+			auto b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block) + 1);
+			a = Sign > 0 ? _mm256_cmpgt_epi32(v, a) : _mm256_cmpgt_epi32(a, v);
+			b = Sign > 0 ? _mm256_cmpgt_epi32(v, b) : _mm256_cmpgt_epi32(b, v);
+			return std::popcount(static_cast<unsigned>(
+				_mm256_movemask_ps(_mm256_castsi256_ps(a)) | _mm256_movemask_ps(_mm256_castsi256_ps(b)) << 8));
+		} else if constexpr (std::is_integral_v<K> && std::is_signed_v<K> && sizeof(K) == 8) {
+			auto v = _mm256_set1_epi64x(x);
+			auto a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block));
+			auto b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(block) + 1);
+			a = Sign > 0 ? _mm256_cmpgt_epi64(v, a) : _mm256_cmpgt_epi64(a, v);
+			b = Sign > 0 ? _mm256_cmpgt_epi64(v, b) : _mm256_cmpgt_epi64(b, v);
+			return std::popcount(static_cast<unsigned>(
+				_mm256_movemask_pd(_mm256_castsi256_pd(a)) | _mm256_movemask_pd(_mm256_castsi256_pd(b)) << 4));
+		} else if constexpr (std::is_same_v<K, float>) {
+			auto v = _mm256_set1_ps(x);
+			auto a = _mm256_loadu_ps(block);
+			auto b = _mm256_loadu_ps(block + 8);
+			if constexpr (Sign > 0) {
+				a = _mm256_cmp_ps(a, v, _CMP_LT_OQ);
+				b = _mm256_cmp_ps(b, v, _CMP_LT_OQ);
+			} else {
+				a = _mm256_cmp_ps(a, v, _CMP_GT_OQ);
+				b = _mm256_cmp_ps(b, v, _CMP_GT_OQ);
+			}
+			return std::popcount(static_cast<unsigned>(_mm256_movemask_ps(a) | _mm256_movemask_ps(b) << 8));
+		} else if constexpr (std::is_same_v<K, double>) {
+			auto v = _mm256_set1_pd(x);
+			auto a = _mm256_loadu_pd(block);
+			auto b = _mm256_loadu_pd(block + 4);
+			if constexpr (Sign > 0) {
+				a = _mm256_cmp_pd(a, v, _CMP_LT_OQ);
+				b = _mm256_cmp_pd(b, v, _CMP_LT_OQ);
+			} else {
+				a = _mm256_cmp_pd(a, v, _CMP_GT_OQ);
+				b = _mm256_cmp_pd(b, v, _CMP_GT_OQ);
+			}
+			return std::popcount(static_cast<unsigned>(_mm256_movemask_pd(a) | _mm256_movemask_pd(b) << 4));
+		}
+#elif defined(__SSE2__)
+		if constexpr (std::is_integral_v<K> && std::is_signed_v<K> && sizeof(K) == 4) {
+			auto v = _mm_set1_epi32(x);
+			unsigned mask{0};
+			for (int i = 0; i < 4; ++i) {
+				auto a = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block) + i);
+				a = Sign > 0 ? _mm_cmpgt_epi32(v, a) : _mm_cmpgt_epi32(a, v);
+				mask |= static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(a))) << 4 * i;
+			}
+			return std::popcount(mask);
+		} else if constexpr (std::is_same_v<K, float>) {
+			auto v = _mm_set1_ps(x);
+			unsigned mask{0};
+			for (int i = 0; i < 4; ++i) {
+				auto a = _mm_loadu_ps(block + 4 * i);
+				a = Sign > 0 ? _mm_cmplt_ps(a, v) : _mm_cmpgt_ps(a, v);
+				mask |= static_cast<unsigned>(_mm_movemask_ps(a)) << 4 * i;
+			}
+			return std::popcount(mask);
+		} else if constexpr (std::is_same_v<K, double>) {
+			auto v = _mm_set1_pd(x);
+			unsigned mask{0};
+			for (int i = 0; i < 4; ++i) {
+				auto a = _mm_loadu_pd(block + 2 * i);
+				a = Sign > 0 ? _mm_cmplt_pd(a, v) : _mm_cmpgt_pd(a, v);
+				mask |= static_cast<unsigned>(_mm_movemask_pd(a)) << 2 * i;
+			}
+			return std::popcount(mask);
+		}
+#endif
+		std::uint64_t count{0};
+		for (std::uint64_t i = 0; i < Width; ++i)
+			count += Cmp{}(block[i], x);
+		return count;
+	}
+
+public:
+	/**
+	 * @brief	Build the index of n keys.
+	 * @param	keys Keys in the primary order, a primary index pads them to whole blocks if blocked
+	 * or else rearranges them in its BFS order
+	 * @param	order Position in keys of the key of each rank in the order of Cmp, ignored by the primary index
+	 */
+	void
+	build(std::vector<K>& keys, std::uint64_t n, std::vector<std::uint32_t>&& order)
+	{
+		if constexpr (Blocked) {
+			auto blocks = (n + Width - 1) / Width;
+			auto* sorted = &keys;
+			if constexpr (!Primary) {
+				mOrder = std::move(order);
+				mKeys.reserve(blocks * Width);
+				for (auto pos : mOrder)
+					mKeys.push_back(keys[pos]);
+				sorted = &mKeys;
+			}
+			sorted->resize(blocks * Width, Padding());
+			mFirst.resize(blocks + 1);
+			mBlock.resize(blocks + 1);
+			std::uint32_t i{0};
+			Fill(1, blocks, [&](std::uint64_t k) {
+				mFirst[k] = (*sorted)[i * Width];
+				mBlock[k] = i++;
+			});
+		} else if constexpr (Primary) {
+			mOrder.resize(n);
+			mRank.resize(n);
+			std::uint32_t i{0};
+			Fill(1, n, [&](std::uint64_t k) {
+				mOrder[i] = k - 1;
+				mRank[k - 1] = i++;
+			});
+			std::vector<K> arranged;
+			arranged.reserve(n);
+			for (auto r : mRank)
+				arranged.push_back(std::move(keys[r]));
+			keys = std::move(arranged);
+		} else {
+			mOrder = std::move(order);
+			mTree.resize(n + 1);
+			std::uint32_t i{0};
+			Fill(1, n, [&](std::uint64_t k) {
+				mTree[k] = {mOrder[i], i};
+				++i;
+			});
+		}
+	}
+
+	/**
+	 * @brief	Position in keys of the key of rank r.
+	 */
+	[[nodiscard]] std::uint64_t
+	position(std::uint64_t r) const noexcept
+	{
+		if constexpr (Primary && Blocked)
+			return r;
+		else
+			return mOrder[r];
+	}
+
+	/**
+	 * @brief	Key of rank r.
+	 */
+	K const&
+	key(K const* keys, std::uint64_t r) const noexcept
+	{
+		if constexpr (Blocked && !Primary)
+			return mKeys[r];
+		else
+			return keys[position(r)];
+	}
+
+	/**
+	 * @brief	Number of keys ordered before args.
+	 */
+	std::uint64_t
+	rank(K const* keys, auto const& ... args) const noexcept
+	{
+		Cmp cmp;
+		std::uint64_t k{1};
+		if constexpr (Blocked) {
+			constexpr std::uint64_t Line = 64 / sizeof(K);
+			std::uint64_t blocks = mFirst.size() - 1;
+			while (k <= blocks) {
+				__builtin_prefetch(mFirst.data() + std::min(k * Line, blocks));
+				k = 2 * k + Precedes(cmp, mFirst[k], args ...);
+			}
+			k >>= std::countr_one(k) + 1;
+			std::uint64_t p = k ? mBlock[k] : blocks;
+			if (!p)
+				return 0;
+			auto const* block = (Primary ? keys : mKeys.data()) + (p - 1) * Width;
+			if constexpr (sizeof...(args) == 1 && (std::is_same_v<std::remove_cvref_t<decltype(args)>, K> && ...))
+				return (p - 1) * Width + Before(block, args ...);
+			std::uint64_t count{0};
+			for (std::uint64_t i = 0; i < Width; ++i)
+				count += Precedes(cmp, block[i], args ...);
+			return (p - 1) * Width + count;
+		} else if constexpr (Primary) {
+			constexpr std::uint64_t Line = std::max<std::uint64_t>(64 / sizeof(K), 2);
+			std::uint64_t n = mRank.size();
+			while (k <= n) {
+				__builtin_prefetch(keys + std::min(k * Line, n) - 1);
+				if (Precedes(cmp, keys[k - 1], args ...))
+					k = 2 * k + 1;
+				else
+					k = 2 * k;
+			}
+			k >>= std::countr_one(k) + 1;
+			return k ? mRank[k - 1] : n;
+		} else {
+			constexpr std::uint64_t Line = 64 / sizeof(Slot);
+			std::uint64_t n = mTree.size() - 1;
+			while (k <= n) {
+				__builtin_prefetch(mTree.data() + std::min(k * Line, n));
+				if (Precedes(cmp, keys[mTree[k].pos], args ...))
+					k = 2 * k + 1;
+				else
+					k = 2 * k;
+			}
+			k >>= std::countr_one(k) + 1;
+			return k ? mTree[k].rank : n;
+		}
+	}
+
+	/**
+	 * @brief	Rank of the key equivalent to args, n if there is none.
+	 */
+	std::uint64_t
+	find(K const* keys, std::uint64_t n, auto const& ... args) const noexcept
+	{
+		auto r = rank(keys, args ...);
+		return r < n && !Precedes(Cmp{}, args ..., key(keys, r)) ? r : n;
+	}
+};//class DS::Eytzinger<K, Cmp, Primary>
+
+}//namespace DS
@@ -0,0 +1,508 @@
+#pragma once
+
+#include "DS/FrozenMap.hpp"
+
+namespace DS {
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+K const&
+FrozenMap<K, V, C, Cs ...>::key(std::uint64_t r) const noexcept
+{ return std::get<N>(mKeys.mIndex).key(mKeys.mKeys.data(), r); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+std::uint64_t
+FrozenMap<K, V, C, Cs ...>::position(std::uint64_t r) const noexcept
+{ return std::get<N>(mKeys.mIndex).position(r); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+void
+FrozenMap<K, V, C, Cs ...>::push(V const* value)
+{
+	if (value)
+		mValues.emplace_back(*value);
+	else
+		mValues.emplace_back();
+	mHasValue.push_back(value);
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+void
+FrozenMap<K, V, C, Cs ...>::copy(std::vector<V const*> const& values)
+{
+	std::vector<V const*> arranged(mSize);
+	for (std::uint64_t r = 0; r < mSize; ++r)
+		arranged[position<0>(r)] = values[r];
+	mValues.reserve(mSize);
+	mHasValue.reserve(mSize);
+	try {
+		for (auto const* value : arranged)
+			push(value);
+	} catch (...) {
+		clear();
+		throw;
+	}
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+void
+FrozenMap<K, V, C, Cs ...>::clear() noexcept
+{
+	for (std::uint64_t i = 0; i < mValues.size(); ++i) {
+		if (mHasValue[i])
+			mValues[i]->~V();
+	}
+	mValues.clear();
+	mHasValue.clear();
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+FrozenMap<K, V, C, Cs ...>
+FrozenMap<K, V, C, Cs ...>::Build(std::vector<std::pair<K const*, V const*>> const& entries)
+{
+	if constexpr (Dimension<C, Cs ...> == 1) {
+		std::vector<K const*> keys;
+		std::vector<V const*> values;
+		keys.reserve(entries.size());
+		values.reserve(entries.size());
+		for (auto const& entry : entries) {
+			keys.push_back(entry.first);
+			values.push_back(entry.second);
+		}
+		FrozenMap map;
+		map.mKeys = FrozenSet<K, C, Cs ...>::template Build<0>(keys);
+		map.mSize = map.mKeys.size();
+		map.copy(values);
+		return map;
+	} else { // the other indices drop the colliding keys as Map does
+		typename Map<K, V, C, Cs ...>::template BulkBuilder<N> builder;
+		for (auto const& entry : entries) {
+			auto i = builder.put(*entry.first);
+			if (entry.second)
+				i.set(*entry.second);
+		}
+		return FrozenMap(builder.build());
+	}
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+FrozenMap<K, V, C, Cs ...>::FrozenMap(Map<K, V, C, Cs ...> const& map)
+		: Container<>(map.size())
+		, mKeys(map, [](auto const& i) -> K const& { return i->key; })
+{
+	std::vector<V const*> values;
+	values.reserve(mSize);
+	for (auto i = map.begin(); i; ++i)
+		values.push_back(i.hasValue() ? &i->value : nullptr);
+	copy(values);
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+FrozenMap<K, V, C, Cs ...>::FrozenMap(FrozenMap const& other)
+		: Container<>(other.mSize)
+		, mKeys(other.mKeys)
+{
+	mValues.reserve(mSize);
+	mHasValue.reserve(mSize);
+	try {
+		for (std::uint64_t i = 0; i < mSize; ++i)
+			push(other.mHasValue[i] ? &static_cast<V const&>(other.mValues[i]) : nullptr);
+	} catch (...) {
+		clear();
+		throw;
+	}
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+FrozenMap<K, V, C, Cs ...>::FrozenMap(FrozenMap&& other) noexcept
+{ swap(*this, other); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+void
+swap(FrozenMap<K, V, C, Cs ...>& a, FrozenMap<K, V, C, Cs ...>& b) noexcept
+{
+	std::swap(a.mSize, b.mSize);
+	swap(a.mKeys, b.mKeys);
+	std::swap(a.mValues, b.mValues);
+	std::swap(a.mHasValue, b.mHasValue);
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+FrozenMap<K, V, C, Cs ...>&
+FrozenMap<K, V, C, Cs ...>::operator=(FrozenMap value) noexcept
+{
+	swap(*this, value);
+	return *this;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+FrozenMap<K, V, C, Cs ...>::~FrozenMap()
+{ clear(); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+Map<K, V, C, Cs ...>
+FrozenMap<K, V, C, Cs ...>::thaw() const
+{
+	typename Map<K, V, C, Cs ...>::template BulkBuilder<> builder;
+	for (std::uint64_t i = 0; i < mSize; ++i) {
+		auto j = builder.put(key<0>(i));
+		if (auto p = position<0>(i); mHasValue[p])
+			j.set(static_cast<V const&>(mValues[p]));
+	}
+	return builder.build();
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenMap<K, V, C, Cs ...>::template const_iterator<N>
+FrozenMap<K, V, C, Cs ...>::get(auto&& ... args) const noexcept
+{ return {this, mSize ? std::get<N>(mKeys.mIndex).find(mKeys.mKeys.data(), mSize, args ...) : 0}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenMap<K, V, C, Cs ...>::template const_iterator<N>
+FrozenMap<K, V, C, Cs ...>::at(std::uint64_t i) const noexcept
+{ return {this, i < mSize ? i : mSize}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+std::uint64_t
+FrozenMap<K, V, C, Cs ...>::rank(auto&& ... args) const noexcept
+{ return mKeys.template rank<N>(args ...); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+std::uint64_t
+FrozenMap<K, V, C, Cs ...>::count(auto const& lo, auto const& hi) const noexcept
+{ return mKeys.template count<N>(lo, hi); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenMap<K, V, C, Cs ...>::template const_iterator<N>
+FrozenMap<K, V, C, Cs ...>::begin() const noexcept
+{ return {this, 0}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenMap<K, V, C, Cs ...>::template const_iterator<N>
+FrozenMap<K, V, C, Cs ...>::end() const noexcept
+{ return {this, mSize}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenMap<K, V, C, Cs ...>::template const_reverse_iterator<N>
+FrozenMap<K, V, C, Cs ...>::rbegin() const noexcept
+{ return {this, mSize ? mSize - 1 : 0}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenMap<K, V, C, Cs ...>::template const_reverse_iterator<N>
+FrozenMap<K, V, C, Cs ...>::rend() const noexcept
+{ return {this, mSize}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenMap<K, V, C, Cs ...>::template const_iterator<N>
+FrozenMap<K, V, C, Cs ...>::cbegin() const noexcept
+{ return begin<N>(); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenMap<K, V, C, Cs ...>::template const_iterator<N>
+FrozenMap<K, V, C, Cs ...>::cend() const noexcept
+{ return end<N>(); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenMap<K, V, C, Cs ...>::template const_reverse_iterator<N>
+FrozenMap<K, V, C, Cs ...>::crbegin() const noexcept
+{ return rbegin<N>(); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenMap<K, V, C, Cs ...>::template const_reverse_iterator<N>
+FrozenMap<K, V, C, Cs ...>::crend() const noexcept
+{ return rend<N>(); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+FrozenMap<K, V, C, Cs ...>::Iterator<d, n>::Iterator(FrozenMap const* map, std::uint64_t i) noexcept
+		: map(map)
+		, i(i)
+{}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+template <Direction od>
+FrozenMap<K, V, C, Cs ...>::Iterator<d, n>::Iterator(Iterator<od, n> const& other) noexcept
+		: map(other.map)
+		, i(other.i)
+{}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+template <Direction od>
+class FrozenMap<K, V, C, Cs ...>::Iterator<d, n>&
+FrozenMap<K, V, C, Cs ...>::Iterator<d, n>::operator=(Iterator<od, n> const& other) noexcept
+{
+	map = other.map;
+	i = other.i;
+	return *this;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+bool
+FrozenMap<K, V, C, Cs ...>::Iterator<d, n>::hasValue() const noexcept
+{ return map->mHasValue[map->template position<n>(i)]; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+class FrozenMap<K, V, C, Cs ...>::Iterator<d, n>&
+FrozenMap<K, V, C, Cs ...>::Iterator<d, n>::operator++() noexcept
+{
+	if constexpr (d == Direction::FORWARD)
+		++i;
+	else
+		i = i ? i - 1 : map->mSize;
+	return *this;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+class FrozenMap<K, V, C, Cs ...>::Iterator<d, n>
+FrozenMap<K, V, C, Cs ...>::Iterator<d, n>::operator++(int) noexcept
+{
+	auto r = *this;
+	++*this;
+	return r;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+class FrozenMap<K, V, C, Cs ...>::Iterator<d, n>&
+FrozenMap<K, V, C, Cs ...>::Iterator<d, n>::operator--() noexcept
+{
+	if constexpr (d == Direction::BACKWARD)
+		++i;
+	else
+		i = i ? i - 1 : map->mSize;
+	return *this;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+class FrozenMap<K, V, C, Cs ...>::Iterator<d, n>
+FrozenMap<K, V, C, Cs ...>::Iterator<d, n>::operator--(int) noexcept
+{
+	auto r = *this;
+	--*this;
+	return r;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+typename FrozenMap<K, V, C, Cs ...>::template Iterator<d, n>::Entry
+FrozenMap<K, V, C, Cs ...>::Iterator<d, n>::operator*() const noexcept
+{ return {map->template key<n>(i), static_cast<V const&>(map->mValues[map->template position<n>(i)])}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+typename FrozenMap<K, V, C, Cs ...>::template Iterator<d, n>::Pointer
+FrozenMap<K, V, C, Cs ...>::Iterator<d, n>::operator->() const noexcept
+{ return {**this}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+template <Direction od>
+bool
+FrozenMap<K, V, C, Cs ...>::Iterator<d, n>::operator==(Iterator<od, n> const& other) const noexcept
+{ return map == other.map && i == other.i; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+FrozenMap<K, V, C, Cs ...>::Iterator<d, n>::operator bool() const noexcept
+{ return i < map->mSize; }
+
+template <typename K, typename V, typename C, typename... Cs>
+template <std::size_t N>
+FrozenMap<K, V, C, Cs...>
+FrozenMap<K, V, C, Cs...>::Difference<N>::operator()(FrozenMap const& a, FrozenMap const& b) const
+{
+	std::vector<std::pair<K const*, V const*>> entries;
+	auto push = [&](auto const& i) { entries.emplace_back(&i->key, i.hasValue() ? &i->value : nullptr); };
+	if (a) {
+		if (b) {
+			// look the keys of a up in b if cheaper than walking both
+			if (a.size() * std::bit_width(b.size()) < b.size()) {
+				for (auto i = a.template begin<N>(); i; ++i) {
+					if (!b.template get<N>(i->key))
+						push(i);
+				}
+				return Build<N>(entries);
+			}
+
+			TypeAt<N, C, Cs ...> cmp;
+			auto i = a.template begin<N>();
+			auto j = b.template begin<N>();
+
+			do {
+				auto const order = Compare(cmp, i->key, j->key);
+				if (order < 0) {
+					push(i);
+					++i;
+					continue;
+				}
+				if (order > 0) {
+					++j;
+					continue;
+				}
+				++i;
+				++j;
+			} while (i && j);
+
+			for (; i; ++i)
+				push(i);
+		} else
+			return a;
+	}
+	return Build<N>(entries);
+}
+
+template <typename K, typename V, typename C, typename... Cs>
+template <typename S, std::size_t N>
+FrozenMap<K, V, C, Cs...>
+FrozenMap<K, V, C, Cs...>::Intersection<S, N>::operator()(FrozenMap const& a, FrozenMap const& b, auto&& ... args) const
+requires Selector<S, K, decltype(args) ...>
+{
+	std::vector<std::pair<K const*, V const*>> entries;
+	if (a && b) {
+		TypeAt<N, C, Cs ...> cmp;
+		S selector;
+		auto select = [&](auto const& i, auto const& j) {
+			auto const& key = selector(i->key, j->key, std::forward<decltype(args)>(args) ...);
+			auto const& k = &key == &i->key ? i : j;
+			entries.emplace_back(&key, k.hasValue() ? &k->value : nullptr);
+		};
+		// look the keys of the smaller one up in the larger one if cheaper than walking both
+		if (a.size() * std::bit_width(b.size()) < b.size()) {
+			for (auto i = a.template begin<N>(); i; ++i) {
+				if (auto j = b.template get<N>(i->key))
+					select(i, j);
+			}
+			return Build<N>(entries);
+		}
+		if (b.size() * std::bit_width(a.size()) < a.size()) {
+			for (auto j = b.template begin<N>(); j; ++j) {
+				if (auto i = a.template get<N>(j->key))
+					select(i, j);
+			}
+			return Build<N>(entries);
+		}
+
+		auto i = a.template begin<N>();
+		auto j = b.template begin<N>();
+
+		do {
+			auto const order = Compare(cmp, i->key, j->key);
+			if (order < 0) {
+				++i;
+				continue;
+			}
+			if (order > 0) {
+				++j;
+				continue;
+			}
+			select(i, j);
+			++i;
+			++j;
+		} while (i && j);
+	}
+	return Build<N>(entries);
+}
+
+template <typename K, typename V, typename C, typename... Cs>
+template <typename S, std::size_t N>
+FrozenMap<K, V, C, Cs...>
+FrozenMap<K, V, C, Cs...>::Join<S, N>::operator()(FrozenMap const& a, FrozenMap const& b, auto&& ... args) const
+requires Selector<S, K, decltype(args) ...>
+{
+	std::vector<std::pair<K const*, V const*>> entries;
+	auto push = [&](auto const& i) { entries.emplace_back(&i->key, i.hasValue() ? &i->value : nullptr); };
+	if (a) {
+		if (b) {
+			TypeAt<N, C, Cs ...> cmp;
+			S selector;
+			auto i = a.template begin<N>();
+			auto j = b.template begin<N>();
+
+			do {
+				auto const order = Compare(cmp, i->key, j->key);
+				if (order < 0) {
+					push(i);
+					++i;
+					continue;
+				}
+				if (order > 0) {
+					++j;
+					continue;
+				}
+				push(&selector(i->key, j->key, std::forward<decltype(args)>(args) ...) == &i->key ? i : j);
+				++i;
+				++j;
+			} while (i && j);
+
+			for (; i; ++i)
+				push(i);
+		} else
+			return a;
+	}
+	return Build<N>(entries);
+}
+
+template <typename K, typename V, typename C, typename... Cs>
+template <typename S, std::size_t N>
+FrozenMap<K, V, C, Cs...>
+FrozenMap<K, V, C, Cs...>::Union<S, N>::operator()(FrozenMap const& a, FrozenMap const& b, auto&& ... args) const
+requires Selector<S, K, decltype(args) ...>
+{
+	std::vector<std::pair<K const*, V const*>> entries;
+	auto push = [&](auto const& i) { entries.emplace_back(&i->key, i.hasValue() ? &i->value : nullptr); };
+	if (a) {
+		if (b) {
+			TypeAt<N, C, Cs ...> cmp;
+			S selector;
+			auto i = a.template begin<N>();
+			auto j = b.template begin<N>();
+
+			do {
+				auto const order = Compare(cmp, i->key, j->key);
+				if (order < 0) {
+					push(i);
+					++i;
+					continue;
+				}
+				if (order > 0) {
+					push(j);
+					++j;
+					continue;
+				}
+				push(&selector(i->key, j->key, std::forward<decltype(args)>(args) ...) == &i->key ? i : j);
+				++i;
+				++j;
+			} while (i && j);
+
+			for (; i; ++i)
+				push(i);
+			for (; j; ++j)
+				push(j);
+		} else
+			return a;
+	} else if (b)
+		return b;
+	return Build<N>(entries);
+}
+
+}//namespace DS
@@ -0,0 +1,435 @@
+#pragma once
+
+#include "DS/FrozenSet.hpp"
+#include <stdexcept>
+
+namespace DS {
+
+template <typename K, typename C, typename ... Cs>
+FrozenSet<K, C, Cs ...>::FrozenSet(auto const& container, auto const& key)
+		: Container<>(container.size())
+{
+	if (mSize > std::numeric_limits<std::uint32_t>::max())
+		throw std::length_error("FrozenSet");
+	mKeys.reserve(mSize);
+	for (auto i = container.begin(); i; ++i)
+		mKeys.push_back(key(i));
+	std::get<0>(mIndex).build(mKeys, mSize, {});
+	if constexpr (Dimension<C, Cs ...> > 1)
+		index<1>(container, key);
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+void
+FrozenSet<K, C, Cs ...>::index(auto const& container, auto const& key)
+{
+	auto const& primary = std::get<0>(mIndex);
+	std::vector<std::uint32_t> order;
+	order.reserve(mSize);
+	for (auto i = container.template begin<N>(); i; ++i)
+		order.push_back(primary.position(primary.find(mKeys.data(), mSize, key(i))));
+	std::get<N>(mIndex).build(mKeys, mSize, std::move(order));
+	if constexpr (N + 1 < Dimension<C, Cs ...>)
+		index<N + 1>(container, key);
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+FrozenSet<K, C, Cs ...>
+FrozenSet<K, C, Cs ...>::Build(std::vector<K const*> const& keys)
+{
+	if constexpr (Dimension<C, Cs ...> == 1) {
+		FrozenSet set;
+		set.mSize = keys.size();
+		set.mKeys.reserve(keys.size());
+		for (auto const* key : keys)
+			set.mKeys.push_back(*key);
+		std::get<0>(set.mIndex).build(set.mKeys, set.mSize, {});
+		return set;
+	} else { // the other indices drop the colliding keys as Set does
+		typename Set<K, C, Cs ...>::template BulkBuilder<N> builder;
+		for (auto const* key : keys)
+			builder.put(*key);
+		return FrozenSet(builder.build());
+	}
+}
+
+template <typename K, typename C, typename ... Cs>
+FrozenSet<K, C, Cs ...>::FrozenSet(Set<K, C, Cs ...> const& set)
+		: FrozenSet(set, [](auto const& i) -> K const& { return *i; })
+{}
+
+template <typename K, typename C, typename ... Cs>
+FrozenSet<K, C, Cs ...>::FrozenSet(FrozenSet&& other) noexcept
+{ swap(*this, other); }
+
+template <typename K, typename C, typename ... Cs>
+void
+swap(FrozenSet<K, C, Cs ...>& a, FrozenSet<K, C, Cs ...>& b) noexcept
+{
+	std::swap(a.mSize, b.mSize);
+	std::swap(a.mKeys, b.mKeys);
+	std::swap(a.mIndex, b.mIndex);
+}
+
+template <typename K, typename C, typename ... Cs>
+FrozenSet<K, C, Cs ...>&
+FrozenSet<K, C, Cs ...>::operator=(FrozenSet value) noexcept
+{
+	swap(*this, value);
+	return *this;
+}
+
+template <typename K, typename C, typename ... Cs>
+Set<K, C, Cs ...>
+FrozenSet<K, C, Cs ...>::thaw() const
+{
+	typename Set<K, C, Cs ...>::template BulkBuilder<> builder;
+	for (std::uint64_t i = 0; i < mSize; ++i)
+		builder.put(std::get<0>(mIndex).key(mKeys.data(), i));
+	return builder.build();
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenSet<K, C, Cs ...>::template const_iterator<N>
+FrozenSet<K, C, Cs ...>::get(auto&& ... args) const noexcept
+{ return {this, mSize ? std::get<N>(mIndex).find(mKeys.data(), mSize, args ...) : 0}; }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenSet<K, C, Cs ...>::template const_iterator<N>
+FrozenSet<K, C, Cs ...>::at(std::uint64_t i) const noexcept
+{ return {this, i < mSize ? i : mSize}; }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+std::uint64_t
+FrozenSet<K, C, Cs ...>::rank(auto&& ... args) const noexcept
+{ return mSize ? std::min(std::get<N>(mIndex).rank(mKeys.data(), args ...), mSize) : 0; }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+std::uint64_t
+FrozenSet<K, C, Cs ...>::count(auto const& lo, auto const& hi) const noexcept
+{
+	auto l = rank<N>(lo);
+	auto h = rank<N>(hi);
+	return l < h ? h - l : 0;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenSet<K, C, Cs ...>::template const_iterator<N>
+FrozenSet<K, C, Cs ...>::begin() const noexcept
+{ return {this, 0}; }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenSet<K, C, Cs ...>::template const_iterator<N>
+FrozenSet<K, C, Cs ...>::end() const noexcept
+{ return {this, mSize}; }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenSet<K, C, Cs ...>::template const_reverse_iterator<N>
+FrozenSet<K, C, Cs ...>::rbegin() const noexcept
+{ return {this, mSize ? mSize - 1 : 0}; }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenSet<K, C, Cs ...>::template const_reverse_iterator<N>
+FrozenSet<K, C, Cs ...>::rend() const noexcept
+{ return {this, mSize}; }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenSet<K, C, Cs ...>::template const_iterator<N>
+FrozenSet<K, C, Cs ...>::cbegin() const noexcept
+{ return begin<N>(); }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenSet<K, C, Cs ...>::template const_iterator<N>
+FrozenSet<K, C, Cs ...>::cend() const noexcept
+{ return end<N>(); }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenSet<K, C, Cs ...>::template const_reverse_iterator<N>
+FrozenSet<K, C, Cs ...>::crbegin() const noexcept
+{ return rbegin<N>(); }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename FrozenSet<K, C, Cs ...>::template const_reverse_iterator<N>
+FrozenSet<K, C, Cs ...>::crend() const noexcept
+{ return rend<N>(); }
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+FrozenSet<K, C, Cs ...>::Iterator<d, n>::Iterator(FrozenSet const* set, std::uint64_t i) noexcept
+		: set(set)
+		, i(i)
+{}
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+template <Direction od>
+FrozenSet<K, C, Cs ...>::Iterator<d, n>::Iterator(Iterator<od, n> const& other) noexcept
+		: set(other.set)
+		, i(other.i)
+{}
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+template <Direction od>
+class FrozenSet<K, C, Cs ...>::Iterator<d, n>&
+FrozenSet<K, C, Cs ...>::Iterator<d, n>::operator=(Iterator<od, n> const& other) noexcept
+{
+	set = other.set;
+	i = other.i;
+	return *this;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+class FrozenSet<K, C, Cs ...>::Iterator<d, n>&
+FrozenSet<K, C, Cs ...>::Iterator<d, n>::operator++() noexcept
+{
+	if constexpr (d == Direction::FORWARD)
+		++i;
+	else
+		i = i ? i - 1 : set->mSize;
+	return *this;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+class FrozenSet<K, C, Cs ...>::Iterator<d, n>
+FrozenSet<K, C, Cs ...>::Iterator<d, n>::operator++(int) noexcept
+{
+	auto r = *this;
+	++*this;
+	return r;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+class FrozenSet<K, C, Cs ...>::Iterator<d, n>&
+FrozenSet<K, C, Cs ...>::Iterator<d, n>::operator--() noexcept
+{
+	if constexpr (d == Direction::BACKWARD)
+		++i;
+	else
+		i = i ? i - 1 : set->mSize;
+	return *this;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+class FrozenSet<K, C, Cs ...>::Iterator<d, n>
+FrozenSet<K, C, Cs ...>::Iterator<d, n>::operator--(int) noexcept
+{
+	auto r = *this;
+	--*this;
+	return r;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+K const&
+FrozenSet<K, C, Cs ...>::Iterator<d, n>::operator*() const noexcept
+{ return std::get<n>(set->mIndex).key(set->mKeys.data(), i); }
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+K const*
+FrozenSet<K, C, Cs ...>::Iterator<d, n>::operator->() const noexcept
+{ return &std::get<n>(set->mIndex).key(set->mKeys.data(), i); }
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+template <Direction od>
+bool
+FrozenSet<K, C, Cs ...>::Iterator<d, n>::operator==(Iterator<od, n> const& other) const noexcept
+{ return set == other.set && i == other.i; }
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t n>
+FrozenSet<K, C, Cs ...>::Iterator<d, n>::operator bool() const noexcept
+{ return i < set->mSize; }
+
+template <typename K, typename C, typename... Cs>
+template <std::size_t N>
+FrozenSet<K, C, Cs...>
+FrozenSet<K, C, Cs...>::Difference<N>::operator()(FrozenSet const& a, FrozenSet const& b) const
+{
+	std::vector<K const*> keys;
+	if (a) {
+		if (b) {
+			// look the keys of a up in b if cheaper than walking both
+			if (a.size() * std::bit_width(b.size()) < b.size()) {
+				for (auto i = a.template begin<N>(); i; ++i) {
+					if (!b.template get<N>(*i))
+						keys.push_back(&*i);
+				}
+				return Build<N>(keys);
+			}
+
+			TypeAt<N, C, Cs ...> cmp;
+			auto i = a.template begin<N>();
+			auto j = b.template begin<N>();
+
+			do {
+				auto const order = Compare(cmp, *i, *j);
+				if (order < 0) {
+					keys.push_back(&*i);
+					++i;
+					continue;
+				}
+				if (order > 0) {
+					++j;
+					continue;
+				}
+				++i;
+				++j;
+			} while (i && j);
+
+			for (; i; ++i)
+				keys.push_back(&*i);
+		} else
+			return a;
+	}
+	return Build<N>(keys);
+}
+
+template <typename K, typename C, typename... Cs>
+template <typename S, std::size_t N>
+FrozenSet<K, C, Cs...>
+FrozenSet<K, C, Cs...>::Intersection<S, N>::operator()(FrozenSet const& a, FrozenSet const& b, auto&& ... args) const
+requires Selector<S, K, decltype(args) ...>
+{
+	std::vector<K const*> keys;
+	if (a && b) {
+		TypeAt<N, C, Cs ...> cmp;
+		S selector;
+		// look the keys of the smaller one up in the larger one if cheaper than walking both
+		if (a.size() * std::bit_width(b.size()) < b.size()) {
+			for (auto i = a.template begin<N>(); i; ++i) {
+				if (auto j = b.template get<N>(*i))
+					keys.push_back(&selector(*i, *j, std::forward<decltype(args)>(args) ...));
+			}
+			return Build<N>(keys);
+		}
+		if (b.size() * std::bit_width(a.size()) < a.size()) {
+			for (auto j = b.template begin<N>(); j; ++j) {
+				if (auto i = a.template get<N>(*j))
+					keys.push_back(&selector(*i, *j, std::forward<decltype(args)>(args) ...));
+			}
+			return Build<N>(keys);
+		}
+
+		auto i = a.template begin<N>();
+		auto j = b.template begin<N>();
+
+		do {
+			auto const order = Compare(cmp, *i, *j);
+			if (order < 0) {
+				++i;
+				continue;
+			}
+			if (order > 0) {
+				++j;
+				continue;
+			}
+			keys.push_back(&selector(*i, *j, std::forward<decltype(args)>(args) ...));
+			++i;
+			++j;
+		} while (i && j);
+	}
+	return Build<N>(keys);
+}
+
+template <typename K, typename C, typename... Cs>
+template <typename S, std::size_t N>
+FrozenSet<K, C, Cs...>
+FrozenSet<K, C, Cs...>::Join<S, N>::operator()(FrozenSet const& a, FrozenSet const& b, auto&& ... args) const
+requires Selector<S, K, decltype(args) ...>
+{
+	std::vector<K const*> keys;
+	if (a) {
+		if (b) {
+			TypeAt<N, C, Cs ...> cmp;
+			S selector;
+			auto i = a.template begin<N>();
+			auto j = b.template begin<N>();
+
+			do {
+				auto const order = Compare(cmp, *i, *j);
+				if (order < 0) {
+					keys.push_back(&*i);
+					++i;
+					continue;
+				}
+				if (order > 0) {
+					++j;
+					continue;
+				}
+				keys.push_back(&selector(*i, *j, std::forward<decltype(args)>(args) ...));
+				++i;
+				++j;
+			} while (i && j);
+
+			for (; i; ++i)
+				keys.push_back(&*i);
+		} else
+			return a;
+	}
+	return Build<N>(keys);
+}
+
+template <typename K, typename C, typename... Cs>
+template <typename S, std::size_t N>
+FrozenSet<K, C, Cs...>
+FrozenSet<K, C, Cs...>::Union<S, N>::operator()(FrozenSet const& a, FrozenSet const& b, auto&& ... args) const
+requires Selector<S, K, decltype(args) ...>
+{
+	std::vector<K const*> keys;
+	if (a) {
+		if (b) {
+			TypeAt<N, C, Cs ...> cmp;
+			S selector;
+			auto i = a.template begin<N>();
+			auto j = b.template begin<N>();
+
+			do {
+				auto const order = Compare(cmp, *i, *j);
+				if (order < 0) {
+					keys.push_back(&*i);
+					++i;
+					continue;
+				}
+				if (order > 0) {
+					keys.push_back(&*j);
+					++j;
+					continue;
+				}
+				keys.push_back(&selector(*i, *j, std::forward<decltype(args)>(args) ...));
+				++i;
+				++j;
+			} while (i && j);
+
+			for (; i; ++i)
+				keys.push_back(&*i);
+			for (; j; ++j)
+				keys.push_back(&*j);
+		} else
+			return a;
+	} else if (b)
+		return b;
+	return Build<N>(keys);
+}
+
+}//namespace DS
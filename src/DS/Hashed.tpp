@@ -0,0 +1,247 @@
+#pragma once
+
+#include "Policy.tpp"
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace DS {
+
+/**
+ * @brief	Base of the hashing policies.
+ */
+struct Hashing : Policy {};
+
+/**
+ * @brief	Hashing policy adding an unordered index to Map, looked up in O(1) expected time.
+ * @details	The hashed index follows the ordered ones, get<Dimension<C, Cs ...>>(args ...) hashes args by H and
+ * compares them to the keys by Eq. Keys equal by Eq must be equivalent by one of the comparators, so that the
+ * hashed index is unique as well. Single element puts and removes update it along with the trees, operations
+ * relinking the trees at once (e.g. merge, splitAt, concat) rebuild it in O(n).
+ * @tparam	H Hash of the keys and of the arguments of get
+ * @tparam	Eq Equality of a key and the arguments of get
+ */
+template <typename H, typename Eq = std::equal_to<>>
+struct Hashed : Hashing {
+	using Hash = H;
+	using Equal = Eq;
+};//struct DS::Hashed<H, Eq>
+
+// Iterators of the hashed index walk the first ordered one
+template <std::size_t N, typename ... Cs>
+inline constexpr std::size_t OrderedIndex = N < Dimension<Cs ...> ? N : 0;
+
+/**
+ * @brief	Open addressing table of the nodes T by the Hashed policy P, probed linearly.
+ * @details	The table holds every node of the container or none, after an allocation failure, in which case get
+ * walks the first index until the container doubles and the table is rebuilt. Hashes are spread by Fibonacci hashing
+ * and kept in the slots, so that probes rarely reach the nodes.
+ */
+template <typename K, typename T, typename P>
+class HashIndex {
+	struct Slot {
+		std::size_t hash;
+		T* node{nullptr};
+	};
+
+	static constexpr int Bits{std::numeric_limits<std::size_t>::digits};
+
+	Slot* mSlots{nullptr};
+	int mShift{Bits}; // the slot of a hash is hash >> mShift
+	std::size_t mCount{0};
+	std::uint64_t mRetry{0}; // without a table, the count to rebuild it at
+
+	static std::size_t
+	Hash(auto const& ... args) noexcept
+	{ return typename P::Hash{}(args ...) * std::size_t{0x9E3779B97F4A7C15}; }
+
+	std::size_t
+	mask() const noexcept
+	{ return (std::size_t{1} << (Bits - mShift)) - 1; }
+
+	// Put the node of hash to the table of enough slots
+	void
+	insert(std::size_t hash, T* t) noexcept
+	{
+		auto i = hash >> mShift;
+		while (mSlots[i].node)
+			i = (i + 1) & mask();
+		mSlots[i] = {hash, t};
+	}
+
+	// Replace the table by an empty one of 2^bits slots, false if it cannot be allocated
+	bool
+	allocate(int bits) noexcept
+	{
+		auto* slots = new(std::nothrow) Slot[std::size_t{1} << bits]{};
+		if (!slots)
+			return false;
+		delete[] std::exchange(mSlots, slots);
+		mShift = Bits - bits;
+		return true;
+	}
+
+	// Slot bits of a table for count nodes, loaded up to 3/4
+	static int
+	BitsFor(std::uint64_t count) noexcept
+	{ return std::max(3, static_cast<int>(std::bit_width((count * 4 + 2) / 3))); }
+
+public:
+	HashIndex() noexcept = default;
+
+	HashIndex(HashIndex const&) = delete;
+
+	HashIndex&
+	operator=(HashIndex const&) = delete;
+
+	~HashIndex()
+	{ delete[] mSlots; }
+
+	friend void
+	swap(HashIndex& a, HashIndex& b) noexcept
+	{
+		std::swap(a.mSlots, b.mSlots);
+		std::swap(a.mShift, b.mShift);
+		std::swap(a.mCount, b.mCount);
+		std::swap(a.mRetry, b.mRetry);
+	}
+
+	/**
+	 * @brief	Drop the table, get walks the first index until it is rebuilt.
+	 */
+	void
+	clear() noexcept
+	{
+		delete[] std::exchange(mSlots, nullptr);
+		mShift = Bits;
+		mCount = 0;
+		mRetry = 0;
+	}
+
+	// Drop the table after an allocation failure, keeping the count to rebuild it once count doubles
+	void
+	drop(std::uint64_t count) noexcept
+	{
+		clear();
+		mCount = count;
+		mRetry = count * 2;
+	}
+
+	/**
+	 * @brief	Rebuild the table of the count nodes of the first index tree root.
+	 */
+	void
+	rebuild(auto* root, std::uint64_t count) noexcept
+	{
+		if (!allocate(BitsFor(count)))
+			return drop(count);
+		mRetry = 0;
+		mCount = count;
+		for (auto* t = root->template leftMost<0, T>(); t; t = t->template next<0, T>())
+			insert(Hash(static_cast<K const&>(t->key)), t);
+	}
+
+	/**
+	 * @brief	Put t, false if there is no table to put it in and it is to be rebuilt.
+	 */
+	bool
+	put(T* t) noexcept
+	{
+		if (!mSlots)
+			return ++mCount < mRetry;
+		if ((mCount + 1) * 4 > (mask() + 1) * 3) {
+			auto* slots = mSlots;
+			auto const size = mask() + 1;
+			mSlots = nullptr;
+			if (!allocate(Bits - mShift + 1)) {
+				mSlots = slots;
+				drop(mCount + 1);
+				return true;
+			}
+			for (std::size_t i = 0; i < size; ++i) {
+				if (slots[i].node)
+					insert(slots[i].hash, slots[i].node);
+			}
+			delete[] slots;
+		}
+		insert(Hash(static_cast<K const&>(t->key)), t);
+		++mCount;
+		return true;
+	}
+
+	/**
+	 * @brief	Remove t, shifting the following nodes of its probe sequence back.
+	 */
+	void
+	remove(T const* t) noexcept
+	{
+		if (!mSlots) {
+			mCount -= mCount > 0;
+			return;
+		}
+		auto i = Hash(static_cast<K const&>(t->key)) >> mShift;
+		while (mSlots[i].node != t)
+			i = (i + 1) & mask();
+		for (auto j = (i + 1) & mask(); mSlots[j].node; j = (j + 1) & mask()) {
+			// move j to the hole at i unless its home slot lies cyclically in (i, j]
+			if (((j - (mSlots[j].hash >> mShift)) & mask()) >= ((j - i) & mask())) {
+				mSlots[i] = mSlots[j];
+				i = j;
+			}
+		}
+		mSlots[i].node = nullptr;
+		--mCount;
+	}
+
+	/**
+	 * @brief	Node equal to args by P::Equal or null, walking the first index tree root if there is no table.
+	 */
+	T*
+	get(auto* root, auto const& ... args) const noexcept
+	{
+		typename P::Equal eq;
+		if (!mSlots) {
+			for (auto* t = root ? root->template leftMost<0, T>() : nullptr; t; t = t->template next<0, T>()) {
+				if (eq(static_cast<K const&>(t->key), args ...))
+					return t;
+			}
+			return nullptr;
+		}
+		auto const hash = Hash(args ...);
+		for (auto i = hash >> mShift; mSlots[i].node; i = (i + 1) & mask()) {
+			if (mSlots[i].hash == hash && eq(static_cast<K const&>(mSlots[i].node->key), args ...))
+				return mSlots[i].node;
+		}
+		return nullptr;
+	}
+};//class DS::HashIndex<K, T, P>
+
+// Index of a container without a Hashed policy
+template <typename K, typename T>
+class HashIndex<K, T, Hashing> {
+public:
+	friend void
+	swap(HashIndex&, HashIndex&) noexcept
+	{}
+
+	void
+	clear() noexcept
+	{}
+
+	void
+	rebuild(auto*, std::uint64_t) noexcept
+	{}
+
+	bool
+	put(T*) noexcept
+	{ return true; }
+
+	void
+	remove(T const*) noexcept
+	{}
+};//class DS::HashIndex<K, T, Hashing>
+
+}//namespace DS
@@ -6,21 +6,32 @@ namespace DS {
 
 template <typename T>
 IntrusivePtr<T>::IntrusivePtr(IntrusivePtr const& other) noexcept
+	: mPtr{other.mPtr}
+	, mOffset{other.mOffset}
 {
-	reinterpret_cast<std::uintptr_t&>(*this) = reinterpret_cast<std::uintptr_t const&>(other);
 	if (mPtr)
 		reinterpret_cast<RefCounter*>(mPtr - mOffset)->addRef();
 }
 
 template <typename T>
 IntrusivePtr<T>::IntrusivePtr(IntrusivePtr&& other) noexcept
-{ std::swap(reinterpret_cast<std::uintptr_t&>(*this), reinterpret_cast<std::uintptr_t&>(other)); }
+	: mPtr{other.mPtr}
+	, mOffset{other.mOffset}
+{
+	other.mPtr = 0;
+	other.mOffset = 0;
+}
 
 template <typename T>
 IntrusivePtr<T>&
 IntrusivePtr<T>::operator=(IntrusivePtr other) noexcept
 {
-	std::swap(reinterpret_cast<std::uintptr_t&>(*this), reinterpret_cast<std::uintptr_t&>(other));
+	auto const ptr = mPtr;
+	auto const offset = mOffset;
+	mPtr = other.mPtr;
+	mOffset = other.mOffset;
+	other.mPtr = ptr;
+	other.mOffset = offset;
 	return *this;
 }
 
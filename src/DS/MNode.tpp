@@ -43,17 +43,32 @@ template <typename K, typename V, typename ... Cs>
 struct MNode : SNode<K, Cs ...> {
 	Holder<V> val;
 
+	static void*
+	operator new(std::size_t size)
+	{
+		auto* ptr = PolicyOf<Allocator, Allocator, Cs ...>::allocate(size);
+		PolicyOf<Stats, Stats, Cs ...>::allocated(size);
+		return ptr;
+	}
+
 	static void*
 	operator new(std::size_t, std::size_t valSize)
-	{ return ::operator new(Offset(&MNode::val) + valSize); }
+	{
+		auto* ptr = PolicyOf<Allocator, Allocator, Cs ...>::allocate(Offset(&MNode::val) + valSize);
+		PolicyOf<Stats, Stats, Cs ...>::allocated(Offset(&MNode::val) + valSize);
+		return ptr;
+	}
 
 	static void
 	operator delete(void* ptr)
-	{ ::operator delete(ptr); }
+	{
+		PolicyOf<Stats, Stats, Cs ...>::deallocated();
+		PolicyOf<Allocator, Allocator, Cs ...>::deallocate(ptr);
+	}
 
 	explicit MNode(auto&& ... kArgs)
 			: SNode<K, Cs ...>(std::forward<decltype(kArgs)>(kArgs) ...)
-	{}
+	{ this->d[0].hasValue = false; }
 
 	~MNode()
 	{
@@ -61,24 +76,6 @@ struct MNode : SNode<K, Cs ...> {
 			val->~V();
 	}
 
-	static TNode<sizeof...(Cs)>*
-	Create(TNode<sizeof...(Cs)>* P, TNode<sizeof...(Cs)>* S,
-			TNode<sizeof...(Cs)> const* other)
-	{
-		auto* t = ::new MNode(static_cast<K const&>(reinterpret_cast<MNode const*>(other)->key));
-		try {
-			if (other->d[0].hasValue)
-				::new(static_cast<void*>(t->val)) Holder<V>(static_cast<V const&>(reinterpret_cast<MNode const*>(other)->val));
-			t->left(other->d[0].hasLeft ? MNode::Create(P, t, other->left()) : P);
-			t->right(other->d[0].hasRight ? MNode::Create(t, S, other->right()) : S);
-			t->state(other->state());
-			return t;
-		} catch (...) {
-			delete t;
-			throw;
-		}
-	}
-
 	static MNode*
 	Create(MNode* P, MNode* S,
 			Stream::Input& input)
@@ -87,7 +84,7 @@ struct MNode : SNode<K, Cs ...> {
 		Stream::Deserializable<V, decltype(input)>
 	{
 		auto state = Stream::Get<std::uint8_t>(input);
-		auto* t = reinterpret_cast<MNode*>(::operator new(sizeof(MNode)));
+		auto* t = reinterpret_cast<MNode*>(operator new(sizeof(MNode)));
 		t->template state(2);
 
 		try {
@@ -99,7 +96,7 @@ struct MNode : SNode<K, Cs ...> {
 		} catch (...) {
 			if (t->d[0].hasValue)
 				t->val->~V();
-			::operator delete(t);
+			operator delete(t);
 			throw;
 		}
 
@@ -107,6 +104,7 @@ struct MNode : SNode<K, Cs ...> {
 			t->left(state & 0x40 ? MNode::Create(P, t, input) : P);
 			t->right(state & 0x10 ? MNode::Create(t, S, input) : S);
 			t->state(state);
+			t->recount();
 			return t;
 		} catch (...) {
 			delete t;
@@ -123,7 +121,7 @@ struct MNode : SNode<K, Cs ...> {
 		Stream::Deserializable<V, decltype(input), VArgs ...>
 	{
 		auto state = Stream::Get<std::uint8_t>(input);
-		auto* t = reinterpret_cast<MNode*>(::operator new(sizeof(MNode)));
+		auto* t = reinterpret_cast<MNode*>(operator new(sizeof(MNode)));
 		t->template state(2);
 
 		try {
@@ -135,7 +133,7 @@ struct MNode : SNode<K, Cs ...> {
 		} catch (...) {
 			if (t->d[0].hasValue)
 				t->val->~V();
-			::operator delete(t);
+			operator delete(t);
 			throw;
 		}
 
@@ -143,6 +141,7 @@ struct MNode : SNode<K, Cs ...> {
 			t->left(state & 0x40 ? MNode::Create(P, t, input, vArgs) : P);
 			t->right(state & 0x10 ? MNode::Create(t, S, input, vArgs) : S);
 			t->state(state);
+			t->recount();
 			return t;
 		} catch (...) {
 			delete t;
@@ -159,7 +158,7 @@ struct MNode : SNode<K, Cs ...> {
 		Stream::Deserializable<V, decltype(input)>
 	{
 		auto state = Stream::Get<std::uint8_t>(input);
-		auto* t = reinterpret_cast<MNode*>(::operator new(sizeof(MNode)));
+		auto* t = reinterpret_cast<MNode*>(operator new(sizeof(MNode)));
 		t->template state(2);
 
 		try {
@@ -171,7 +170,7 @@ struct MNode : SNode<K, Cs ...> {
 		} catch (...) {
 			if (t->d[0].hasValue)
 				t->val->~V();
-			::operator delete(t);
+			operator delete(t);
 			throw;
 		}
 
@@ -179,6 +178,7 @@ struct MNode : SNode<K, Cs ...> {
 			t->left(state & 0x40 ? MNode::Create(P, t, kArgs, input) : P);
 			t->right(state & 0x10 ? MNode::Create(t, S, kArgs, input) : S);
 			t->state(state);
+			t->recount();
 			return t;
 		} catch (...) {
 			delete t;
@@ -195,7 +195,7 @@ struct MNode : SNode<K, Cs ...> {
 		Stream::Deserializable<V, decltype(input), VArgs ...>
 	{
 		auto state = Stream::Get<std::uint8_t>(input);
-		auto* t = reinterpret_cast<MNode*>(::operator new(sizeof(MNode)));
+		auto* t = reinterpret_cast<MNode*>(operator new(sizeof(MNode)));
 		t->template state(2);
 
 		try {
@@ -207,7 +207,7 @@ struct MNode : SNode<K, Cs ...> {
 		} catch (...) {
 			if (t->d[0].hasValue)
 				t->val->~V();
-			::operator delete(t);
+			operator delete(t);
 			throw;
 		}
 
@@ -215,6 +215,7 @@ struct MNode : SNode<K, Cs ...> {
 			t->left(state & 0x40 ? MNode::Create(P, t, kArgs, input, vArgs) : P);
 			t->right(state & 0x10 ? MNode::Create(t, S, kArgs, input, vArgs) : S);
 			t->state(state);
+			t->recount();
 			return t;
 		} catch (...) {
 			delete t;
@@ -260,6 +261,7 @@ struct MNode : SNode<K, Cs ...> {
 			t->left(state & 0x40 ? MNode::Create(P, t, std::forward<decltype(kArgs)>(kArgs) ..., input, DP::Factory<V, VType, VArgs ...>{}, std::forward<decltype(vArgs)>(vArgs) ...) : P);
 			t->right(state & 0x10 ? MNode::Create(t, S, std::forward<decltype(kArgs)>(kArgs) ..., input, DP::Factory<V, VType, VArgs ...>{}, std::forward<decltype(vArgs)>(vArgs) ...) : S);
 			t->state(state);
+			t->recount();
 			return t;
 		} catch (...) {
 			delete t;
@@ -274,7 +276,7 @@ struct MNode : SNode<K, Cs ...> {
 	requires Stream::Deserializable<V, decltype(input), decltype(vArgs) ...>
 	{
 		auto state = Stream::Get<std::uint8_t>(input);
-		auto* t = reinterpret_cast<MNode*>(::operator new(sizeof(MNode)));
+		auto* t = reinterpret_cast<MNode*>(operator new(sizeof(MNode)));
 		t->template state(2);
 
 		try {
@@ -290,7 +292,7 @@ struct MNode : SNode<K, Cs ...> {
 		} catch (...) {
 			if (t->d[0].hasValue)
 				t->val->~V();
-			::operator delete(t);
+			operator delete(t);
 			throw;
 		}
 
@@ -298,6 +300,7 @@ struct MNode : SNode<K, Cs ...> {
 			t->left(state & 0x40 ? MNode::Create(P, t, DP::Factory<K, KType, KArgs ...>{}, std::forward<decltype(kArgs)>(kArgs) ..., input, std::forward<decltype(vArgs)>(vArgs) ...) : P);
 			t->right(state & 0x10 ? MNode::Create(t, S, DP::Factory<K, KType, KArgs ...>{}, std::forward<decltype(kArgs)>(kArgs) ..., input, std::forward<decltype(vArgs)>(vArgs) ...) : S);
 			t->state(state);
+			t->recount();
 			return t;
 		} catch (...) {
 			delete t;
@@ -346,6 +349,7 @@ struct MNode : SNode<K, Cs ...> {
 			t->left(state & 0x40 ? MNode::Create(P, t, DP::Factory<K, KType, KArgs ...>{}, std::forward<decltype(kArgs)>(kArgs) ..., input, DP::Factory<V, VType, VArgs ...>{}, std::forward<decltype(vArgs)>(vArgs) ...) : P);
 			t->right(state & 0x10 ? MNode::Create(t, S, DP::Factory<K, KType, KArgs ...>{}, std::forward<decltype(kArgs)>(kArgs) ..., input, DP::Factory<V, VType, VArgs ...>{}, std::forward<decltype(vArgs)>(vArgs) ...) : S);
 			t->state(state);
+			t->recount();
 			return t;
 		} catch (...) {
 			delete t;
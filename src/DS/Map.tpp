@@ -4,15 +4,107 @@
 
 namespace DS {
 
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+void
+Map<K, V, C, Cs ...>::adopt(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* root) noexcept
+{
+	mRoot[N] = root;
+	if constexpr (Dimension<C, Cs ...> > 1)
+		mSize = SNode<K, C, Cs ...>::template Reindex<MNode<K, V, C, Cs ...>, N>(mRoot, root->d[N].cnt);
+	else
+		mSize = root->d[N].cnt;
+	rehash();
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+void
+Map<K, V, C, Cs ...>::rehash() noexcept
+{
+	if (mSize)
+		mHash.rebuild(mRoot[0], mSize);
+	else
+		mHash.clear();
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+MNode<K, V, C, Cs ...>*
+Map<K, V, C, Cs ...>::Copy(K const& key)
+{
+	auto const* m = static_cast<MNode<K, V, C, Cs ...> const*>(ToParent(const_cast<K*>(&key), &SNode<K, C, Cs ...>::key));
+	auto* c = new MNode<K, V, C, Cs ...>(key);
+	if (m->d[0].hasValue) {
+		try {
+			c->set(static_cast<V const&>(m->val));
+		} catch (...) {
+			delete c;
+			throw;
+		}
+	}
+	return c;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N, bool OnlyA, bool OnlyB, bool Both>
+Map<K, V, C, Cs ...>
+Map<K, V, C, Cs ...>::Merge(Map const& a, Map const& b, unsigned threads, auto const& select)
+{
+	auto* root = a.mRoot[N]
+		? SNode<K, C, Cs ...>::template Clone<MNode<K, V, C, Cs ...>, N>(reinterpret_cast<SNode<K, C, Cs ...> const*>(a.mRoot[N]), Copy, threads)
+		: nullptr;
+	int h;
+	root = SNode<K, C, Cs ...>::template Merge<MNode<K, V, C, Cs ...>, N, OnlyA, OnlyB, Both>(
+		root, root ? a.mRoot[N]->template height<N>() : 0,
+		reinterpret_cast<SNode<K, C, Cs ...> const*>(b.mRoot[N]), b.mRoot[N] ? b.mRoot[N]->template height<N>() : 0, h,
+		threads, Copy, select);
+	Map map;
+	if (root) {
+		TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>::template Thread<N>(root, nullptr, nullptr, threads);
+		map.template adopt<N>(root);
+	}
+	return map;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N, bool OnlyA, bool OnlyB, bool Both, bool Move>
+void
+Map<K, V, C, Cs ...>::mergeInPlace(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* b, auto const& select)
+{
+	// never called, the nodes are relinked rather than copied
+	auto copy = [](K const&) noexcept -> TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* { return nullptr; };
+	int h;
+	auto* root = SNode<K, C, Cs ...>::template Merge<MNode<K, V, C, Cs ...>, N, OnlyA, OnlyB, Both, Move>(
+		mRoot[N], mRoot[N] ? mRoot[N]->template height<N>() : 0,
+		reinterpret_cast<SNode<K, C, Cs ...> const*>(b), b ? b->template height<N>() : 0, h,
+		1, copy, select);
+	std::fill(mRoot, mRoot + Dimension<C, Cs ...>, nullptr);
+	mSize = 0;
+	mHash.clear();
+	if (root) {
+		// Merge rethreads around the joins, only the ends are left
+		TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>::template Rethread<N>(nullptr, root->template leftMost<N>());
+		TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>::template Rethread<N>(root->template rightMost<N>(), nullptr);
+		adopt<N>(root);
+	}
+}
+
 template <typename K, typename V, typename C, typename ... Cs>
 Map<K, V, C, Cs ...>::Map(Map const& other)
+requires std::is_copy_constructible_v<K> && std::is_copy_constructible_v<V>
+		: Map(other, 1)
+{}
+
+template <typename K, typename V, typename C, typename ... Cs>
+Map<K, V, C, Cs ...>::Map(Map const& other, unsigned threads)
 requires std::is_copy_constructible_v<K> && std::is_copy_constructible_v<V>
 		: Container(other.mSize)
 {
 	if (mSize) {
-		mRoot[0] = MNode<K, V, C, Cs ...>::Create(nullptr, nullptr, other.mRoot[0]);
-		if constexpr (sizeof...(Cs) > 0)
+		mRoot[0] = SNode<K, C, Cs ...>::template Clone<MNode<K, V, C, Cs ...>, 0>(reinterpret_cast<SNode<K, C, Cs ...> const*>(other.mRoot[0]), Copy, threads);
+		TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>::Thread(mRoot[0], nullptr, nullptr, threads);
+		if constexpr (Dimension<C, Cs ...> > 1)
 			SNode<K, C, Cs ...>::template BuildTree<MNode<K, V, C, Cs ...>, Exception>(mRoot);
+		rehash();
 	}
 }
 
@@ -25,7 +117,8 @@ void
 swap(Map<K, V, C, Cs ...>& a, Map<K, V, C, Cs ...>& b) noexcept
 {
 	std::swap(a.mSize, b.mSize);
-	std::swap_ranges(a.mRoot, a.mRoot + sizeof...(Cs) + 1, b.mRoot);
+	std::swap_ranges(a.mRoot, a.mRoot + Dimension<C, Cs ...>, b.mRoot);
+	swap(a.mHash, b.mHash);
 }
 
 template <typename K, typename V, typename C, typename ... Cs>
@@ -45,8 +138,9 @@ requires
 {
 	if (mSize) {
 		mRoot[0] = MNode<K, V, C, Cs ...>::Create(nullptr, nullptr, input);
-		if constexpr (sizeof...(Cs) > 0)
+		if constexpr (Dimension<C, Cs ...> > 1)
 			SNode<K, C, Cs ...>::template BuildTree<MNode<K, V, C, Cs ...>, Exception>(mRoot);
+		rehash();
 	}
 }
 
@@ -60,8 +154,9 @@ requires
 {
 	if (mSize) {
 		mRoot[0] = MNode<K, V, C, Cs ...>::Create(nullptr, nullptr, input, vArgs);
-		if constexpr (sizeof...(Cs) > 0)
+		if constexpr (Dimension<C, Cs ...> > 1)
 			SNode<K, C, Cs ...>::template BuildTree<MNode<K, V, C, Cs ...>, Exception>(mRoot);
+		rehash();
 	}
 }
 
@@ -75,8 +170,9 @@ requires
 {
 	if (mSize) {
 		mRoot[0] = MNode<K, V, C, Cs ...>::Create(nullptr, nullptr, kArgs, input);
-		if constexpr (sizeof...(Cs) > 0)
+		if constexpr (Dimension<C, Cs ...> > 1)
 			SNode<K, C, Cs ...>::template BuildTree<MNode<K, V, C, Cs ...>, Exception>(mRoot);
+		rehash();
 	}
 }
 
@@ -90,8 +186,9 @@ requires
 {
 	if (mSize) {
 		mRoot[0] = MNode<K, V, C, Cs ...>::Create(nullptr, nullptr, kArgs, input, vArgs);
-		if constexpr (sizeof...(Cs) > 0)
+		if constexpr (Dimension<C, Cs ...> > 1)
 			SNode<K, C, Cs ...>::template BuildTree<MNode<K, V, C, Cs ...>, Exception>(mRoot);
+		rehash();
 	}
 }
 
@@ -106,8 +203,9 @@ requires
 {
 	if (mSize) {
 		mRoot[0] = MNode<K, V, C, Cs ...>::Create(nullptr, nullptr, input, vArgs);
-		if constexpr (sizeof...(Cs) > 0)
+		if constexpr (Dimension<C, Cs ...> > 1)
 			SNode<K, C, Cs ...>::template BuildTree<MNode<K, V, C, Cs ...>, Exception>(mRoot);
+		rehash();
 	}
 }
 
@@ -119,8 +217,9 @@ requires Stream::Deserializable<K, decltype(input), KArgs ...>
 {
 	if (mSize) {
 		mRoot[0] = MNode<K, V, C, Cs ...>::Create(nullptr, nullptr, input, kArgs, DP::Factory<V, VType, VArgs ...>{}, std::forward<decltype(vArgs)>(vArgs) ...);
-		if constexpr (sizeof...(Cs) > 0)
+		if constexpr (Dimension<C, Cs ...> > 1)
 			SNode<K, C, Cs ...>::template BuildTree<MNode<K, V, C, Cs ...>, Exception>(mRoot);
+		rehash();
 	}
 }
 template <typename K, typename V, typename C, typename ... Cs>
@@ -131,8 +230,9 @@ requires Stream::Deserializable<V, decltype(input), decltype(vArgs) ...>
 {
 	if (mSize) {
 		mRoot[0] = MNode<K, V, C, Cs ...>::Create(nullptr, nullptr, DP::Factory<K, KType, KArgs ...>{}, std::forward<decltype(kArgs)>(kArgs) ..., input, std::forward<decltype(vArgs)>(vArgs) ...);
-		if constexpr (sizeof...(Cs) > 0)
+		if constexpr (Dimension<C, Cs ...> > 1)
 			SNode<K, C, Cs ...>::template BuildTree<MNode<K, V, C, Cs ...>, Exception>(mRoot);
+		rehash();
 	}
 }
 
@@ -143,8 +243,9 @@ Map<K, V, C, Cs ...>::Map(DP::Factory<K, KType, KArgs ...>, auto&& ... kArgs, St
 {
 	if (mSize) {
 		mRoot[0] = MNode<K, V, C, Cs ...>::Create(nullptr, nullptr, DP::Factory<K, KType, KArgs ...>{}, std::forward<decltype(kArgs)>(kArgs) ..., input, DP::Factory<V, VType, VArgs ...>{}, std::forward<decltype(vArgs)>(vArgs) ...);
-		if constexpr (sizeof...(Cs) > 0)
+		if constexpr (Dimension<C, Cs ...> > 1)
 			SNode<K, C, Cs ...>::template BuildTree<MNode<K, V, C, Cs ...>, Exception>(mRoot);
+		rehash();
 	}
 }
 */
@@ -172,7 +273,7 @@ requires
 	mRoot[N]->template toDot<N>(dotOutput);
 	reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template toDot<N>(dotOutput);
 	reinterpret_cast<MNode<K, V, C, Cs ...>*>(mRoot[N])->template toDot<N>(dotOutput);
-	if constexpr (N < sizeof...(Cs))
+	if constexpr (N + 1 < Dimension<C, Cs ...>)
 		return toDot<N + 1>(dotOutput);
 	return dotOutput;
 }
@@ -191,50 +292,90 @@ requires Stream::InsertableTo<K, decltype(dotOutput)> && Stream::InsertableTo<V,
 
 template <typename K, typename V, typename C, typename ... Cs>
 Map<K, V, C, Cs ...>::~Map()
+{
+	if (mRoot[0]) {
+		PolicyOf<Reclaimer, Reclaimer, Cs ...>::reclaim(mRoot[0], [](void* root) {
+			static_cast<TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>*>(root)->template deleteTree<MNode<K, V, C, Cs ...>>();
+		});
+	}
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+void
+Map<K, V, C, Cs ...>::clear(unsigned threads) noexcept
 {
 	if (mRoot[0])
-		mRoot[0]->template deleteTree<MNode<K, V, C, Cs ...>>();
+		mRoot[0]->template deleteTree<MNode<K, V, C, Cs ...>>(threads);
+	std::fill(mRoot, mRoot + Dimension<C, Cs ...>, nullptr);
+	mSize = 0;
+	mHash.clear();
 }
 
 template <typename K, typename V, typename C, typename ... Cs>
-template <std::size_t N>
+FrozenMap<K, V, C, Cs ...>
+Map<K, V, C, Cs ...>::freeze() const
+requires std::is_copy_constructible_v<K> && std::is_copy_constructible_v<V>
+{ return FrozenMap<K, V, C, Cs ...>(*this); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N, std::size_t Skip>
 MNode<K, V, C, Cs ...>*
 Map<K, V, C, Cs ...>::putAsRoot(MNode<K, V, C, Cs ...>* created) noexcept
 {
-	mRoot[N] = created;
-	created->template left<N>(nullptr);
-	created->template right<N>(nullptr);
-	created->template state<N>(2);
-	if constexpr (N < sizeof...(Cs))
-		return putAsRoot<N + 1>(created);
+	if constexpr (N != Skip) {
+		mRoot[N] = created;
+		created->template left<N>(nullptr);
+		created->template right<N>(nullptr);
+		created->template state<N>(2);
+		created->d[N].cnt = 1;
+	}
+	if constexpr (N + 1 < Dimension<C, Cs ...>)
+		return putAsRoot<N + 1, Skip>(created);
 	++mSize;
+	if (!mHash.put(created))
+		rehash();
 	return created;
 }
 
 template <typename K, typename V, typename C, typename ... Cs>
-template <std::size_t N>
+template <std::size_t N, std::size_t Skip>
 MNode<K, V, C, Cs ...>*
 Map<K, V, C, Cs ...>::putToRoot(MNode<K, V, C, Cs ...>* created) noexcept
 {
-	auto* m = created;
-	if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template attach<N>(reinterpret_cast<TNode<sizeof...(Cs) + 1>**>(&created)))
-		mRoot[N] = t;
-	else if (m != created) { // found an existing node
-		delete m;
+	if constexpr (N == Skip) {
+		if constexpr (N + 1 < Dimension<C, Cs ...>)
+			return putToRoot<N + 1, Skip>(created);
+		++mSize;
+		if (!mHash.put(created))
+			rehash();
 		return created;
-	}
-	if constexpr (N < sizeof...(Cs)) {
-		created = putToRoot<N + 1>(created);
-		if (m != created) { // later comparators found an existing node
-			// rollback last attachment
-			if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template detach<N>(reinterpret_cast<TNode<sizeof...(Cs) + 1>**>(&m)))
-				mRoot[N] = t;
+	} else {
+		// validate the later comparators first so that a collision leaves every index untouched,
+		// the node equal on the Nth index is still the one returned
+		if constexpr (N + 1 < Dimension<C, Cs ...>) {
+			if (auto* e = SNode<K, C, Cs ...>::template Collision<N + 1, Skip>(mRoot, created)) {
+				if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template get<N>(static_cast<K const&>(created->key)))
+					e = reinterpret_cast<SNode<K, C, Cs ...>*>(t);
+				if constexpr (N == 0 && Skip >= Dimension<C, Cs ...>)
+					delete created;
+				return reinterpret_cast<MNode<K, V, C, Cs ...>*>(e);
+			}
 		}
+		TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* e = created;
+		if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template attach<N>(&e))
+			mRoot[N] = t;
+		else if (e != created) { // found an existing node
+			if constexpr (N == 0 && Skip >= Dimension<C, Cs ...>) // otherwise created is still linked to the Skip index
+				delete created;
+			return reinterpret_cast<MNode<K, V, C, Cs ...>*>(e);
+		}
+		if constexpr (N + 1 < Dimension<C, Cs ...>)
+			SNode<K, C, Cs ...>::template AttachAll<N + 1, Skip>(mRoot, created);
+		++mSize;
+		if (!mHash.put(created))
+			rehash();
 		return created;
 	}
-	// last comparator is successful
-	++mSize;
-	return created;
 }
 
 template <typename K, typename V, typename C, typename ... Cs>
@@ -243,16 +384,136 @@ Map<K, V, C, Cs ...>::put(MNode<K, V, C, Cs ...>* created) noexcept
 { return mRoot[0] ? putToRoot(created) : putAsRoot(created); }
 
 
+template <typename K, typename V, typename C, typename ... Cs>
+MNode<K, V, C, Cs ...>*
+Map<K, V, C, Cs ...>::emplace(bool& created, auto const& create, auto const& k)
+{
+	// attaching resets the state of the node, including whether create() gave it a value
+	bool hasValue;
+	auto make = [&] {
+		auto* t = create();
+		hasValue = t->d[0].hasValue;
+		return t;
+	};
+	if (!mRoot[0]) {
+		created = true;
+		auto* m = putAsRoot(make());
+		m->d[0].hasValue = hasValue;
+		return m;
+	}
+	TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* found;
+	if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[0])->template emplace<0>(found, created, make, k))
+		mRoot[0] = t;
+	auto* m = reinterpret_cast<MNode<K, V, C, Cs ...>*>(found);
+	if (created) {
+		m->d[0].hasValue = hasValue;
+		if (auto* e = putToRoot<0, 0>(m); e != m) { // other comparators found an existing node
+			auto* toDel = found;
+			if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[0])->template detach<0>(&toDel))
+				mRoot[0] = t;
+			delete m;
+			created = false;
+			return e;
+		}
+	}
+	return m;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+MNode<K, V, C, Cs ...>*
+Map<K, V, C, Cs ...>::put(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* hint, MNode<K, V, C, Cs ...>* created) noexcept
+{
+	if (!hint)
+		return put(created);
+	CountedAt<N, C, Cs ...> cmp;
+	auto* h = reinterpret_cast<MNode<K, V, C, Cs ...>*>(hint);
+	bool last;
+	auto const order = Compare(cmp, static_cast<K const&>(h->key), static_cast<K const&>(created->key));
+	if (order < 0) {
+		if (h->template next<N>())
+			return put(created);
+		last = true;
+	} else if (order > 0) {
+		if (h->template prev<N>())
+			return put(created);
+		last = false;
+	} else {
+		delete created;
+		return h;
+	}
+	if constexpr (Dimension<C, Cs ...> > 1) {
+		if (auto* e = SNode<K, C, Cs ...>::template Collision<0, N>(mRoot, created)) {
+			delete created;
+			return reinterpret_cast<MNode<K, V, C, Cs ...>*>(e);
+		}
+	}
+	auto* r = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N]);
+	if (auto* t = last ? r->template attachLast<N>(created) : r->template attachFirst<N>(created))
+		mRoot[N] = t;
+	if constexpr (Dimension<C, Cs ...> > 1)
+		SNode<K, C, Cs ...>::template AttachAll<0, N>(mRoot, created);
+	++mSize;
+	if (!mHash.put(created))
+		rehash();
+	return created;
+}
+
 template <typename K, typename V, typename C, typename ... Cs>
 typename Map<K, V, C, Cs ...>::template iterator<>
 Map<K, V, C, Cs ...>::put(auto&& ... kArgs)
-{ return put(::new MNode<K, V, C, Cs ...>(std::forward<decltype(kArgs)>(kArgs) ...)); }
+{ return put(new MNode<K, V, C, Cs ...>(std::forward<decltype(kArgs)>(kArgs) ...)); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t N>
+typename Map<K, V, C, Cs ...>::template iterator<>
+Map<K, V, C, Cs ...>::put(Iterator<d, c, N> hint, auto&& ... kArgs)
+{
+	// end() of the Nth index stands for its last element, or its first one backwards
+	TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* h = hint.pos;
+	if (!h && mRoot[N])
+		h = d == Direction::FORWARD ? mRoot[N]->template rightMost<N>() : mRoot[N]->template leftMost<N>();
+	return put<N>(h, new MNode<K, V, C, Cs ...>(std::forward<decltype(kArgs)>(kArgs) ...));
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+std::pair<typename Map<K, V, C, Cs ...>::template iterator<>, bool>
+Map<K, V, C, Cs ...>::tryPut(auto&& k, auto&& ... vArgs)
+{
+	bool created{false};
+	auto* m = emplace(created, [&] {
+		auto* t = new MNode<K, V, C, Cs ...>(std::forward<decltype(k)>(k));
+		if constexpr (sizeof...(vArgs) > 0) {
+			try {
+				t->set(std::forward<decltype(vArgs)>(vArgs) ...);
+			} catch (...) {
+				delete t;
+				throw;
+			}
+		}
+		return t;
+	}, k);
+	return {iterator<>(m), created};
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+V&
+Map<K, V, C, Cs ...>::getOrPut(auto&& k, auto&& ... vArgs)
+{
+	// vArgs are consumed only if a node is created
+	auto i = tryPut(std::forward<decltype(k)>(k), std::forward<decltype(vArgs)>(vArgs) ...).first;
+	if (i.hasValue())
+		return *reinterpret_cast<MNode<K, V, C, Cs ...>*>(i.pos)->val;
+	auto& v = i.set(std::forward<decltype(vArgs)>(vArgs) ...);
+	refresh(i);
+	return v;
+}
 
 template <typename K, typename V, typename C, typename ... Cs>
 template <EqDerived<K> DK>
 typename Map<K, V, C, Cs ...>::template iterator<>
 Map<K, V, C, Cs ...>::put(auto&& ... dkArgs)
-{ return put(reinterpret_cast<MNode<K, V, C, Cs ...>*>(::new MNode<DK, V>(std::forward<decltype(dkArgs)>(dkArgs) ...))); }
+{ return put(reinterpret_cast<MNode<K, V, C, Cs ...>*>(new MNode<DK, V, C, Cs ...>(std::forward<decltype(dkArgs)>(dkArgs) ...))); }
 
 template <typename K, typename V, typename C, typename ... Cs>
 template <typename ... KArgs>
@@ -261,7 +522,7 @@ Map<K, V, C, Cs ...>::put(DP::CreateInfo<K, KArgs ...> const& kCreateInfo, auto&
 {
 	if (kCreateInfo.size > sizeof(K))
 		throw Exception(MException::Code::LargerKey, "kCreateInfo.size is greater than the size of K.");
-	return put(::new MNode<K, V, C, Cs ...>(kCreateInfo, std::forward<decltype(kArgs)>(kArgs) ...));
+	return put(new MNode<K, V, C, Cs ...>(kCreateInfo, std::forward<decltype(kArgs)>(kArgs) ...));
 }
 
 
@@ -269,13 +530,13 @@ template <typename K, typename V, typename C, typename ... Cs>
 template <Derived<V> DV>
 typename Map<K, V, C, Cs ...>::template iterator<>
 Map<K, V, C, Cs ...>::putDV(auto&& ... kArgs)
-{ return put(reinterpret_cast<MNode<K, V, C, Cs ...>*>(::new MNode<K, DV>(std::forward<decltype(kArgs)>(kArgs) ...))); }
+{ return put(reinterpret_cast<MNode<K, V, C, Cs ...>*>(new MNode<K, DV, C, Cs ...>(std::forward<decltype(kArgs)>(kArgs) ...))); }
 
 template <typename K, typename V, typename C, typename ... Cs>
 template <EqDerived<K> DK, Derived<V> DV>
 typename Map<K, V, C, Cs ...>::template iterator<>
 Map<K, V, C, Cs ...>::putDV(auto&& ... dkArgs)
-{ return put(reinterpret_cast<MNode<K, V, C, Cs ...>*>(::new MNode<DK, DV>(std::forward<decltype(dkArgs)>(dkArgs) ...))); }
+{ return put(reinterpret_cast<MNode<K, V, C, Cs ...>*>(new MNode<DK, DV, C, Cs ...>(std::forward<decltype(dkArgs)>(dkArgs) ...))); }
 
 template <typename K, typename V, typename C, typename ... Cs>
 template <typename ... KArgs, Derived<V> DV>
@@ -284,7 +545,7 @@ Map<K, V, C, Cs ...>::putDV(DP::CreateInfo<K, KArgs ...> const& kCreateInfo, aut
 {
 	if (kCreateInfo.size > sizeof(K))
 		throw Exception(MException::Code::LargerKey, "kCreateInfo.size is greater than the size of K.");
-	return put(reinterpret_cast<MNode<K, V, C, Cs ...>*>(::new MNode<K, DV>(kCreateInfo, std::forward<decltype(kArgs)>(kArgs) ...)));
+	return put(reinterpret_cast<MNode<K, V, C, Cs ...>*>(new MNode<K, DV, C, Cs ...>(kCreateInfo, std::forward<decltype(kArgs)>(kArgs) ...)));
 }
 
 
@@ -298,7 +559,7 @@ template <typename K, typename V, typename C, typename ... Cs>
 template <EqDerived<K> DK, typename ... VArgs>
 typename Map<K, V, C, Cs ...>::template iterator<>
 Map<K, V, C, Cs ...>::putFV(DP::CreateInfo<V, VArgs ...> const& vCreateInfo, auto&& ... dkArgs)
-{ return put(reinterpret_cast<MNode<K, V, C, Cs ...>*>(new(vCreateInfo.size) MNode<DK, V>(std::forward<decltype(dkArgs)>(dkArgs) ...))); }
+{ return put(reinterpret_cast<MNode<K, V, C, Cs ...>*>(new(vCreateInfo.size) MNode<DK, V, C, Cs ...>(std::forward<decltype(dkArgs)>(dkArgs) ...))); }
 
 template <typename K, typename V, typename C, typename ... Cs>
 template <typename ... KArgs, typename ... VArgs>
@@ -317,18 +578,21 @@ MNode<K, V, C, Cs ...>*
 Map<K, V, C, Cs ...>::remove(MNode<K, V, C, Cs ...>* toDel) noexcept
 {
 	auto* m = toDel;
-	if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template detach<N>(reinterpret_cast<TNode<sizeof...(Cs) + 1>**>(&toDel)))
+	TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* d = toDel;
+	if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template detach<N>(&d))
 		mRoot[N] = t;
-	else if (m != toDel)
-		return toDel;
-	if constexpr (N < sizeof...(Cs)) {
+	else if (d != m)
+		return reinterpret_cast<MNode<K, V, C, Cs ...>*>(d);
+	toDel = reinterpret_cast<MNode<K, V, C, Cs ...>*>(d);
+	if constexpr (N + 1 < Dimension<C, Cs ...>) {
 		toDel = remove<N + 1>(toDel);
 		if (m != toDel) {
 			// later comparators found another one or could not find it at all
 			// if it is root it means nothing happened already
 			if (m != mRoot[N]) {
 				// rollback last detachment
-				if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template attach<N>(reinterpret_cast<TNode<sizeof...(Cs) + 1>**>(&m)))
+				d = m;
+				if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template attach<N>(&d))
 					mRoot[N] = t;
 			}
 		} else if (m == mRoot[N])
@@ -338,6 +602,7 @@ Map<K, V, C, Cs ...>::remove(MNode<K, V, C, Cs ...>* toDel) noexcept
 	// last comparator is successful
 	if (m == mRoot[N])
 		mRoot[N] = nullptr;
+	mHash.remove(m);
 	delete m;
 	--mSize;
 	return toDel;
@@ -354,7 +619,10 @@ template <std::size_t N>
 bool
 Map<K, V, C, Cs ...>::remove(auto&& ... args) noexcept
 {
-	if (mRoot[N]) {
+	if constexpr (N == HashedIndex) {
+		if (auto* m = mHash.get(mRoot[0], args ...))
+			return m == remove(m);
+	} else if (mRoot[N]) {
 		if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template get<N>(std::forward<decltype(args)>(args) ...))
 			return t == remove(reinterpret_cast<MNode<K, V, C, Cs ...>*>(t));
 	}
@@ -363,42 +631,327 @@ Map<K, V, C, Cs ...>::remove(auto&& ... args) noexcept
 
 template <typename K, typename V, typename C, typename ... Cs>
 template <std::size_t N>
-typename Map<K, V, C, Cs ...>::template iterator<N>
+typename Map<K, V, C, Cs ...>::template iterator<OrderedIndex<N, C, Cs ...>>
 Map<K, V, C, Cs ...>::get(auto&& ... args) noexcept
-{ return mRoot[N] ? reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template get<N>(std::forward<decltype(args)>(args) ...) : nullptr; }
+{
+	if constexpr (N == HashedIndex)
+		return mHash.get(mRoot[0], args ...);
+	else
+		return mRoot[N] ? reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template get<N>(std::forward<decltype(args)>(args) ...) : nullptr;
+}
 
 template <typename K, typename V, typename C, typename ... Cs>
 template <std::size_t N>
-typename Map<K, V, C, Cs ...>::template const_iterator<N>
+typename Map<K, V, C, Cs ...>::template const_iterator<OrderedIndex<N, C, Cs ...>>
 Map<K, V, C, Cs ...>::get(auto&& ... args) const noexcept
 { return const_cast<Map*>(this)->template get<N>(std::forward<decltype(args)>(args) ...); }
 
 template <typename K, typename V, typename C, typename ... Cs>
 template <std::size_t N>
-typename Map<K, V, C, Cs ...>::template iterator<N>
-Map<K, V, C, Cs ...>::at(std::uint64_t i) noexcept
-{ // TODO: O(n)->O(logn) childCount?
-	iterator<N> it(nullptr);
-	if (mRoot[N]) {
-		if (i < mSize / 2) {
-			it.pos = mRoot[N]->template leftMost<N>();
-			for (std::uint64_t j{0}; j < i; ++j)
-				++it;
-		} else {
-			it.pos = mRoot[N]->template rightMost<N>();
-			for (std::uint64_t j = mSize - 1; i < j; --j)
-				--it;
-		}
+auto
+Map<K, V, C, Cs ...>::getMany(auto first, auto last, auto out) noexcept
+{
+	SNode<K, C, Cs ...>::template GetMany<N>(mRoot[N], first, last, [&](TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* t) {
+		*out = iterator<N>(t);
+		++out;
+	});
+	return out;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+auto
+Map<K, V, C, Cs ...>::getMany(auto first, auto last, auto out) const noexcept
+{
+	SNode<K, C, Cs ...>::template GetMany<N>(mRoot[N], first, last, [&](TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* t) {
+		*out = const_iterator<N>(t);
+		++out;
+	});
+	return out;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N, Constness c>
+std::uint64_t
+Map<K, V, C, Cs ...>::remove(Iterator<Direction::FORWARD, c, N> first, Iterator<Direction::FORWARD, c, N> last) noexcept
+{
+	if (!mRoot[N] || !first.pos)
+		return 0;
+	auto m = SNode<K, C, Cs ...>::template Erase<MNode<K, V, C, Cs ...>, N>(mRoot, mSize, first.pos, last.pos);
+	mSize -= m;
+	rehash();
+	return m;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+Map<K, V, C, Cs ...>
+Map<K, V, C, Cs ...>::splitAt(auto&& ... args) noexcept
+{
+	Map upper;
+	if (!mRoot[N])
+		return upper;
+	if (auto* r = SNode<K, C, Cs ...>::template Cut<N>(mRoot, mSize, std::forward<decltype(args)>(args) ...)) {
+		mSize -= r->d[N].cnt;
+		rehash();
+		upper.template adopt<N>(r);
 	}
-	return it;
+	return upper;
 }
 
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+bool
+Map<K, V, C, Cs ...>::concat(Map&& other) noexcept
+{
+	if (!other.mRoot[N])
+		return true;
+	if (!mRoot[N]) {
+		swap(*this, other);
+		return true;
+	}
+	if (!Precedes(CountedAt<N, C, Cs ...>{},
+			static_cast<K const&>(mRoot[N]->template rightMost<N, SNode<K, C, Cs ...>>()->key),
+			static_cast<K const&>(other.mRoot[N]->template leftMost<N, SNode<K, C, Cs ...>>()->key)))
+		return false;
+	auto* t = other.mRoot[N]->template leftMost<N, MNode<K, V, C, Cs ...>>();
+	mRoot[N] = TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>::template Append<N, BalancingOf<C, Cs ...>>(mRoot[N], other.mRoot[N]);
+	if constexpr (Dimension<C, Cs ...> > 1) {
+		while (t) {
+			auto* m = t;
+			t = t->template next<N, MNode<K, V, C, Cs ...>>();
+			bool const hasValue = m->d[0].hasValue;
+			auto* e = putToRoot<0, N>(m);
+			m->d[0].hasValue = hasValue;
+			if (e != m) { // other comparators found an existing node
+				TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* toDel = m;
+				if (auto* r = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template detach<N>(&toDel))
+					mRoot[N] = r;
+				delete m;
+			}
+		}
+	} else
+		mSize += other.mSize;
+	std::fill(other.mRoot, other.mRoot + Dimension<C, Cs ...>, nullptr);
+	other.mSize = 0;
+	other.mHash.clear();
+	rehash();
+	return true;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <typename S, std::size_t N>
+void
+Map<K, V, C, Cs ...>::merge(Map&& other, auto&& ... args)
+requires Selector<S, K, decltype(args) ...>
+{
+	if (&other == this)
+		return;
+	S selector;
+	auto* b = std::exchange(other.mRoot[N], nullptr);
+	std::fill(other.mRoot, other.mRoot + Dimension<C, Cs ...>, nullptr);
+	other.mSize = 0;
+	other.mHash.clear();
+	// the nodes of both trees are being relinked when S throws, the merge completes keeping the elements of this
+	// container for the remaining keys in both before the exception is rethrown
+	std::exception_ptr error;
+	auto select = [&](K const& i, K const& j) noexcept -> K const& {
+		if (!error) {
+			try {
+				return selector(i, j, std::forward<decltype(args)>(args) ...);
+			} catch (...) {
+				error = std::current_exception();
+			}
+		}
+		return i;
+	};
+	if (mSize >= (b ? b->d[N].cnt : 0))
+		mergeInPlace<N, true, true, true, true>(b, select);
+	else // split the larger tree around the keys of the smaller one
+		mergeInPlace<N, true, true, true, true>(std::exchange(mRoot[N], b), [&](K const& j, K const& i) noexcept -> K const&
+		{ return select(i, j); });
+	if (error)
+		std::rethrow_exception(error);
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+void
+Map<K, V, C, Cs ...>::subtract(Map const& other) noexcept
+{
+	if (&other == this)
+		*this = Map();
+	else if (mRoot[N] && other.mRoot[N])
+		mergeInPlace<N, true, false, false, false>(other.mRoot[N], nullptr);
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+void
+Map<K, V, C, Cs ...>::retain(Map const& other) noexcept
+{
+	if (mRoot[N] && &other != this)
+		mergeInPlace<N, false, false, true, false>(other.mRoot[N], [](K const& i, K const&) noexcept -> K const& { return i; });
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename Map<K, V, C, Cs ...>::template iterator<N>
+Map<K, V, C, Cs ...>::lowerBound(auto&& ... args) noexcept
+{ return mRoot[N] ? reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template lowerBound<N>(std::forward<decltype(args)>(args) ...) : nullptr; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename Map<K, V, C, Cs ...>::template const_iterator<N>
+Map<K, V, C, Cs ...>::lowerBound(auto&& ... args) const noexcept
+{ return const_cast<Map*>(this)->template lowerBound<N>(std::forward<decltype(args)>(args) ...); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename Map<K, V, C, Cs ...>::template iterator<N>
+Map<K, V, C, Cs ...>::upperBound(auto&& ... args) noexcept
+{ return mRoot[N] ? reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template upperBound<N>(std::forward<decltype(args)>(args) ...) : nullptr; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename Map<K, V, C, Cs ...>::template const_iterator<N>
+Map<K, V, C, Cs ...>::upperBound(auto&& ... args) const noexcept
+{ return const_cast<Map*>(this)->template upperBound<N>(std::forward<decltype(args)>(args) ...); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+std::pair<typename Map<K, V, C, Cs ...>::template iterator<N>, typename Map<K, V, C, Cs ...>::template iterator<N>>
+Map<K, V, C, Cs ...>::equalRange(auto&& ... args) noexcept
+{ return {lowerBound<N>(args ...), upperBound<N>(args ...)}; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+std::pair<typename Map<K, V, C, Cs ...>::template const_iterator<N>, typename Map<K, V, C, Cs ...>::template const_iterator<N>>
+Map<K, V, C, Cs ...>::equalRange(auto&& ... args) const noexcept
+{ return const_cast<Map*>(this)->template equalRange<N>(std::forward<decltype(args)>(args) ...); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename Map<K, V, C, Cs ...>::template iterator<N>
+Map<K, V, C, Cs ...>::at(std::uint64_t i) noexcept
+{ return mRoot[N] ? mRoot[N]->template at<N>(i) : nullptr; }
+
 template <typename K, typename V, typename C, typename ... Cs>
 template <std::size_t N>
 typename Map<K, V, C, Cs ...>::template const_iterator<N>
 Map<K, V, C, Cs ...>::at(std::uint64_t i) const noexcept
 { return const_cast<Map*>(this)->at<N>(i); }
 
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+std::uint64_t
+Map<K, V, C, Cs ...>::rank(auto&& ... args) const noexcept
+{ return mRoot[N] ? reinterpret_cast<SNode<K, C, Cs ...> const*>(mRoot[N])->template rank<N>(std::forward<decltype(args)>(args) ...) : 0; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+std::uint64_t
+Map<K, V, C, Cs ...>::count(auto const& lo, auto const& hi) const noexcept
+{
+	auto l = rank<N>(lo);
+	auto h = rank<N>(hi);
+	return l < h ? h - l : 0;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+AggregateOf<N, C, Cs ...>
+Map<K, V, C, Cs ...>::aggregate()
+requires (!std::is_void_v<MonoidOf<N, C, Cs ...>>)
+{
+	return mRoot[N]
+		? reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template aggregate<N>(Of<N>)
+		: MonoidOf<N, C, Cs ...>::identity();
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+AggregateOf<N, C, Cs ...>
+Map<K, V, C, Cs ...>::aggregate(auto const& lo, auto const& hi)
+requires (!std::is_void_v<MonoidOf<N, C, Cs ...>>)
+{
+	return mRoot[N]
+		? reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template aggregate<N>(Of<N>, lo, hi)
+		: MonoidOf<N, C, Cs ...>::identity();
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename Map<K, V, C, Cs ...>::template iterator<N>
+Map<K, V, C, Cs ...>::search(auto const& pred)
+requires (!std::is_void_v<MonoidOf<N, C, Cs ...>>)
+{ return mRoot[N] ? reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template search<N>(Of<N>, pred) : nullptr; }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+void
+Map<K, V, C, Cs ...>::Diff(SNode<K, C, Cs ...>* t, Map& b, K const* lo, K const* hi, auto& out)
+{
+	using M = MonoidOf<N, C, Cs ...>;
+	CountedAt<N, C, Cs ...> cmp;
+	auto below = [&](K const& k) { return lo && !Precedes(cmp, *lo, k); };
+	auto above = [&](K const& k) { return hi && !Precedes(cmp, k, *hi); };
+	auto const inB = b.mRoot[N]
+		? reinterpret_cast<SNode<K, C, Cs ...>*>(b.mRoot[N])->template aggregateWithin<N>(Of<N>, below, above)
+		: M::identity();
+	if (t ? t->template aggregate<N>(Of<N>) == inB : inB == M::identity())
+		return;
+	if (!t) { // every element of b in the range is missing from a
+		for (iterator<N> j = lo ? b.template upperBound<N>(*lo) : b.template begin<N>(); j && !above(j->key); ++j)
+			out(iterator<N>(nullptr), j);
+		return;
+	}
+	K const& key = t->key;
+	Diff<N>(t->d[N].hasLeft ? t->template left<N, SNode<K, C, Cs ...>>() : nullptr, b, lo, &key, out);
+	auto j = b.template get<N>(key);
+	if (!j || Of<N>(t) != Of<N>(reinterpret_cast<SNode<K, C, Cs ...>*>(j.pos)))
+		out(iterator<N>(t), j);
+	Diff<N>(t->d[N].hasRight ? t->template right<N, SNode<K, C, Cs ...>>() : nullptr, b, &key, hi, out);
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+void
+Map<K, V, C, Cs ...>::diff(Map& a, Map& b, auto&& out)
+requires (!std::is_void_v<MonoidOf<N, C, Cs ...>>)
+{
+	if (&a != &b)
+		Diff<N>(reinterpret_cast<SNode<K, C, Cs ...>*>(a.mRoot[N]), b, nullptr, nullptr, out);
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+void
+Map<K, V, C, Cs ...>::invalidate(MNode<K, V, C, Cs ...> const* m) noexcept
+{
+	if constexpr (!std::is_void_v<MonoidOf<N, C, Cs ...>>)
+		reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template invalidate<N>(m);
+	if constexpr (N + 1 < Dimension<C, Cs ...>)
+		invalidate<N + 1>(m);
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <Direction d, Constness c, std::size_t N>
+void
+Map<K, V, C, Cs ...>::refresh(Iterator<d, c, N> i) noexcept
+{
+	if constexpr (IsAugmented<C, Cs ...>) {
+		if (i.pos)
+			invalidate(reinterpret_cast<MNode<K, V, C, Cs ...>*>(i.pos));
+	}
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+auto
+Map<K, V, C, Cs ...>::stats() noexcept
+requires (!std::is_same_v<PolicyOf<Stats, Stats, C, Cs ...>, Stats>)
+{ return PolicyOf<Stats, Stats, C, Cs ...>::read(); }
+
 template <typename K, typename V, typename C, typename ... Cs>
 template <std::size_t N>
 typename Map<K, V, C, Cs ...>::template iterator<N>
@@ -473,7 +1026,7 @@ Map<K, V, C, Cs ...>::crend() const noexcept
 
 template <typename K, typename V, typename C, typename ... Cs>
 template <Direction d, Constness c, std::size_t n>
-Map<K, V, C, Cs ...>::Iterator<d, c, n>::Iterator(TNode<sizeof...(Cs) + 1>* pos) noexcept
+Map<K, V, C, Cs ...>::Iterator<d, c, n>::Iterator(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* pos) noexcept
 		: pos(pos)
 {}
 
@@ -591,22 +1144,40 @@ template <std::size_t N>
 Map<K, V, C, Cs ...>
 Map<K, V, C, Cs ...>::Difference<N>::operator()(Map const& a, Map const& b) const
 {
-	Map map;
+	if (threads > 1 && a && b)
+		return Merge<N, true, false, false>(a, b, threads, nullptr);
+
+	BulkBuilder<N> builder;
 	if (a) {
 		if (b) {
-			TypeAt<N, C, Cs ...> cmp;
+			// look the keys of a up in b if cheaper than walking both
+			if (a.size() * std::bit_width(b.size()) < b.size()) {
+				for (auto* i = a.mRoot[N]->template leftMost<N, MNode<K, V, C, Cs ...>>(); i; i = i->template next<N, MNode<K, V, C, Cs ...>>()) {
+					if (!reinterpret_cast<SNode<K, C, Cs ...>*>(b.mRoot[N])->template get<N>(static_cast<K const&>(i->key))) {
+						auto* c = new MNode<K, V, C, Cs ...>(static_cast<K const&>(i->key));
+						builder.push(c);
+						if (i->d[0].hasValue)
+							c->set(static_cast<V const&>(i->val));
+					}
+				}
+				return builder.build();
+			}
+
+			CountedAt<N, C, Cs ...> cmp;
 			auto* i = a.mRoot[N]->template leftMost<N, MNode<K, V, C, Cs...>>();
 			auto* j = b.mRoot[N]->template leftMost<N, MNode<K, V, C, Cs...>>();
 
 			do {
-				if (cmp(static_cast<K const&>(i->key), static_cast<K const&>(j->key))) {
-					auto c = map.put(static_cast<K const&>(i->key));
-					if (i->d[N].hasValue)
-						c.set(static_cast<V const&>(i->val));
+				auto const order = Compare(cmp, static_cast<K const&>(i->key), static_cast<K const&>(j->key));
+				if (order < 0) {
+					auto* c = new MNode<K, V, C, Cs ...>(static_cast<K const&>(i->key));
+					builder.push(c);
+					if (i->d[0].hasValue)
+						c->set(static_cast<V const&>(i->val));
 					i = i->template next<N, MNode<K, V, C, Cs...>>();
 					continue;
 				}
-				if (cmp(static_cast<K const&>(j->key), static_cast<K const&>(i->key))) {
+				if (order > 0) {
 					j = j->template next<N, MNode<K, V, C, Cs...>>();
 					continue;
 				}
@@ -615,15 +1186,16 @@ Map<K, V, C, Cs ...>::Difference<N>::operator()(Map const& a, Map const& b) cons
 			} while (i && j);
 
 			while (i) {
-				auto c = map.put(static_cast<K const&>(i->key));
-				if (i->d[N].hasValue)
-					c.set(static_cast<V const&>(i->val));
+				auto* c = new MNode<K, V, C, Cs ...>(static_cast<K const&>(i->key));
+				builder.push(c);
+				if (i->d[0].hasValue)
+					c->set(static_cast<V const&>(i->val));
 				i = i->template next<N, MNode<K, V, C, Cs...>>();
 			}
 		} else
-			map = a;
+			return a;
 	}
-	return map;
+	return builder.build();
 }
 
 template <typename K, typename V, typename C, typename ... Cs>
@@ -632,32 +1204,61 @@ Map<K, V, C, Cs ...>
 Map<K, V, C, Cs ...>::Intersection<S, N>::operator()(Map const& a, Map const& b, auto&& ... args) const
 requires Selector<S, K, decltype(args) ...>
 {
-	Map map;
+	if (threads > 1 && a && b) {
+		S selector;
+		if (a.size() <= b.size())
+			return Merge<N, false, false, true>(a, b, threads, [&](K const& i, K const& j) -> K const&
+			{ return selector(i, j, std::forward<decltype(args)>(args) ...); });
+		return Merge<N, false, false, true>(b, a, threads, [&](K const& j, K const& i) -> K const&
+		{ return selector(i, j, std::forward<decltype(args)>(args) ...); });
+	}
+
+	BulkBuilder<N> builder;
 	if (a && b) {
-		TypeAt<N, C, Cs ...> cmp;
+		CountedAt<N, C, Cs ...> cmp;
 		S selector;
+		auto push = [&](K const& key) {
+			auto* c = new MNode<K, V, C, Cs ...>(key);
+			builder.push(c);
+			auto const* m = static_cast<MNode<K, V, C, Cs ...> const*>(ToParent(const_cast<K*>(&key), &SNode<K, C, Cs ...>::key));
+			if (m->d[0].hasValue)
+				c->set(static_cast<V const&>(m->val));
+		};
+		// look the keys of the smaller one up in the larger one if cheaper than walking both
+		if (a.size() * std::bit_width(b.size()) < b.size()) {
+			for (auto* i = a.mRoot[N]->template leftMost<N, MNode<K, V, C, Cs ...>>(); i; i = i->template next<N, MNode<K, V, C, Cs ...>>()) {
+				if (auto* j = reinterpret_cast<MNode<K, V, C, Cs ...>*>(reinterpret_cast<SNode<K, C, Cs ...>*>(b.mRoot[N])->template get<N>(static_cast<K const&>(i->key))))
+					push(selector(static_cast<K const&>(i->key), static_cast<K const&>(j->key), std::forward<decltype(args)>(args) ...));
+			}
+			return builder.build();
+		}
+		if (b.size() * std::bit_width(a.size()) < a.size()) {
+			for (auto* j = b.mRoot[N]->template leftMost<N, MNode<K, V, C, Cs ...>>(); j; j = j->template next<N, MNode<K, V, C, Cs ...>>()) {
+				if (auto* i = reinterpret_cast<MNode<K, V, C, Cs ...>*>(reinterpret_cast<SNode<K, C, Cs ...>*>(a.mRoot[N])->template get<N>(static_cast<K const&>(j->key))))
+					push(selector(static_cast<K const&>(i->key), static_cast<K const&>(j->key), std::forward<decltype(args)>(args) ...));
+			}
+			return builder.build();
+		}
+
 		auto* i = a.mRoot[N]->template leftMost<N, MNode<K, V, C, Cs...>>();
 		auto* j = b.mRoot[N]->template leftMost<N, MNode<K, V, C, Cs...>>();
 
 		do {
-			if (cmp(static_cast<K const&>(i->key), static_cast<K const&>(j->key))) {
+			auto const order = Compare(cmp, static_cast<K const&>(i->key), static_cast<K const&>(j->key));
+			if (order < 0) {
 				i = i->template next<N, MNode<K, V, C, Cs...>>();
 				continue;
 			}
-			if (cmp(static_cast<K const&>(j->key), static_cast<K const&>(i->key))) {
+			if (order > 0) {
 				j = j->template next<N, MNode<K, V, C, Cs...>>();
 				continue;
 			}
-			K const& key = selector(static_cast<K const&>(i->key), static_cast<K const&>(j->key), std::forward<decltype(args)>(args) ...);
-			auto c = map.put(key);
-			auto* m = ToParent(&key, &MNode<K, V, C, Cs ...>::key);
-			if (m->d[N].hasValue)
-				c.set(static_cast<V const&>(m->val));
+			push(selector(static_cast<K const&>(i->key), static_cast<K const&>(j->key), std::forward<decltype(args)>(args) ...));
 			i = i->template next<N, MNode<K, V, C, Cs...>>();
 			j = j->template next<N, MNode<K, V, C, Cs...>>();
 		} while (i && j);
 	}
-	return map;
+	return builder.build();
 }
 
 template <typename K, typename V, typename C, typename ... Cs>
@@ -666,45 +1267,55 @@ Map<K, V, C, Cs ...>
 Map<K, V, C, Cs ...>::Join<S, N>::operator()(Map const& a, Map const& b, auto&& ... args) const
 requires Selector<S, K, decltype(args) ...>
 {
-	Map map;
+	if (threads > 1 && a && b) {
+		S selector;
+		return Merge<N, true, false, true>(a, b, threads, [&](K const& i, K const& j) -> K const&
+		{ return selector(i, j, std::forward<decltype(args)>(args) ...); });
+	}
+
+	BulkBuilder<N> builder;
 	if (a) {
 		if (b) {
-			TypeAt<N, C, Cs ...> cmp;
+			CountedAt<N, C, Cs ...> cmp;
 			S selector;
 			auto* i = a.mRoot[N]->template leftMost<N, MNode<K, V, C, Cs...>>();
 			auto* j = b.mRoot[N]->template leftMost<N, MNode<K, V, C, Cs...>>();
 
 			do {
-				if (cmp(static_cast<K const&>(i->key), static_cast<K const&>(j->key))) {
-					auto c = map.put(static_cast<K const&>(i->key));
-					if (i->d[N].hasValue)
-						c.set(static_cast<V const&>(i->val));
+				auto const order = Compare(cmp, static_cast<K const&>(i->key), static_cast<K const&>(j->key));
+				if (order < 0) {
+					auto* c = new MNode<K, V, C, Cs ...>(static_cast<K const&>(i->key));
+					builder.push(c);
+					if (i->d[0].hasValue)
+						c->set(static_cast<V const&>(i->val));
 					i = i->template next<N, MNode<K, V, C, Cs...>>();
 					continue;
 				}
-				if (cmp(static_cast<K const&>(j->key), static_cast<K const&>(i->key))) {
+				if (order > 0) {
 					j = j->template next<N, MNode<K, V, C, Cs...>>();
 					continue;
 				}
 				K const& key = selector(static_cast<K const&>(i->key), static_cast<K const&>(j->key), std::forward<decltype(args)>(args) ...);
-				auto c = map.put(key);
-				auto* m = ToParent(&key, &MNode<K, V, C, Cs ...>::key);
-				if (m->d[N].hasValue)
-					c.set(static_cast<V const&>(m->val));
+				auto* c = new MNode<K, V, C, Cs ...>(key);
+				builder.push(c);
+				auto const* m = static_cast<MNode<K, V, C, Cs ...> const*>(ToParent(const_cast<K*>(&key), &SNode<K, C, Cs ...>::key));
+				if (m->d[0].hasValue)
+					c->set(static_cast<V const&>(m->val));
 				i = i->template next<N, MNode<K, V, C, Cs...>>();
 				j = j->template next<N, MNode<K, V, C, Cs...>>();
 			} while (i && j);
 
 			while (i) {
-				auto c = map.put(static_cast<K const&>(i->key));
-				if (i->d[N].hasValue)
-					c.set(static_cast<V const&>(i->val));
+				auto* c = new MNode<K, V, C, Cs ...>(static_cast<K const&>(i->key));
+				builder.push(c);
+				if (i->d[0].hasValue)
+					c->set(static_cast<V const&>(i->val));
 				i = i->template next<N, MNode<K, V, C, Cs...>>();
 			}
 		} else
-			map = a;
+			return a;
 	}
-	return map;
+	return builder.build();
 }
 
 template <typename K, typename V, typename C, typename ... Cs>
@@ -713,56 +1324,172 @@ Map<K, V, C, Cs ...>
 Map<K, V, C, Cs ...>::Union<S, N>::operator()(Map const& a, Map const& b, auto&& ... args) const
 requires Selector<S, K, decltype(args) ...>
 {
-	Map map;
+	if (threads > 1 && a && b) {
+		S selector;
+		if (a.size() >= b.size())
+			return Merge<N, true, true, true>(a, b, threads, [&](K const& i, K const& j) -> K const&
+			{ return selector(i, j, std::forward<decltype(args)>(args) ...); });
+		return Merge<N, true, true, true>(b, a, threads, [&](K const& j, K const& i) -> K const&
+		{ return selector(i, j, std::forward<decltype(args)>(args) ...); });
+	}
+
+	BulkBuilder<N> builder;
 	if (a) {
 		if (b) {
-			TypeAt<N, C, Cs ...> cmp;
+			CountedAt<N, C, Cs ...> cmp;
 			S selector;
 			auto* i = a.mRoot[N]->template leftMost<N, MNode<K, V, C, Cs...>>();
 			auto* j = b.mRoot[N]->template leftMost<N, MNode<K, V, C, Cs...>>();
 
 			do {
-				if (cmp(static_cast<K const&>(i->key), static_cast<K const&>(j->key))) {
-					auto c = map.put(static_cast<K const&>(i->key));
-					if (i->d[N].hasValue)
-						c.set(static_cast<V const&>(i->val));
+				auto const order = Compare(cmp, static_cast<K const&>(i->key), static_cast<K const&>(j->key));
+				if (order < 0) {
+					auto* c = new MNode<K, V, C, Cs ...>(static_cast<K const&>(i->key));
+					builder.push(c);
+					if (i->d[0].hasValue)
+						c->set(static_cast<V const&>(i->val));
 					i = i->template next<N, MNode<K, V, C, Cs...>>();
 					continue;
 				}
-				if (cmp(static_cast<K const&>(j->key), static_cast<K const&>(i->key))) {
-					auto c = map.put(static_cast<K const&>(j->key));
-					if (j->d[N].hasValue)
-						c.set(static_cast<V const&>(j->val));
+				if (order > 0) {
+					auto* c = new MNode<K, V, C, Cs ...>(static_cast<K const&>(j->key));
+					builder.push(c);
+					if (j->d[0].hasValue)
+						c->set(static_cast<V const&>(j->val));
 					j = j->template next<N, MNode<K, V, C, Cs...>>();
 					continue;
 				}
 				K const& key = selector(static_cast<K const&>(i->key), static_cast<K const&>(j->key), std::forward<decltype(args)>(args) ...);
-				auto c = map.put(key);
-				auto* m = ToParent(&key, &MNode<K, V, C, Cs ...>::key);
-				if (m->d[N].hasValue)
-					c.set(static_cast<V const&>(m->val));
+				auto* c = new MNode<K, V, C, Cs ...>(key);
+				builder.push(c);
+				auto const* m = static_cast<MNode<K, V, C, Cs ...> const*>(ToParent(const_cast<K*>(&key), &SNode<K, C, Cs ...>::key));
+				if (m->d[0].hasValue)
+					c->set(static_cast<V const&>(m->val));
 				i = i->template next<N, MNode<K, V, C, Cs...>>();
 				j = j->template next<N, MNode<K, V, C, Cs...>>();
 			} while (i && j);
 
 			while (i) {
-				auto c = map.put(static_cast<K const&>(i->key));
-				if (i->d[N].hasValue)
-					c.set(static_cast<V const&>(i->val));
+				auto* c = new MNode<K, V, C, Cs ...>(static_cast<K const&>(i->key));
+				builder.push(c);
+				if (i->d[0].hasValue)
+					c->set(static_cast<V const&>(i->val));
 				i = i->template next<N, MNode<K, V, C, Cs...>>();
 			}
 
 			while (j) {
-				auto c = map.put(static_cast<K const&>(j->key));
-				if (j->d[N].hasValue)
-					c.set(static_cast<V const&>(j->val));
+				auto* c = new MNode<K, V, C, Cs ...>(static_cast<K const&>(j->key));
+				builder.push(c);
+				if (j->d[0].hasValue)
+					c->set(static_cast<V const&>(j->val));
 				j = j->template next<N, MNode<K, V, C, Cs...>>();
 			}
 		} else
-			map = a;
+			return a;
 	} else if (b)
-		map = b;
+		return b;
+	return builder.build();
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+Map<K, V, C, Cs ...>::BulkBuilder<N>::~BulkBuilder()
+{
+	while (mHead) {
+		auto* t = mHead;
+		mHead = mHead->template right<N>();
+		delete reinterpret_cast<MNode<K, V, C, Cs ...>*>(t);
+	}
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+void
+Map<K, V, C, Cs ...>::BulkBuilder<N>::push(MNode<K, V, C, Cs ...>* created) noexcept
+{
+	created->template state<N>(2);
+	created->template right<N>(nullptr);
+	if (mTail)
+		mTail->template right<N>(created);
+	else
+		mHead = created;
+	mTail = created;
+	++mCount;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+bool
+Map<K, V, C, Cs ...>::BulkBuilder<N>::follows(auto&& ... args) const noexcept
+{ return !mTail || Precedes(CountedAt<N, C, Cs ...>{}, static_cast<K const&>(reinterpret_cast<SNode<K, C, Cs ...>*>(mTail)->key), args ...); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+typename Map<K, V, C, Cs ...>::template iterator<N>
+Map<K, V, C, Cs ...>::BulkBuilder<N>::put(auto&& ... kArgs)
+{
+	auto* created = new MNode<K, V, C, Cs ...>(std::forward<decltype(kArgs)>(kArgs) ...);
+	if (!follows(static_cast<K const&>(created->key))) {
+		delete created;
+		throw Exception(SException::Code::UnorderedKey, std::to_string(N + 1) + ". comparator");
+	}
+	push(created);
+	return created;
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+template <std::size_t N>
+Map<K, V, C, Cs ...>
+Map<K, V, C, Cs ...>::BulkBuilder<N>::build() noexcept
+{
+	Map map;
+	if (mCount) {
+		TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* last{nullptr};
+		map.template adopt<N>(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>::template BuildBalanced<N>(mHead, last, mCount));
+		mHead = mTail = nullptr;
+		mCount = 0;
+	}
 	return map;
 }
 
+
+template <typename K, typename V, typename C, typename ... Cs>
+Map<K, V, C, Cs ...>::Loader::Loader(Map& map) noexcept
+		: mMap(map)
+{ std::fill(mMap.mRoot + 1, mMap.mRoot + Dimension<C, Cs ...>, nullptr); }
+
+template <typename K, typename V, typename C, typename ... Cs>
+Map<K, V, C, Cs ...>::Loader::~Loader()
+{
+	if constexpr (Dimension<C, Cs ...> > 1) {
+		if (mMap.mRoot[0])
+			mMap.mSize = SNode<K, C, Cs ...>::template Reindex<MNode<K, V, C, Cs ...>, 0>(mMap.mRoot, mMap.mSize);
+	}
+	mMap.rehash();
+}
+
+template <typename K, typename V, typename C, typename ... Cs>
+typename Map<K, V, C, Cs ...>::template iterator<>
+Map<K, V, C, Cs ...>::Loader::put(auto&& ... kArgs)
+{
+	TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* created = new MNode<K, V, C, Cs ...>(std::forward<decltype(kArgs)>(kArgs) ...);
+	if (!mMap.mRoot[0]) {
+		mMap.mRoot[0] = created;
+		created->template left<0>(nullptr);
+		created->template right<0>(nullptr);
+		created->template state<0>(2);
+		created->d[0].cnt = 1;
+	} else {
+		auto* t = created;
+		if (auto* r = reinterpret_cast<SNode<K, C, Cs ...>*>(mMap.mRoot[0])->template attach<0>(&created))
+			mMap.mRoot[0] = r;
+		else if (t != created) { // found an existing node
+			delete reinterpret_cast<MNode<K, V, C, Cs ...>*>(t);
+			return created;
+		}
+	}
+	++mMap.mSize;
+	return created;
+}
+
 }//namespace DS
@@ -0,0 +1,389 @@
+#pragma once
+
+#include "Compare.tpp"
+#include "Policy.tpp"
+#include "SlabPool.tpp"
+#include "DS/CountedPtr.hpp"
+#include "DS/IntrusivePtr.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+namespace DS {
+
+/**
+ * @brief	Node of a persistent tree, immutable once published and shared by every version reaching it.
+ * @details	Updates copy the path to the changed node and share the rest, the node is released when no parent or
+ * version refers to it any more. V is void for sets.
+ */
+template <typename K, typename V, typename ... Ps>
+struct PNode {
+	struct NoValue {};
+
+	std::atomic<std::uint32_t> refs{1}; // parents and versions referring to the node
+	std::uint8_t height;
+	PNode* const l;
+	PNode* const r;
+	K const key;
+	[[no_unique_address]] std::conditional_t<std::is_void_v<V>, NoValue, V> const value;
+
+	static void*
+	operator new(std::size_t size)
+	{ return PolicyOf<Allocator, Allocator, Ps ...>::allocate(size); }
+
+	static void
+	operator delete(void* ptr)
+	{ PolicyOf<Allocator, Allocator, Ps ...>::deallocate(ptr); }
+
+	PNode(PNode* l, PNode* r, auto&& key, auto&& ... vArgs)
+			: height(1 + std::max(Height(l), Height(r)))
+			, l(l)
+			, r(r)
+			, key(std::forward<decltype(key)>(key))
+			, value(std::forward<decltype(vArgs)>(vArgs) ...)
+	{}
+
+	static int
+	Height(PNode const* t) noexcept
+	{ return t ? t->height : 0; }
+
+	static PNode*
+	Share(PNode* t) noexcept
+	{
+		if (t)
+			t->refs.fetch_add(1, std::memory_order::relaxed);
+		return t;
+	}
+
+	static void
+	Release(PNode* t) noexcept
+	{
+		while (t && t->refs.fetch_sub(1, std::memory_order::acq_rel) == 1) {
+			Release(t->l);
+			auto* r = t->r;
+			delete t;
+			t = r;
+		}
+	}
+
+	// Releases t on scope exit
+	struct Held {
+		PNode* t;
+
+		~Held()
+		{ Release(t); }
+	};
+
+	// New node over l and r, taking their references, which are released if it throws
+	static PNode*
+	Make(PNode* l, PNode* r, auto&& key, auto&& ... vArgs)
+	{
+		try {
+			return new PNode(l, r, std::forward<decltype(key)>(key), std::forward<decltype(vArgs)>(vArgs) ...);
+		} catch (...) {
+			Release(l);
+			Release(r);
+			throw;
+		}
+	}
+
+	// Copy of the entry of s over l and r
+	static PNode*
+	Copy(PNode const* s, PNode* l, PNode* r)
+	{ return Make(l, r, s->key, s->value); }
+
+	// Copy of the entry of s over l and r, rotated if their heights differ by 2
+	static PNode*
+	Balance(PNode const* s, PNode* l, PNode* r)
+	{
+		if (Height(l) > Height(r) + 1) {
+			Held const old{l}; // its children are shared by the rotated nodes
+			if (Height(l->l) >= Height(l->r)) {
+				auto* n = Copy(s, Share(l->r), r);
+				return Copy(l, Share(l->l), n);
+			}
+			auto* c = l->r;
+			auto* b = Copy(s, Share(c->r), r);
+			PNode* a;
+			try {
+				a = Copy(l, Share(l->l), Share(c->l));
+			} catch (...) {
+				Release(b);
+				throw;
+			}
+			return Copy(c, a, b);
+		}
+		if (Height(r) > Height(l) + 1) {
+			Held const old{r};
+			if (Height(r->r) >= Height(r->l)) {
+				auto* n = Copy(s, l, Share(r->l));
+				return Copy(r, n, Share(r->r));
+			}
+			auto* c = r->l;
+			auto* a = Copy(s, l, Share(c->l));
+			PNode* b;
+			try {
+				b = Copy(r, Share(c->r), Share(r->r));
+			} catch (...) {
+				Release(a);
+				throw;
+			}
+			return Copy(c, a, b);
+		}
+		return Copy(s, l, r);
+	}
+
+	/**
+	 * @brief	Copy of the tree t with key put, or null if Replace is false and key exists.
+	 * @param	added Whether key is added
+	 */
+	template <typename C, bool Replace>
+	static PNode*
+	Put(PNode* t, bool& added, auto&& key, auto&& ... vArgs)
+	{
+		if (!t) {
+			added = true;
+			return Make(nullptr, nullptr, std::forward<decltype(key)>(key), std::forward<decltype(vArgs)>(vArgs) ...);
+		}
+		auto const order = Compare(C{}, t->key, key);
+		if (order > 0) {
+			auto* l = Put<C, Replace>(t->l, added, std::forward<decltype(key)>(key), std::forward<decltype(vArgs)>(vArgs) ...);
+			return l ? Balance(t, l, Share(t->r)) : nullptr;
+		}
+		if (order < 0) {
+			auto* r = Put<C, Replace>(t->r, added, std::forward<decltype(key)>(key), std::forward<decltype(vArgs)>(vArgs) ...);
+			return r ? Balance(t, Share(t->l), r) : nullptr;
+		}
+		if constexpr (Replace)
+			return Make(Share(t->l), Share(t->r), t->key, std::forward<decltype(vArgs)>(vArgs) ...);
+		else
+			return nullptr;
+	}
+
+	// Copy of the tree t without its first node
+	static PNode*
+	RemoveFirst(PNode* t, PNode const*& first)
+	{
+		if (!t->l) {
+			first = t;
+			return Share(t->r);
+		}
+		auto* l = RemoveFirst(t->l, first);
+		return Balance(t, l, Share(t->r));
+	}
+
+	/**
+	 * @brief	Copy of the tree t without the node equal to args.
+	 * @param	removed Whether it is found, otherwise null is returned
+	 */
+	template <typename C>
+	static PNode*
+	Remove(PNode* t, bool& removed, auto const& ... args)
+	{
+		if (!t)
+			return nullptr;
+		auto const order = Compare(C{}, t->key, args ...);
+		if (order > 0) {
+			auto* l = Remove<C>(t->l, removed, args ...);
+			return removed ? Balance(t, l, Share(t->r)) : nullptr;
+		}
+		if (order < 0) {
+			auto* r = Remove<C>(t->r, removed, args ...);
+			return removed ? Balance(t, Share(t->l), r) : nullptr;
+		}
+		removed = true;
+		if (!t->l)
+			return Share(t->r);
+		if (!t->r)
+			return Share(t->l);
+		PNode const* next;
+		auto* r = RemoveFirst(t->r, next);
+		return Balance(next, Share(t->l), r);
+	}
+
+	template <typename C>
+	static PNode const*
+	Get(PNode const* t, auto const& ... args) noexcept
+	{
+		while (t) {
+			auto const order = Compare(C{}, t->key, args ...);
+			if (order == 0)
+				return t;
+			t = order > 0 ? t->l : t->r;
+		}
+		return nullptr;
+	}
+};//struct DS::PNode<K, V, Ps ...>
+
+/**
+ * @brief	Root of a persistent tree, released with the last snapshot referring to it.
+ */
+template <typename K, typename V, typename ... Ps>
+struct PVersion : RefCounter {
+	PNode<K, V, Ps ...>* const root;
+	std::uint64_t const size;
+
+	PVersion(PNode<K, V, Ps ...>* root, std::uint64_t size) noexcept
+			: RefCounter(1)
+			, root(root)
+			, size(size)
+	{}
+
+	~PVersion() override
+	{ PNode<K, V, Ps ...>::Release(root); }
+
+	/**
+	 * @brief	Reference the version published in current, concurrently with Publish.
+	 * @details	The reader borrows the version by counting in the pointer first, so that it is not released before
+	 * it is referenced. The borrowed count is then given back to the pointer if it is still published, otherwise
+	 * to the version, which Publish has moved the counts of the pointer to.
+	 */
+	static PVersion*
+	Acquire(std::atomic<CountedPtr<PVersion>>& current) noexcept
+	{
+		auto p = current.fetchAddCount(1, std::memory_order::acquire);
+		auto* v = static_cast<PVersion*>(p);
+		v->addRef();
+		++p.cnt;
+		while (static_cast<PVersion*>(p) == v) {
+			auto q = p;
+			--q.cnt;
+			if (current.compare_exchange_weak(p, q, std::memory_order::release, std::memory_order::relaxed))
+				return v;
+		}
+		v->subRef();
+		return v;
+	}
+
+	/**
+	 * @brief	Replace the version published in current by v, only one thread may publish.
+	 */
+	static void
+	Publish(std::atomic<CountedPtr<PVersion>>& current, PVersion* v) noexcept
+	{
+		auto p = current.exchange(v, std::memory_order::acq_rel);
+		if (p.cnt)
+			p->addRef(p.cnt);
+		p->subRef();
+	}
+};//struct DS::PVersion<K, V, Ps ...>
+
+/**
+ * @brief	Immutable view of a persistent tree, safe to read on any thread while the tree is updated.
+ * @details	Copies share the version, its nodes are released with the last snapshot referring to them.
+ * Iterators are valid as long as the snapshot is.
+ */
+template <typename K, typename V, typename C, typename ... Ps>
+class PSnapshot {
+	IntrusivePtr<PVersion<K, V, Ps ...>> mVersion;
+
+public:
+	using Node = PNode<K, V, Ps ...>;
+
+	/**
+	 * @brief	Forward iterator keeping the path from the root, up to MaxHeight nodes.
+	 */
+	class Iterator {
+		friend class PSnapshot;
+
+		static constexpr std::size_t MaxHeight{96}; // an AVL tree of 2^64 nodes is less than 93 high
+
+		Node const* mPath[MaxHeight];
+		std::size_t mDepth{0};
+
+		// Push t and its left descendants
+		void
+		descend(Node const* t) noexcept
+		{
+			for (; t; t = t->l)
+				mPath[mDepth++] = t;
+		}
+
+	public:
+		Iterator() noexcept = default;
+
+		Node const&
+		operator*() const noexcept
+		{ return *mPath[mDepth - 1]; }
+
+		Node const*
+		operator->() const noexcept
+		{ return mPath[mDepth - 1]; }
+
+		Iterator&
+		operator++() noexcept
+		{
+			descend(mPath[--mDepth]->r);
+			return *this;
+		}
+
+		bool
+		operator==(Iterator const& other) const noexcept
+		{ return mDepth ? other.mDepth && mPath[mDepth - 1] == other.mPath[other.mDepth - 1] : !other.mDepth; }
+
+		explicit operator bool() const noexcept
+		{ return mDepth; }
+	};//class DS::PSnapshot<K, V, C, Ps ...>::Iterator
+
+	using const_iterator = Iterator;
+
+	PSnapshot() noexcept = default;
+
+	explicit PSnapshot(PVersion<K, V, Ps ...>* version) noexcept
+			: mVersion(version)
+	{}
+
+	[[nodiscard]] std::uint64_t
+	size() const noexcept
+	{ return mVersion ? mVersion->size : 0; }
+
+	explicit operator bool() const noexcept
+	{ return size(); }
+
+	/**
+	 * @brief	Root node of the version, null if it is empty.
+	 */
+	Node const*
+	root() const noexcept
+	{ return mVersion ? mVersion->root : nullptr; }
+
+	/**
+	 * @brief	Node equal to args or null, in O(log n).
+	 */
+	Node const*
+	get(auto const& ... args) const noexcept
+	{ return Node::template Get<C>(root(), args ...); }
+
+	/**
+	 * @brief	First node not ordered before args, in O(log n).
+	 */
+	Iterator
+	lowerBound(auto const& ... args) const noexcept
+	{
+		Iterator i;
+		for (auto const* t = root(); t;) {
+			if (Precedes(C{}, t->key, args ...))
+				t = t->r;
+			else {
+				i.mPath[i.mDepth++] = t;
+				t = t->l;
+			}
+		}
+		return i;
+	}
+
+	Iterator
+	begin() const noexcept
+	{
+		Iterator i;
+		i.descend(root());
+		return i;
+	}
+
+	Iterator
+	end() const noexcept
+	{ return {}; }
+};//class DS::PSnapshot<K, V, C, Ps ...>
+
+}//namespace DS
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "DS/PersistentMap.hpp"
+
+namespace DS {
+
+template <typename K, typename V, typename C, typename ... Ps>
+PersistentMap<K, V, C, Ps ...>::PersistentMap()
+		: mCurrent(new Version(nullptr, 0))
+{}
+
+template <typename K, typename V, typename C, typename ... Ps>
+PersistentMap<K, V, C, Ps ...>::~PersistentMap()
+{ static_cast<Version*>(mCurrent.loadExclusively())->subRef(); }
+
+template <typename K, typename V, typename C, typename ... Ps>
+void
+PersistentMap<K, V, C, Ps ...>::publish(Node* root, std::uint64_t size)
+{
+	Version* v;
+	try {
+		v = new Version(root, size);
+	} catch (...) {
+		Node::Release(root);
+		throw;
+	}
+	Version::Publish(mCurrent, v);
+	std::atomic_ref{mSize}.store(size, std::memory_order::release);
+}
+
+template <typename K, typename V, typename C, typename ... Ps>
+bool
+PersistentMap<K, V, C, Ps ...>::put(auto&& k, auto&& ... vArgs)
+{
+	auto const* current = static_cast<Version*>(mCurrent.load(std::memory_order::relaxed));
+	bool added{false};
+	auto* root = Node::template Put<C, true>(current->root, added,
+		std::forward<decltype(k)>(k), std::forward<decltype(vArgs)>(vArgs) ...);
+	publish(root, current->size + added);
+	return added;
+}
+
+template <typename K, typename V, typename C, typename ... Ps>
+bool
+PersistentMap<K, V, C, Ps ...>::remove(auto const& ... args)
+{
+	auto const* current = static_cast<Version*>(mCurrent.load(std::memory_order::relaxed));
+	bool removed{false};
+	auto* root = Node::template Remove<C>(current->root, removed, args ...);
+	if (removed)
+		publish(root, current->size - 1);
+	return removed;
+}
+
+template <typename K, typename V, typename C, typename ... Ps>
+void
+PersistentMap<K, V, C, Ps ...>::clear()
+{
+	if (size())
+		publish(nullptr, 0);
+}
+
+template <typename K, typename V, typename C, typename ... Ps>
+typename PersistentMap<K, V, C, Ps ...>::Snapshot
+PersistentMap<K, V, C, Ps ...>::snapshot() const noexcept
+{ return Snapshot(Version::Acquire(mCurrent)); }
+
+}//namespace DS
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "DS/PersistentSet.hpp"
+
+namespace DS {
+
+template <typename K, typename C, typename ... Ps>
+PersistentSet<K, C, Ps ...>::PersistentSet()
+		: mCurrent(new Version(nullptr, 0))
+{}
+
+template <typename K, typename C, typename ... Ps>
+PersistentSet<K, C, Ps ...>::~PersistentSet()
+{ static_cast<Version*>(mCurrent.loadExclusively())->subRef(); }
+
+template <typename K, typename C, typename ... Ps>
+void
+PersistentSet<K, C, Ps ...>::publish(Node* root, std::uint64_t size)
+{
+	Version* v;
+	try {
+		v = new Version(root, size);
+	} catch (...) {
+		Node::Release(root);
+		throw;
+	}
+	Version::Publish(mCurrent, v);
+	std::atomic_ref{mSize}.store(size, std::memory_order::release);
+}
+
+template <typename K, typename C, typename ... Ps>
+bool
+PersistentSet<K, C, Ps ...>::put(auto&& k)
+{
+	auto const* current = static_cast<Version*>(mCurrent.load(std::memory_order::relaxed));
+	bool added{false};
+	if (auto* root = Node::template Put<C, false>(current->root, added, std::forward<decltype(k)>(k)))
+		publish(root, current->size + 1);
+	return added;
+}
+
+template <typename K, typename C, typename ... Ps>
+bool
+PersistentSet<K, C, Ps ...>::remove(auto const& ... args)
+{
+	auto const* current = static_cast<Version*>(mCurrent.load(std::memory_order::relaxed));
+	bool removed{false};
+	auto* root = Node::template Remove<C>(current->root, removed, args ...);
+	if (removed)
+		publish(root, current->size - 1);
+	return removed;
+}
+
+template <typename K, typename C, typename ... Ps>
+void
+PersistentSet<K, C, Ps ...>::clear()
+{
+	if (size())
+		publish(nullptr, 0);
+}
+
+template <typename K, typename C, typename ... Ps>
+typename PersistentSet<K, C, Ps ...>::Snapshot
+PersistentSet<K, C, Ps ...>::snapshot() const noexcept
+{ return Snapshot(Version::Acquire(mCurrent)); }
+
+}//namespace DS
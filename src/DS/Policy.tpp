@@ -0,0 +1,58 @@
+#pragma once
+
+#include <concepts>
+#include <new>
+
+namespace DS {
+
+/**
+ * @brief	Base of the policy tags that may follow the comparators of Set and Map.
+ * @details	Policies do not add an index, they must be placed after all the comparators.
+ */
+struct Policy {};
+
+template <typename T>
+concept IsPolicy = std::derived_from<T, Policy>;
+
+// Number of comparators in Cs
+template <typename ... Cs>
+inline constexpr std::size_t Dimension = (std::size_t{0} + ... + !IsPolicy<Cs>);
+
+// true, if no comparator follows a policy in Cs
+template <typename ... Cs>
+inline constexpr bool PoliciesLast = true;
+
+template <typename T, typename ... Cs>
+inline constexpr bool PoliciesLast<T, Cs ...> = IsPolicy<T> ? (IsPolicy<Cs> && ...) : PoliciesLast<Cs ...>;
+
+
+template <typename Kind, typename Default, typename ... Cs>
+struct policyOf
+{ using type = Default; };
+
+template <typename Kind, typename Default, typename T, typename ... Cs>
+struct policyOf<Kind, Default, T, Cs ...>
+{ using type = std::conditional_t<std::derived_from<T, Kind>, T, typename policyOf<Kind, Default, Cs ...>::type>; };
+
+// First policy of Kind in Cs, or Default
+template <typename Kind, typename Default, typename ... Cs>
+using PolicyOf = typename policyOf<Kind, Default, Cs ...>::type;
+
+
+/**
+ * @brief	Node allocation policy.
+ * @details	Nodes are allocated by the static allocate(size) and released by the static deallocate(ptr) of the
+ * first Allocator in Cs. This default one uses the global operator new and delete. Returned blocks must be
+ * aligned to 16 bytes, unless the Allocator encodes the links itself (see Compact).
+ */
+struct Allocator : Policy {
+	static void*
+	allocate(std::size_t size)
+	{ return ::operator new(size); }
+
+	static void
+	deallocate(void* ptr) noexcept
+	{ ::operator delete(ptr); }
+};//struct DS::Allocator
+
+}//namespace DS
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Policy.tpp"
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace DS {
+
+/**
+ * @brief	Node reclamation policy.
+ * @details	Set and Map hand their trees to the static reclaim(tree, destroy) of the first Reclaimer in Cs on
+ * destruction, which must call destroy(tree) once. This default one destroys the tree on the calling thread.
+ */
+struct Reclaimer : Policy {
+	static void
+	reclaim(void* tree, void (*destroy)(void*)) noexcept
+	{ destroy(tree); }
+};//struct DS::Reclaimer
+
+/**
+ * @brief	Reclamation policy destroying the trees on a background thread, destructors return in O(1).
+ * @details	Trees are destroyed in the order they are handed over. The thread exits once no tree is left, so that
+ * allocators caching blocks per thread (e.g. SlabPool<>) get them back, and the program waits for it on exit.
+ * Containers with static storage duration should not use this policy.
+ */
+class BackgroundReclaimer : public Reclaimer {
+	struct Queue {
+		std::mutex mutex;
+		std::vector<std::pair<void*, void (*)(void*)>> trees;
+		std::thread worker;
+		bool running{false};
+
+		~Queue()
+		{
+			if (worker.joinable())
+				worker.join();
+		}
+	};
+
+	static Queue Pending;
+
+	static void
+	Run() noexcept
+	{
+		std::unique_lock lock(Pending.mutex);
+		while (!Pending.trees.empty()) {
+			auto trees = std::exchange(Pending.trees, {});
+			lock.unlock();
+			for (auto [tree, destroy] : trees)
+				destroy(tree);
+			lock.lock();
+		}
+		Pending.running = false;
+	}
+
+public:
+	static void
+	reclaim(void* tree, void (*destroy)(void*)) noexcept
+	{
+		std::unique_lock lock(Pending.mutex);
+		try {
+			Pending.trees.emplace_back(tree, destroy);
+		} catch (...) { // out of memory
+			lock.unlock();
+			destroy(tree);
+			return;
+		}
+		if (Pending.running)
+			return;
+		if (Pending.worker.joinable()) // done but for its thread_local destructors
+			Pending.worker.join();
+		try {
+			Pending.worker = std::thread(Run);
+			Pending.running = true;
+		} catch (std::system_error const&) { // out of threads
+			auto trees = std::exchange(Pending.trees, {});
+			lock.unlock();
+			for (auto [t, d] : trees)
+				d(t);
+		}
+	}
+};//class DS::BackgroundReclaimer
+
+inline BackgroundReclaimer::Queue BackgroundReclaimer::Pending;
+
+}//namespace DS
@@ -1,14 +1,23 @@
 #pragma once
 
 #include "TNode.tpp"
+#include "Augment.tpp"
+#include "Compact.tpp"
+#include "Compare.tpp"
 #include "Holder.tpp"
+#include "Reclaim.tpp"
+#include "SlabPool.tpp"
 #include <DP/Factory.hpp>
+#include <algorithm>
+#include <exception>
+#include <vector>
 
 namespace DS {
 
 struct SException {
 	enum class Code : int {
-		KeyCollision = 1
+		KeyCollision = 1,
+		UnorderedKey
 	};
 };//struct SException
 
@@ -33,22 +42,46 @@ make_error_code(SException::Code e) noexcept
 
 		[[nodiscard]] std::string
 		message(int e) const noexcept override
-		{ return e == 1 ? "Key Collision" : "Unknown Error"; }
+		{ return e == 1 ? "Key Collision" : e == 2 ? "Unordered Key" : "Unknown Error"; }
 	} instance;
 	return {static_cast<int>(e), instance};
 }
 
 template <typename K, typename ... Cs>
-struct SNode : TNode<sizeof...(Cs)> {
+struct SNode : TNode<Dimension<Cs ...>, LinksOf<Cs ...>> {
+	template <std::size_t ... N>
+	static std::tuple<AggregateOf<N, Cs ...> ...>
+	Aggregates(std::index_sequence<N ...>);
+
+	[[no_unique_address]] std::conditional_t<IsAugmented<Cs ...>,
+		decltype(Aggregates(std::make_index_sequence<Dimension<Cs ...>>())), NoAggregate> agg{};
 	Holder<K> key;
 
+	using Stat = PolicyOf<Stats, Stats, Cs ...>;
+	using Balance = BalancingOf<Cs ...>;
+
+	static void*
+	operator new(std::size_t size)
+	{
+		auto* ptr = PolicyOf<Allocator, Allocator, Cs ...>::allocate(size);
+		Stat::allocated(size);
+		return ptr;
+	}
+
 	static void*
 	operator new(std::size_t, std::size_t const keySize)
-	{ return ::operator new(Offset(&SNode::key) + keySize); }
+	{
+		auto* ptr = PolicyOf<Allocator, Allocator, Cs ...>::allocate(Offset(&SNode::key) + keySize);
+		Stat::allocated(Offset(&SNode::key) + keySize);
+		return ptr;
+	}
 
 	static void
 	operator delete(void* ptr)
-	{ ::operator delete(ptr); }
+	{
+		Stat::deallocated();
+		PolicyOf<Allocator, Allocator, Cs ...>::deallocate(ptr);
+	}
 
 	explicit SNode(auto&& ... args)
 			: key(std::forward<decltype(args)>(args) ...)
@@ -57,33 +90,18 @@ struct SNode : TNode<sizeof...(Cs)> {
 	~SNode()
 	{ key->~K(); }
 
-	static TNode<sizeof...(Cs)>*
-	Create(TNode<sizeof...(Cs)>* P, TNode<sizeof...(Cs)>* S,
-			TNode<sizeof...(Cs)> const* other)
-	{
-		auto* t = ::new SNode(static_cast<K const&>(reinterpret_cast<SNode const*>(other)->key));
-		try {
-			t->left(other->d[0].hasLeft ? SNode::Create(P, t, other->left()) : P);
-			t->right(other->d[0].hasRight ? SNode::Create(t, S, other->right()) : S);
-			t->state(other->state());
-			return t;
-		} catch (...) {
-			delete t;
-			throw;
-		}
-	}
-
-	static TNode<sizeof...(Cs)>*
-	Create(TNode<sizeof...(Cs)>* P, TNode<sizeof...(Cs)>* S,
+	static TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	Create(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* P, TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* S,
 			Stream::Input& input, auto&& ... kArgs)
 	requires Stream::Deserializable<K, decltype(input), decltype(kArgs) ...>
 	{
 		auto state = Stream::Get<std::uint8_t>(input);
-		auto* t = ::new SNode(input, std::forward<decltype(kArgs)>(kArgs) ...);
+		auto* t = new SNode(input, std::forward<decltype(kArgs)>(kArgs) ...);
 		try {
 			t->left(state & 0x40 ? SNode::Create(P, t, input, std::forward<decltype(kArgs)>(kArgs) ...) : P);
 			t->right(state & 0x10 ? SNode::Create(t, S, input, std::forward<decltype(kArgs)>(kArgs) ...) : S);
 			t->state(state);
+			t->recount();
 			return t;
 		} catch (...) {
 			delete t;
@@ -92,8 +110,8 @@ struct SNode : TNode<sizeof...(Cs)> {
 	}
 
 	template <typename Type, typename ... Args>
-	static TNode<sizeof...(Cs)>*
-	Create(TNode<sizeof...(Cs)>* P, TNode<sizeof...(Cs)>* S,
+	static TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	Create(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* P, TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* S,
 			Stream::Input& input, DP::Factory<K, Type, Args ...>, auto&& ... kArgs)
 	{
 		using seq = std::make_index_sequence<sizeof...(Args) - sizeof...(kArgs)>;
@@ -104,6 +122,7 @@ struct SNode : TNode<sizeof...(Cs)> {
 			t->left(state & 0x40 ? SNode::Create(P, t, input, DP::Factory<K, Type, Args ...>{}) : P);
 			t->right(state & 0x10 ? SNode::Create(t, S, input, DP::Factory<K, Type, Args ...>{}) : S);
 			t->state(state);
+			t->recount();
 			return t;
 		} catch (...) {
 			delete t;
@@ -113,7 +132,7 @@ struct SNode : TNode<sizeof...(Cs)> {
 
 	template <typename Node, typename Exception, std::size_t N>
 	static void
-	Attach(TNode<sizeof...(Cs)>* root[], TNode<sizeof...(Cs)>* created)
+	Attach(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* root[], TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* created)
 	{
 		auto* s = created;
 		if (auto* t = reinterpret_cast<SNode*>(root[N])->template attach<N>(&created))
@@ -130,70 +149,661 @@ struct SNode : TNode<sizeof...(Cs)> {
 
 	template <typename Node, typename Exception, std::size_t N = 1>
 	static void
-	BuildTree(TNode<sizeof...(Cs)>* root[])
+	BuildTree(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* root[])
 	{
 		root[N] = root[0];
 		root[N]->template left<N>(nullptr);
 		root[N]->template right<N>(nullptr);
 		root[N]->template state<N>(2);
+		root[N]->d[N].cnt = 1;
 		if (root[0]->d[0].hasLeft)
 			Attach<Node, Exception, N>(root, root[0]->template left<0>());
 		if (root[0]->d[0].hasRight)
 			Attach<Node, Exception, N>(root, root[0]->template right<0>());
-		if constexpr(N < sizeof...(Cs) - 1)
+		if constexpr(N + 1 < Dimension<Cs ...>)
 			BuildTree<Node, Exception, N + 1>(root);
 	}
 
+	/**
+	 * @brief	Node equal to created on any index from the Nth one on but Skip, in O(log n) per index.
+	 */
+	template <std::size_t N, std::size_t Skip>
+	static SNode*
+	Collision(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* root[], SNode const* created)
+	{
+		if constexpr (N != Skip) {
+			if (auto* t = reinterpret_cast<SNode*>(root[N])->template get<N>(static_cast<K const&>(created->key)))
+				return reinterpret_cast<SNode*>(t);
+		}
+		if constexpr (N + 1 < Dimension<Cs ...>)
+			return Collision<N + 1, Skip>(root, created);
+		return nullptr;
+	}
+
+	/**
+	 * @brief	Attach created to every index from the Nth one on but Skip, none of which may have an equal node.
+	 */
+	template <std::size_t N, std::size_t Skip>
+	static void
+	AttachAll(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* root[], TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* created) noexcept
+	{
+		if constexpr (N != Skip) {
+			if (auto* t = reinterpret_cast<SNode*>(root[N])->template attach<N>(&created))
+				root[N] = t;
+		}
+		if constexpr (N + 1 < Dimension<Cs ...>)
+			AttachAll<N + 1, Skip>(root, created);
+	}
+
 	template <std::size_t N>
-	TNode<sizeof...(Cs)>*
+	TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
 	get(auto&& ... args)
 	{
 		auto* t = this;
-		TypeAt<N, Cs ...> cmp;
+		CountedAt<N, Cs ...> cmp;
 		while(true) {
-			if (cmp(std::forward<decltype(args)>(args) ..., static_cast<K const&>(t->key))) {
-				if (t->d[N].hasLeft) {
+			Stat::template visited<N>();
+			auto const order = Compare(cmp, static_cast<K const&>(t->key), args ...);
+			if (order > 0 && t->d[N].hasLeft)
+				t = t->template left<N, SNode>();
+			else if (order < 0 && t->d[N].hasRight)
+				t = t->template right<N, SNode>();
+			else {
+				Stat::template descended<N>(Stats::Descent::Get);
+				return order == 0 ? t : nullptr;
+			}
+		}
+	}
+
+	/**
+	 * @brief	Emit the node of each key in [first, last) by the Nth comparator in order, or null if missing.
+	 * @details	Keys are looked up in groups of G that take one step each per round, prefetching the nodes of
+	 * the next round so the cache misses of a group overlap instead of forming one chain per key.
+	 */
+	template <std::size_t N, std::size_t G = 16>
+	static void
+	GetMany(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* root, auto first, auto last, auto const& emit)
+	{
+		CountedAt<N, Cs ...> cmp;
+		while (first != last) {
+			std::remove_reference_t<decltype(*first)>* key[G];
+			SNode* t[G];
+			SNode* found[G];
+			std::size_t n{0};
+			for (; n < G && first != last; ++n, ++first) {
+				key[n] = std::addressof(*first);
+				t[n] = reinterpret_cast<SNode*>(root);
+				found[n] = nullptr;
+			}
+			for (bool pending = root; pending;) {
+				pending = false;
+				for (std::size_t i = 0; i < n; ++i) {
+					auto* s = t[i];
+					if (!s)
+						continue;
+					auto const order = Compare(cmp, static_cast<K const&>(s->key), *key[i]);
+					if (order > 0)
+						s = s->d[N].hasLeft ? s->template left<N, SNode>() : nullptr;
+					else if (order < 0)
+						s = s->d[N].hasRight ? s->template right<N, SNode>() : nullptr;
+					else {
+						found[i] = s;
+						s = nullptr;
+					}
+					if ((t[i] = s)) {
+						__builtin_prefetch(s);
+						__builtin_prefetch(&s->key);
+						pending = true;
+					}
+				}
+			}
+			for (std::size_t i = 0; i < n; ++i)
+				emit(static_cast<TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*>(found[i]));
+		}
+	}
+
+	/**
+	 * @brief	Aggregate of the subtree on the Nth index, recomputing the subtrees changed since their last use.
+	 * @param	of Aggregate of a single node
+	 */
+	template <std::size_t N>
+	AggregateOf<N, Cs ...> const&
+	aggregate(auto const& of)
+	{
+		using M = MonoidOf<N, Cs ...>;
+		if (!this->d[N].aggregated) {
+			auto a = of(this);
+			if (this->d[N].hasLeft)
+				a = M::combine(this->template left<N, SNode>()->template aggregate<N>(of), a);
+			if (this->d[N].hasRight)
+				a = M::combine(a, this->template right<N, SNode>()->template aggregate<N>(of));
+			std::get<N>(agg) = std::move(a);
+			this->d[N].aggregated = true;
+		}
+		return std::get<N>(agg);
+	}
+
+	/**
+	 * @brief	Aggregate of the nodes on the Nth index whose keys are neither below nor above the range, in O(log n).
+	 */
+	template <std::size_t N>
+	AggregateOf<N, Cs ...>
+	aggregateWithin(auto const& of, auto const& below, auto const& above)
+	{
+		using M = MonoidOf<N, Cs ...>;
+		auto* t = this;
+		// the highest node in the range splits it
+		while (true) {
+			if (below(static_cast<K const&>(t->key))) {
+				if (!t->d[N].hasRight)
+					return M::identity();
+				t = t->template right<N, SNode>();
+			} else if (above(static_cast<K const&>(t->key))) {
+				if (!t->d[N].hasLeft)
+					return M::identity();
+				t = t->template left<N, SNode>();
+			} else
+				break;
+		}
+		auto a = of(t);
+		for (auto* s = t->d[N].hasLeft ? t->template left<N, SNode>() : nullptr; s;) {
+			if (below(static_cast<K const&>(s->key)))
+				s = s->d[N].hasRight ? s->template right<N, SNode>() : nullptr;
+			else {
+				if (s->d[N].hasRight)
+					a = M::combine(s->template right<N, SNode>()->template aggregate<N>(of), a);
+				a = M::combine(of(s), a);
+				s = s->d[N].hasLeft ? s->template left<N, SNode>() : nullptr;
+			}
+		}
+		for (auto* s = t->d[N].hasRight ? t->template right<N, SNode>() : nullptr; s;) {
+			if (!above(static_cast<K const&>(s->key))) {
+				if (s->d[N].hasLeft)
+					a = M::combine(a, s->template left<N, SNode>()->template aggregate<N>(of));
+				a = M::combine(a, of(s));
+				s = s->d[N].hasRight ? s->template right<N, SNode>() : nullptr;
+			} else
+				s = s->d[N].hasLeft ? s->template left<N, SNode>() : nullptr;
+		}
+		return a;
+	}
+
+	/**
+	 * @brief	Aggregate of the nodes in [lo, hi) on the Nth index, in O(log n).
+	 */
+	template <std::size_t N>
+	AggregateOf<N, Cs ...>
+	aggregate(auto const& of, auto const& lo, auto const& hi)
+	{
+		CountedAt<N, Cs ...> cmp;
+		return aggregateWithin<N>(of,
+			[&](K const& k) { return Precedes(cmp, k, lo); },
+			[&](K const& k) { return !Precedes(cmp, k, hi); });
+	}
+
+	/**
+	 * @brief	First node on the Nth index whose aggregate with the nodes before it satisfies pred, in O(log n).
+	 * @details	pred must be monotone, once it holds for a prefix it must hold for the longer ones.
+	 */
+	template <std::size_t N>
+	TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	search(auto const& of, auto const& pred)
+	{
+		using M = MonoidOf<N, Cs ...>;
+		auto a = M::identity();
+		auto* t = this;
+		while (true) {
+			if (t->d[N].hasLeft) {
+				auto l = M::combine(a, t->template left<N, SNode>()->template aggregate<N>(of));
+				if (pred(std::as_const(l))) {
 					t = t->template left<N, SNode>();
 					continue;
 				}
+				a = std::move(l);
+			}
+			a = M::combine(a, of(t));
+			if (pred(std::as_const(a)))
+				return t;
+			if (!t->d[N].hasRight)
 				return nullptr;
+			t = t->template right<N, SNode>();
+		}
+	}
+
+	/**
+	 * @brief	Mark the aggregates of t and its ancestors on the Nth index to be recomputed, in O(log n).
+	 */
+	template <std::size_t N>
+	void
+	invalidate(SNode const* t) noexcept
+	{
+		CountedAt<N, Cs ...> cmp;
+		for (auto* s = this; s;) {
+			s->d[N].aggregated = false;
+			if (s == t)
+				return;
+			if (Precedes(cmp, static_cast<K const&>(t->key), static_cast<K const&>(s->key)))
+				s = s->d[N].hasLeft ? s->template left<N, SNode>() : nullptr;
+			else
+				s = s->d[N].hasRight ? s->template right<N, SNode>() : nullptr;
+		}
+	}
+
+	template <std::size_t N>
+	std::uint64_t
+	rank(auto&& ... args) const
+	{
+		std::uint64_t r{0};
+		auto const* t = this;
+		CountedAt<N, Cs ...> cmp;
+		while (true) {
+			if (Precedes(cmp, static_cast<K const&>(t->key), args ...)) {
+				r += t->template leftCount<N>() + 1;
+				if (!t->d[N].hasRight)
+					return r;
+				t = t->template right<N, SNode>();
+			} else {
+				if (!t->d[N].hasLeft)
+					return r;
+				t = t->template left<N, SNode>();
 			}
-			if (cmp(static_cast<K const&>(t->key), std::forward<decltype(args)>(args) ...)) {
-				if (t->d[N].hasRight) {
-					t = t->template right<N, SNode>();
-					continue;
+		}
+	}
+
+	/**
+	 * @brief	First node not ordered before args, in O(log n).
+	 */
+	template <std::size_t N>
+	TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	lowerBound(auto&& ... args)
+	{
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* b{nullptr};
+		auto* t = this;
+		CountedAt<N, Cs ...> cmp;
+		while (true) {
+			if (Precedes(cmp, static_cast<K const&>(t->key), args ...)) {
+				if (!t->d[N].hasRight)
+					return b;
+				t = t->template right<N, SNode>();
+			} else {
+				b = t;
+				if (!t->d[N].hasLeft)
+					return b;
+				t = t->template left<N, SNode>();
+			}
+		}
+	}
+
+	/**
+	 * @brief	First node ordered after args, in O(log n).
+	 */
+	template <std::size_t N>
+	TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	upperBound(auto&& ... args)
+	{
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* b{nullptr};
+		auto* t = this;
+		CountedAt<N, Cs ...> cmp;
+		while (true) {
+			if (Precedes(cmp, args ..., static_cast<K const&>(t->key))) {
+				b = t;
+				if (!t->d[N].hasLeft)
+					return b;
+				t = t->template left<N, SNode>();
+			} else {
+				if (!t->d[N].hasRight)
+					return b;
+				t = t->template right<N, SNode>();
+			}
+		}
+	}
+
+	/**
+	 * @brief	Split the tree t of height ht into the nodes ordered before and after args, in O(log n).
+	 * @param	l, hl Tree of the preceding nodes and its height
+	 * @param	r, hr Tree of the following nodes and its height
+	 * @return	Unlinked node equal to args if any
+	 * @details	Threads are left as they are, see TNode::Thread.
+	 */
+	template <std::size_t N>
+	static SNode*
+	Split(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* t, int ht,
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*& l, int& hl,
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*& r, int& hr, auto&& ... args) noexcept
+	{
+		if (!t) {
+			l = r = nullptr;
+			hl = hr = 0;
+			return nullptr;
+		}
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* tl = t->d[N].hasLeft ? t->template left<N>() : nullptr;
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* tr = t->d[N].hasRight ? t->template right<N>() : nullptr;
+		int const htl = ht - (t->d[N].isRight ? 2 : 1);
+		int const htr = ht - (t->d[N].isLeft ? 2 : 1);
+		auto const order = Compare(CountedAt<N, Cs ...>{}, static_cast<K const&>(reinterpret_cast<SNode*>(t)->key), args ...);
+		if (order > 0) {
+			auto* e = Split<N>(tl, htl, l, hl, r, hr, std::forward<decltype(args)>(args) ...);
+			r = TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template Join<N, Balance>(r, hr, t, tr, htr, hr);
+			return e;
+		}
+		if (order < 0) {
+			auto* e = Split<N>(tr, htr, l, hl, r, hr, std::forward<decltype(args)>(args) ...);
+			l = TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template Join<N, Balance>(tl, htl, t, l, hl, hl);
+			return e;
+		}
+		l = tl;
+		hl = htl;
+		r = tr;
+		hr = htr;
+		return reinterpret_cast<SNode*>(t);
+	}
+
+	/**
+	 * @brief	Copy the shape of the tree t on the Nth index with the nodes created by copy.
+	 * @details	The subtrees of at least Grain nodes are copied on separate threads while threads allow, the others
+	 * iteratively. Threads are left unset, see TNode::Thread.
+	 */
+	template <typename Node, std::size_t N>
+	static TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	Clone(SNode const* t, auto const& copy, unsigned threads)
+	{
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* c = copy(static_cast<K const&>(t->key));
+		Shape<N>(c, t);
+		if (threads > 1 && t->d[N].cnt >= TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::Grain) {
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* l{nullptr};
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* r{nullptr};
+			try {
+				TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::Fork(true,
+					[&] {
+						if (t->d[N].hasLeft)
+							l = Clone<Node, N>(t->template left<N, SNode>(), copy, threads / 2);
+					},
+					[&] {
+						if (t->d[N].hasRight)
+							r = Clone<Node, N>(t->template right<N, SNode>(), copy, threads - threads / 2);
+					});
+			} catch (...) {
+				if (l)
+					l->template deleteTree<Node, N>();
+				if (r)
+					r->template deleteTree<Node, N>();
+				delete reinterpret_cast<Node*>(c);
+				throw;
+			}
+			c->d[N].hasLeft = l != nullptr;
+			c->d[N].hasRight = r != nullptr;
+			c->template left<N>(l);
+			c->template right<N>(r);
+			return c;
+		}
+
+		// nodes whose children are still to be copied, an AVL tree of 2^64 nodes is less than 93 high
+		std::pair<SNode const*, TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*> pending[96];
+		std::size_t n{0};
+		pending[n++] = {t, c};
+		try {
+			while (n) {
+				auto [s, p] = pending[--n];
+				if (s->d[N].hasRight) {
+					auto const* sr = s->template right<N, SNode>();
+					auto* r = copy(static_cast<K const&>(sr->key));
+					Shape<N>(r, sr);
+					p->d[N].hasRight = true;
+					p->template right<N>(r);
+					pending[n++] = {sr, r};
+				}
+				if (s->d[N].hasLeft) {
+					auto const* sl = s->template left<N, SNode>();
+					auto* l = copy(static_cast<K const&>(sl->key));
+					Shape<N>(l, sl);
+					p->d[N].hasLeft = true;
+					p->template left<N>(l);
+					pending[n++] = {sl, l};
 				}
+			}
+		} catch (...) {
+			c->template deleteTree<Node, N>();
+			throw;
+		}
+		return c;
+	}
+
+	// Copy the state of t on the Nth index to its childless copy c
+	template <std::size_t N>
+	static void
+	Shape(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* c, SNode const* t) noexcept
+	{
+		c->d[N].balance = t->d[N].balance;
+		c->d[N].hasLeft = false;
+		c->d[N].hasRight = false;
+		c->d[N].aggregated = false;
+		c->template left<N>(nullptr);
+		c->template right<N>(nullptr);
+		c->d[N].cnt = t->d[N].cnt;
+	}
+
+	/**
+	 * @brief	Merge the tree b into the tree a by splitting a around the keys of b.
+	 * @tparam	OnlyA Keep the nodes of a missing in b
+	 * @tparam	OnlyB Keep copies of the nodes of b missing in a
+	 * @tparam	Both Keep the node chosen by select(aKey, bKey) for the keys in both
+	 * @tparam	Move Consume b too, relinking its kept nodes instead of copying them and deleting the others
+	 * @param	a, ha Tree consumed by the merge and its height
+	 * @param	b, hb Tree left untouched unless Move and its height
+	 * @param	h Height of the merged tree
+	 * @return	Root of the merged tree
+	 * @details	Takes O(m log(n / m + 1)) work for trees of sizes m <= n, the recursions on
+	 * the two halves run on separate threads while threads allow and the halves are large enough.
+	 * The threads of a and b are kept around each join, all but the ones of the two ends of the merged tree, the
+	 * copies of the nodes of b are left unthreaded, see TNode::Thread. select must not throw if Move.
+	 */
+	template <typename Node, std::size_t N, bool OnlyA, bool OnlyB, bool Both, bool Move = false>
+	static TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	Merge(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* a, int ha, SNode const* b, int hb, int& h,
+			unsigned threads, auto const& copy, auto const& select)
+	{
+		if (!b) {
+			if constexpr (OnlyA) {
+				h = ha;
+				return a;
+			} else {
+				if (a)
+					a->template deleteTree<Node, N>();
+				h = 0;
 				return nullptr;
 			}
+		}
+		if (!a) {
+			if constexpr (OnlyB) {
+				h = hb;
+				if constexpr (Move)
+					return const_cast<SNode*>(b);
+				else
+					return Clone<Node, N>(b, copy, threads);
+			} else {
+				if constexpr (Move)
+					const_cast<SNode*>(b)->template deleteTree<Node, N>();
+				h = 0;
+				return nullptr;
+			}
+		}
+
+		bool const parallel = threads > 1 && a->d[N].cnt + b->d[N].cnt >= TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::Grain;
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* l;
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* r;
+		int hl, hr;
+		SNode* e = Split<N>(a, ha, l, hl, r, hr, static_cast<K const&>(b->key));
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* k{nullptr};
+		// b itself if Move and it is not kept
+		SNode* d = Move ? const_cast<SNode*>(b) : nullptr;
+		try {
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::Fork(parallel,
+				[&] { l = Merge<Node, N, OnlyA, OnlyB, Both, Move>(std::exchange(l, nullptr), hl,
+						b->d[N].hasLeft ? b->template left<N, SNode>() : nullptr, hb - (b->d[N].isRight ? 2 : 1), hl,
+						threads / 2, copy, select); },
+				[&] { r = Merge<Node, N, OnlyA, OnlyB, Both, Move>(std::exchange(r, nullptr), hr,
+						b->d[N].hasRight ? b->template right<N, SNode>() : nullptr, hb - (b->d[N].isLeft ? 2 : 1), hr,
+						threads - threads / 2, copy, select); });
+			if (e) {
+				if constexpr (Both) {
+					static_assert(!Move || noexcept(select(std::declval<K const&>(), std::declval<K const&>())));
+					K const& key = select(static_cast<K const&>(e->key), static_cast<K const&>(b->key));
+					if (&key == &static_cast<K const&>(e->key))
+						k = std::exchange(e, nullptr);
+					else if constexpr (Move)
+						k = std::exchange(d, nullptr);
+					else
+						k = copy(key);
+				}
+			} else if constexpr (OnlyB) {
+				if constexpr (Move)
+					k = std::exchange(d, nullptr);
+				else
+					k = copy(static_cast<K const&>(b->key));
+			}
+		} catch (...) {
+			if (l)
+				l->template deleteTree<Node, N>();
+			if (r)
+				r->template deleteTree<Node, N>();
+			delete reinterpret_cast<Node*>(e);
+			delete reinterpret_cast<Node*>(d);
+			throw;
+		}
+		delete reinterpret_cast<Node*>(e);
+		delete reinterpret_cast<Node*>(d);
+		auto* P = l ? l->template rightMost<N>() : nullptr;
+		auto* S = r ? r->template leftMost<N>() : nullptr;
+		if (!k) {
+			auto* t = TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template Concat<N, Balance>(l, hl, r, hr, h);
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template Rethread<N>(P, S);
 			return t;
 		}
+		auto* t = TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template Join<N, Balance>(l, hl, k, r, hr, h);
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template Rethread<N>(P, k);
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template Rethread<N>(k, S);
+		return t;
 	}
 
 	template <std::size_t N>
-	TNode<sizeof...(Cs)>*
-	attach(TNode<sizeof...(Cs)>** created) noexcept
+	TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	attach(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>** created) noexcept
 	{
-		if (TypeAt<N, Cs ...>{}(static_cast<K const&>(reinterpret_cast<SNode*>(*created)->key), static_cast<K const&>(key)))
-			return this->d[N].hasLeft
-				? this->template attachedToLeft<N>(this->template left<N, SNode>()->template attach<N>(created))
-				: this->template attachToLeft<N>(*created);
+		auto* c = *created;
+		Stat::template visited<N>();
+		auto const order = Compare(CountedAt<N, Cs ...>{}, static_cast<K const&>(key), static_cast<K const&>(reinterpret_cast<SNode*>(c)->key));
+		if (order > 0) {
+			if (!this->d[N].hasLeft) {
+				Stat::template descended<N>(Stats::Descent::Put);
+				return this->template attachToLeft<N>(c);
+			}
+			auto* t = this->template left<N, SNode>()->template attach<N>(created);
+			if (c == *created)
+				this->template recount<N>(1);
+			return this->template attachedToLeft<N, Stat, Balance>(t);
+		}
 
-		if (TypeAt<N, Cs ...>{}(static_cast<K const&>(key), static_cast<K const&>(reinterpret_cast<SNode*>(*created)->key)))
-			return this->d[N].hasRight
-				? this->template attachedToRight<N>(this->template right<N, SNode>()->template attach<N>(created))
-				: this->template attachToRight<N>(*created);
+		if (order < 0) {
+			if (!this->d[N].hasRight) {
+				Stat::template descended<N>(Stats::Descent::Put);
+				return this->template attachToRight<N>(c);
+			}
+			auto* t = this->template right<N, SNode>()->template attach<N>(created);
+			if (c == *created)
+				this->template recount<N>(1);
+			return this->template attachedToRight<N, Stat, Balance>(t);
+		}
 
+		Stat::template descended<N>(Stats::Descent::Put);
 		*created = this;
 		return nullptr;
 	}
 
+	/**
+	 * @brief	Attach created after the last node without comparing keys, returns as attach.
+	 */
+	template <std::size_t N>
+	TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	attachLast(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* created) noexcept
+	{
+		if (!this->d[N].hasRight)
+			return this->template attachToRight<N>(created);
+		auto* t = this->template right<N, SNode>()->template attachLast<N>(created);
+		this->template recount<N>(1);
+		return this->template attachedToRight<N, Stat, Balance>(t);
+	}
+
+	/**
+	 * @brief	Attach created before the first node without comparing keys, returns as attach.
+	 */
+	template <std::size_t N>
+	TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	attachFirst(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* created) noexcept
+	{
+		if (!this->d[N].hasLeft)
+			return this->template attachToLeft<N>(created);
+		auto* t = this->template left<N, SNode>()->template attachFirst<N>(created);
+		this->template recount<N>(1);
+		return this->template attachedToLeft<N, Stat, Balance>(t);
+	}
+
+	/**
+	 * @brief	Attach the node made by create() where args belongs unless a node equal to args exists, in one descent.
+	 * @param	found Node equal to args if any, otherwise the created one
+	 * @param	created Whether create() is called
+	 * @return	Root of the subtree if it is rotated or grown as in attach
+	 * @details	The descent is iterative as in get, only a miss walks its path back up to rebalance.
+	 * Nothing is changed if create() throws.
+	 */
+	template <std::size_t N>
+	TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	emplace(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*& found, bool& created, auto const& create, auto&& ... args)
+	{
+		// deeper than any tree of less than 2^64 nodes balanced by one of the policies
+		constexpr std::size_t MaxHeight{160};
+		SNode* path[MaxHeight];
+		bool toRight[MaxHeight];
+		std::size_t depth{0};
+		CountedAt<N, Cs ...> cmp;
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* t;
+		for (auto* s = this;;) {
+			Stat::template visited<N>();
+			auto const order = Compare(cmp, static_cast<K const&>(s->key), args ...);
+			if (order == 0) {
+				Stat::template descended<N>(Stats::Descent::Get);
+				found = s;
+				return nullptr;
+			}
+			bool const right = order < 0;
+			if (right ? !s->d[N].hasRight : !s->d[N].hasLeft) {
+				Stat::template descended<N>(Stats::Descent::Put);
+				found = create();
+				created = true;
+				t = right ? s->template attachToRight<N>(found) : s->template attachToLeft<N>(found);
+				break;
+			}
+			path[depth] = s;
+			toRight[depth++] = right;
+			s = right ? s->template right<N, SNode>() : s->template left<N, SNode>();
+		}
+		while (depth--) {
+			auto* s = path[depth];
+			s->template recount<N>(1);
+			t = toRight[depth] ? s->template attachedToRight<N, Stat, Balance>(t) : s->template attachedToLeft<N, Stat, Balance>(t);
+		}
+		return t;
+	}
+
 	template <std::size_t N>
-	TNode<sizeof...(Cs)>*
-	detachFromLeft(TNode<sizeof...(Cs)>** toDel)
+	TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	detachFromLeft(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>** toDel)
 	{
 		if (this->d[N].hasLeft) {
 			bool leftWasBalanced = this->template left<N>()->d[N].isBalanced;
-			if (auto* t = this->template left<N, SNode>()->template detach<N>(toDel)) {
+			auto* t = this->template left<N, SNode>()->template detach<N>(toDel);
+			if (*toDel)
+				this->template recount<N>(-1);
+			if (t) {
 				if (t != this->template left<N>()) {
 					this->template left<N>(t);
 					if (leftWasBalanced || !this->template left<N>()->d[N].isBalanced)
@@ -204,27 +814,32 @@ struct SNode : TNode<sizeof...(Cs)> {
 				}
 				if (this->d[N].isRight) {
 					if (this->template right<N>()->d[N].isLeft)
-						return this->template rl<N>();
+						return this->template rl<N, Stat>();
 					if (this->template right<N>()->d[N].isRight)
-						return this->template rr<N>();
+						return this->template rr<N, Stat>();
 					this->template right<N>()->d[N].balance = 4;
+					Stat::template rotated<N>(Stats::Rotation::RR);
 					return this->template leftRotate<N>();
 				}
 				this->d[N].balance >>= 1;
 				if (this->d[N].isBalanced)
 					return this;
 			}
-		}
+		} else // not found
+			Stat::template descended<N>(Stats::Descent::Remove);
 		return nullptr;
 	}
 
 	template <std::size_t N>
-	TNode<sizeof...(Cs)>*
-	detachFromRight(TNode<sizeof...(Cs)>** toDel)
+	TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	detachFromRight(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>** toDel)
 	{
 		if (this->d[N].hasRight) {
 			bool rightWasBalanced = this->template right<N>()->d[N].isBalanced;
-			if (auto* t = this->template right<N, SNode>()->template detach<N>(toDel)) {
+			auto* t = this->template right<N, SNode>()->template detach<N>(toDel);
+			if (*toDel)
+				this->template recount<N>(-1);
+			if (t) {
 				if (t != this->template right<N>()) {
 					this->template right<N>(t);
 					if (rightWasBalanced || !this->template right<N>()->d[N].isBalanced)
@@ -235,28 +850,117 @@ struct SNode : TNode<sizeof...(Cs)> {
 				}
 				if (this->d[N].isLeft) {
 					if (this->template left<N>()->d[N].isRight)
-						return this->template lr<N>();
+						return this->template lr<N, Stat>();
 					if (this->template left<N>()->d[N].isLeft)
-						return this->template ll<N>();
+						return this->template ll<N, Stat>();
 					this->template left<N>()->d[N].balance = 1;
+					Stat::template rotated<N>(Stats::Rotation::LL);
 					return this->template rightRotate<N>();
 				}
 				this->d[N].balance <<= 1;
 				if (this->d[N].isBalanced)
 					return this;
 			}
+		} else // not found
+			Stat::template descended<N>(Stats::Descent::Remove);
+		return nullptr;
+	}
+
+	template <std::size_t N>
+	TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	unlinkFromLeft(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>** toDel, bool& shrunk) noexcept
+	{
+		if (!this->d[N].hasLeft) { // not found
+			Stat::template descended<N>(Stats::Descent::Remove);
+			*toDel = nullptr;
+			return this;
+		}
+		auto* l = this->template left<N>();
+		auto* t = this->template left<N, SNode>()->template unlink<N>(toDel, shrunk);
+		if (!*toDel)
+			return this;
+		this->template recount<N>(-1);
+		if (t)
+			this->template left<N>(t);
+		else {
+			this->d[N].hasLeft = false;
+			this->template left<N>(l->template left<N>());
+		}
+		return this->template detachedFromLeft<N, Stat, Balance>(shrunk);
+	}
+
+	template <std::size_t N>
+	TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	unlinkFromRight(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>** toDel, bool& shrunk) noexcept
+	{
+		if (!this->d[N].hasRight) { // not found
+			Stat::template descended<N>(Stats::Descent::Remove);
+			*toDel = nullptr;
+			return this;
+		}
+		auto* r = this->template right<N>();
+		auto* t = this->template right<N, SNode>()->template unlink<N>(toDel, shrunk);
+		if (!*toDel)
+			return this;
+		this->template recount<N>(-1);
+		if (t)
+			this->template right<N>(t);
+		else {
+			this->d[N].hasRight = false;
+			this->template right<N>(r->template right<N>());
+		}
+		return this->template detachedFromRight<N, Stat, Balance>(shrunk);
+	}
+
+	// Detach toDel as detach does from the trees of other Balancing policies than AVL
+	// Returns the root of the subtree, null if it is left empty, shrunk if its rank decreases
+	template <std::size_t N>
+	TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	unlink(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>** toDel, bool& shrunk) noexcept
+	{
+		Stat::template visited<N>();
+		auto const order = Compare(CountedAt<N, Cs ...>{}, static_cast<K const&>(key), static_cast<K const&>(reinterpret_cast<SNode*>(*toDel)->key));
+		if (order > 0)
+			return unlinkFromLeft<N>(toDel, shrunk);
+		if (order < 0)
+			return unlinkFromRight<N>(toDel, shrunk);
+		if (this != *toDel || !this->d[N].hasLeft || !this->d[N].hasRight) // else goes on below the next node
+			Stat::template descended<N>(Stats::Descent::Remove);
+		if (this != *toDel) {
+			*toDel = nullptr;
+			return this;
+		}
+		if (this->d[N].hasLeft && this->d[N].hasRight)
+			return this->template swapWithNext<N, SNode>()->template unlinkFromRight<N>(toDel, shrunk);
+		shrunk = true;
+		if (this->d[N].hasRight) { // a single child, not a leaf if weight balanced
+			this->template right<N>()->template leftMost<N>()->template left<N>(this->template left<N>());
+			return this->template right<N>();
+		}
+		if (this->d[N].hasLeft) {
+			this->template left<N>()->template rightMost<N>()->template right<N>(this->template right<N>());
+			return this->template left<N>();
 		}
 		return nullptr;
 	}
 
 	template <std::size_t N>
-	TNode<sizeof...(Cs)>*
-	detach(TNode<sizeof...(Cs)>** toDel) noexcept
+	TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	detach(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>** toDel) noexcept
 	{
-		if (TypeAt<N, Cs ...>{}(static_cast<K const&>(reinterpret_cast<SNode*>(*toDel)->key), static_cast<K const&>(key)))
+		if constexpr (!std::same_as<Balance, AVL>) {
+			bool shrunk{false};
+			auto* t = unlink<N>(toDel, shrunk);
+			return !*toDel ? nullptr : t ? t : this;
+		}
+		Stat::template visited<N>();
+		auto const order = Compare(CountedAt<N, Cs ...>{}, static_cast<K const&>(key), static_cast<K const&>(reinterpret_cast<SNode*>(*toDel)->key));
+		if (order > 0)
 			return detachFromLeft<N>(toDel);
-		if (TypeAt<N, Cs ...>{}(static_cast<K const&>(key), static_cast<K const&>(reinterpret_cast<SNode*>(*toDel)->key)))
+		if (order < 0)
 			return detachFromRight<N>(toDel);
+		if (this != *toDel || !this->d[N].hasLeft || !this->d[N].hasRight) // else goes on below the next node
+			Stat::template descended<N>(Stats::Descent::Remove);
 		if (this != *toDel)
 			return *toDel = nullptr;
 		if (this->d[N].hasRight) {
@@ -276,6 +980,372 @@ struct SNode : TNode<sizeof...(Cs)> {
 		return this;
 	}
 
+	// Detach toDel from every index but the Nth
+	template <std::size_t N, std::size_t M = 0>
+	static void
+	DetachOthers(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* root[], TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* toDel) noexcept
+	{
+		if constexpr (M != N) {
+			auto* s = toDel;
+			if (auto* t = reinterpret_cast<SNode*>(root[M])->template detach<M>(&toDel))
+				root[M] = t;
+			if (s == root[M])
+				root[M] = nullptr;
+		}
+		if constexpr (M + 1 < Dimension<Cs ...>)
+			DetachOthers<N, M + 1>(root, toDel);
+	}
+
+	// Relink the n nodes not marked on the Nth index into balanced trees on every other index
+	template <std::size_t N, std::size_t M = 0>
+	static void
+	RelinkOthers(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* root[], std::uint64_t n) noexcept
+	{
+		if constexpr (M != N) {
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* head{nullptr};
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* tail{nullptr};
+			for (auto* t = root[M]->template leftMost<M>(); t;) {
+				auto* next = t->template next<M>();
+				if (!t->d[N].u1) {
+					if (tail)
+						tail->template right<M>(t);
+					else
+						head = t;
+					tail = t;
+				}
+				t = next;
+			}
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* last{nullptr};
+			root[M] = n ? TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template BuildBalanced<M>(head, last, n) : nullptr;
+		}
+		if constexpr (M + 1 < Dimension<Cs ...>)
+			RelinkOthers<N, M + 1>(root, n);
+	}
+
+	// Stable merge sort of the first n nodes of list chained through right<M>() by the Mth comparator, list is advanced past them
+	template <std::size_t M>
+	static TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	Sort(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*& list, std::uint64_t n) noexcept
+	{
+		if (n == 1) {
+			auto* t = list;
+			list = t->template right<M>();
+			t->template right<M>(nullptr);
+			return t;
+		}
+		auto* a = Sort<M>(list, n / 2);
+		auto* b = Sort<M>(list, n - n / 2);
+		CountedAt<M, Cs ...> cmp;
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* head{nullptr};
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* tail{nullptr};
+		while (a && b) {
+			auto*& t = Precedes(cmp, static_cast<K const&>(reinterpret_cast<SNode*>(b)->key),
+				static_cast<K const&>(reinterpret_cast<SNode*>(a)->key)) ? b : a;
+			if (tail)
+				tail->template right<M>(t);
+			else
+				head = t;
+			tail = t;
+			t = t->template right<M>();
+		}
+		tail->template right<M>(a ? a : b);
+		return head;
+	}
+
+	// Chain the n nodes of the Nth index through right<M>() in the order of the Mth comparator, keeping their order on ties
+	// and pointing left<M>() of each one to the first node of its run of equal ones
+	template <std::size_t N, std::size_t M>
+	static TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	Chain(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* root, std::uint64_t n) noexcept
+	{
+		CountedAt<M, Cs ...> cmp;
+		if constexpr (std::is_trivially_copyable_v<K> && sizeof(K) <= 2 * sizeof(void*)) {
+			// sorting copies of small keys saves the cache misses of reaching them through the nodes
+			try {
+				std::vector<std::pair<K, TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*>> keys;
+				keys.reserve(n);
+				for (auto* t = root->template leftMost<N>(); t; t = t->template next<N>())
+					keys.emplace_back(static_cast<K const&>(reinterpret_cast<SNode*>(t)->key), t);
+				std::stable_sort(keys.begin(), keys.end(), [&](auto const& a, auto const& b) {
+					return Precedes(cmp, a.first, b.first);
+				});
+				auto* first = keys.front().second;
+				first->template left<M>(first);
+				for (std::uint64_t i{1}; i < n; ++i) {
+					keys[i - 1].second->template right<M>(keys[i].second);
+					if (Precedes(cmp, keys[i - 1].first, keys[i].first))
+						first = keys[i].second;
+					keys[i].second->template left<M>(first);
+				}
+				keys.back().second->template right<M>(nullptr);
+				return keys.front().second;
+			} catch (std::bad_alloc const&) {}
+		}
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* head{nullptr};
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* tail{nullptr};
+		for (auto* t = root->template leftMost<N>(); t; t = t->template next<N>()) {
+			if (tail)
+				tail->template right<M>(t);
+			else
+				head = t;
+			tail = t;
+		}
+		head = Sort<M>(head, n);
+		auto* first = head;
+		head->template left<M>(first);
+		for (auto* t = head; auto* next = t->template right<M>(); t = next) {
+			if (Precedes(cmp, static_cast<K const&>(reinterpret_cast<SNode*>(t)->key),
+					static_cast<K const&>(reinterpret_cast<SNode*>(next)->key)))
+				first = next;
+			next->template left<M>(first);
+		}
+		return head;
+	}
+
+	// Sort the n nodes of the Nth index on every other index into head
+	template <std::size_t N, std::size_t M = 0>
+	static void
+	SortOthers(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* root[], TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* head[], std::uint64_t n) noexcept
+	{
+		if constexpr (M != N)
+			head[M] = Chain<N, M>(root[N], n);
+		if constexpr (M + 1 < Dimension<Cs ...>)
+			SortOthers<N, M + 1>(root, head, n);
+	}
+
+	// Whether a run of nodes equal to t on an index other than the Nth already has a node kept, see Chain()
+	template <std::size_t N, std::size_t M = 0>
+	static bool
+	Taken(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* t) noexcept
+	{
+		if constexpr (M != N) {
+			if (t->template left<M>()->d[M].u1)
+				return true;
+		}
+		if constexpr (M + 1 < Dimension<Cs ...>)
+			return Taken<N, M + 1>(t);
+		return false;
+	}
+
+	// Keep t in its run of equal nodes on every index other than the Nth
+	template <std::size_t N, std::size_t M = 0>
+	static void
+	Take(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* t) noexcept
+	{
+		if constexpr (M != N)
+			t->template left<M>()->d[M].u1 = true;
+		if constexpr (M + 1 < Dimension<Cs ...>)
+			Take<N, M + 1>(t);
+	}
+
+	// Mark on the Nth index the nodes equal on another index to a node kept before them, in the order of the Nth index
+	// as if they were put one by one, return the number of marked nodes
+	template <std::size_t N>
+	static std::uint64_t
+	MarkTaken(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* root) noexcept
+	{
+		std::uint64_t marked{0};
+		for (auto* t = root->template leftMost<N>(); t; t = t->template next<N>()) {
+			if (Taken<N>(t)) {
+				t->d[N].u1 = true;
+				++marked;
+			} else
+				Take<N>(t);
+		}
+		return marked;
+	}
+
+	// Link the first n nodes not marked on the Nth index of the sorted lists in head into balanced trees on every other index
+	template <std::size_t N, std::size_t M = 0>
+	static void
+	LinkOthers(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* root[], TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* head[], std::uint64_t n) noexcept
+	{
+		if constexpr (M != N) {
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* tail{nullptr};
+			for (auto* t = head[M]; t; t = t->template right<M>()) {
+				t->d[M].u1 = false; // see Take()
+				if (t->d[N].u1)
+					continue;
+				if (tail)
+					tail->template right<M>(t);
+				else
+					head[M] = t;
+				tail = t;
+			}
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* last{nullptr};
+			root[M] = TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template BuildBalanced<M>(head[M], last, n);
+		}
+		if constexpr (M + 1 < Dimension<Cs ...>)
+			LinkOthers<N, M + 1>(root, head, n);
+	}
+
+	/**
+	 * @brief	Link the n nodes of the Nth index into balanced trees on every other index.
+	 * @param	root Roots of the indices, only the Nth one is read
+	 * @return	Number of nodes left in the trees
+	 * @details	Each index is merge sorted in O(n log n) and linked in O(n), rather than attached to node by node.
+	 * Nodes equal on another index to one kept before them on the Nth index are deleted, as if the nodes were put one
+	 * by one in the order of the Nth index, relinking it in O(n).
+	 */
+	template <typename Node, std::size_t N>
+	static std::uint64_t
+	Reindex(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* root[], std::uint64_t n) noexcept
+	{
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* head[Dimension<Cs ...>];
+		SortOthers<N>(root, head, n);
+		std::uint64_t const marked = MarkTaken<N>(root[N]);
+		LinkOthers<N>(root, head, n - marked);
+		if (marked) {
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* tail{nullptr};
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* toDel{nullptr};
+			for (auto* t = root[N]->template leftMost<N>(); t;) {
+				auto* next = t->template next<N>();
+				if (t->d[N].u1) {
+					t->template right<N>(toDel);
+					toDel = t;
+				} else {
+					if (tail)
+						tail->template right<N>(t);
+					else
+						head[N] = t;
+					tail = t;
+				}
+				t = next;
+			}
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* last{nullptr};
+			root[N] = TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template BuildBalanced<N>(head[N], last, n - marked);
+			while (toDel) {
+				auto* t = toDel;
+				toDel = toDel->template right<N>();
+				delete reinterpret_cast<Node*>(t);
+			}
+		}
+		return n - marked;
+	}
+
+	/**
+	 * @brief	Unlink the nodes in [first, last) of the Nth index from every index and delete them.
+	 * @param	root Roots of the indices
+	 * @param	size Number of nodes in the trees
+	 * @param	last Node following the range, null for the end
+	 * @return	Number of deleted nodes
+	 * @details	The Nth index is split and joined around the range in O(log n). Each of the m nodes is detached from the
+	 * other indices if that costs less than relinking them, otherwise every index is relinked in O(n).
+	 */
+	template <typename Node, std::size_t N>
+	static std::uint64_t
+	Erase(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* root[], std::uint64_t size,
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* first, TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* last) noexcept
+	{
+		auto const* r = reinterpret_cast<SNode const*>(root[N]);
+		std::uint64_t const from = r->template rank<N>(static_cast<K const&>(reinterpret_cast<SNode*>(first)->key));
+		std::uint64_t const to = last ? r->template rank<N>(static_cast<K const&>(reinterpret_cast<SNode*>(last)->key)) : size;
+		if (to <= from)
+			return 0;
+		std::uint64_t const m = to - from;
+
+		if (m * std::bit_width(size) >= size) {
+			for (auto* t = first; t != last; t = t->template next<N>())
+				t->d[N].u1 = true;
+			if constexpr (Dimension<Cs ...> > 1)
+				RelinkOthers<N>(root, size - m);
+
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* head{nullptr};
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* tail{nullptr};
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* toDel{nullptr};
+			for (auto* t = root[N]->template leftMost<N>(); t;) {
+				auto* next = t->template next<N>();
+				if (t->d[N].u1) {
+					t->template right<N>(toDel);
+					toDel = t;
+				} else {
+					if (tail)
+						tail->template right<N>(t);
+					else
+						head = t;
+					tail = t;
+				}
+				t = next;
+			}
+			TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* prev{nullptr};
+			root[N] = size - m ? TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template BuildBalanced<N>(head, prev, size - m) : nullptr;
+			while (toDel) {
+				auto* t = toDel;
+				toDel = toDel->template right<N>();
+				delete reinterpret_cast<Node*>(t);
+			}
+			return m;
+		}
+
+		if constexpr (Dimension<Cs ...> > 1) {
+			for (auto* t = first; t != last; t = t->template next<N>())
+				DetachOthers<N>(root, t);
+		}
+
+		auto* P = first->template prev<N>();
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* l;
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* mid;
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* rest;
+		int hl, hm, hr, h;
+		Split<N>(root[N], root[N]->template height<N>(), l, hl, rest, hr, static_cast<K const&>(reinterpret_cast<SNode*>(first)->key));
+		if (last) {
+			Split<N>(rest, hr, mid, hm, rest, hr, static_cast<K const&>(reinterpret_cast<SNode*>(last)->key));
+			rest = TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template Join<N, Balance>(nullptr, 0, last, rest, hr, hr);
+		} else
+			mid = std::exchange(rest, nullptr);
+		root[N] = TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template Concat<N, Balance>(l, hl, rest, hr, h);
+
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template Rethread<N>(P, last);
+
+		if (mid)
+			mid->template deleteTree<Node, N>();
+		delete reinterpret_cast<Node*>(first);
+		return m;
+	}
+
+	/**
+	 * @brief	Cut the nodes not ordered before args on the Nth index out of the trees root.
+	 * @param	root Roots of the indices
+	 * @param	size Number of nodes in the trees
+	 * @return	Tree of the cut nodes on the Nth index, unlinked from the other indices
+	 * @details	The Nth index is split in O(log n). Each of the m nodes is detached from the other indices if that
+	 * costs less than relinking them, otherwise every other index is relinked in O(n).
+	 */
+	template <std::size_t N>
+	static TNode<Dimension<Cs ...>, LinksOf<Cs ...>>*
+	Cut(TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* root[], std::uint64_t size, auto&& ... args) noexcept
+	{
+		auto* r = reinterpret_cast<SNode*>(root[N]);
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* S = r->template lowerBound<N>(args ...);
+		if (!S)
+			return nullptr;
+
+		if constexpr (Dimension<Cs ...> > 1) {
+			std::uint64_t const m = size - r->template rank<N>(args ...);
+			if (m * std::bit_width(size) >= size) {
+				for (auto* t = S; t; t = t->template next<N>())
+					t->d[N].u1 = true;
+				RelinkOthers<N>(root, size - m);
+				for (auto* t = S; t; t = t->template next<N>())
+					t->d[N].u1 = false;
+			} else {
+				for (auto* t = S; t; t = t->template next<N>())
+					DetachOthers<N>(root, t);
+			}
+		}
+
+		auto* P = S->template prev<N>();
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* l;
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>* cut;
+		int hl, hc;
+		Split<N>(root[N], root[N]->template height<N>(), l, hl, cut, hc, static_cast<K const&>(reinterpret_cast<SNode*>(S)->key));
+		root[N] = l;
+		cut = TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template Join<N, Balance>(nullptr, 0, S, cut, hc, hc);
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template Rethread<N>(P, nullptr);
+		TNode<Dimension<Cs ...>, LinksOf<Cs ...>>::template Rethread<N>(nullptr, S);
+		return cut;
+	}
+
 	void
 	serialize(Stream::Output& output) const
 	requires Stream::InsertableTo<K, decltype(output)>
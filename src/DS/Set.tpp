@@ -4,14 +4,78 @@
 
 namespace DS {
 
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+void
+Set<K, C, Cs ...>::adopt(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* root) noexcept
+{
+	mRoot[N] = root;
+	if constexpr (Dimension<C, Cs ...> > 1)
+		mSize = SNode<K, C, Cs ...>::template Reindex<SNode<K, C, Cs ...>, N>(mRoot, root->d[N].cnt);
+	else
+		mSize = root->d[N].cnt;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N, bool OnlyA, bool OnlyB, bool Both>
+Set<K, C, Cs ...>
+Set<K, C, Cs ...>::Merge(Set const& a, Set const& b, unsigned threads, auto const& select)
+{
+	auto copy = [](K const& key) { return new SNode<K, C, Cs ...>(key); };
+	auto* root = a.mRoot[N]
+		? SNode<K, C, Cs ...>::template Clone<SNode<K, C, Cs ...>, N>(reinterpret_cast<SNode<K, C, Cs ...> const*>(a.mRoot[N]), copy, threads)
+		: nullptr;
+	int h;
+	root = SNode<K, C, Cs ...>::template Merge<SNode<K, C, Cs ...>, N, OnlyA, OnlyB, Both>(
+		root, root ? a.mRoot[N]->template height<N>() : 0,
+		reinterpret_cast<SNode<K, C, Cs ...> const*>(b.mRoot[N]), b.mRoot[N] ? b.mRoot[N]->template height<N>() : 0, h,
+		threads, copy, select);
+	Set set;
+	if (root) {
+		TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>::template Thread<N>(root, nullptr, nullptr, threads);
+		set.template adopt<N>(root);
+	}
+	return set;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N, bool OnlyA, bool OnlyB, bool Both, bool Move>
+void
+Set<K, C, Cs ...>::mergeInPlace(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* b, auto const& select)
+{
+	// never called, the nodes are relinked rather than copied
+	auto copy = [](K const&) noexcept -> TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* { return nullptr; };
+	int h;
+	auto* root = SNode<K, C, Cs ...>::template Merge<SNode<K, C, Cs ...>, N, OnlyA, OnlyB, Both, Move>(
+		mRoot[N], mRoot[N] ? mRoot[N]->template height<N>() : 0,
+		reinterpret_cast<SNode<K, C, Cs ...> const*>(b), b ? b->template height<N>() : 0, h,
+		1, copy, select);
+	std::fill(mRoot, mRoot + Dimension<C, Cs ...>, nullptr);
+	mSize = 0;
+	if (root) {
+		// Merge rethreads around the joins, only the ends are left
+		TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>::template Rethread<N>(nullptr, root->template leftMost<N>());
+		TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>::template Rethread<N>(root->template rightMost<N>(), nullptr);
+		adopt<N>(root);
+	}
+}
+
 template <typename K, typename C, typename ... Cs>
 Set<K, C, Cs ...>::Set(Set const& other)
+requires std::is_copy_constructible_v<K>
+		: Set(other, 1)
+{}
+
+template <typename K, typename C, typename ... Cs>
+Set<K, C, Cs ...>::Set(Set const& other, unsigned threads)
 requires std::is_copy_constructible_v<K>
 		: Container(other.mSize)
 {
 	if (mSize) {
-		mRoot[0] = SNode<K, C, Cs ...>::Create(nullptr, nullptr, other.mRoot[0]);
-		if constexpr(sizeof...(Cs) > 0)
+		mRoot[0] = SNode<K, C, Cs ...>::template Clone<SNode<K, C, Cs ...>, 0>(reinterpret_cast<SNode<K, C, Cs ...> const*>(other.mRoot[0]),
+			[](K const& key) { return new SNode<K, C, Cs ...>(key); }, threads);
+		TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>::Thread(mRoot[0], nullptr, nullptr, threads);
+		if constexpr(Dimension<C, Cs ...> > 1)
 			SNode<K, C, Cs ...>::template BuildTree<SNode<K, C, Cs ...>, Exception>(mRoot);
 	}
 }
@@ -25,7 +89,7 @@ void
 swap(Set<K, C, Cs ...>& a, Set<K, C, Cs ...>& b) noexcept
 {
 	std::swap(a.mSize, b.mSize);
-	std::swap_ranges(a.mRoot, a.mRoot + sizeof...(Cs) + 1, b.mRoot);
+	std::swap_ranges(a.mRoot, a.mRoot + Dimension<C, Cs ...>, b.mRoot);
 }
 
 template <typename K, typename C, typename ... Cs>
@@ -43,7 +107,7 @@ requires Stream::Deserializable<K, decltype(input), decltype(kArgs) ...>
 {
 	if (mSize) {
 		mRoot[0] = SNode<K, C, Cs ...>::Create(nullptr, nullptr, input, std::forward<decltype(kArgs)>(kArgs) ...);
-		if constexpr(sizeof...(Cs) > 0)
+		if constexpr(Dimension<C, Cs ...> > 1)
 			SNode<K, C, Cs ...>::template BuildTree<SNode<K, C, Cs ...>, Exception>(mRoot);
 	}
 }
@@ -55,7 +119,7 @@ Set<K, C, Cs ...>::Set(Stream::Input& input, DP::Factory<K, Type, Args ...>, aut
 {
 	if (mSize) {
 		mRoot[0] = SNode<K, C, Cs ...>::Create(nullptr, nullptr, input, DP::Factory<K, Type, Args ...>{}, std::forward<decltype(kArgs)>(kArgs) ...);
-		if constexpr(sizeof...(Cs) > 0)
+		if constexpr(Dimension<C, Cs ...> > 1)
 			SNode<K, C, Cs ...>::template BuildTree<SNode<K, C, Cs ...>, Exception>(mRoot);
 	}
 }
@@ -79,7 +143,7 @@ requires Stream::InsertableTo<K, decltype(dotOutput)>
 {
 	mRoot[N]->template toDot<N>(dotOutput);
 	reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template toDot<N>(dotOutput);
-	if constexpr (N < sizeof...(Cs))
+	if constexpr (N + 1 < Dimension<C, Cs ...>)
 		return toDot<N + 1>(dotOutput);
 	return dotOutput;
 }
@@ -98,50 +162,83 @@ requires Stream::InsertableTo<K, decltype(dotOutput)>
 
 template <typename K, typename C, typename ... Cs>
 Set<K, C, Cs ...>::~Set()
+{
+	if (mRoot[0]) {
+		PolicyOf<Reclaimer, Reclaimer, Cs ...>::reclaim(mRoot[0], [](void* root) {
+			static_cast<TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>*>(root)->template deleteTree<SNode<K, C, Cs ...>>();
+		});
+	}
+}
+
+template <typename K, typename C, typename ... Cs>
+void
+Set<K, C, Cs ...>::clear(unsigned threads) noexcept
 {
 	if (mRoot[0])
-		mRoot[0]->template deleteTree<SNode<K, C, Cs ...>>();
+		mRoot[0]->template deleteTree<SNode<K, C, Cs ...>>(threads);
+	std::fill(mRoot, mRoot + Dimension<C, Cs ...>, nullptr);
+	mSize = 0;
 }
 
 template <typename K, typename C, typename ... Cs>
-template <std::size_t N>
+FrozenSet<K, C, Cs ...>
+Set<K, C, Cs ...>::freeze() const
+requires std::is_copy_constructible_v<K>
+{ return FrozenSet<K, C, Cs ...>(*this); }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N, std::size_t Skip>
 SNode<K, C, Cs ...>*
 Set<K, C, Cs ...>::putAsRoot(SNode<K, C, Cs ...>* created) noexcept
 {
-	mRoot[N] = created;
-	created->template left<N>(nullptr);
-	created->template right<N>(nullptr);
-	created->template state<N>(2);
-	if constexpr (N < sizeof...(Cs))
-		return putAsRoot<N + 1>(created);
+	if constexpr (N != Skip) {
+		mRoot[N] = created;
+		created->template left<N>(nullptr);
+		created->template right<N>(nullptr);
+		created->template state<N>(2);
+		created->d[N].cnt = 1;
+	}
+	if constexpr (N + 1 < Dimension<C, Cs ...>)
+		return putAsRoot<N + 1, Skip>(created);
 	++mSize;
 	return created;
 }
 
 template <typename K, typename C, typename ... Cs>
-template <std::size_t N>
+template <std::size_t N, std::size_t Skip>
 SNode<K, C, Cs ...>*
 Set<K, C, Cs ...>::putToRoot(SNode<K, C, Cs ...>* created) noexcept
 {
-	auto* s = created;
-	if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template attach<N>(reinterpret_cast<TNode<sizeof...(Cs) + 1>**>(&created)))
-		mRoot[N] = t;
-	else if (s != created) { // found an existing node
-		delete s;
+	if constexpr (N == Skip) {
+		if constexpr (N + 1 < Dimension<C, Cs ...>)
+			return putToRoot<N + 1, Skip>(created);
+		++mSize;
 		return created;
-	}
-	if constexpr (N < sizeof...(Cs)) {
-		created = putToRoot<N + 1>(created);
-		if (s != created) { // later comparators found an existing node
-			// rollback last attachment
-			if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template detach<N>(reinterpret_cast<TNode<sizeof...(Cs) + 1>**>(&s)))
-				mRoot[N] = t;
+	} else {
+		// validate the later comparators first so that a collision leaves every index untouched,
+		// the node equal on the Nth index is still the one returned
+		if constexpr (N + 1 < Dimension<C, Cs ...>) {
+			if (auto* e = SNode<K, C, Cs ...>::template Collision<N + 1, Skip>(mRoot, created)) {
+				if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template get<N>(static_cast<K const&>(created->key)))
+					e = reinterpret_cast<SNode<K, C, Cs ...>*>(t);
+				if constexpr (N == 0 && Skip >= Dimension<C, Cs ...>)
+					delete created;
+				return e;
+			}
+		}
+		TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* e = created;
+		if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template attach<N>(&e))
+			mRoot[N] = t;
+		else if (e != created) { // found an existing node
+			if constexpr (N == 0 && Skip >= Dimension<C, Cs ...>) // otherwise created is still linked to the Skip index
+				delete created;
+			return reinterpret_cast<SNode<K, C, Cs ...>*>(e);
 		}
+		if constexpr (N + 1 < Dimension<C, Cs ...>)
+			SNode<K, C, Cs ...>::template AttachAll<N + 1, Skip>(mRoot, created);
+		++mSize;
 		return created;
 	}
-	// last comparator is successful
-	++mSize;
-	return created;
 }
 
 template <typename K, typename C, typename ... Cs>
@@ -150,16 +247,66 @@ Set<K, C, Cs ...>::put(SNode<K, C, Cs ...>* created) noexcept
 { return mRoot[0] ? putToRoot(created) : putAsRoot(created); }
 
 
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+SNode<K, C, Cs ...>*
+Set<K, C, Cs ...>::put(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* hint, SNode<K, C, Cs ...>* created) noexcept
+{
+	if (!hint)
+		return put(created);
+	CountedAt<N, C, Cs ...> cmp;
+	auto* h = reinterpret_cast<SNode<K, C, Cs ...>*>(hint);
+	bool last;
+	auto const order = Compare(cmp, static_cast<K const&>(h->key), static_cast<K const&>(created->key));
+	if (order < 0) {
+		if (h->template next<N>())
+			return put(created);
+		last = true;
+	} else if (order > 0) {
+		if (h->template prev<N>())
+			return put(created);
+		last = false;
+	} else {
+		delete created;
+		return h;
+	}
+	if constexpr (Dimension<C, Cs ...> > 1) {
+		if (auto* e = SNode<K, C, Cs ...>::template Collision<0, N>(mRoot, created)) {
+			delete created;
+			return e;
+		}
+	}
+	auto* r = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N]);
+	if (auto* t = last ? r->template attachLast<N>(created) : r->template attachFirst<N>(created))
+		mRoot[N] = t;
+	if constexpr (Dimension<C, Cs ...> > 1)
+		SNode<K, C, Cs ...>::template AttachAll<0, N>(mRoot, created);
+	++mSize;
+	return created;
+}
+
 template <typename K, typename C, typename ... Cs>
 typename Set<K, C, Cs ...>::template const_iterator<>
 Set<K, C, Cs ...>::put(auto&& ... kArgs)
-{ return put(::new SNode<K, C, Cs ...>(std::forward<decltype(kArgs)>(kArgs) ...)); }
+{ return put(new SNode<K, C, Cs ...>(std::forward<decltype(kArgs)>(kArgs) ...)); }
+
+template <typename K, typename C, typename ... Cs>
+template <Direction d, std::size_t N>
+typename Set<K, C, Cs ...>::template const_iterator<>
+Set<K, C, Cs ...>::put(Iterator<d, N> hint, auto&& ... kArgs)
+{
+	// end() of the Nth index stands for its last element, or its first one backwards
+	TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* h = hint.pos;
+	if (!h && mRoot[N])
+		h = d == Direction::FORWARD ? mRoot[N]->template rightMost<N>() : mRoot[N]->template leftMost<N>();
+	return put<N>(h, new SNode<K, C, Cs ...>(std::forward<decltype(kArgs)>(kArgs) ...));
+}
 
 template <typename K, typename C, typename ... Cs>
 template <Derived<K> DK>
 typename Set<K, C, Cs ...>::template const_iterator<>
 Set<K, C, Cs ...>::put(auto&& ... dkArgs)
-{ return put(reinterpret_cast<SNode<K, C, Cs ...>*>(::new SNode<DK>(std::forward<decltype(dkArgs)>(dkArgs) ...))); }
+{ return put(reinterpret_cast<SNode<K, C, Cs ...>*>(new SNode<DK, C, Cs ...>(std::forward<decltype(dkArgs)>(dkArgs) ...))); }
 
 template <typename K, typename C, typename ... Cs>
 template <typename ... Args>
@@ -174,18 +321,21 @@ SNode<K, C, Cs ...>*
 Set<K, C, Cs ...>::remove(SNode<K, C, Cs ...>* toDel) noexcept
 {
 	auto* s = toDel;
-	if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template detach<N>(reinterpret_cast<TNode<sizeof...(Cs) + 1>**>(&toDel)))
+	TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* d = toDel;
+	if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template detach<N>(&d))
 		mRoot[N] = t;
-	else if (s != toDel)
-		return toDel;
-	if constexpr (N < sizeof...(Cs)) {
+	else if (d != s)
+		return reinterpret_cast<SNode<K, C, Cs ...>*>(d);
+	toDel = reinterpret_cast<SNode<K, C, Cs ...>*>(d);
+	if constexpr (N + 1 < Dimension<C, Cs ...>) {
 		toDel = remove<N + 1>(toDel);
 		if (s != toDel) {
 			// later comparators found another one or could not find it at all
 			// if it is root it means nothing happened already
 			if (s != mRoot[N]) {
 				// rollback last detachment
-				if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template attach<N>(reinterpret_cast<TNode<sizeof...(Cs) + 1>**>(&s)))
+				d = s;
+				if (auto* t = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template attach<N>(&d))
 					mRoot[N] = t;
 			}
 		} else if (s == mRoot[N])
@@ -218,32 +368,215 @@ Set<K, C, Cs ...>::remove(auto&& ... args) noexcept
 	return false;
 }
 
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+std::uint64_t
+Set<K, C, Cs ...>::remove(const_iterator<N> first, const_iterator<N> last) noexcept
+{
+	if (!mRoot[N] || !first.pos)
+		return 0;
+	auto m = SNode<K, C, Cs ...>::template Erase<SNode<K, C, Cs ...>, N>(mRoot, mSize, first.pos, last.pos);
+	mSize -= m;
+	return m;
+}
+
 template <typename K, typename C, typename ... Cs>
 template <std::size_t N>
 typename Set<K, C, Cs ...>::template const_iterator<N>
 Set<K, C, Cs ...>::get(auto&& ... args) const noexcept
 { return mRoot[N] ? reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template get<N>(std::forward<decltype(args)>(args) ...) : nullptr; }
 
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+auto
+Set<K, C, Cs ...>::getMany(auto first, auto last, auto out) const noexcept
+{
+	SNode<K, C, Cs ...>::template GetMany<N>(mRoot[N], first, last, [&](TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* t) {
+		*out = const_iterator<N>(t);
+		++out;
+	});
+	return out;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+Set<K, C, Cs ...>
+Set<K, C, Cs ...>::splitAt(auto&& ... args) noexcept
+{
+	Set upper;
+	if (!mRoot[N])
+		return upper;
+	if (auto* r = SNode<K, C, Cs ...>::template Cut<N>(mRoot, mSize, std::forward<decltype(args)>(args) ...)) {
+		mSize -= r->d[N].cnt;
+		upper.template adopt<N>(r);
+	}
+	return upper;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+bool
+Set<K, C, Cs ...>::concat(Set&& other) noexcept
+{
+	if (!other.mRoot[N])
+		return true;
+	if (!mRoot[N]) {
+		swap(*this, other);
+		return true;
+	}
+	if (!Precedes(CountedAt<N, C, Cs ...>{},
+			static_cast<K const&>(mRoot[N]->template rightMost<N, SNode<K, C, Cs ...>>()->key),
+			static_cast<K const&>(other.mRoot[N]->template leftMost<N, SNode<K, C, Cs ...>>()->key)))
+		return false;
+	auto* t = other.mRoot[N]->template leftMost<N, SNode<K, C, Cs ...>>();
+	mRoot[N] = TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>::template Append<N, BalancingOf<C, Cs ...>>(mRoot[N], other.mRoot[N]);
+	if constexpr (Dimension<C, Cs ...> > 1) {
+		while (t) {
+			auto* s = t;
+			t = t->template next<N, SNode<K, C, Cs ...>>();
+			if (putToRoot<0, N>(s) != s) { // other comparators found an existing node
+				TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* toDel = s;
+				if (auto* r = reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template detach<N>(&toDel))
+					mRoot[N] = r;
+				delete s;
+			}
+		}
+	} else
+		mSize += other.mSize;
+	std::fill(other.mRoot, other.mRoot + Dimension<C, Cs ...>, nullptr);
+	other.mSize = 0;
+	return true;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <typename S, std::size_t N>
+void
+Set<K, C, Cs ...>::merge(Set&& other, auto&& ... args)
+requires Selector<S, K, decltype(args) ...>
+{
+	if (&other == this)
+		return;
+	S selector;
+	auto* b = std::exchange(other.mRoot[N], nullptr);
+	std::fill(other.mRoot, other.mRoot + Dimension<C, Cs ...>, nullptr);
+	other.mSize = 0;
+	// the nodes of both trees are being relinked when S throws, the merge completes keeping the elements of this
+	// container for the remaining keys in both before the exception is rethrown
+	std::exception_ptr error;
+	auto select = [&](K const& i, K const& j) noexcept -> K const& {
+		if (!error) {
+			try {
+				return selector(i, j, std::forward<decltype(args)>(args) ...);
+			} catch (...) {
+				error = std::current_exception();
+			}
+		}
+		return i;
+	};
+	if (mSize >= (b ? b->d[N].cnt : 0))
+		mergeInPlace<N, true, true, true, true>(b, select);
+	else // split the larger tree around the keys of the smaller one
+		mergeInPlace<N, true, true, true, true>(std::exchange(mRoot[N], b), [&](K const& j, K const& i) noexcept -> K const&
+		{ return select(i, j); });
+	if (error)
+		std::rethrow_exception(error);
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+void
+Set<K, C, Cs ...>::subtract(Set const& other) noexcept
+{
+	if (&other == this)
+		*this = Set();
+	else if (mRoot[N] && other.mRoot[N])
+		mergeInPlace<N, true, false, false, false>(other.mRoot[N], nullptr);
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+void
+Set<K, C, Cs ...>::retain(Set const& other) noexcept
+{
+	if (mRoot[N] && &other != this)
+		mergeInPlace<N, false, false, true, false>(other.mRoot[N], [](K const& i, K const&) noexcept -> K const& { return i; });
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename Set<K, C, Cs ...>::template const_iterator<N>
+Set<K, C, Cs ...>::lowerBound(auto&& ... args) const noexcept
+{ return mRoot[N] ? reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template lowerBound<N>(std::forward<decltype(args)>(args) ...) : nullptr; }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+typename Set<K, C, Cs ...>::template const_iterator<N>
+Set<K, C, Cs ...>::upperBound(auto&& ... args) const noexcept
+{ return mRoot[N] ? reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template upperBound<N>(std::forward<decltype(args)>(args) ...) : nullptr; }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+std::pair<typename Set<K, C, Cs ...>::template const_iterator<N>, typename Set<K, C, Cs ...>::template const_iterator<N>>
+Set<K, C, Cs ...>::equalRange(auto&& ... args) const noexcept
+{ return {lowerBound<N>(args ...), upperBound<N>(args ...)}; }
+
 template <typename K, typename C, typename ... Cs>
 template <std::size_t N>
 typename Set<K, C, Cs ...>::template const_iterator<N>
 Set<K, C, Cs ...>::at(std::uint64_t i) const noexcept
-{ // TODO: O(n)->O(logn) childCount?
-	const_iterator<N> it(nullptr);
-	if (mRoot[N]) {
-		if (i < mSize / 2) {
-			it.pos = mRoot[N]->template leftMost<N>();
-			for (std::uint64_t j{0}; j < i; ++j)
-				++it;
-		} else {
-			it.pos = mRoot[N]->template rightMost<N>();
-			for (std::uint64_t j = mSize - 1; i < j; --j)
-				--it;
-		}
-	}
-	return it;
+{ return mRoot[N] ? mRoot[N]->template at<N>(i) : nullptr; }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+std::uint64_t
+Set<K, C, Cs ...>::rank(auto&& ... args) const noexcept
+{ return mRoot[N] ? reinterpret_cast<SNode<K, C, Cs ...> const*>(mRoot[N])->template rank<N>(std::forward<decltype(args)>(args) ...) : 0; }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+std::uint64_t
+Set<K, C, Cs ...>::count(auto const& lo, auto const& hi) const noexcept
+{
+	auto l = rank<N>(lo);
+	auto h = rank<N>(hi);
+	return l < h ? h - l : 0;
 }
 
+template <typename K,  typename C, typename ... Cs>
+template <std::size_t N>
+AggregateOf<N, C, Cs ...>
+Set<K, C, Cs ...>::aggregate()
+requires (!std::is_void_v<MonoidOf<N, C, Cs ...>>)
+{
+	return mRoot[N]
+		? reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template aggregate<N>(Of<N>)
+		: MonoidOf<N, C, Cs ...>::identity();
+}
+
+template <typename K,  typename C, typename ... Cs>
+template <std::size_t N>
+AggregateOf<N, C, Cs ...>
+Set<K, C, Cs ...>::aggregate(auto const& lo, auto const& hi)
+requires (!std::is_void_v<MonoidOf<N, C, Cs ...>>)
+{
+	return mRoot[N]
+		? reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template aggregate<N>(Of<N>, lo, hi)
+		: MonoidOf<N, C, Cs ...>::identity();
+}
+
+template <typename K,  typename C, typename ... Cs>
+template <std::size_t N>
+typename Set<K, C, Cs ...>::template const_iterator<N>
+Set<K, C, Cs ...>::search(auto const& pred)
+requires (!std::is_void_v<MonoidOf<N, C, Cs ...>>)
+{ return mRoot[N] ? reinterpret_cast<SNode<K, C, Cs ...>*>(mRoot[N])->template search<N>(Of<N>, pred) : nullptr; }
+
+template <typename K, typename C, typename ... Cs>
+auto
+Set<K, C, Cs ...>::stats() noexcept
+requires (!std::is_same_v<PolicyOf<Stats, Stats, C, Cs ...>, Stats>)
+{ return PolicyOf<Stats, Stats, C, Cs ...>::read(); }
+
 template <typename K, typename C, typename ... Cs>
 template <std::size_t N>
 typename Set<K, C, Cs ...>::template const_iterator<N>
@@ -294,7 +627,7 @@ Set<K, C, Cs ...>::crend() const noexcept
 
 template <typename K, typename C, typename ... Cs>
 template <Direction d, std::size_t n>
-Set<K, C, Cs ...>::Iterator<d, n>::Iterator(TNode<sizeof...(Cs) + 1>* pos) noexcept
+Set<K, C, Cs ...>::Iterator<d, n>::Iterator(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* pos) noexcept
 		: pos(pos)
 {}
 
@@ -382,20 +715,33 @@ template <std::size_t N>
 Set<K, C, Cs...>
 Set<K, C, Cs...>::Difference<N>::operator()(Set const& a, Set const& b) const
 {
-	Set set;
+	if (threads > 1 && a && b)
+		return Merge<N, true, false, false>(a, b, threads, nullptr);
+
+	BulkBuilder<N> builder;
 	if (a) {
 		if (b) {
-			TypeAt<N, C, Cs ...> cmp;
+			// look the keys of a up in b if cheaper than walking both
+			if (a.size() * std::bit_width(b.size()) < b.size()) {
+				for (auto* i = a.mRoot[N]->template leftMost<N, SNode<K, C, Cs ...>>(); i; i = i->template next<N, SNode<K, C, Cs ...>>()) {
+					if (!reinterpret_cast<SNode<K, C, Cs ...>*>(b.mRoot[N])->template get<N>(static_cast<K const&>(i->key)))
+						builder.push(new SNode<K, C, Cs ...>(static_cast<K const&>(i->key)));
+				}
+				return builder.build();
+			}
+
+			CountedAt<N, C, Cs ...> cmp;
 			auto* i = a.mRoot[N]->template leftMost<N, SNode<K, C, Cs...>>();
 			auto* j = b.mRoot[N]->template leftMost<N, SNode<K, C, Cs...>>();
 
 			do {
-				if (cmp(static_cast<K const&>(i->key), static_cast<K const&>(j->key))) {
-					set.put(static_cast<K const&>(i->key));
+				auto const order = Compare(cmp, static_cast<K const&>(i->key), static_cast<K const&>(j->key));
+				if (order < 0) {
+					builder.push(new SNode<K, C, Cs ...>(static_cast<K const&>(i->key)));
 					i = i->template next<N, SNode<K, C, Cs...>>();
 					continue;
 				}
-				if (cmp(static_cast<K const&>(j->key), static_cast<K const&>(i->key))) {
+				if (order > 0) {
 					j = j->template next<N, SNode<K, C, Cs...>>();
 					continue;
 				}
@@ -404,13 +750,13 @@ Set<K, C, Cs...>::Difference<N>::operator()(Set const& a, Set const& b) const
 			} while (i && j);
 
 			while (i) {
-				set.put(static_cast<K const&>(i->key));
+				builder.push(new SNode<K, C, Cs ...>(static_cast<K const&>(i->key)));
 				i = i->template next<N, SNode<K, C, Cs...>>();
 			}
 		} else
-			set = a;
+			return a;
 	}
-	return set;
+	return builder.build();
 }
 
 template <typename K, typename C, typename... Cs>
@@ -419,28 +765,54 @@ Set<K, C, Cs...>
 Set<K, C, Cs...>::Intersection<S, N>::operator()(Set const& a, Set const& b, auto&& ... args) const
 requires Selector<S, K, decltype(args) ...>
 {
-	Set set;
+	if (threads > 1 && a && b) {
+		S selector;
+		if (a.size() <= b.size())
+			return Merge<N, false, false, true>(a, b, threads, [&](K const& i, K const& j) -> K const&
+			{ return selector(i, j, std::forward<decltype(args)>(args) ...); });
+		return Merge<N, false, false, true>(b, a, threads, [&](K const& j, K const& i) -> K const&
+		{ return selector(i, j, std::forward<decltype(args)>(args) ...); });
+	}
+
+	BulkBuilder<N> builder;
 	if (a && b) {
-		TypeAt<N, C, Cs ...> cmp;
+		CountedAt<N, C, Cs ...> cmp;
 		S selector;
+		// look the keys of the smaller one up in the larger one if cheaper than walking both
+		if (a.size() * std::bit_width(b.size()) < b.size()) {
+			for (auto* i = a.mRoot[N]->template leftMost<N, SNode<K, C, Cs ...>>(); i; i = i->template next<N, SNode<K, C, Cs ...>>()) {
+				if (auto* j = reinterpret_cast<SNode<K, C, Cs ...>*>(reinterpret_cast<SNode<K, C, Cs ...>*>(b.mRoot[N])->template get<N>(static_cast<K const&>(i->key))))
+					builder.push(new SNode<K, C, Cs ...>(selector(static_cast<K const&>(i->key), static_cast<K const&>(j->key), std::forward<decltype(args)>(args) ...)));
+			}
+			return builder.build();
+		}
+		if (b.size() * std::bit_width(a.size()) < a.size()) {
+			for (auto* j = b.mRoot[N]->template leftMost<N, SNode<K, C, Cs ...>>(); j; j = j->template next<N, SNode<K, C, Cs ...>>()) {
+				if (auto* i = reinterpret_cast<SNode<K, C, Cs ...>*>(reinterpret_cast<SNode<K, C, Cs ...>*>(a.mRoot[N])->template get<N>(static_cast<K const&>(j->key))))
+					builder.push(new SNode<K, C, Cs ...>(selector(static_cast<K const&>(i->key), static_cast<K const&>(j->key), std::forward<decltype(args)>(args) ...)));
+			}
+			return builder.build();
+		}
+
 		auto* i = a.mRoot[N]->template leftMost<N, SNode<K, C, Cs...>>();
 		auto* j = b.mRoot[N]->template leftMost<N, SNode<K, C, Cs...>>();
 
 		do {
-			if (cmp(static_cast<K const&>(i->key), static_cast<K const&>(j->key))) {
+			auto const order = Compare(cmp, static_cast<K const&>(i->key), static_cast<K const&>(j->key));
+			if (order < 0) {
 				i = i->template next<N, SNode<K, C, Cs...>>();
 				continue;
 			}
-			if (cmp(static_cast<K const&>(j->key), static_cast<K const&>(i->key))) {
+			if (order > 0) {
 				j = j->template next<N, SNode<K, C, Cs...>>();
 				continue;
 			}
-			set.put(selector(static_cast<K const&>(i->key), static_cast<K const&>(j->key), std::forward<decltype(args)>(args) ...));
+			builder.push(new SNode<K, C, Cs ...>(selector(static_cast<K const&>(i->key), static_cast<K const&>(j->key), std::forward<decltype(args)>(args) ...)));
 			i = i->template next<N, SNode<K, C, Cs...>>();
 			j = j->template next<N, SNode<K, C, Cs...>>();
 		} while (i && j);
 	}
-	return set;
+	return builder.build();
 }
 
 template <typename K, typename C, typename... Cs>
@@ -449,37 +821,44 @@ Set<K, C, Cs...>
 Set<K, C, Cs...>::Join<S, N>::operator()(Set const& a, Set const& b, auto&& ... args) const
 requires Selector<S, K, decltype(args) ...>
 {
-	Set set;
+	if (threads > 1 && a && b) {
+		S selector;
+		return Merge<N, true, false, true>(a, b, threads, [&](K const& i, K const& j) -> K const&
+		{ return selector(i, j, std::forward<decltype(args)>(args) ...); });
+	}
+
+	BulkBuilder<N> builder;
 	if (a) {
 		if (b) {
-			TypeAt<N, C, Cs ...> cmp;
+			CountedAt<N, C, Cs ...> cmp;
 			S selector;
-			auto* i = a.mRoot[N]->template leftMost<N, SNode < K, C, Cs...>>();
-			auto* j = b.mRoot[N]->template leftMost<N, SNode < K, C, Cs...>>();
+			auto* i = a.mRoot[N]->template leftMost<N, SNode<K, C, Cs...>>();
+			auto* j = b.mRoot[N]->template leftMost<N, SNode<K, C, Cs...>>();
 
 			do {
-				if (cmp(static_cast<K const&>(i->key), static_cast<K const&>(j->key))) {
-					set.put(static_cast<K const&>(i->key));
-					i = i->template next<N, SNode < K, C, Cs...>>();
+				auto const order = Compare(cmp, static_cast<K const&>(i->key), static_cast<K const&>(j->key));
+				if (order < 0) {
+					builder.push(new SNode<K, C, Cs ...>(static_cast<K const&>(i->key)));
+					i = i->template next<N, SNode<K, C, Cs...>>();
 					continue;
 				}
-				if (cmp(static_cast<K const&>(j->key), static_cast<K const&>(i->key))) {
-					j = j->template next<N, SNode < K, C, Cs...>>();
+				if (order > 0) {
+					j = j->template next<N, SNode<K, C, Cs...>>();
 					continue;
 				}
-				set.put(selector(static_cast<K const&>(i->key), static_cast<K const&>(j->key), std::forward<decltype(args)>(args) ...));
-				i = i->template next<N, SNode < K, C, Cs...>>();
-				j = j->template next<N, SNode < K, C, Cs...>>();
+				builder.push(new SNode<K, C, Cs ...>(selector(static_cast<K const&>(i->key), static_cast<K const&>(j->key), std::forward<decltype(args)>(args) ...)));
+				i = i->template next<N, SNode<K, C, Cs...>>();
+				j = j->template next<N, SNode<K, C, Cs...>>();
 			} while (i && j);
 
 			while (i) {
-				set.put(static_cast<K const&>(i->key));
-				i = i->template next<N, SNode < K, C, Cs...>>();
+				builder.push(new SNode<K, C, Cs ...>(static_cast<K const&>(i->key)));
+				i = i->template next<N, SNode<K, C, Cs...>>();
 			}
 		} else
-			set = a;
+			return a;
 	}
-	return set;
+	return builder.build();
 }
 
 template <typename K, typename C, typename... Cs>
@@ -488,44 +867,152 @@ Set<K, C, Cs...>
 Set<K, C, Cs...>::Union<S, N>::operator()(Set const& a, Set const& b, auto&& ... args) const
 requires Selector<S, K, decltype(args) ...>
 {
-	Set set;
+	if (threads > 1 && a && b) {
+		S selector;
+		if (a.size() >= b.size())
+			return Merge<N, true, true, true>(a, b, threads, [&](K const& i, K const& j) -> K const&
+			{ return selector(i, j, std::forward<decltype(args)>(args) ...); });
+		return Merge<N, true, true, true>(b, a, threads, [&](K const& j, K const& i) -> K const&
+		{ return selector(i, j, std::forward<decltype(args)>(args) ...); });
+	}
+
+	BulkBuilder<N> builder;
 	if (a) {
 		if (b) {
-			TypeAt<N, C, Cs ...> cmp;
+			CountedAt<N, C, Cs ...> cmp;
 			S selector;
-			auto* i = a.mRoot[N]->template leftMost<N, SNode < K, C, Cs...>>();
-			auto* j = b.mRoot[N]->template leftMost<N, SNode < K, C, Cs...>>();
+			auto* i = a.mRoot[N]->template leftMost<N, SNode<K, C, Cs...>>();
+			auto* j = b.mRoot[N]->template leftMost<N, SNode<K, C, Cs...>>();
 
 			do {
-				if (cmp(static_cast<K const&>(i->key), static_cast<K const&>(j->key))) {
-					set.put(static_cast<K const&>(i->key));
-					i = i->template next<N, SNode < K, C, Cs...>>();
+				auto const order = Compare(cmp, static_cast<K const&>(i->key), static_cast<K const&>(j->key));
+				if (order < 0) {
+					builder.push(new SNode<K, C, Cs ...>(static_cast<K const&>(i->key)));
+					i = i->template next<N, SNode<K, C, Cs...>>();
 					continue;
 				}
-				if (cmp(static_cast<K const&>(j->key), static_cast<K const&>(i->key))) {
-					set.put(static_cast<K const&>(j->key));
-					j = j->template next<N, SNode < K, C, Cs...>>();
+				if (order > 0) {
+					builder.push(new SNode<K, C, Cs ...>(static_cast<K const&>(j->key)));
+					j = j->template next<N, SNode<K, C, Cs...>>();
 					continue;
 				}
-				set.put(selector(static_cast<K const&>(i->key), static_cast<K const&>(j->key), std::forward<decltype(args)>(args) ...));
-				i = i->template next<N, SNode < K, C, Cs...>>();
-				j = j->template next<N, SNode < K, C, Cs...>>();
+				builder.push(new SNode<K, C, Cs ...>(selector(static_cast<K const&>(i->key), static_cast<K const&>(j->key), std::forward<decltype(args)>(args) ...)));
+				i = i->template next<N, SNode<K, C, Cs...>>();
+				j = j->template next<N, SNode<K, C, Cs...>>();
 			} while (i && j);
 
 			while (i) {
-				set.put(static_cast<K const&>(i->key));
-				i = i->template next<N, SNode < K, C, Cs...>>();
+				builder.push(new SNode<K, C, Cs ...>(static_cast<K const&>(i->key)));
+				i = i->template next<N, SNode<K, C, Cs...>>();
 			}
 
 			while (j) {
-				set.put(static_cast<K const&>(j->key));
-				j = j->template next<N, SNode < K, C, Cs...>>();
+				builder.push(new SNode<K, C, Cs ...>(static_cast<K const&>(j->key)));
+				j = j->template next<N, SNode<K, C, Cs...>>();
 			}
 		} else
-			set = a;
+			return a;
 	} else if (b)
-		set = b;
+		return b;
+	return builder.build();
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+Set<K, C, Cs ...>::BulkBuilder<N>::~BulkBuilder()
+{
+	while (mHead) {
+		auto* t = mHead;
+		mHead = mHead->template right<N>();
+		delete reinterpret_cast<SNode<K, C, Cs ...>*>(t);
+	}
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+void
+Set<K, C, Cs ...>::BulkBuilder<N>::push(SNode<K, C, Cs ...>* created) noexcept
+{
+	created->template state<N>(2);
+	created->template right<N>(nullptr);
+	if (mTail)
+		mTail->template right<N>(created);
+	else
+		mHead = created;
+	mTail = created;
+	++mCount;
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+bool
+Set<K, C, Cs ...>::BulkBuilder<N>::follows(auto&& ... args) const noexcept
+{ return !mTail || Precedes(CountedAt<N, C, Cs ...>{}, static_cast<K const&>(reinterpret_cast<SNode<K, C, Cs ...>*>(mTail)->key), args ...); }
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+void
+Set<K, C, Cs ...>::BulkBuilder<N>::put(auto&& ... kArgs)
+{
+	auto* created = new SNode<K, C, Cs ...>(std::forward<decltype(kArgs)>(kArgs) ...);
+	if (!follows(static_cast<K const&>(created->key))) {
+		delete created;
+		throw Exception(SException::Code::UnorderedKey, std::to_string(N + 1) + ". comparator");
+	}
+	push(created);
+}
+
+template <typename K, typename C, typename ... Cs>
+template <std::size_t N>
+Set<K, C, Cs ...>
+Set<K, C, Cs ...>::BulkBuilder<N>::build() noexcept
+{
+	Set set;
+	if (mCount) {
+		TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* last{nullptr};
+		set.template adopt<N>(TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>::template BuildBalanced<N>(mHead, last, mCount));
+		mHead = mTail = nullptr;
+		mCount = 0;
+	}
 	return set;
 }
 
+
+template <typename K, typename C, typename ... Cs>
+Set<K, C, Cs ...>::Loader::Loader(Set& set) noexcept
+		: mSet(set)
+{ std::fill(mSet.mRoot + 1, mSet.mRoot + Dimension<C, Cs ...>, nullptr); }
+
+template <typename K, typename C, typename ... Cs>
+Set<K, C, Cs ...>::Loader::~Loader()
+{
+	if constexpr (Dimension<C, Cs ...> > 1) {
+		if (mSet.mRoot[0])
+			mSet.mSize = SNode<K, C, Cs ...>::template Reindex<SNode<K, C, Cs ...>, 0>(mSet.mRoot, mSet.mSize);
+	}
+}
+
+template <typename K, typename C, typename ... Cs>
+void
+Set<K, C, Cs ...>::Loader::put(auto&& ... kArgs)
+{
+	TNode<Dimension<C, Cs ...>, LinksOf<C, Cs ...>>* created = new SNode<K, C, Cs ...>(std::forward<decltype(kArgs)>(kArgs) ...);
+	if (!mSet.mRoot[0]) {
+		mSet.mRoot[0] = created;
+		created->template left<0>(nullptr);
+		created->template right<0>(nullptr);
+		created->template state<0>(2);
+		created->d[0].cnt = 1;
+	} else {
+		auto* t = created;
+		if (auto* r = reinterpret_cast<SNode<K, C, Cs ...>*>(mSet.mRoot[0])->template attach<0>(&created))
+			mSet.mRoot[0] = r;
+		else if (t != created) { // found an existing node
+			delete reinterpret_cast<SNode<K, C, Cs ...>*>(t);
+			return;
+		}
+	}
+	++mSet.mSize;
+}
+
 }//namespace DS
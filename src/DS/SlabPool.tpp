@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Policy.tpp"
+#include <bit>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+namespace DS {
+
+/**
+ * @brief	Node allocation policy serving the nodes from slabs of same sized blocks.
+ * @details	Sizes are rounded up to 16 bytes and each size class is carved from its own SlabSize aligned slabs,
+ * so variable sized nodes (DP::CreateInfo::size) are pooled as well. Released blocks up to MaxBlock are kept
+ * in per thread free lists and handed over to the other threads when their thread exits, the larger ones are
+ * pooled by powers of 2 under a lock up to half a slab. Only the blocks larger than that get a slab of their
+ * own. Slabs are reused, but never returned to the system, except the ones of those blocks.
+ * @tparam	SlabSize Size and alignment of a slab, a power of 2
+ * @tparam	MaxBlock Largest block size kept per thread
+ */
+template <std::size_t SlabSize = 1 << 16, std::size_t MaxBlock = 512>
+class SlabPool : public Allocator {
+	static constexpr std::size_t Align{16}; // lowest 4 bits of the links keep the node state
+	static constexpr std::size_t Small{MaxBlock / Align};
+	static constexpr int FirstLarge{std::bit_width(MaxBlock)};
+	static constexpr std::size_t Large{std::countr_zero(SlabSize) - FirstLarge};
+
+	static_assert(std::has_single_bit(SlabSize) && MaxBlock % Align == 0 && MaxBlock + Align <= SlabSize);
+
+	struct Slab {
+		std::size_t blockSize; // 0 if the slab holds a single large block
+	};
+
+	struct Class {
+		void* free{nullptr};
+		std::byte* next{nullptr};
+		std::byte* end{nullptr};
+
+		// Released block, or the next one of the last slab, nullptr if neither is left
+		void*
+		take(std::size_t size) noexcept
+		{
+			if (free)
+				return std::exchange(free, *static_cast<void**>(free));
+			if (next != end)
+				return std::exchange(next, next + size);
+			return nullptr;
+		}
+
+		void
+		give(void* ptr) noexcept
+		{
+			*static_cast<void**>(ptr) = free;
+			free = ptr;
+		}
+	};
+
+	struct Cache {
+		Class classes[Small];
+
+		~Cache()
+		{
+			Exited = true;
+			std::scoped_lock lock(Shared);
+			for (std::size_t i = 0; i < Small; ++i) {
+				auto& c = classes[i];
+				if (Pool[i].next == Pool[i].end)
+					std::swap(c.next, Pool[i].next), std::swap(c.end, Pool[i].end);
+				for (; c.next != c.end; c.next += (i + 1) * Align)
+					Pool[i].give(c.next);
+				while (c.free)
+					Pool[i].give(std::exchange(c.free, *static_cast<void**>(c.free)));
+			}
+		}
+	};
+
+	static inline thread_local Cache Local;
+	static inline thread_local bool Exited{false}; // Local is destroyed, the blocks go through Pool
+	static inline std::mutex Shared;
+	static inline Class Pool[Small + Large];
+
+	// Class of the blocks of size bytes, rounded up to Align
+	static std::size_t
+	ClassOf(std::size_t size) noexcept
+	{ return size <= MaxBlock ? size / Align - 1 : Small + std::bit_width(size - 1) - FirstLarge; }
+
+	// Carve the blocks of size bytes of c from the rest of the slab of pool or from a new slab, c is empty
+	static void
+	Refill(Class& c, Class& pool, std::size_t size)
+	{
+		if (pool.next != pool.end) {
+			c.next = std::exchange(pool.next, nullptr);
+			c.end = std::exchange(pool.end, nullptr);
+			return;
+		}
+		auto* slab = static_cast<Slab*>(::operator new(SlabSize, std::align_val_t{SlabSize}));
+		slab->blockSize = size;
+		c.next = reinterpret_cast<std::byte*>(slab) + Align;
+		c.end = c.next + (SlabSize - Align) / size * size;
+	}
+
+public:
+	static void*
+	allocate(std::size_t size)
+	{
+		size = (size + Align - 1) & ~(Align - 1);
+		if (size <= MaxBlock && !Exited) {
+			auto& c = Local.classes[size / Align - 1];
+			if (auto* ptr = c.take(size))
+				return ptr;
+			std::scoped_lock lock(Shared);
+			c.free = std::exchange(Pool[size / Align - 1].free, nullptr);
+			if (!c.free)
+				Refill(c, Pool[size / Align - 1], size);
+			return c.take(size);
+		}
+		if (size > SlabSize / 2) {
+			auto* slab = static_cast<Slab*>(::operator new(Align + size, std::align_val_t{SlabSize}));
+			slab->blockSize = 0;
+			return reinterpret_cast<std::byte*>(slab) + Align;
+		}
+		if (size > MaxBlock)
+			size = std::bit_ceil(size);
+		std::scoped_lock lock(Shared);
+		auto& c = Pool[ClassOf(size)];
+		if (auto* ptr = c.take(size))
+			return ptr;
+		Refill(c, c, size);
+		return c.take(size);
+	}
+
+	static void
+	deallocate(void* ptr) noexcept
+	{
+		auto* slab = reinterpret_cast<Slab*>(reinterpret_cast<std::uintptr_t>(ptr) & ~(SlabSize - 1));
+		if (!slab->blockSize)
+			::operator delete(slab, std::align_val_t{SlabSize});
+		else if (slab->blockSize <= MaxBlock && !Exited)
+			Local.classes[slab->blockSize / Align - 1].give(ptr);
+		else {
+			std::scoped_lock lock(Shared);
+			Pool[ClassOf(slab->blockSize)].give(ptr);
+		}
+	}
+};//class DS::SlabPool<SlabSize, MaxBlock>
+
+}//namespace DS
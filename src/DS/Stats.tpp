@@ -0,0 +1,225 @@
+#pragma once
+
+#include "Compare.tpp"
+#include "Policy.tpp"
+#include "DS/Pack.hpp"
+#include <Stream/InOut.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace DS {
+
+/**
+ * @brief	Instrumentation policy.
+ * @details	Set and Map report their comparisons, rebalancing rotations, descents and node allocations to the static
+ * hooks of the first Stats in Cs. This default one counts nothing, its empty hooks compile away.
+ */
+struct Stats : Policy {
+	enum class Rotation : std::uint8_t {
+		LL, RR, LR, RL
+	};
+
+	enum class Descent : std::uint8_t {
+		Get, Put, Remove
+	};
+
+	// The Nth comparator is called
+	template <std::size_t N>
+	static void
+	compared() noexcept
+	{}
+
+	// The current descent of the Nth index visits a node
+	template <std::size_t N>
+	static void
+	visited() noexcept
+	{}
+
+	// The current descent of the Nth index ends
+	template <std::size_t N>
+	static void
+	descended(Descent) noexcept
+	{}
+
+	// The Nth index is rebalanced after a put or a remove
+	template <std::size_t N>
+	static void
+	rotated(Rotation) noexcept
+	{}
+
+	static void
+	allocated(std::size_t) noexcept
+	{}
+
+	static void
+	deallocated() noexcept
+	{}
+};//struct DS::Stats
+
+/**
+ * @brief	Stats policy counting into relaxed atomics shared by the containers using it.
+ * @tparam	Indices Number of indices counted, not less than the number of comparators
+ * @tparam	Tag Type telling the counters of different containers apart
+ * @details	Each hook costs an atomic increment, contended if the containers are used on several threads.
+ */
+template <std::size_t Indices = 4, typename Tag = void>
+class Counters : public Stats {
+public:
+	static constexpr std::size_t MaxDepth{64};
+
+	/**
+	 * @brief	Counters read at once, inserted into a Stream::Output as std::uint64_t in declaration order,
+	 * preceded by Indices.
+	 */
+	struct Snapshot {
+		std::uint64_t comparisons[Indices]{};
+		std::uint64_t rotations[Indices][4]{}; // by Rotation
+		std::uint64_t descents[Indices][3]{}; // by Descent
+		std::uint64_t depths[Indices][MaxDepth]{}; // nodes visited by a descent, the last one counts the deeper ones too
+		std::uint64_t allocations{0};
+		std::uint64_t allocatedBytes{0};
+		std::uint64_t deallocations{0};
+
+		friend Stream::Output&
+		operator<<(Stream::Output& output, Snapshot const& snapshot)
+		{
+			output << std::uint64_t{Indices};
+			for (auto c : snapshot.comparisons)
+				output << c;
+			for (auto const& r : snapshot.rotations) {
+				for (auto c : r)
+					output << c;
+			}
+			for (auto const& d : snapshot.descents) {
+				for (auto c : d)
+					output << c;
+			}
+			for (auto const& d : snapshot.depths) {
+				for (auto c : d)
+					output << c;
+			}
+			return output << snapshot.allocations << snapshot.allocatedBytes << snapshot.deallocations;
+		}
+	};//struct DS::Counters<Indices, Tag>::Snapshot
+
+private:
+	static inline std::atomic<std::uint64_t> Comparisons[Indices]{};
+	static inline std::atomic<std::uint64_t> Rotations[Indices][4]{};
+	static inline std::atomic<std::uint64_t> Descents[Indices][3]{};
+	static inline std::atomic<std::uint64_t> Depths[Indices][MaxDepth]{};
+	static inline std::atomic<std::uint64_t> Allocations{0};
+	static inline std::atomic<std::uint64_t> AllocatedBytes{0};
+	static inline std::atomic<std::uint64_t> Deallocations{0};
+	static inline thread_local std::uint64_t Depth[Indices]{}; // of the current descent on each index
+
+	static void
+	Count(std::atomic<std::uint64_t>& counter, std::uint64_t n = 1) noexcept
+	{ counter.fetch_add(n, std::memory_order_relaxed); }
+
+public:
+	template <std::size_t N>
+	static void
+	compared() noexcept
+	{
+		static_assert(N < Indices, "Counters must have an index for each comparator");
+		Count(Comparisons[N]);
+	}
+
+	template <std::size_t N>
+	static void
+	visited() noexcept
+	{ ++Depth[N]; }
+
+	template <std::size_t N>
+	static void
+	descended(Descent descent) noexcept
+	{
+		Count(Descents[N][static_cast<std::size_t>(descent)]);
+		Count(Depths[N][std::min(std::exchange(Depth[N], 0), MaxDepth - 1)]);
+	}
+
+	template <std::size_t N>
+	static void
+	rotated(Rotation rotation) noexcept
+	{ Count(Rotations[N][static_cast<std::size_t>(rotation)]); }
+
+	static void
+	allocated(std::size_t size) noexcept
+	{
+		Count(Allocations);
+		Count(AllocatedBytes, size);
+	}
+
+	static void
+	deallocated() noexcept
+	{ Count(Deallocations); }
+
+	/**
+	 * @brief	Current counters, each one read atomically on its own.
+	 */
+	static Snapshot
+	read() noexcept
+	{
+		Snapshot snapshot;
+		auto load = [](auto& to, auto const& from) { to = from.load(std::memory_order_relaxed); };
+		for (std::size_t i = 0; i < Indices; ++i) {
+			load(snapshot.comparisons[i], Comparisons[i]);
+			for (std::size_t j = 0; j < 4; ++j)
+				load(snapshot.rotations[i][j], Rotations[i][j]);
+			for (std::size_t j = 0; j < 3; ++j)
+				load(snapshot.descents[i][j], Descents[i][j]);
+			for (std::size_t j = 0; j < MaxDepth; ++j)
+				load(snapshot.depths[i][j], Depths[i][j]);
+		}
+		load(snapshot.allocations, Allocations);
+		load(snapshot.allocatedBytes, AllocatedBytes);
+		load(snapshot.deallocations, Deallocations);
+		return snapshot;
+	}
+
+	/**
+	 * @brief	Zero the counters.
+	 */
+	static void
+	reset() noexcept
+	{
+		auto zero = [](auto& counter) { counter.store(0, std::memory_order_relaxed); };
+		for (std::size_t i = 0; i < Indices; ++i) {
+			zero(Comparisons[i]);
+			for (auto& c : Rotations[i])
+				zero(c);
+			for (auto& c : Descents[i])
+				zero(c);
+			for (auto& c : Depths[i])
+				zero(c);
+		}
+		zero(Allocations);
+		zero(AllocatedBytes);
+		zero(Deallocations);
+	}
+};//class DS::Counters<Indices, Tag>
+
+// Comparator calling Cmp, reporting each comparison to S as the Nth comparator
+// std::less and std::greater of operands ordered by operator<=> are turned into a single three way comparison
+template <typename Cmp, typename S, std::size_t N>
+struct Counted {
+	template <typename K, typename ... Args>
+	auto
+	operator()(K const& key, Args const& ... args) const
+	{
+		S::template compared<N>();
+		if constexpr (StandardOrder<Cmp, K, Args ...>)
+			return Compare(Cmp{}, key, args ...);
+		else
+			return Cmp{}(key, args ...);
+	}
+};//struct DS::Counted<Cmp, S, N>
+
+// Nth comparator of Cs, counted if Cs has a Stats policy
+template <std::size_t N, typename ... Cs>
+using CountedAt = std::conditional_t<std::is_same_v<PolicyOf<Stats, Stats, Cs ...>, Stats>,
+	TypeAt<N, Cs ...>, Counted<TypeAt<N, Cs ...>, PolicyOf<Stats, Stats, Cs ...>, N>>;
+
+}//namespace DS
@@ -1,64 +1,498 @@
 #pragma once
 
+#include "Balancing.tpp"
+#include "Stats.tpp"
 #include <Format/Dot.hpp>
+#include <bit>
+#include <future>
 
 namespace DS {
 
-template <std::size_t Dim>
+/**
+ * @brief	Links of TNode kept as pointers, the lowest 4 bits of which keep the node state.
+ * @details	An Allocator may encode the links otherwise (see Compact) by providing the same members.
+ */
+struct Pointers {
+	using Word = std::uintptr_t;
+	using Count = std::uint64_t;
+
+	static Word
+	Encode(void const* ptr) noexcept
+	{ return reinterpret_cast<Word>(ptr); }
+
+	static void*
+	Decode(Word word) noexcept
+	{ return reinterpret_cast<void*>(word); }
+};//struct DS::Pointers
+
+template <typename A>
+concept LinkEncoding = requires(void const* ptr, typename A::Word word) {
+	{ A::Encode(ptr) } -> std::same_as<typename A::Word>;
+	{ A::Decode(word) } -> std::same_as<void*>;
+	typename A::Count;
+};
+
+// Links of the nodes allocated by the first Allocator in Cs
+template <typename ... Cs>
+using LinksOf = std::conditional_t<LinkEncoding<PolicyOf<Allocator, Allocator, Cs ...>>,
+	PolicyOf<Allocator, Allocator, Cs ...>, Pointers>;
+
+template <std::size_t Dim, typename L = Pointers>
 struct TNode {
+	using Word = typename L::Word;
+
 	struct {
 		union {
-			std::uintptr_t l;
-			std::uintptr_t sl:4;
-			std::uintptr_t balance:3;
+			Word l;
+			Word sl:4;
+			Word balance:3;
 			struct {
-				std::uintptr_t isRight:1;
-				std::uintptr_t isBalanced:1;
-				std::uintptr_t isLeft:1;
-				std::uintptr_t u1:1;
+				Word isRight:1;
+				Word isBalanced:1;
+				Word isLeft:1;
+				Word u1:1;
 			};
 		};
 		union {
-			std::uintptr_t r;
-			std::uintptr_t sr:4;
-			std::uintptr_t has:3;
+			Word r;
+			Word sr:4;
+			Word has:3;
 			struct {
-				std::uintptr_t hasRight:1;
-				std::uintptr_t hasValue:1;
-				std::uintptr_t hasLeft:1;
-				std::uintptr_t u2:1;
+				Word hasRight:1;
+				Word hasValue:1;
+				Word hasLeft:1;
+				Word aggregated:1; // see Augment
 			};
 		};
-	} d[Dim];
-
-	template <typename Node>
+		typename L::Count cnt;
+	} d[Dim]{}; // a new node starts with every mark and flag clear
+
+	/**
+	 * @brief	Smallest subtree worth handing over to another thread.
+	 */
+	static constexpr std::uint64_t Grain{1 << 12};
+
+	/**
+	 * @brief	Delete the nodes of the tree, the subtrees of at least Grain nodes on separate threads while threads allow.
+	 * @details	Takes O(1) space on each thread, the left children are rotated up until the tree is a list.
+	 */
+	template <typename Node, std::size_t N = 0>
 	void
-	deleteTree()
+	deleteTree(unsigned threads = 1) noexcept
+	{
+		if (threads > 1 && d[N].cnt >= Grain) {
+			Fork(true,
+				[this, threads] {
+					if (d[N].hasLeft)
+						left<N>()->template deleteTree<Node, N>(threads / 2);
+				},
+				[this, threads] {
+					if (d[N].hasRight)
+						right<N>()->template deleteTree<Node, N>(threads - threads / 2);
+				});
+			delete reinterpret_cast<Node*>(this);
+			return;
+		}
+		for (TNode* t = this; t;) {
+			if (t->d[N].hasLeft) {
+				TNode* l = t->template left<N>();
+				t->d[N].hasLeft = l->d[N].hasRight;
+				t->template left<N>(l->template right<N>());
+				l->d[N].hasRight = true;
+				l->template right<N>(t);
+				t = l;
+			} else {
+				TNode* r = t->d[N].hasRight ? t->template right<N>() : nullptr;
+				delete reinterpret_cast<Node*>(t);
+				t = r;
+			}
+		}
+	}
+
+	/**
+	 * @brief	Run f on another thread and g on this one if parallel, both on this one otherwise.
+	 * @details	Both run to completion, the first exception thrown is rethrown afterwards.
+	 */
+	static void
+	Fork(bool parallel, auto&& f, auto&& g)
+	{
+		std::future<void> future;
+		if (parallel) {
+			try {
+				future = std::async(std::launch::async, f);
+			} catch (std::system_error const&) {}
+		}
+		std::exception_ptr e;
+		if (!future.valid()) {
+			try {
+				f();
+			} catch (...) {
+				e = std::current_exception();
+			}
+		}
+		try {
+			g();
+		} catch (...) {
+			if (!e)
+				e = std::current_exception();
+		}
+		if (future.valid()) {
+			try {
+				future.get();
+			} catch (...) {
+				if (!e)
+					e = std::current_exception();
+			}
+		}
+		if (e)
+			std::rethrow_exception(e);
+	}
+
+	/**
+	 * @brief	Link the first n nodes of the list chained through right<N>() into a balanced tree.
+	 * @param	list Head of the list, advanced past the linked nodes
+	 * @param	last Previously linked node, becomes the last linked one
+	 * @return	Root of the tree
+	 */
+	template <std::size_t N = 0>
+	static TNode*
+	BuildBalanced(TNode*& list, TNode*& last, std::uint64_t n) noexcept
+	{
+		std::uint64_t const nl = (n - 1) / 2;
+		std::uint64_t const nr = n - 1 - nl;
+		TNode* l = nl ? BuildBalanced<N>(list, last, nl) : nullptr;
+
+		TNode* t = list;
+		list = t->template right<N>();
+		t->d[N].balance = std::bit_width(nl) < std::bit_width(nr) ? 1 : 2;
+		t->d[N].hasLeft = nl != 0;
+		t->d[N].hasRight = nr != 0;
+		t->d[N].cnt = n;
+		t->d[N].aggregated = false;
+		t->template left<N>(l ? l : last);
+		if (last && !last->d[N].hasRight)
+			last->template right<N>(t);
+		last = t;
+
+		t->template right<N>(nr ? BuildBalanced<N>(list, last, nr) : nullptr);
+		return t;
+	}
+
+	/**
+	 * @brief	Make k the parent of l and r whose heights differ by at most 1.
+	 */
+	template <std::size_t N = 0>
+	static TNode*
+	Link(TNode* l, int hl, TNode* k, TNode* r, int hr, int& h) noexcept
+	{
+		k->d[N].balance = hl < hr ? 1 : hl == hr ? 2 : 4;
+		k->d[N].hasLeft = l != nullptr;
+		k->d[N].hasRight = r != nullptr;
+		if (l)
+			k->template left<N>(l);
+		if (r)
+			k->template right<N>(r);
+		k->d[N].cnt = (l ? l->d[N].cnt : 0) + (r ? r->d[N].cnt : 0) + 1;
+		k->d[N].aggregated = false;
+		h = std::max(hl, hr) + 1;
+		return k;
+	}
+
+	template <std::size_t N = 0, typename B = AVL>
+	static TNode*
+	JoinRight(TNode* t, int ht, TNode* k, TNode* r, int hr, int& h) noexcept
+	{
+		int const hl = ht - (t->d[N].isRight ? 2 : 1);
+		int const hc = ht - (t->d[N].isLeft ? 2 : 1);
+		TNode* c = t->d[N].hasRight ? t->template right<N>() : nullptr;
+		int hs;
+		TNode* s;
+		if constexpr (std::same_as<B, WeightBalanced>)
+			s = Join<N, B>(c, hc, k, r, hr, hs);
+		else
+			s = hc <= hr + 1 ? Link<N>(c, hc, k, r, hr, hs) : JoinRight<N, B>(c, hc, k, r, hr, hs);
+		if (!c) // k follows t
+			k->template left<N>(t);
+		t->d[N].hasRight = true;
+		t->template right<N>(s);
+		if constexpr (std::same_as<B, WeightBalanced>) {
+			t->template recount<N>();
+			h = hs + 1;
+			return t->template reweigh<N>();
+		}
+		if (hs <= hl + 1) {
+			// t of rank ht keeps it, unless s reaches it
+			h = std::max(ht, std::max(hl, hs) + 1);
+			t->template diffs<N>(h - hl, h - hs);
+			t->template recount<N>();
+			return t;
+		}
+		h = hl + 2;
+		if (s->d[N].isLeft)
+			return t->template rl<N>();
+		if (s->d[N].isRight)
+			return t->template rr<N>();
+		s->d[N].balance = 4;
+		t->d[N].balance = 1;
+		++h;
+		return t->template leftRotate<N>();
+	}
+
+	template <std::size_t N = 0, typename B = AVL>
+	static TNode*
+	JoinLeft(TNode* l, int hl, TNode* k, TNode* t, int ht, int& h) noexcept
+	{
+		int const hc = ht - (t->d[N].isRight ? 2 : 1);
+		int const hr = ht - (t->d[N].isLeft ? 2 : 1);
+		TNode* c = t->d[N].hasLeft ? t->template left<N>() : nullptr;
+		int hs;
+		TNode* s;
+		if constexpr (std::same_as<B, WeightBalanced>)
+			s = Join<N, B>(l, hl, k, c, hc, hs);
+		else
+			s = hc <= hl + 1 ? Link<N>(l, hl, k, c, hc, hs) : JoinLeft<N, B>(l, hl, k, c, hc, hs);
+		if (!c) // k precedes t
+			k->template right<N>(t);
+		t->d[N].hasLeft = true;
+		t->template left<N>(s);
+		if constexpr (std::same_as<B, WeightBalanced>) {
+			t->template recount<N>();
+			h = hs + 1;
+			return t->template reweigh<N>();
+		}
+		if (hs <= hr + 1) {
+			// t of rank ht keeps it, unless s reaches it
+			h = std::max(ht, std::max(hs, hr) + 1);
+			t->template diffs<N>(h - hs, h - hr);
+			t->template recount<N>();
+			return t;
+		}
+		h = hr + 2;
+		if (s->d[N].isRight)
+			return t->template lr<N>();
+		if (s->d[N].isLeft)
+			return t->template ll<N>();
+		s->d[N].balance = 1;
+		t->d[N].balance = 4;
+		++h;
+		return t->template rightRotate<N>();
+	}
+
+	/**
+	 * @brief	Join the trees l and r of heights hl and hr with k in between, in O(|hl - hr| + 1).
+	 * @tparam	B Balancing policy of the trees, WeightBalanced ones are joined by their counts in O(log n)
+	 * @param	h Height of the joined tree
+	 * @return	Root of the joined tree
+	 * @details	Every node of l must precede k and every node of r must follow it.
+	 * Threads are left as they are, except the ones between k and the nodes it is linked under, see Thread.
+	 */
+	template <std::size_t N = 0, typename B = AVL>
+	static TNode*
+	Join(TNode* l, int hl, TNode* k, TNode* r, int hr, int& h) noexcept
+	{
+		if constexpr (std::same_as<B, WeightBalanced>) {
+			std::uint64_t const wl = (l ? l->d[N].cnt : 0) + 1;
+			std::uint64_t const wr = (r ? r->d[N].cnt : 0) + 1;
+			if (wl > B::Delta * wr)
+				return JoinRight<N, B>(l, hl, k, r, hr, h);
+			if (wr > B::Delta * wl)
+				return JoinLeft<N, B>(l, hl, k, r, hr, h);
+		} else {
+			if (hl > hr + 1)
+				return JoinRight<N, B>(l, hl, k, r, hr, h);
+			if (hr > hl + 1)
+				return JoinLeft<N, B>(l, hl, k, r, hr, h);
+		}
+		return Link<N>(l, hl, k, r, hr, h);
+	}
+
+	/**
+	 * @brief	Unlink the last node of the tree t of height ht.
+	 * @param	last Unlinked node
+	 * @param	h Height of the remaining tree
+	 * @return	Root of the remaining tree
+	 */
+	template <std::size_t N = 0, typename B = AVL>
+	static TNode*
+	SplitLast(TNode* t, int ht, TNode*& last, int& h) noexcept
+	{
+		int const hl = ht - (t->d[N].isRight ? 2 : 1);
+		TNode* l = t->d[N].hasLeft ? t->template left<N>() : nullptr;
+		if (!t->d[N].hasRight) {
+			last = t;
+			h = hl;
+			return l;
+		}
+		int hr;
+		TNode* r = SplitLast<N, B>(t->template right<N>(), ht - (t->d[N].isLeft ? 2 : 1), last, hr);
+		return Join<N, B>(l, hl, t, r, hr, h);
+	}
+
+	/**
+	 * @brief	Join the trees l and r of heights hl and hr, in O(log n).
+	 * @see		Join
+	 */
+	template <std::size_t N = 0, typename B = AVL>
+	static TNode*
+	Concat(TNode* l, int hl, TNode* r, int hr, int& h) noexcept
+	{
+		if (!l) {
+			h = hr;
+			return r;
+		}
+		if (!r) {
+			h = hl;
+			return l;
+		}
+		TNode* k;
+		l = SplitLast<N, B>(l, hl, k, hl);
+		return Join<N, B>(l, hl, k, r, hr, h);
+	}
+
+	/**
+	 * @brief	Thread P and S, adjacent after a split or a concatenation, to each other and to their subtrees.
+	 * @details	Null P or S marks an end of the tree.
+	 */
+	template <std::size_t N = 0>
+	static void
+	Rethread(TNode* P, TNode* S) noexcept
+	{
+		for (auto* t : {P, S}) {
+			if (t && t->d[N].hasLeft)
+				t->template left<N>()->template rightMost<N>()->template right<N>(t);
+			if (t && t->d[N].hasRight)
+				t->template right<N>()->template leftMost<N>()->template left<N>(t);
+		}
+		if (P && !P->d[N].hasRight)
+			P->template right<N>(S);
+		if (S && !S->d[N].hasLeft)
+			S->template left<N>(P);
+	}
+
+	/**
+	 * @brief	Join the threaded trees l and r whose nodes all follow the ones of l, in O(log n).
+	 * @return	Root of the joined tree
+	 */
+	template <std::size_t N = 0, typename B = AVL>
+	static TNode*
+	Append(TNode* l, TNode* r) noexcept
+	{
+		if (!l)
+			return r;
+		if (!r)
+			return l;
+		auto* P = l->template rightMost<N>();
+		auto* S = r->template leftMost<N>();
+		int h;
+		l = Concat<N, B>(l, l->template height<N>(), r, r->template height<N>(), h);
+		Rethread<N>(P, S);
+		return l;
+	}
+
+	/**
+	 * @brief	Thread the missing links of the tree t to its neighbours, P and S at both ends.
+	 */
+	template <std::size_t N = 0>
+	static void
+	Thread(TNode* t, TNode* P, TNode* S, unsigned threads = 1) noexcept
+	{
+		auto left = [=] {
+			if (t->d[N].hasLeft)
+				Thread<N>(t->template left<N>(), P, t, threads / 2);
+			else
+				t->template left<N>(P);
+		};
+		auto right = [=] {
+			if (t->d[N].hasRight)
+				Thread<N>(t->template right<N>(), t, S, threads - threads / 2);
+			else
+				t->template right<N>(S);
+		};
+		if (threads > 1 && t->d[N].cnt >= Grain)
+			Fork(true, left, right);
+		else {
+			left();
+			right();
+		}
+	}
+
+	/**
+	 * @brief	Height of the tree, its rank if it is rank balanced, in O(log n).
+	 */
+	template <std::size_t N = 0>
+	[[nodiscard]] int
+	height() const noexcept
 	{
-		if (d[0].hasRight)
-			right()->template deleteTree<Node>();
-		if (d[0].hasLeft)
-			left()->template deleteTree<Node>();
-		delete reinterpret_cast<Node*>(this);
+		int h{0};
+		for (auto const* t = this;; t = t->d[N].isRight ? t->template right<N>() : t->template left<N>()) {
+			h += t->d[N].isRight ? t->template rightDiff<N>() : 1;
+			if (!(t->d[N].isRight ? t->d[N].hasRight : t->d[N].hasLeft))
+				return h;
+		}
 	}
 
+	// Rank differences to the children of a rank balanced tree, 1 or 2
+	template <std::size_t N = 0>
+	[[nodiscard]] int
+	leftDiff() const noexcept
+	{ return d[N].isRight ? 2 : 1; }
+
+	template <std::size_t N = 0>
+	[[nodiscard]] int
+	rightDiff() const noexcept
+	{ return d[N].isLeft ? 2 : 1; }
+
+	template <std::size_t N = 0>
+	void
+	diffs(int l, int r) noexcept
+	{ d[N].balance = (l == 2) | (l == r && l == 1) << 1 | (r == 2) << 2; }
+
 	template <std::size_t N = 0>
 	[[nodiscard]] std::uint8_t
 	state() const noexcept
-	{ return d[N].sl | d[N].sr << 4; }
+	{ return d[N].sl | (d[N].sr & 0x7) << 4; }
 
 	template <std::size_t N = 0>
 	void
 	state(std::uint8_t s) noexcept
 	{
 		d[N].sl = s & 0xF;
-		d[N].sr = s >> 4;
+		d[N].sr = s >> 4 & 0x7;
+	}
+
+	template <std::size_t N = 0>
+	[[nodiscard]] std::uint64_t
+	leftCount() const noexcept
+	{ return d[N].hasLeft ? left<N>()->d[N].cnt : 0; }
+
+	template <std::size_t N = 0>
+	[[nodiscard]] std::uint64_t
+	rightCount() const noexcept
+	{ return d[N].hasRight ? right<N>()->d[N].cnt : 0; }
+
+	template <std::size_t N = 0>
+	void
+	recount() noexcept
+	{
+		d[N].cnt = leftCount<N>() + rightCount<N>() + 1;
+		d[N].aggregated = false;
+	}
+
+	/**
+	 * @brief	Count n nodes added to the Nth subtree, or removed if n is negative.
+	 */
+	template <std::size_t N = 0>
+	void
+	recount(std::int64_t n) noexcept
+	{
+		d[N].cnt += n;
+		d[N].aggregated = false;
 	}
 
 	template <std::size_t N = 0, typename Node = TNode>
 	Node*
 	left() noexcept
-	{ return reinterpret_cast<Node*>(d[N].l & ~std::uintptr_t{0xF}); }
+	{ return reinterpret_cast<Node*>(L::Decode(d[N].l & ~Word{0xF})); }
 
 	template <std::size_t N = 0, typename Node = TNode>
 	Node const*
@@ -68,12 +502,12 @@ struct TNode {
 	template <std::size_t N = 0>
 	void
 	left(TNode* p) noexcept
-	{ d[N].l = reinterpret_cast<std::uintptr_t>(p) | d[N].sl; }
+	{ d[N].l = L::Encode(p) | d[N].sl; }
 
 	template <std::size_t N = 0, typename Node = TNode>
 	Node*
 	right() noexcept
-	{ return reinterpret_cast<Node*>(d[N].r & ~std::uintptr_t{0xF}); }
+	{ return reinterpret_cast<Node*>(L::Decode(d[N].r & ~Word{0xF})); }
 
 	template <std::size_t N = 0, typename Node = TNode>
 	Node const*
@@ -83,7 +517,7 @@ struct TNode {
 	template <std::size_t N = 0>
 	void
 	right(TNode* p) noexcept
-	{ d[N].r = reinterpret_cast<std::uintptr_t>(p) | d[N].sr; }
+	{ d[N].r = L::Encode(p) | d[N].sr; }
 
 	template <std::size_t N = 0>
 	auto*
@@ -97,6 +531,8 @@ struct TNode {
 			Y->d[N].hasLeft = true;
 		}
 		Y->left<N>(this);
+		recount<N>();
+		Y->template recount<N>();
 		return Y;
 	}
 
@@ -112,29 +548,34 @@ struct TNode {
 			Y->d[N].hasRight = true;
 		}
 		Y->right<N>(this);
+		recount<N>();
+		Y->template recount<N>();
 		return Y;
 	}
 
-	template <std::size_t N = 0>
+	template <std::size_t N = 0, typename S = Stats>
 	auto*
 	ll() noexcept
 	{
+		S::template rotated<N>(Stats::Rotation::LL);
 		d[N].balance = left<N>()->d[N].balance = 2;
 		return rightRotate<N>();
 	}
 
-	template <std::size_t N = 0>
+	template <std::size_t N = 0, typename S = Stats>
 	auto*
 	rr() noexcept
 	{
+		S::template rotated<N>(Stats::Rotation::RR);
 		d[N].balance = right<N>()->d[N].balance = 2;
 		return leftRotate<N>();
 	}
 
-	template <std::size_t N = 0>
+	template <std::size_t N = 0, typename S = Stats>
 	auto*
 	lr() noexcept
 	{
+		S::template rotated<N>(Stats::Rotation::LR);
 		d[N].balance = left<N>()->template right<N>()->d[N].isLeft ? 1 : 2;
 		left<N>()->d[N].balance = left<N>()->template right<N>()->d[N].isRight ? 4 : 2;
 		left<N>()->template right<N>()->d[N].balance = 2;
@@ -142,10 +583,11 @@ struct TNode {
 		return rightRotate<N>();
 	}
 
-	template <std::size_t N = 0>
+	template <std::size_t N = 0, typename S = Stats>
 	auto*
 	rl() noexcept
 	{
+		S::template rotated<N>(Stats::Rotation::RL);
 		d[N].balance = right<N>()->template left<N>()->d[N].isRight ? 4 : 2;
 		right<N>()->d[N].balance = right<N>()->template left<N>()->d[N].isLeft ? 1 : 2;
 		right<N>()->template left<N>()->d[N].balance = 2;
@@ -183,6 +625,30 @@ struct TNode {
 	rightMost() const noexcept
 	{ return const_cast<TNode*>(this)->template rightMost<N, Node>(); }
 
+	template <std::size_t N = 0, typename Node = TNode>
+	Node*
+	at(std::uint64_t i) noexcept
+	{
+		TNode* t = this;
+		while (true) {
+			auto l = t->leftCount<N>();
+			if (i < l)
+				t = t->left<N>();
+			else if (i > l) {
+				if (!t->d[N].hasRight)
+					return nullptr;
+				i -= l + 1;
+				t = t->right<N>();
+			} else
+				return reinterpret_cast<Node*>(t);
+		}
+	}
+
+	template <std::size_t N = 0, typename Node = TNode>
+	Node const*
+	at(std::uint64_t i) const noexcept
+	{ return const_cast<TNode*>(this)->template at<N, Node>(i); }
+
 	template <std::size_t N = 0, typename Node = TNode>
 	Node*
 	prev() noexcept
@@ -203,14 +669,60 @@ struct TNode {
 	next() const noexcept
 	{ return const_cast<TNode*>(this)->template next<N, Node>(); }
 
-	template <std::size_t N>
+	/**
+	 * @brief	Rotate the subtree once if the weights of its children differ by more than WeightBalanced::Delta.
+	 * @return	Root of the subtree
+	 */
+	template <std::size_t N = 0, typename S = Stats>
+	TNode*
+	reweigh() noexcept
+	{
+		std::uint64_t const wl = leftCount<N>() + 1;
+		std::uint64_t const wr = rightCount<N>() + 1;
+		if (wr > WeightBalanced::Delta * wl) {
+			TNode* r = right<N>();
+			if (r->template leftCount<N>() + 1 < WeightBalanced::Gamma * (r->template rightCount<N>() + 1)) {
+				S::template rotated<N>(Stats::Rotation::RR);
+				return leftRotate<N>();
+			}
+			S::template rotated<N>(Stats::Rotation::RL);
+			right<N>(r->template rightRotate<N>());
+			return leftRotate<N>();
+		}
+		if (wl > WeightBalanced::Delta * wr) {
+			TNode* l = left<N>();
+			if (l->template rightCount<N>() + 1 < WeightBalanced::Gamma * (l->template leftCount<N>() + 1)) {
+				S::template rotated<N>(Stats::Rotation::LL);
+				return rightRotate<N>();
+			}
+			S::template rotated<N>(Stats::Rotation::LR);
+			left<N>(l->template leftRotate<N>());
+			return rightRotate<N>();
+		}
+		return this;
+	}
+
+	/**
+	 * @brief	Rebalance after the left subtree is replaced by t, or grown if t is the same one.
+	 * @return	Root of the subtree if it is rotated or grown, WeightBalanced ones are returned only if rotated
+	 */
+	template <std::size_t N, typename S = Stats, typename B = AVL>
 	TNode*
 	attachedToLeft(TNode* t) noexcept
 	{
-		if (t) {
+		if constexpr (std::same_as<B, WeightBalanced>) {
+			if (t && t != left<N>())
+				left<N>(t);
+			auto* w = reweigh<N, S>();
+			return w != this ? w : nullptr;
+		} else if (t) {
 			if (t == left<N>()) {
+				if (std::same_as<B, WAVL> && d[N].balance == 5) { // a 2,2 node keeps its rank
+					d[N].balance = 4;
+					return nullptr;
+				}
 				if (d[N].isLeft)
-					return left<N>()->d[N].isLeft ? ll<N>() : lr<N>();
+					return left<N>()->d[N].isLeft ? ll<N, S>() : lr<N, S>();
 				d[N].balance <<= 1;
 				if (d[N].isLeft)
 					return this;
@@ -220,14 +732,27 @@ struct TNode {
 		return nullptr;
 	}
 
-	template <std::size_t N>
+	/**
+	 * @brief	Rebalance after the right subtree is replaced by t, or grown if t is the same one.
+	 * @see		attachedToLeft
+	 */
+	template <std::size_t N, typename S = Stats, typename B = AVL>
 	TNode*
 	attachedToRight(TNode* t) noexcept
 	{
-		if (t) {
+		if constexpr (std::same_as<B, WeightBalanced>) {
+			if (t && t != right<N>())
+				right<N>(t);
+			auto* w = reweigh<N, S>();
+			return w != this ? w : nullptr;
+		} else if (t) {
 			if (t == right<N>()) {
+				if (std::same_as<B, WAVL> && d[N].balance == 5) { // a 2,2 node keeps its rank
+					d[N].balance = 1;
+					return nullptr;
+				}
 				if (d[N].isRight)
-					return right<N>()->d[N].isRight ? rr<N>() : rl<N>();
+					return right<N>()->d[N].isRight ? rr<N, S>() : rl<N, S>();
 				d[N].balance >>= 1;
 				if (d[N].isRight)
 					return this;
@@ -237,6 +762,130 @@ struct TNode {
 		return nullptr;
 	}
 
+	/**
+	 * @brief	Rebalance after a node is detached from the left subtree, rank balanced ones if it is shrunk.
+	 * @param	shrunk Whether the rank of the left subtree decreased, then whether the one of this subtree does
+	 * @return	Root of the subtree
+	 * @details	A rank balanced subtree is demoted or rotated at most twice, after which shrunk is false.
+	 */
+	template <std::size_t N, typename S = Stats, typename B = WAVL>
+	TNode*
+	detachedFromLeft(bool& shrunk) noexcept
+	{
+		if constexpr (std::same_as<B, WeightBalanced>)
+			return reweigh<N, S>();
+		else {
+			if (!shrunk)
+				return this;
+			if (!d[N].isRight) { // a 1-child becomes a 2-child
+				if (d[N].hasLeft || d[N].hasRight) {
+					d[N].balance = d[N].isLeft ? 5 : 1;
+					shrunk = false;
+				} else // a leaf is demoted
+					d[N].balance = 2;
+				return this;
+			}
+			if (d[N].isLeft) { // demoted from 2,2 to 2,1
+				d[N].balance = 1;
+				return this;
+			}
+			TNode* y = right<N>();
+			if (y->d[N].balance == 5) { // demoted along with y
+				y->d[N].balance = 2;
+				d[N].balance = 1;
+				return this;
+			}
+			shrunk = false;
+			if (!y->d[N].isLeft) {
+				S::template rotated<N>(Stats::Rotation::RR);
+				bool const high = !y->d[N].isRight;
+				auto* t = leftRotate<N>();
+				if (high) {
+					d[N].balance = 1;
+					y->d[N].balance = 4;
+				} else if (d[N].hasLeft || d[N].hasRight) {
+					d[N].balance = 5;
+					y->d[N].balance = 4;
+				} else {
+					d[N].balance = 2;
+					y->d[N].balance = 5;
+				}
+				return t;
+			}
+			S::template rotated<N>(Stats::Rotation::RL);
+			TNode* z = y->template left<N>();
+			int const zl = z->template leftDiff<N>();
+			int const zr = z->template rightDiff<N>();
+			right<N>(y->template rightRotate<N>());
+			auto* t = leftRotate<N>();
+			diffs<N>(1, zl);
+			y->template diffs<N>(zr, 1);
+			z->d[N].balance = 5;
+			return t;
+		}
+	}
+
+	/**
+	 * @brief	Rebalance after a node is detached from the right subtree.
+	 * @see		detachedFromLeft
+	 */
+	template <std::size_t N, typename S = Stats, typename B = WAVL>
+	TNode*
+	detachedFromRight(bool& shrunk) noexcept
+	{
+		if constexpr (std::same_as<B, WeightBalanced>)
+			return reweigh<N, S>();
+		else {
+			if (!shrunk)
+				return this;
+			if (!d[N].isLeft) { // a 1-child becomes a 2-child
+				if (d[N].hasLeft || d[N].hasRight) {
+					d[N].balance = d[N].isRight ? 5 : 4;
+					shrunk = false;
+				} else // a leaf is demoted
+					d[N].balance = 2;
+				return this;
+			}
+			if (d[N].isRight) { // demoted from 2,2 to 1,2
+				d[N].balance = 4;
+				return this;
+			}
+			TNode* y = left<N>();
+			if (y->d[N].balance == 5) { // demoted along with y
+				y->d[N].balance = 2;
+				d[N].balance = 4;
+				return this;
+			}
+			shrunk = false;
+			if (!y->d[N].isRight) {
+				S::template rotated<N>(Stats::Rotation::LL);
+				bool const high = !y->d[N].isLeft;
+				auto* t = rightRotate<N>();
+				if (high) {
+					d[N].balance = 4;
+					y->d[N].balance = 1;
+				} else if (d[N].hasLeft || d[N].hasRight) {
+					d[N].balance = 5;
+					y->d[N].balance = 1;
+				} else {
+					d[N].balance = 2;
+					y->d[N].balance = 5;
+				}
+				return t;
+			}
+			S::template rotated<N>(Stats::Rotation::LR);
+			TNode* z = y->template right<N>();
+			int const zl = z->template leftDiff<N>();
+			int const zr = z->template rightDiff<N>();
+			left<N>(y->template leftRotate<N>());
+			auto* t = rightRotate<N>();
+			diffs<N>(zr, 1);
+			y->template diffs<N>(1, zl);
+			z->d[N].balance = 5;
+			return t;
+		}
+	}
+
 	template <std::size_t N>
 	auto*
 	attachToLeft(TNode* t) noexcept
@@ -244,8 +893,10 @@ struct TNode {
 		t->template left<N>(left<N>());
 		t->template right<N>(this);
 		t->template state<N>(2);
+		t->d[N].cnt = 1;
 		d[N].hasLeft = true;
 		left<N>(t);
+		recount<N>(1);
 		d[N].balance <<= 1;
 		return d[N].isLeft ? this : nullptr;
 	}
@@ -257,8 +908,10 @@ struct TNode {
 		t->template right<N>(right<N>());
 		t->template left<N>(this);
 		t->template state<N>(2);
+		t->d[N].cnt = 1;
 		d[N].hasRight = true;
 		right<N>(t);
+		recount<N>(1);
 		d[N].balance >>= 1;
 		return d[N].isRight ? this : nullptr;
 	}
@@ -274,9 +927,9 @@ struct TNode {
 		P->template left<N>(P != left<N>() ? left<N>() : this);
 		P->template right<N>(right<N>());
 		if (P->d[N].hasLeft) {
-			Pleft->template right<N>(this);
+			Pleft->template rightMost<N>()->template right<N>(this);
 			if (P != left<N>())
-				Pleft->template left<N>()->template right<N>(this);
+				Pleft->template leftMost<N>()->template left<N>()->template right<N>(this);
 		} else {
 			if (P != left<N>())
 				Pleft->template right<N>(this);
@@ -286,9 +939,14 @@ struct TNode {
 		P->d[N].balance ^= d[N].balance;
 		d[N].balance ^= P->d[N].balance;
 		P->d[N].balance ^= d[N].balance;
-		P->d[N].has ^= d[N].has;
-		d[N].has ^= P->d[N].has;
-		P->d[N].has ^= d[N].has;
+		P->d[N].hasLeft ^= d[N].hasLeft;
+		d[N].hasLeft ^= P->d[N].hasLeft;
+		P->d[N].hasLeft ^= d[N].hasLeft;
+		P->d[N].hasRight ^= d[N].hasRight;
+		d[N].hasRight ^= P->d[N].hasRight;
+		P->d[N].hasRight ^= d[N].hasRight;
+		std::swap(P->d[N].cnt, d[N].cnt);
+		P->d[N].aggregated = d[N].aggregated = false;
 		return P;
 	}
 
@@ -303,9 +961,9 @@ struct TNode {
 		S->template right<N>(S != right<N>() ? right<N>() : this);
 		S->template left<N>(left<N>());
 		if (S->d[N].hasRight) {
-			Sright->template left<N>(this);
+			Sright->template leftMost<N>()->template left<N>(this);
 			if (S != right<N>())
-				Sright->template right<N>()->template left<N>(this);
+				Sright->template rightMost<N>()->template right<N>()->template left<N>(this);
 		} else {
 			if (S != right<N>())
 				Sright->template left<N>(this);
@@ -315,9 +973,14 @@ struct TNode {
 		S->d[N].balance ^= d[N].balance;
 		d[N].balance ^= S->d[N].balance;
 		S->d[N].balance ^= d[N].balance;
-		S->d[N].has ^= d[N].has;
-		d[N].has ^= S->d[N].has;
-		S->d[N].has ^= d[N].has;
+		S->d[N].hasLeft ^= d[N].hasLeft;
+		d[N].hasLeft ^= S->d[N].hasLeft;
+		S->d[N].hasLeft ^= d[N].hasLeft;
+		S->d[N].hasRight ^= d[N].hasRight;
+		d[N].hasRight ^= S->d[N].hasRight;
+		S->d[N].hasRight ^= d[N].hasRight;
+		std::swap(S->d[N].cnt, d[N].cnt);
+		S->d[N].aggregated = d[N].aggregated = false;
 		return S;
 	}
 
@@ -346,6 +1009,6 @@ struct TNode {
 		dotOutput << "}\n";
 		return dotOutput;
 	}
-};//struct TNode<std::size_t>
+};//struct TNode<Dim, L>
 
 }//namespace DS
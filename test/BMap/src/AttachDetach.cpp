@@ -0,0 +1,154 @@
+#include "DS/BMap.hpp"
+#include "DS/Test/BTree.hpp"
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace DS;
+
+struct Counting : Allocator {
+	static inline long live{0};
+
+	static void*
+	allocate(std::size_t size)
+	{
+		++live;
+		return Allocator::allocate(size);
+	}
+
+	static void
+	deallocate(void* ptr) noexcept
+	{
+		--live;
+		Allocator::deallocate(ptr);
+	}
+};
+
+using BMap2D = BMap<int, std::string, std::less<>, std::greater<>, Counting>;
+
+void
+TestTree(BMap2D const& map)
+{
+	auto* const* rootNode = reinterpret_cast<BNode<int, BValue<std::string, std::less<>, std::greater<>, Counting>*, std::less<>, std::greater<>, Counting>* const*>(reinterpret_cast<std::byte const*>(&map) + sizeof(std::uint64_t));
+	assert((DS::Test::TestBTree<std::less<>>(rootNode[0]) == map.size()));
+	assert((DS::Test::TestBTree<std::greater<>>(rootNode[1]) == map.size()));
+}
+
+void
+TestEqual(BMap2D const& map, std::map<int, std::string> const& expected)
+{
+	TestTree(map);
+	assert((map.size() == expected.size()));
+	auto j = map.rbegin<1>();
+	for (auto const& [k, v] : expected) {
+		assert((j && j->key == k && j.hasValue() == !v.empty()));
+		if (j.hasValue())
+			assert((j->value == v));
+		++j;
+	}
+	assert(!j);
+}
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 8192);
+
+	{
+		BMap2D map;
+		std::map<int, std::string> expected;
+		for (int i{0}; i < 20000; ++i) {
+			int x = distrib(gen);
+			if (i % 3 == 2) {
+				assert((map.remove<1>(x) == expected.erase(x)));
+			} else {
+				auto j = map.put(x);
+				assert((j && j->key == x));
+				auto& v = expected[x];
+				if (x % 2) {
+					v = std::to_string(i) + std::string(24, 'v');
+					j.set(v);
+				} else {
+					v.clear();
+					j.unset();
+				}
+			}
+		}
+		TestEqual(map, expected);
+
+		std::uint64_t r{0};
+		for (auto const& [k, v] : expected) {
+			assert((map.at(r)->key == k && map.at<1>(expected.size() - r - 1)->key == k));
+			assert((map.rank(k) == r));
+			assert((map.get<1>(k).hasValue() == !v.empty()));
+			++r;
+		}
+		assert(!map.at(r));
+		assert(!map.get(-1));
+
+		BMap2D const copy = map;
+		TestEqual(copy, expected);
+
+		for (auto i = map.begin(); i; ++i) {
+			if (!i.hasValue())
+				i.set("empty");
+			else
+				i->value += '!';
+		}
+		for (auto& [k, v] : expected)
+			v = v.empty() ? "empty" : v + '!';
+		TestEqual(map, expected);
+
+		auto difference = BMap2D::Difference<>{}(copy, map);
+		assert(!difference);
+
+		std::map<int, std::string> half;
+		for (auto const& [k, v] : expected) {
+			if (k % 4 == 1)
+				half.emplace(k, v);
+			else
+				map.remove(k);
+		}
+		TestEqual(map, half);
+		difference = BMap2D::Difference<1>{}(copy, map);
+		assert((difference.size() == copy.size() - map.size()));
+		TestTree(difference);
+
+		auto intersection = BMap2D::Intersection<RightSelector<int>>{}(copy, map);
+		TestEqual(intersection, half);
+		auto union_ = BMap2D::Union<RightSelector<int>, 1>{}(copy, map);
+		for (auto const& [k, v] : half)
+			expected[k] = v;
+		for (auto& [k, v] : expected) {
+			if (k % 4 != 1)
+				v = v == "empty" ? "" : v.substr(0, v.size() - 1);
+		}
+		TestEqual(union_, expected);
+		auto join = BMap2D::Join<LeftSelector<int>>{}(map, copy);
+		TestEqual(join, half);
+
+		while (union_)
+			assert(union_.remove(union_.rbegin()));
+	}
+	assert((Counting::live == 0));
+
+	{
+		std::vector<std::byte> data;
+		auto append = [&](auto const& value) {
+			auto const* p = reinterpret_cast<std::byte const*>(&value);
+			data.insert(data.end(), p, p + sizeof value);
+		};
+		append(std::uint64_t{3});
+		append(1), append(std::uint8_t{1}), append(1.5);
+		append(2), append(std::uint8_t{0});
+		append(4), append(std::uint8_t{1}), append(4.5);
+		Stream::BufferInput input(data.data(), data.size());
+		BMap<int, double, std::less<>, std::greater<>> map(input);
+		assert((map.size() == 3));
+		assert((map.at(0)->value == 1.5 && !map.at(1).hasValue() && map.at<1>(0)->value == 4.5));
+	}
+
+	return 0;
+}
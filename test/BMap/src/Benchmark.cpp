@@ -0,0 +1,73 @@
+#include "DS/BMap.hpp"
+#include "DS/Map.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace DS;
+
+template <typename M>
+void
+Run(char const* name, std::vector<int> const& keys, std::vector<float>& total)
+{
+	auto const t0{std::chrono::steady_clock::now()};
+	M map;
+	for (int k : keys)
+		map.put(k).set(k);
+	auto const t1{std::chrono::steady_clock::now()};
+	long long found{0};
+	for (int k : keys)
+		found += map.get(k)->value;
+	auto const t2{std::chrono::steady_clock::now()};
+	long long sum{0};
+	for (auto i = map.begin(); i; ++i)
+		sum += i->value;
+	for (auto i = map.template begin<1>(); i; ++i)
+		sum -= i->key;
+	auto const t3{std::chrono::steady_clock::now()};
+	for (int k : keys)
+		map.remove(k);
+	auto const t4{std::chrono::steady_clock::now()};
+
+	assert((sum == 0 && map.size() == 0));
+
+	float const t[]{
+		std::chrono::duration_cast<std::chrono::duration<float>>(t1 - t0).count(),
+		std::chrono::duration_cast<std::chrono::duration<float>>(t2 - t1).count(),
+		std::chrono::duration_cast<std::chrono::duration<float>>(t3 - t2).count(),
+		std::chrono::duration_cast<std::chrono::duration<float>>(t4 - t3).count()};
+	for (int i = 0; i < 4; ++i)
+		total[i] += t[i];
+	std::cout
+		<< name << "\tput " << t[0] << "s\tget " << t[1] << "s\titerate " << t[2] << "s\tremove " << t[3] << "s\t"
+		<< found << ' ' << sum << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	int const testCount{std::stoi(argv[1])};
+	int const itemCount{std::stoi(argv[2])};
+
+	std::mt19937 gen(testCount);
+	std::vector<int> keys(itemCount);
+	std::iota(keys.begin(), keys.end(), 0);
+
+	std::vector<float> avl(4), btree(4);
+	for (int t = 0; t < testCount;) {
+		std::shuffle(keys.begin(), keys.end(), gen);
+		std::cout << ++t << '/' << testCount << std::endl;
+		Run<Map<int, long long, std::less<>, std::greater<>>>("Map", keys, avl);
+		Run<BMap<int, long long, std::less<>, std::greater<>>>("BMap", keys, btree);
+	}
+
+	std::cout << "BMap/Map";
+	for (int i = 0; i < 4; ++i)
+		std::cout << '\t' << btree[i] / avl[i];
+	std::cout << std::endl;
+
+	return 0;
+}
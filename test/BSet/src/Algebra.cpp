@@ -0,0 +1,83 @@
+#include "DS/BSet.hpp"
+#include "DS/Test/BTree.hpp"
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace DS;
+
+using BSet2D = BSet<int, std::less<>, std::greater<>>;
+
+void
+TestTree(BSet2D const& set)
+{
+	auto* const* rootNode = reinterpret_cast<BNode<int, void, std::less<>, std::greater<>>* const*>(reinterpret_cast<std::byte const*>(&set) + sizeof(std::uint64_t));
+	assert((DS::Test::TestBTree<std::less<>>(rootNode[0]) == set.size()));
+	assert((DS::Test::TestBTree<std::greater<>>(rootNode[1]) == set.size()));
+}
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 1 << 14);
+
+	for (int n{0}; n < 300; n += 7) {
+		BSet2D::BulkBuilder<1> builder;
+		for (int i{n}; i > 0; --i)
+			builder.put(i);
+		auto set = builder.build();
+		TestTree(set);
+		assert((set.size() == static_cast<std::uint64_t>(n)));
+		assert((std::equal(set.begin<0>(), set.end<0>(), set.rbegin<1>())));
+	}
+
+	for (int sizeB : {4096, 64}) {
+		std::set<int> a, b;
+		BSet2D setA, setB;
+		for (int i{0}; i < 4096; ++i) {
+			int x = distrib(gen);
+			a.insert(x);
+			setA.put(x);
+		}
+		for (int i{0}; i < sizeB; ++i) {
+			int y = distrib(gen);
+			b.insert(y);
+			setB.put(y);
+		}
+
+		std::vector<int> expected;
+		std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+		auto difference = BSet2D::Difference<>{}(setA, setB);
+		TestTree(difference);
+		assert((difference.size() == expected.size() && std::equal(difference.begin(), difference.end(), expected.begin())));
+
+		expected.clear();
+		std::set_difference(b.begin(), b.end(), a.begin(), a.end(), std::back_inserter(expected));
+		difference = BSet2D::Difference<1>{}(setB, setA);
+		TestTree(difference);
+		assert((difference.size() == expected.size() && std::equal(difference.begin(), difference.end(), expected.begin())));
+
+		expected.clear();
+		std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+		auto intersection = BSet2D::Intersection<LeftSelector<int>>{}(setA, setB);
+		TestTree(intersection);
+		assert((intersection.size() == expected.size() && std::equal(intersection.begin(), intersection.end(), expected.begin())));
+		intersection = BSet2D::Intersection<RightSelector<int>, 1>{}(setB, setA);
+		TestTree(intersection);
+		assert((intersection.size() == expected.size() && std::equal(intersection.begin(), intersection.end(), expected.begin())));
+
+		expected.clear();
+		std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+		auto union_ = BSet2D::Union<LeftSelector<int>>{}(setA, setB);
+		TestTree(union_);
+		assert((union_.size() == expected.size() && std::equal(union_.begin(), union_.end(), expected.begin())));
+
+		auto join = BSet2D::Join<LeftSelector<int>, 1>{}(setA, setB);
+		TestTree(join);
+		assert((join.size() == a.size() && std::equal(join.begin(), join.end(), a.begin())));
+	}
+
+	return 0;
+}
@@ -0,0 +1,169 @@
+#include "DS/BSet.hpp"
+#include "DS/Test/BTree.hpp"
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+
+using namespace DS;
+
+struct Counting : Allocator {
+	static inline long live{0};
+
+	static void*
+	allocate(std::size_t size)
+	{
+		++live;
+		return Allocator::allocate(size);
+	}
+
+	static void
+	deallocate(void* ptr) noexcept
+	{
+		--live;
+		Allocator::deallocate(ptr);
+	}
+};
+
+struct ByFirst {
+	bool
+	operator()(std::pair<int, int> const& a, std::pair<int, int> const& b) const noexcept
+	{ return a.first < b.first; }
+};
+
+struct BySecond {
+	bool
+	operator()(std::pair<int, int> const& a, std::pair<int, int> const& b) const noexcept
+	{ return a.second < b.second; }
+};
+
+template <typename K, typename ... Cmps>
+void
+TestTree(auto const& set)
+{
+	auto* const* rootNode = reinterpret_cast<BNode<K, void, Cmps ..., Counting>* const*>(reinterpret_cast<std::byte const*>(&set) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		((assert((DS::Test::TestBTree<Cmps>(rootNode[N]) == set.size()))), ...);
+	}(std::make_index_sequence<sizeof...(Cmps)>{});
+}
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+
+	{
+		std::uniform_int_distribution<> distrib(0, 8192);
+		BSet<int, std::less<>, std::greater<>, Counting> set2D;
+		std::set<int> expected;
+		for (int i{0}; i < 20000; ++i) {
+			int x = distrib(gen);
+			if (i % 3 == 2) {
+				assert((set2D.remove<1>(x) == expected.erase(x)));
+			} else {
+				auto j = set2D.put(x);
+				assert((j && *j == x));
+				expected.insert(x);
+			}
+			if (i % 1000 == 0)
+				TestTree<int, std::less<>, std::greater<>>(set2D);
+		}
+		TestTree<int, std::less<>, std::greater<>>(set2D);
+		assert((set2D.size() == expected.size()));
+		assert((std::equal(set2D.begin(), set2D.end(), expected.begin())));
+		assert((std::equal(set2D.rbegin(), set2D.rend(), expected.rbegin())));
+		assert((std::equal(set2D.begin<1>(), set2D.end<1>(), expected.rbegin())));
+
+		std::uint64_t r{0};
+		for (int x : expected) {
+			assert((*set2D.at(r) == x));
+			assert((*set2D.at<1>(expected.size() - r - 1) == x));
+			assert((set2D.rank(x) == r));
+			assert((set2D.get<1>(x) && *set2D.get<1>(x) == x));
+			++r;
+		}
+		assert(!set2D.at(r));
+		assert((set2D.count(1000, 3000) == static_cast<std::uint64_t>(std::distance(expected.lower_bound(1000), expected.lower_bound(3000)))));
+		assert(!set2D.get(-1));
+
+		auto copy = set2D;
+		TestTree<int, std::less<>, std::greater<>>(copy);
+		assert((std::equal(copy.begin(), copy.end(), expected.begin())));
+
+		while (copy)
+			assert(copy.remove(copy.begin()));
+		assert((copy.size() == 0 && !copy.begin()));
+
+		for (int x : expected)
+			assert(set2D.remove(x));
+		assert((set2D.size() == 0 && !set2D.begin<1>()));
+	}
+	assert((Counting::live == 0));
+
+	{
+		// a key is put only if no comparator finds an existing one
+		std::uniform_int_distribution<> distrib(0, 2048);
+		BSet<std::pair<int, int>, ByFirst, BySecond, Counting> set;
+		std::set<int> firsts, seconds;
+		for (int i{0}; i < 4096; ++i) {
+			std::pair<int, int> p{distrib(gen), distrib(gen)};
+			auto j = set.put(p);
+			if (!firsts.contains(p.first) && !seconds.contains(p.second)) {
+				assert((*j == p));
+				firsts.insert(p.first);
+				seconds.insert(p.second);
+			} else
+				assert((j && (j->first == p.first || j->second == p.second)));
+			if (i % 3 == 2 && set) {
+				auto k = *set.at<1>(distrib(gen) % set.size());
+				assert(set.remove<1>(k));
+				firsts.erase(k.first);
+				seconds.erase(k.second);
+			}
+		}
+		TestTree<std::pair<int, int>, ByFirst, BySecond>(set);
+		assert((set.size() == firsts.size() && set.size() == seconds.size()));
+	}
+	assert((Counting::live == 0));
+
+	{
+		std::uniform_int_distribution<> distrib(0, 1 << 20);
+		BSet<std::string, std::less<>, std::greater<>, Counting> set;
+		std::set<std::string> expected;
+		for (int i{0}; i < 4096; ++i) {
+			auto s = std::to_string(distrib(gen)) + std::string(i % 40, 'x');
+			set.put(s);
+			expected.insert(s);
+			if (i % 2) {
+				auto t = *set.at(distrib(gen) % set.size());
+				assert(set.remove(t));
+				expected.erase(t);
+			}
+		}
+		TestTree<std::string, std::less<>, std::greater<>>(set);
+		assert((set.size() == expected.size() && std::equal(set.begin(), set.end(), expected.begin())));
+	}
+	assert((Counting::live == 0));
+
+	{
+		struct {
+			std::uint64_t size{4};
+			int keys[4]{1, 2, 3, 5};
+		} data;
+		Stream::BufferInput input(&data, sizeof data);
+		BSet<int, std::less<>, std::greater<>> set(input);
+		assert((set.size() == 4 && *set.at(3) == 5 && *set.at<1>(0) == 5));
+
+		data.keys[3] = 0;
+		Stream::BufferInput unordered(&data, sizeof data);
+		bool thrown{false};
+		try {
+			BSet<int> other(unordered);
+		} catch (BSet<int>::Exception const&) {
+			thrown = true;
+		}
+		assert(thrown);
+	}
+
+	return 0;
+}
@@ -0,0 +1,73 @@
+#include "DS/BSet.hpp"
+#include "DS/Set.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace DS;
+
+template <typename S>
+void
+Run(char const* name, std::vector<int> const& keys, std::vector<float>& total)
+{
+	auto const t0{std::chrono::steady_clock::now()};
+	S set;
+	for (int k : keys)
+		set.put(k);
+	auto const t1{std::chrono::steady_clock::now()};
+	std::uint64_t found{0};
+	for (int k : keys)
+		found += static_cast<bool>(set.get(k));
+	auto const t2{std::chrono::steady_clock::now()};
+	long long sum{0};
+	for (auto i = set.begin(); i; ++i)
+		sum += *i;
+	for (auto i = set.template begin<1>(); i; ++i)
+		sum -= *i;
+	auto const t3{std::chrono::steady_clock::now()};
+	for (int k : keys)
+		set.remove(k);
+	auto const t4{std::chrono::steady_clock::now()};
+
+	assert((found == keys.size() && sum == 0 && set.size() == 0));
+
+	float const t[]{
+		std::chrono::duration_cast<std::chrono::duration<float>>(t1 - t0).count(),
+		std::chrono::duration_cast<std::chrono::duration<float>>(t2 - t1).count(),
+		std::chrono::duration_cast<std::chrono::duration<float>>(t3 - t2).count(),
+		std::chrono::duration_cast<std::chrono::duration<float>>(t4 - t3).count()};
+	for (int i = 0; i < 4; ++i)
+		total[i] += t[i];
+	std::cout
+		<< name << "\tput " << t[0] << "s\tget " << t[1] << "s\titerate " << t[2] << "s\tremove " << t[3] << "s\t"
+		<< found << ' ' << sum << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	int const testCount{std::stoi(argv[1])};
+	int const itemCount{std::stoi(argv[2])};
+
+	std::mt19937 gen(testCount);
+	std::vector<int> keys(itemCount);
+	std::iota(keys.begin(), keys.end(), 0);
+
+	std::vector<float> avl(4), btree(4);
+	for (int t = 0; t < testCount;) {
+		std::shuffle(keys.begin(), keys.end(), gen);
+		std::cout << ++t << '/' << testCount << std::endl;
+		Run<Set<int, std::less<>, std::greater<>>>("Set", keys, avl);
+		Run<BSet<int, std::less<>, std::greater<>>>("BSet", keys, btree);
+	}
+
+	std::cout << "BSet/Set";
+	for (int i = 0; i < 4; ++i)
+		std::cout << '\t' << btree[i] / avl[i];
+	std::cout << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,106 @@
+#include "DS/CMap.hpp"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <random>
+#include <string>
+#include <thread>
+
+using namespace DS;
+
+// Elements in order, each one mapped to twice its key
+std::uint64_t
+TestOrder(CMap<int, int> const& map)
+{
+	std::uint64_t n{0};
+	int last{-1};
+	for (auto i = map.begin(); i != map.end(); ++i, ++n) {
+		assert((last < i->key && i->value == i->key * 2));
+		last = i->key;
+	}
+	return n;
+}
+
+int main(int argc, char* argv[])
+{
+	int const itemCount{std::stoi(argv[1])};
+	int const opCount{std::stoi(argv[2])};
+	int const maxThreadCount{std::stoi(argv[3])};
+
+	// puts and removes of disjoint keys on every thread, while the others read
+	{
+		CMap<int, int> map;
+		{
+			std::list<std::jthread> threads;
+			for (int t = 0; t < maxThreadCount; ++t) {
+				threads.emplace_back([&map](int start, int end, int step) {
+					for (int i = start; i < end; i += step)
+						assert((map.put(i, i * 2) && !map.put(i, 0)));
+					for (int i = start; i < end; i += step * 2)
+						assert((map.remove(i) && !map.remove(i)));
+					for (int i = start; i < end; i += step) {
+						auto const value = map.get(i);
+						assert((value ? *value == i * 2 && (i - start) % (step * 2) : !((i - start) % (step * 2))));
+						auto const j = map.lowerBound(i);
+						assert((j && j->key >= i));
+					}
+				}, t, itemCount, maxThreadCount);
+			}
+		}
+		std::uint64_t kept{0};
+		for (int i = 0; i < itemCount; ++i)
+			kept += i % (maxThreadCount * 2) >= maxThreadCount;
+		assert((TestOrder(map) == map.size() && map.size() == kept));
+	}
+
+	// a value got is kept after it is removed
+	{
+		CMap<int, std::string> map;
+		map.put(1, "one");
+		auto const value = map.get(1);
+		assert((map.remove(1) && !map.get(1) && !map.begin() && *value == "one"));
+	}
+
+	// mixed operations, 80% get, 10% put and 10% remove of uniformly distributed keys
+	for (int threadCount = 1; threadCount <= maxThreadCount; threadCount *= 2) {
+		CMap<int, int> map;
+		for (int i = 0; i < itemCount * 2; i += 2)
+			map.put(i, i * 2);
+
+		auto const t0{std::chrono::steady_clock::now()};
+		{
+			std::list<std::jthread> threads;
+			for (int t = 0; t < threadCount; ++t) {
+				threads.emplace_back([&map, opCount, itemCount](unsigned seed) {
+					std::mt19937 gen(seed);
+					std::uniform_int_distribution<> keys(0, itemCount * 2 - 1);
+					std::uniform_int_distribution<> ops(0, 9);
+					for (int i = 0; i < opCount; ++i) {
+						int const k{keys(gen)};
+						switch (ops(gen)) {
+							case 0:
+								map.put(k, k * 2);
+								break;
+							case 1:
+								map.remove(k);
+								break;
+							default:
+								if (auto const value = map.get(k))
+									assert((*value == k * 2));
+						}
+					}
+				}, t);
+			}
+		}
+		auto const t1{std::chrono::steady_clock::now()};
+
+		assert((TestOrder(map) == map.size()));
+		std::cout
+			<< threadCount << " threads\t"
+			<< std::chrono::duration_cast<std::chrono::duration<float>>(t1 - t0).count() << "s\t"
+			<< threadCount * opCount / std::chrono::duration_cast<std::chrono::duration<float>>(t1 - t0).count() / 1e6 << " Mops/s"
+			<< std::endl;
+	}
+	return 0;
+}
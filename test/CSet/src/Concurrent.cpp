@@ -0,0 +1,102 @@
+#include "DS/CSet.hpp"
+#include <cassert>
+#include <list>
+#include <string>
+#include <thread>
+
+using namespace DS;
+
+// Key counting its live instances
+struct Key {
+	static inline std::atomic<long> live{0};
+	std::string name;
+
+	explicit Key(int i)
+			: name(std::to_string(1000000 + i))
+	{ ++live; }
+
+	Key(Key const& other)
+			: name(other.name)
+	{ ++live; }
+
+	~Key()
+	{ --live; }
+
+	bool
+	operator<(Key const& other) const noexcept
+	{ return name < other.name; }
+};
+
+// Orders keys by their names and the ints they are made of
+struct Less {
+	using is_transparent = void;
+
+	bool
+	operator()(Key const& a, Key const& b) const noexcept
+	{ return a < b; }
+
+	bool
+	operator()(Key const& a, int b) const
+	{ return a.name < Key(b).name; }
+
+	bool
+	operator()(int a, Key const& b) const
+	{ return Key(a).name < b.name; }
+};
+
+int main(int argc, char* argv[])
+{
+	int const itemCount{std::stoi(argv[1])};
+	int const threadCount{std::stoi(argv[2])};
+
+	{
+		CSet<Key, Less> set;
+		for (int i = 0; i < itemCount; ++i)
+			assert((set.put(Key(i))));
+		assert((set.size() == static_cast<std::uint64_t>(itemCount) && !set.put(Key(0))));
+
+		// readers traverse while the writers remove the odd keys and put them back, then remove them for good
+		std::atomic<int> writers{threadCount};
+		{
+			std::list<std::jthread> threads;
+			for (int t = 0; t < threadCount; ++t) {
+				threads.emplace_back([&](int start) {
+					for (int round = 0; round < 2; ++round) {
+						for (int i = start; i < itemCount; i += threadCount * 2)
+							assert((set.remove(i)));
+						if (!round) {
+							for (int i = start; i < itemCount; i += threadCount * 2)
+								assert((set.put(Key(i))));
+						}
+					}
+					--writers;
+				}, t * 2 + 1);
+				threads.emplace_back([&] {
+					do {
+						std::string last;
+						int even{0};
+						for (auto i = set.begin(); i; ++i) {
+							assert((last < i->name));
+							last = i->name;
+							even += !(std::stoi(i->name) % 2);
+						}
+						// the even keys are never removed, each one is seen
+						assert((even == (itemCount + 1) / 2));
+						auto const j = set.lowerBound(itemCount / 2);
+						assert((j && std::stoi(j->name) >= 1000000 + itemCount / 2));
+					} while (writers);
+				});
+			}
+		}
+		assert((set.size() == static_cast<std::uint64_t>(itemCount + 1) / 2 && !set.get(1) && set.get(0)));
+		std::uint64_t n{0};
+		for (auto const& k : set)
+			assert((!(std::stoi(k.name) % 2) && ++n));
+		assert((n == set.size()));
+		// a key got is kept after it is removed
+		auto const first = set.get(0);
+		assert((set.remove(0) && first->name == "1000000" && set.begin()->name == "1000002"));
+	}
+	assert((Key::live == 0));
+	return 0;
+}
@@ -0,0 +1,148 @@
+#include "DS/FrozenMap.hpp"
+#include <cassert>
+#include <map>
+#include <random>
+#include <string>
+
+using namespace DS;
+
+using Map2D = Map<int, std::string, std::less<>, std::greater<>>;
+using Frozen1D = FrozenMap<int, std::string>;
+using Frozen2D = FrozenMap<int, std::string, std::less<>, std::greater<>>;
+
+void
+TestEqual(Frozen2D const& map, std::map<int, std::string> const& expected)
+{
+	assert((map.size() == expected.size()));
+	auto i = map.begin();
+	auto j = map.rbegin<1>();
+	std::uint64_t r{0};
+	for (auto const& [k, v] : expected) {
+		assert((i && i->key == k && i.hasValue() == !v.empty()));
+		assert((j && j->key == k && j.hasValue() == !v.empty()));
+		assert((map.at(r)->key == k && map.rank(k) == r && map.rank<1>(k) == expected.size() - 1 - r));
+		if (i.hasValue())
+			assert((i->value == v && j->value == v && map.get<1>(k)->value == v));
+		++i;
+		++j;
+		++r;
+	}
+	assert((!i && !j));
+}
+
+void
+TestEqual(Frozen1D const& map, std::map<int, std::string> const& expected)
+{
+	assert((map.size() == expected.size()));
+	auto i = map.begin();
+	for (auto const& [k, v] : expected) {
+		assert((i && i->key == k && i.hasValue() == !v.empty() && (!i.hasValue() || i->value == v)));
+		++i;
+	}
+	assert((!i));
+}
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 8192);
+
+	for (int n : {0, 1, 100, 4096}) {
+		Map2D map;
+		std::map<int, std::string> expected;
+		for (int i = 0; i < n; ++i) {
+			int k = distrib(gen);
+			auto j = map.put(k);
+			auto value = k % 3 ? std::to_string(k) : std::string();
+			if (!value.empty())
+				j.set(value);
+			expected[k] = value;
+		}
+
+		auto frozen = map.freeze();
+		TestEqual(frozen, expected);
+		for (int k = 0; k <= 8192; ++k) {
+			auto i = frozen.get(k);
+			assert((static_cast<bool>(i) == expected.contains(k) && frozen.rank(k) == map.rank(k)));
+		}
+
+		auto copy = frozen;
+		auto moved = std::move(frozen);
+		assert((!frozen && !frozen.get(0)));
+		TestEqual(copy, expected);
+		TestEqual(moved, expected);
+
+		auto thawed = copy.thaw();
+		assert((thawed.size() == expected.size()));
+		for (auto const& [k, v] : expected) {
+			auto i = thawed.get<1>(k);
+			assert((i && i.hasValue() == !v.empty() && (v.empty() || i->value == v)));
+		}
+	}
+
+	{
+		Map<int, std::string> mapA, mapB;
+		std::map<int, std::string> a, b;
+		for (int i = 0; i < 4096; ++i) {
+			int x = distrib(gen);
+			mapA.put(x).set("a");
+			a[x] = "a";
+			int y = distrib(gen);
+			if (y % 2) {
+				mapB.put(y).set("b");
+				b[y] = "b";
+			} else {
+				mapB.put(y);
+				b[y];
+			}
+		}
+		auto frozenA = mapA.freeze();
+		auto frozenB = mapB.freeze();
+
+		std::map<int, std::string> expected;
+		for (auto const& [k, v] : a)
+			if (!b.contains(k))
+				expected[k] = v;
+		TestEqual(Frozen1D::Difference<>{}(frozenA, frozenB), expected);
+
+		expected.clear();
+		for (auto const& [k, v] : b)
+			if (a.contains(k))
+				expected[k] = v;
+		TestEqual(Frozen1D::Intersection<RightSelector<int>>{}(frozenA, frozenB), expected);
+
+		expected = b;
+		for (auto const& [k, v] : a)
+			expected[k] = v;
+		TestEqual(Frozen1D::Union<LeftSelector<int>>{}(frozenA, frozenB), expected);
+
+		expected = a;
+		for (auto const& [k, v] : b)
+			if (a.contains(k))
+				expected[k] = v;
+		TestEqual(Frozen1D::Join<RightSelector<int>>{}(frozenA, frozenB), expected);
+	}
+
+	{
+		Map2D mapA, mapB;
+		std::map<int, std::string> a, b;
+		for (int i = 0; i < 1024; ++i) {
+			int x = distrib(gen);
+			mapA.put(x).set("a");
+			a[x] = "a";
+			int y = distrib(gen);
+			mapB.put(y).set("b");
+			b[y] = "b";
+		}
+		auto frozenA = mapA.freeze();
+		auto frozenB = mapB.freeze();
+
+		std::map<int, std::string> expected = a;
+		for (auto const& [k, v] : b)
+			expected[k] = v;
+		TestEqual(Frozen2D::Union<RightSelector<int>, 1>{}(frozenA, frozenB), expected);
+	}
+
+	return 0;
+}
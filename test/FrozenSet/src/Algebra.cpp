@@ -0,0 +1,80 @@
+#include "DS/FrozenSet.hpp"
+#include <algorithm>
+#include <cassert>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace DS;
+
+using Frozen1D = FrozenSet<int>;
+using Frozen2D = FrozenSet<int, std::less<>, std::greater<>>;
+
+bool
+Equal(Frozen1D const& frozen, std::vector<int> const& expected)
+{
+	return frozen.size() == expected.size()
+		&& std::equal(expected.begin(), expected.end(), frozen.begin())
+		&& std::equal(expected.rbegin(), expected.rend(), frozen.rbegin());
+}
+
+bool
+Equal(Frozen2D const& frozen, std::vector<int> const& expected)
+{
+	return frozen.size() == expected.size()
+		&& std::equal(expected.begin(), expected.end(), frozen.begin())
+		&& std::equal(expected.rbegin(), expected.rend(), frozen.begin<1>());
+}
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 1 << 14);
+
+	for (int sizeB : {4096, 64}) {
+		std::set<int> a, b;
+		Set<int> setA1, setB1;
+		Set<int, std::less<>, std::greater<>> setA2, setB2;
+		for (int i{0}; i < 4096; ++i) {
+			int x = distrib(gen);
+			a.insert(x);
+			setA1.put(x);
+			setA2.put(x);
+		}
+		for (int i{0}; i < sizeB; ++i) {
+			int y = distrib(gen);
+			b.insert(y);
+			setB1.put(y);
+			setB2.put(y);
+		}
+		auto a1 = setA1.freeze(), b1 = setB1.freeze();
+		auto a2 = setA2.freeze(), b2 = setB2.freeze();
+
+		std::vector<int> expected;
+		std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+		assert((Equal(Frozen1D::Difference<>{}(a1, b1), expected)));
+		assert((Equal(Frozen2D::Difference<1>{}(a2, b2), expected)));
+
+		expected.clear();
+		std::set_difference(b.begin(), b.end(), a.begin(), a.end(), std::back_inserter(expected));
+		assert((Equal(Frozen1D::Difference<>{}(b1, a1), expected)));
+		assert((Equal(Frozen2D::Difference<>{}(b2, a2), expected)));
+
+		expected.clear();
+		std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+		assert((Equal(Frozen1D::Intersection<LeftSelector<int>>{}(a1, b1), expected)));
+		assert((Equal(Frozen2D::Intersection<RightSelector<int>, 1>{}(b2, a2), expected)));
+
+		expected.clear();
+		std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+		assert((Equal(Frozen1D::Union<LeftSelector<int>>{}(a1, b1), expected)));
+		assert((Equal(Frozen2D::Union<LeftSelector<int>, 1>{}(a2, b2), expected)));
+
+		expected.assign(a.begin(), a.end());
+		assert((Equal(Frozen1D::Join<LeftSelector<int>>{}(a1, b1), expected)));
+		assert((Equal(Frozen2D::Join<LeftSelector<int>, 1>{}(a2, b2), expected)));
+	}
+
+	return 0;
+}
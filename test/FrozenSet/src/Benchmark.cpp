@@ -0,0 +1,88 @@
+#include "DS/FrozenSet.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace DS;
+
+template <typename S, typename K>
+void
+Run(char const* name, S const& set, std::vector<K> const& queries, std::vector<float>& total)
+{
+	auto const t0{std::chrono::steady_clock::now()};
+	std::uint64_t found{0};
+	for (auto const& q : queries)
+		found += static_cast<bool>(set.get(q));
+	auto const t1{std::chrono::steady_clock::now()};
+	std::uint64_t rank{0};
+	for (auto const& q : queries)
+		rank += set.template rank<1>(q);
+	auto const t2{std::chrono::steady_clock::now()};
+	long long sum{0};
+	for (auto i = set.template begin<1>(); i; ++i) {
+		if constexpr (std::is_arithmetic_v<K>)
+			sum += *i;
+		else
+			sum += i->size();
+	}
+	auto const t3{std::chrono::steady_clock::now()};
+
+	assert((found == queries.size() / 2));
+
+	float const t[]{
+		std::chrono::duration_cast<std::chrono::duration<float>>(t1 - t0).count(),
+		std::chrono::duration_cast<std::chrono::duration<float>>(t2 - t1).count(),
+		std::chrono::duration_cast<std::chrono::duration<float>>(t3 - t2).count()};
+	for (int i = 0; i < 3; ++i)
+		total[i] += t[i];
+	std::cout
+		<< name << "\tget " << t[0] << "s\trank " << t[1] << "s\titerate " << t[2] << "s\t"
+		<< found << ' ' << rank << ' ' << sum << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	int const testCount{std::stoi(argv[1])};
+	int const itemCount{std::stoi(argv[2])};
+
+	std::mt19937 gen(testCount);
+	std::vector<int> queries(2 * itemCount);
+	std::iota(queries.begin(), queries.end(), 0);
+
+	std::vector<float> tree(3), frozen(3), sTree(3), sFrozen(3);
+	for (int t = 0; t < testCount;) {
+		std::shuffle(queries.begin(), queries.end(), gen);
+		std::cout << ++t << '/' << testCount << std::endl;
+
+		// even keys are stored, odd ones are missed
+		Set<int, std::less<>, std::greater<>> set;
+		for (int i = 0; i < itemCount; ++i)
+			set.put(2 * i);
+		Run("Set", set, queries, tree);
+		Run("FrozenSet", set.freeze(), queries, frozen);
+
+		std::vector<std::string> sQueries;
+		for (int q : queries)
+			sQueries.push_back(std::to_string(q));
+		Set<std::string, std::less<>, std::greater<>> sSet;
+		for (int i = 0; i < itemCount; ++i)
+			sSet.put(std::to_string(2 * i));
+		Run("Set<string>", sSet, sQueries, sTree);
+		Run("FrozenSet<string>", sSet.freeze(), sQueries, sFrozen);
+	}
+
+	std::cout << "FrozenSet/Set";
+	for (int i = 0; i < 3; ++i)
+		std::cout << '\t' << frozen[i] / tree[i];
+	std::cout << std::endl << "FrozenSet<string>/Set<string>";
+	for (int i = 0; i < 3; ++i)
+		std::cout << '\t' << sFrozen[i] / sTree[i];
+	std::cout << std::endl;
+
+	return 0;
+}
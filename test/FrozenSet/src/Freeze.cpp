@@ -0,0 +1,96 @@
+#include "DS/FrozenSet.hpp"
+#include <cassert>
+#include <random>
+#include <string>
+
+using namespace DS;
+
+template <std::size_t N, typename K, typename ... Cs>
+void
+TestIndex(Set<K, Cs ...> const& set, FrozenSet<K, Cs ...> const& frozen, std::vector<K> const& queries)
+{
+	auto i = frozen.template begin<N>();
+	auto j = set.template begin<N>();
+	for (std::uint64_t r = 0; j; ++r, ++i, ++j)
+		assert((i && *i == *j && *frozen.template at<N>(r) == *j));
+	assert((!i && i == frozen.template end<N>()));
+
+	auto ri = frozen.template rbegin<N>();
+	auto rj = set.template rbegin<N>();
+	for (; rj; ++ri, ++rj)
+		assert((ri && *ri == *rj));
+	assert((!ri && !frozen.template at<N>(set.size())));
+
+	for (auto const& q : queries) {
+		auto f = frozen.template get<N>(q);
+		auto s = set.template get<N>(q);
+		assert((static_cast<bool>(f) == static_cast<bool>(s) && (!f || *f == *s)));
+		assert((frozen.template rank<N>(q) == set.template rank<N>(q)));
+	}
+	if (queries.size() > 1)
+		assert((frozen.template count<N>(queries[0], queries[1]) == set.template count<N>(queries[0], queries[1])));
+}
+
+template <typename K, typename ... Cs>
+void
+Test(std::vector<K> const& keys, std::vector<K> const& queries)
+{
+	Set<K, Cs ...> set;
+	for (auto const& k : keys)
+		set.put(k);
+	auto frozen = set.freeze();
+	assert((frozen.size() == set.size()));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(TestIndex<N>(set, frozen, queries), ...);
+	}(std::make_index_sequence<Dimension<Cs ...>>());
+
+	auto copy = frozen;
+	auto moved = std::move(frozen);
+	assert((!frozen && !frozen.get(keys.empty() ? K{} : keys[0]) && frozen.rank(K{}) == 0));
+	assert((moved.size() == set.size() && copy.size() == set.size()));
+	auto thawed = copy.thaw();
+	assert((thawed.size() == set.size() && std::equal(thawed.begin(), thawed.end(), set.begin())));
+}
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(-(1 << 16), 1 << 16);
+
+	for (int n : {0, 1, 2, 15, 16, 17, 63, 64, 65, 1000, 10000}) {
+		std::vector<int> keys, queries;
+		for (int i = 0; i < n; ++i)
+			keys.push_back(distrib(gen));
+		for (int i = 0; i < 2 * n + 2; ++i)
+			queries.push_back(i % 2 && n ? keys[i / 2 % n] : distrib(gen));
+
+		Test<int, std::less<>, std::greater<>>(keys, queries);
+		Test<long, std::greater<long>>({keys.begin(), keys.end()}, {queries.begin(), queries.end()});
+
+		std::vector<double> dKeys, dQueries;
+		for (int k : keys)
+			dKeys.push_back(k / 4.0);
+		for (int q : queries)
+			dQueries.push_back(q / 4.0);
+		Test<double, std::less<double>, std::greater<>>(dKeys, dQueries);
+
+		std::vector<std::string> sKeys, sQueries;
+		for (int k : keys)
+			sKeys.push_back(std::to_string(k));
+		for (int q : queries)
+			sQueries.push_back(std::to_string(q));
+		Test<std::string, std::less<>, std::greater<>>(sKeys, sQueries);
+
+		Set<int> set;
+		for (int k : keys)
+			set.put(k);
+		auto frozen = set.freeze();
+		for (int q : queries) { // heterogeneous lookups
+			assert((frozen.rank(q + 0.5) == set.rank(q + 0.5)));
+			assert((static_cast<bool>(frozen.get(static_cast<long>(q))) == static_cast<bool>(set.get(q))));
+		}
+	}
+
+	return 0;
+}
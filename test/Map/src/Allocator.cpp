@@ -0,0 +1,134 @@
+#include "DS/Map.hpp"
+#include "DS/Test/Balance.hpp"
+#include <map>
+#include <random>
+#include <string>
+
+using namespace DS;
+
+struct Counting : Allocator {
+	static inline long live{0};
+
+	static void*
+	allocate(std::size_t size)
+	{
+		++live;
+		return Allocator::allocate(size);
+	}
+
+	static void
+	deallocate(void* ptr) noexcept
+	{
+		--live;
+		Allocator::deallocate(ptr);
+	}
+};
+
+struct Value {
+	int v;
+
+	explicit Value(int v)
+			: v{v}
+	{}
+
+	virtual
+	~Value() = default;
+};
+
+struct LargeValue : Value {
+	std::string padding;
+
+	explicit LargeValue(int v)
+			: Value(v)
+			, padding(std::to_string(v))
+	{}
+};
+
+template <std::size_t M, typename L = Pointers>
+void
+TestTree(auto const& map)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<M, L>* const*>(reinterpret_cast<std::byte const*>(&map) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<M, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<M, N>(rootNode[N]) == map.size()))), ...);
+	}(std::make_index_sequence<M>{});
+}
+
+int main()
+{
+	{
+		Map<int, Value, std::less<>, std::greater<>, Counting> map;
+		for (int i{0}; i < 1000; ++i) {
+			if (i % 2)
+				map.putDV<LargeValue>(i).set<LargeValue>(i);
+			else
+				map.put(i).set(i);
+		}
+		assert((Counting::live == 1000));
+		for (int i{0}; i < 1000; i += 3)
+			map.remove(i);
+		assert((Counting::live == map.size()));
+	}
+	assert((Counting::live == 0));
+
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 1 << 14);
+
+	// Nodes of both sizes share the pool, each from its own size class
+	std::map<int, int> expected;
+	Map<int, Value, std::less<>, std::greater<>, SlabPool<>> map;
+	for (int i{0}; i < 1 << 13; ++i) {
+		int x = distrib(gen);
+		if (expected.emplace(x, i).second) {
+			if (x % 2)
+				map.putDV<LargeValue>(x).set<LargeValue>(i);
+			else
+				map.put(x).set(i);
+		}
+	}
+	for (int i{0}; i < 1 << 12; ++i) {
+		int x = distrib(gen);
+		assert((map.remove(x) == (expected.erase(x) == 1)));
+	}
+	TestTree<2>(map);
+	assert((map.size() == expected.size()));
+	auto i = map.begin();
+	for (auto const& [x, v] : expected) {
+		assert((i->key == x && i->value.v == v));
+		++i;
+	}
+
+	Map<int, int, std::less<>, std::greater<>, SlabPool<>> a, b;
+	for (int j{0}; j < 1 << 14; ++j)
+		(j % 3 ? a : b).put(j).set(-j);
+	auto joined = Map<int, int, std::less<>, std::greater<>, SlabPool<>>::Union<LeftSelector<int>>{2}(a, b);
+	TestTree<2>(joined);
+	assert((joined.size() == 1 << 14));
+	Map<int, int, std::less<>, std::greater<>, SlabPool<>> copy(joined);
+	TestTree<2>(copy);
+	auto difference = Map<int, int, std::less<>, std::greater<>, SlabPool<>>::Difference<>{2}(copy, b);
+	TestTree<2>(difference);
+	assert((difference.size() == a.size()));
+
+	// Compact nodes of both sizes are linked by 32 bit handles
+	{
+		Map<int, Value, std::less<>, std::greater<>, Compact<1 << 16>> compact;
+		for (auto const& [x, v] : expected) {
+			if (x % 2)
+				compact.putDV<LargeValue>(x).set<LargeValue>(v);
+			else
+				compact.put(x).set(v);
+		}
+		for (int x{0}; x < 1 << 14; x += 5)
+			assert((compact.remove(x) == (expected.erase(x) == 1)));
+		TestTree<2, LinksOf<Compact<1 << 16>>>(compact);
+		auto j = compact.begin<1>();
+		for (auto k = expected.rbegin(); k != expected.rend(); ++k, ++j)
+			assert((j->key == k->first && j->value.v == k->second));
+		assert((!j && compact.size() == expected.size()));
+	}
+
+	return 0;
+}
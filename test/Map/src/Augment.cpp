@@ -0,0 +1,96 @@
+#include "DS/Map.hpp"
+#include <cassert>
+#include <map>
+#include <random>
+
+using namespace DS;
+
+struct Sample {
+	long value;
+	long weight;
+};
+
+// Weighted sum and count of the samples
+struct Total {
+	struct Type {
+		long sum;
+		long count;
+	};
+
+	static Type
+	identity() noexcept
+	{ return {0, 0}; }
+
+	static Type
+	combine(Type const& a, Type const& b) noexcept
+	{ return {a.sum + b.sum, a.count + b.count}; }
+
+	static Type
+	of(long, Sample const& s) noexcept
+	{ return {s.value * s.weight, 1}; }
+};
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<long> distrib(0, 1 << 16);
+
+	Map<long, Sample, std::less<>, Augment<Total>> samples;
+	std::map<long, Sample> expected;
+	auto window = [&](long from, long to) {
+		Total::Type t{0, 0};
+		for (auto i = expected.lower_bound(from); i != expected.end() && i->first < to; ++i) {
+			t.sum += i->second.value * i->second.weight;
+			++t.count;
+		}
+		auto a = samples.aggregate(from, to);
+		assert((a.sum == t.sum && a.count == t.count));
+	};
+
+	for (long time = 0; time < 1 << 14; time += distrib(gen) % 8 + 1) {
+		Sample s{distrib(gen), distrib(gen) % 4};
+		if (time % 3) {
+			samples.tryPut(time, s);
+			expected.emplace(time, s);
+		} else {
+			// elements without a value aggregate to nothing until their value is set and refreshed
+			auto i = samples.put(time);
+			window(0, 1 << 14);
+			i.set(s);
+			samples.refresh(i);
+			expected.emplace(time, s);
+		}
+		if (time % 16 == 0)
+			window(time - 256, time + 1);
+	}
+
+	// values changed through iterators
+	for (int j = 0; j < 256; ++j) {
+		auto i = samples.lowerBound(distrib(gen) % (1 << 14));
+		if (!i)
+			continue;
+		long w = distrib(gen) % 4;
+		i->value.weight = w;
+		expected[i->key].weight = w;
+		samples.refresh(i);
+		window(i->key - 100, i->key + 100);
+	}
+
+	// evicting old samples
+	samples.remove(samples.begin(), samples.lowerBound(1 << 13));
+	expected.erase(expected.begin(), expected.lower_bound(1 << 13));
+	for (long time = 0; time < 1 << 14; time += 512)
+		window(time, time + 1024);
+
+	// getOrPut refreshes a value it sets
+	samples.put(1 << 15);
+	window(0, 1 << 16);
+	samples.getOrPut(1 << 15, Sample{3, 3});
+	expected.emplace(1 << 15, Sample{3, 3});
+	window(0, 1 << 16);
+
+	auto all = samples.aggregate();
+	assert((all.count == static_cast<long>(samples.size())));
+	return 0;
+}
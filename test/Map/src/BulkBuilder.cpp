@@ -0,0 +1,80 @@
+#include "DS/Map.hpp"
+#include "DS/Test/Balance.hpp"
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace DS;
+
+template <std::size_t M>
+void
+TestTree(auto const& map)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<M>* const*>(reinterpret_cast<std::byte const*>(&map) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<M, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<M, N>(rootNode[N]) == map.size()))), ...);
+	}(std::make_index_sequence<M>{});
+}
+
+template <typename M>
+bool
+Equal(M const& map, std::map<int, int> const& expected)
+{
+	return map.size() == expected.size() && std::equal(map.begin(), map.end(), expected.begin(), [](auto const& e, auto const& p) {
+		return e.key == p.first && e.value == p.second;
+	});
+}
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 4096);
+
+	for (int n{0}; n < 130; ++n) {
+		Map<int, int, std::greater<>, std::less<>>::BulkBuilder<1> builder;
+		for (int i{0}; i < n; ++i)
+			builder.put(i).set(-i);
+		auto map2D = builder.build();
+		assert((map2D.size() == n));
+		TestTree<2>(map2D);
+		for (int i{0}; i < n; ++i)
+			assert((map2D.at<1>(i)->key == i && map2D.at<1>(i)->value == -i));
+	}
+
+	std::map<int, int> a, b;
+	Map<int, int, std::less<>, std::greater<>> mapA, mapB;
+	for (int i{0}; i < 1024; ++i) {
+		int x = distrib(gen);
+		if (a.emplace(x, i).second)
+			mapA.put(x).set(i);
+		int y = distrib(gen);
+		if (b.emplace(y, -i).second)
+			mapB.put(y).set(-i);
+	}
+
+	std::map<int, int> expected;
+	std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()), [](auto const& l, auto const& r) { return l.first < r.first; });
+	auto difference = Map<int, int, std::less<>, std::greater<>>::Difference<>{}(mapA, mapB);
+	TestTree<2>(difference);
+	assert(Equal(difference, expected));
+
+	expected.clear();
+	std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()), [](auto const& l, auto const& r) { return l.first < r.first; });
+	auto intersection = Map<int, int, std::less<>, std::greater<>>::Intersection<LeftSelector<int>>{}(mapA, mapB);
+	TestTree<2>(intersection);
+	assert(Equal(intersection, expected));
+
+	expected.clear();
+	std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()), [](auto const& l, auto const& r) { return l.first < r.first; });
+	auto union_ = Map<int, int, std::less<>, std::greater<>>::Union<LeftSelector<int>>{}(mapA, mapB);
+	TestTree<2>(union_);
+	assert(Equal(union_, expected));
+
+	auto join = Map<int, int, std::less<>, std::greater<>>::Join<LeftSelector<int>, 1>{}(mapA, mapB);
+	TestTree<2>(join);
+	assert(Equal(join, a));
+
+	return 0;
+}
@@ -0,0 +1,80 @@
+#include "DS/Map.hpp"
+#include "DS/Test/Balance.hpp"
+#include <random>
+#include <vector>
+
+using namespace DS;
+
+struct ByMod {
+	bool
+	operator()(int a, int b) const noexcept
+	{ return a % 1024 < b % 1024; }
+};
+
+struct ByTens {
+	bool
+	operator()(int a, int b) const noexcept
+	{ return a / 10 < b / 10; }
+};
+
+template <std::size_t N>
+void
+Shape(TNode<2> const* t, std::vector<std::pair<TNode<2> const*, std::uint8_t>>& shape)
+{
+	if (t->d[N].hasLeft)
+		Shape<N>(t->template left<N>(), shape);
+	shape.emplace_back(t, t->template state<N>());
+	if (t->d[N].hasRight)
+		Shape<N>(t->template right<N>(), shape);
+}
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 1 << 16);
+
+	Map<int, int, std::less<>, ByMod> map2D;
+	auto* containerSize2D = reinterpret_cast<std::byte*>(&map2D);
+	auto** rootNode2D = reinterpret_cast<TNode<2>**>(containerSize2D + sizeof(std::uint64_t));
+	map2D.put(distrib(gen));
+	for (int i{0}; i < 4096; ++i) {
+		std::vector<std::pair<TNode<2> const*, std::uint8_t>> shape0, shape1;
+		Shape<0>(rootNode2D[0], shape0);
+		Shape<1>(rootNode2D[1], shape1);
+		auto* root0 = rootNode2D[0];
+		auto* root1 = rootNode2D[1];
+		auto size = map2D.size();
+
+		int key = distrib(gen);
+		auto existing = map2D.get<1>(key);
+		auto put = map2D.put(key);
+		if (existing) {
+			// a rejected key must not touch any index
+			assert((put == existing));
+			assert((map2D.size() == size && rootNode2D[0] == root0 && rootNode2D[1] == root1));
+			std::vector<std::pair<TNode<2> const*, std::uint8_t>> after0, after1;
+			Shape<0>(rootNode2D[0], after0);
+			Shape<1>(rootNode2D[1], after1);
+			assert((after0 == shape0 && after1 == shape1));
+		} else
+			assert((put->key == key));
+		DS::Test::TestBalance<2, 0>(rootNode2D[0]);
+		DS::Test::TestBalance<2, 1>(rootNode2D[1]);
+		DS::Test::TestThread<2, 0>(rootNode2D[0]);
+		DS::Test::TestThread<2, 1>(rootNode2D[1]);
+		assert((DS::Test::TestCount<2, 0>(rootNode2D[0]) == map2D.size()));
+		assert((DS::Test::TestCount<2, 1>(rootNode2D[1]) == map2D.size()));
+	}
+	assert((map2D.size() <= 1024));
+
+	// a key equal on the first index and colliding with another element on the second one gets the first one
+	Map<int, int, ByMod, ByTens> folded;
+	folded.put(5).set(0);
+	folded.put(1025).set(1);
+	auto equal = folded.put(1029);
+	assert((equal->key == 5 && equal->value == 0 && folded.size() == 2));
+	equal->value = 2;
+	assert((folded.get(5)->value == 2 && folded.get<1>(1025)->value == 1));
+	return 0;
+}
@@ -0,0 +1,83 @@
+#include "DS/Map.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace DS;
+
+using Index = Map<int, int, std::less<>, std::greater<>>;
+
+int main(int argc, char* argv[])
+{
+	int const testCount{std::stoi(argv[1])};
+	int const itemCount{std::stoi(argv[2])};
+
+	std::mt19937 gen(testCount);
+
+	// nothing is found in an empty map
+	Index map;
+	std::vector<int> keys(100);
+	std::iota(keys.begin(), keys.end(), 0);
+	std::vector<Index::const_iterator<>> found(keys.size(), std::as_const(map).end());
+	assert((std::as_const(map).getMany(keys.begin(), keys.end(), found.begin()) == found.end()));
+	assert(std::none_of(found.begin(), found.end(), [](auto const& i) { return static_cast<bool>(i); }));
+
+	// even keys are present, results come in the order of the keys on every index
+	for (int i{0}; i < itemCount; i += 2)
+		map.put(i).set(-i);
+	keys.resize(itemCount);
+	std::iota(keys.begin(), keys.end(), 0);
+	std::shuffle(keys.begin(), keys.end(), gen);
+	std::vector<Index::iterator<1>> result;
+	map.getMany<1>(keys.begin(), keys.end(), std::back_inserter(result));
+	assert((result.size() == keys.size()));
+	for (std::size_t i = 0; i < keys.size(); ++i) {
+		assert((static_cast<bool>(result[i]) == !(keys[i] % 2)));
+		if (result[i]) {
+			assert((result[i]->key == keys[i] && result[i]->value == -keys[i]));
+			result[i]->value = keys[i];
+		}
+	}
+	assert((map.get(2)->value == 2));
+
+	std::vector<int> lookups(itemCount);
+	std::uniform_int_distribution<> distrib(0, itemCount - 1);
+	std::vector<Index::iterator<>> out(256, map.end());
+	float getTotal{0}, getManyTotal{0};
+	for (int t = 0; t < testCount; ++t) {
+		for (int& k : lookups)
+			k = distrib(gen);
+
+		auto const t0{std::chrono::steady_clock::now()};
+		std::uint64_t hitGet{0};
+		for (std::size_t i = 0; i < lookups.size(); i += out.size()) {
+			auto const last = std::min(i + out.size(), lookups.size());
+			for (std::size_t j = i; j < last; ++j)
+				out[j - i] = map.get(lookups[j]);
+			for (std::size_t j = i; j < last; ++j)
+				hitGet += static_cast<bool>(out[j - i]);
+		}
+		auto const t1{std::chrono::steady_clock::now()};
+		std::uint64_t hitGetMany{0};
+		for (std::size_t i = 0; i < lookups.size(); i += out.size()) {
+			auto const last = std::min(i + out.size(), lookups.size());
+			map.getMany(lookups.begin() + i, lookups.begin() + last, out.begin());
+			for (std::size_t j = i; j < last; ++j)
+				hitGetMany += static_cast<bool>(out[j - i]);
+		}
+		auto const t2{std::chrono::steady_clock::now()};
+		assert((hitGet == hitGetMany));
+
+		float const tGet{std::chrono::duration_cast<std::chrono::duration<float>>(t1 - t0).count()};
+		float const tGetMany{std::chrono::duration_cast<std::chrono::duration<float>>(t2 - t1).count()};
+		getTotal += tGet;
+		getManyTotal += tGetMany;
+		std::cout << "get " << tGet << "s\tgetMany " << tGetMany << "s\t" << hitGet << std::endl;
+	}
+	std::cout << "Average\tget " << getTotal / testCount << "s\tgetMany " << getManyTotal / testCount << 's' << std::endl;
+	return 0;
+}
@@ -0,0 +1,165 @@
+#include "DS/Map.hpp"
+#include <bit>
+#include <cassert>
+#include <new>
+#include <random>
+#include <unordered_map>
+
+using namespace DS;
+
+struct Record {
+	int id;
+	int name;
+};
+
+struct ById {
+	bool
+	operator()(Record const& a, Record const& b) const noexcept
+	{ return a.id < b.id; }
+
+	bool
+	operator()(Record const& a, int b) const noexcept
+	{ return a.id < b; }
+
+	bool
+	operator()(int a, Record const& b) const noexcept
+	{ return a < b.id; }
+};
+
+struct ByName {
+	bool
+	operator()(Record const& a, Record const& b) const noexcept
+	{ return a.name < b.name; }
+};
+
+struct IdHash {
+	std::size_t
+	operator()(Record const& r) const noexcept
+	{ return r.id; }
+
+	std::size_t
+	operator()(int id) const noexcept
+	{ return id; }
+};
+
+struct IdEq {
+	bool
+	operator()(Record const& a, int id) const noexcept
+	{ return a.id == id; }
+};
+
+using Index = Map<Record, int, ByName, ById, Hashed<IdHash, IdEq>>;
+
+// Tables of the hashed indices are the only nothrow array allocations, counted and failed on demand
+std::size_t tableAllocations{0};
+bool failTables{false};
+
+void*
+operator new[](std::size_t size, std::nothrow_t const&) noexcept
+{
+	++tableAllocations;
+	try {
+		return failTables ? nullptr : ::operator new[](size);
+	} catch (...) {
+		return nullptr;
+	}
+}
+
+// Every element is found by its id on the hashed index, and only those
+void
+TestHashed(Index const& index, std::unordered_map<int, int> const& expected, int itemCount)
+{
+	assert((index.size() == expected.size()));
+	for (auto i = index.begin(); i != index.end(); ++i)
+		assert((index.get<Index::HashedIndex>(i->key.id) == i));
+	for (int id{0}; id < itemCount; ++id) {
+		auto i = index.get<Index::HashedIndex>(id);
+		auto e = expected.find(id);
+		assert((e == expected.end() ? !i : i && i->key.id == id && i->value == e->second));
+		assert((i == index.get<1>(id)));
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int const itemCount{std::stoi(argv[1])};
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, itemCount - 1);
+
+	// the maps without a Hashed policy do not grow
+	static_assert(sizeof(Map<int, int>) == sizeof(std::uint64_t) + sizeof(void*));
+
+	Index index;
+	std::unordered_map<int, int> expected;
+	std::unordered_map<int, int> names; // name of each id in index
+	for (int n{0}; n < itemCount * 4; ++n) {
+		int const id{distrib(gen)};
+		if (distrib(gen) % 3) {
+			// a name taken by another id is rejected by the ordered index of the names
+			Record const r{id, distrib(gen)};
+			auto i = index.put(r);
+			if (i->key.id == id && i->key.name == r.name && !i.hasValue()) {
+				i.set(n);
+				expected[id] = n;
+				names[id] = r.name;
+			}
+		} else {
+			assert((index.remove<Index::HashedIndex>(id) == expected.erase(id)));
+			names.erase(id);
+		}
+	}
+	TestHashed(index, expected, itemCount);
+	for (auto i = index.begin(); i != index.end(); ++i)
+		assert((names[i->key.id] == i->key.name));
+
+	// the trees relinked at once rebuild the hashed index
+	auto upper = index.splitAt<1>(itemCount / 2);
+	std::unordered_map<int, int> lower, higher;
+	for (auto const& [id, value] : expected)
+		(id < itemCount / 2 ? lower : higher).emplace(id, value);
+	TestHashed(index, lower, itemCount);
+	TestHashed(upper, higher, itemCount);
+	assert((index.concat<1>(std::move(upper))));
+	TestHashed(index, expected, itemCount);
+	TestHashed(upper, {}, itemCount);
+
+	Index copy(index);
+	index.remove<1>(index.begin<1>(), index.lowerBound<1>(itemCount / 4));
+	std::erase_if(lower, [&](auto const& e) { return e.first < itemCount / 4; });
+	std::erase_if(expected, [&](auto const& e) { return e.first < itemCount / 4; });
+	TestHashed(index, expected, itemCount);
+	index.subtract<1>(copy);
+	TestHashed(index, {}, itemCount);
+	index = std::move(copy);
+	TestHashed(copy, {}, itemCount);
+	copy.put(Record{0, 0});
+	assert((copy.get<Index::HashedIndex>(0) && copy.size() == 1));
+	index.clear();
+	TestHashed(index, {}, itemCount);
+
+	// a single comparator hashed by the key itself
+	Map<int, int, std::less<>, Hashed<std::hash<int>>> map;
+	for (int i{0}; i < itemCount; ++i)
+		map.tryPut(i * 7 % itemCount, i);
+	for (int i{0}; i < itemCount; i += 2)
+		assert((map.remove<1>(i)));
+	for (int i{0}; i < itemCount; ++i)
+		assert((!map.get<1>(i) == !(i % 2) && map.get<1>(i) == map.get(i)));
+
+	// a table that cannot grow is dropped, its rebuild is retried each time the map doubles
+	Map<int, int, std::less<>, Hashed<std::hash<int>>> failing;
+	failing.tryPut(0, 0);
+	failTables = true;
+	tableAllocations = 0;
+	for (int i{1}; i < itemCount; ++i)
+		failing.tryPut(i, i);
+	assert((tableAllocations <= std::bit_width(unsigned(itemCount))));
+	failTables = false;
+	for (int i{itemCount}; i < itemCount * 2; ++i)
+		failing.tryPut(i, i);
+	assert((tableAllocations <= std::bit_width(unsigned(itemCount)) * 2));
+	for (int i{0}; i < itemCount * 2; i += 7)
+		assert((failing.get<1>(i) && failing.get<1>(i) == failing.get(i)));
+	return 0;
+}
@@ -0,0 +1,181 @@
+#include "DS/Map.hpp"
+#include "DS/Test/Balance.hpp"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <stdexcept>
+
+using namespace DS;
+
+// Value counting its copies
+struct Blob {
+	static inline int copies{0};
+	int id;
+
+	explicit Blob(int id) noexcept
+			: id(id)
+	{}
+
+	Blob(Blob const& other) noexcept
+			: id(other.id)
+	{ ++copies; }
+};
+
+using Index = Map<int, Blob, std::less<>, std::greater<>>;
+
+template <std::size_t M>
+void
+TestTree(auto const& map)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<M>* const*>(reinterpret_cast<std::byte const*>(&map) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<M, N>(rootNode[N]), ...);
+		(DS::Test::TestThread<M, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<M, N>(rootNode[N]) == map.size()))), ...);
+	}(std::make_index_sequence<M>{});
+}
+
+// Elements of map match expected, with the same value objects as before if addresses holds them
+bool
+Equal(Index const& map, std::map<int, int> const& expected, std::map<int, Blob const*> const& addresses)
+{
+	if (map.size() != expected.size())
+		return false;
+	auto e = expected.begin();
+	for (auto i = map.begin(); i; ++i, ++e) {
+		if (i->key != e->first || i->value.id != e->second || &i->value != addresses.at(i->key))
+			return false;
+	}
+	for (auto i = map.begin<1>(); i; ++i) {
+		if (i->key != (--e)->first)
+			return false;
+	}
+	return true;
+}
+
+void
+Fill(Index& map, std::map<int, int>& expected, std::map<int, Blob const*>& addresses, int count, int sign, auto& gen)
+{
+	std::uniform_int_distribution<> distrib(0, 1 << 16);
+	for (int i{0}; i < count; ++i) {
+		int k = distrib(gen);
+		if (expected.emplace(k, sign * k).second) {
+			auto& v = map.put(k).set(sign * k);
+			addresses.emplace(k, &v);
+		}
+	}
+}
+
+// Takes the right key until its third call, which throws
+struct ThrowingSelector {
+	static inline int calls{0};
+
+	int const&
+	operator()(int const&, int const& r) const
+	{
+		if (++calls == 3)
+			throw std::runtime_error("selector");
+		return r;
+	}
+};
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	auto byKey = [](auto const& l, auto const& r) { return l.first < r.first; };
+
+	for (int count : {100, 1 << 14}) {
+		std::map<int, int> a, b, expected;
+		std::map<int, Blob const*> aAddresses, bAddresses;
+		Index mapA, mapB;
+		Fill(mapA, a, aAddresses, 1 << 14, 1, gen);
+		Fill(mapB, b, bAddresses, count, -1, gen);
+
+		// keeps only the elements of mapA, untouched
+		Index copyA = mapA;
+		Blob::copies = 0;
+		copyA.retain(mapB);
+		std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()), byKey);
+		TestTree<2>(copyA);
+		std::map<int, Blob const*> copyAddresses;
+		for (auto i = copyA.begin(); i; ++i)
+			copyAddresses.emplace(i->key, &i->value);
+		copyA.retain(copyA);
+		copyA.merge<RightSelector<int>>(std::move(copyA));
+		TestTree<2>(copyA);
+		assert(Equal(copyA, expected, copyAddresses));
+
+		expected.clear();
+		mapA.subtract(mapB);
+		std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::inserter(expected, expected.end()), byKey);
+		TestTree<2>(mapA);
+		assert(Equal(mapA, expected, aAddresses));
+		assert((mapB.size() == b.size()));
+
+		// the right one wins, every node of both maps is reused
+		mapA.merge<RightSelector<int>>(std::move(copyA));
+		assert((copyA.size() == 0 && !copyA.begin()));
+		mapA.merge<RightSelector<int>>(std::move(mapB));
+		assert((mapB.size() == 0 && !mapB.begin()));
+		for (auto const& [k, v] : b) {
+			a[k] = v;
+			aAddresses[k] = bAddresses[k];
+		}
+		TestTree<2>(mapA);
+		assert(Equal(mapA, a, aAddresses));
+		assert((Blob::copies == 0));
+	}
+
+	// merging into a smaller map splits the larger one
+	std::map<int, int> small, large;
+	std::map<int, Blob const*> smallAddresses, largeAddresses;
+	Index mapSmall, mapLarge;
+	Fill(mapSmall, small, smallAddresses, 64, 1, gen);
+	Fill(mapLarge, large, largeAddresses, 1 << 14, -1, gen);
+	Blob::copies = 0;
+	mapSmall.merge<LeftSelector<int>>(std::move(mapLarge));
+	for (auto const& [k, v] : large) {
+		if (small.emplace(k, v).second)
+			smallAddresses.emplace(k, largeAddresses[k]);
+	}
+	TestTree<2>(mapSmall);
+	assert(Equal(mapSmall, small, smallAddresses));
+	assert((Blob::copies == 0));
+
+	// a throwing selector still relinks every node, the ones of mapA win after the throw
+	for (int count : {100, 1 << 14}) {
+		std::map<int, int> a, b;
+		std::map<int, Blob const*> aAddresses, bAddresses;
+		Index mapA, mapB;
+		Fill(mapA, a, aAddresses, 1 << 12, 1, gen);
+		Fill(mapB, b, bAddresses, count, -1, gen);
+		ThrowingSelector::calls = 0;
+		bool thrown{false};
+		try {
+			mapA.merge<ThrowingSelector>(std::move(mapB));
+		} catch (std::runtime_error const&) {
+			thrown = true;
+		}
+		assert((mapB.size() == 0 && !mapB.begin()));
+		TestTree<2>(mapA);
+		// the keys in both are selected in no particular order, two of them from mapB
+		std::size_t common{0}, taken{0};
+		for (auto const& [k, v] : b) {
+			if (a.emplace(k, v).second) {
+				aAddresses.emplace(k, bAddresses[k]);
+				continue;
+			}
+			++common;
+			if (&mapA.get(k)->value == bAddresses[k]) {
+				a[k] = v;
+				aAddresses[k] = bAddresses[k];
+				++taken;
+			}
+		}
+		assert((thrown == (common >= 3) && ThrowingSelector::calls == static_cast<int>(std::min<std::size_t>(common, 3))));
+		assert((taken == std::min<std::size_t>(common, 2)));
+		assert(Equal(mapA, a, aAddresses));
+	}
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include "DS/Map.hpp"
+#include "DS/Test/Balance.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <set>
+
+using namespace DS;
+
+// Orders by the remainder, so that keys collide on it
+struct Folded {
+	static inline int modulus{1};
+
+	bool
+	operator()(int a, int b) const noexcept
+	{ return a % modulus < b % modulus; }
+};
+
+using Index = Map<int, int, std::less<>, std::greater<>, Folded>;
+
+void
+TestTree(Index const& map, Index const& expected)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<3>* const*>(reinterpret_cast<std::byte const*>(&map) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<3, N>(rootNode[N]), ...);
+		(DS::Test::TestThread<3, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<3, N>(rootNode[N]) == expected.size()))), ...);
+	}(std::make_index_sequence<3>{});
+	assert((map.size() == expected.size()));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		([&] {
+			auto j = expected.begin<N>();
+			for (auto i = map.begin<N>(); i; ++i, ++j)
+				assert((i->key == j->key && i->value == j->value));
+			assert((!j));
+		}(), ...);
+	}(std::make_index_sequence<3>{});
+}
+
+int main(int argc, char* argv[])
+{
+	int const itemCount{std::stoi(argv[1])};
+
+	std::mt19937 gen(itemCount);
+	std::uniform_int_distribution<> distrib(0, itemCount * 4);
+	Folded::modulus = itemCount * 3;
+	std::vector<int> keys;
+	std::set<int> sorted;
+	for (int i{0}; i < itemCount; ++i) {
+		keys.push_back(distrib(gen));
+		sorted.insert(keys.back());
+	}
+
+	// attached one by one, in ascending order so that the lower key wins a collision as it does in the Loader
+	Index expected;
+	for (int k : sorted)
+		expected.tryPut(k, -k);
+	Index map;
+	{
+		Index::Loader loader(map);
+		for (int k : keys)
+			loader.put(k).set(-k);
+	}
+	TestTree(map, expected);
+
+	// loading into a non-empty map reindexes what it has too
+	Index half;
+	for (int k : sorted) {
+		if (k % 2)
+			half.tryPut(k, -k);
+	}
+	{
+		std::size_t size{half.size()};
+		Index::Loader loader(half);
+		for (int k : sorted) {
+			if (!(k % 2)) {
+				loader.put(k).set(-k);
+				assert((half.size() == ++size));
+			}
+		}
+	}
+	TestTree(half, expected);
+
+	// without collisions every element is kept, the values are not touched
+	auto const t0{std::chrono::steady_clock::now()};
+	Map<int, int, std::less<>, std::greater<>> put2D;
+	for (int k : keys)
+		put2D.put(k).set(-k);
+	auto const t1{std::chrono::steady_clock::now()};
+	Map<int, int, std::less<>, std::greater<>> map2D;
+	{
+		decltype(map2D)::Loader loader(map2D);
+		for (int k : keys)
+			loader.put(k).set(-k);
+	}
+	auto const t2{std::chrono::steady_clock::now()};
+	std::cout << "put: " << std::chrono::duration<float>(t1 - t0).count()
+		<< "s load: " << std::chrono::duration<float>(t2 - t1).count() << "s" << std::endl;
+	{
+		decltype(map2D)::Loader loader(map2D);
+		loader.put(keys[0]).set(0);
+	}
+	assert((map2D.size() == sorted.size() && map2D.get(keys[0])->value == 0));
+	auto j = sorted.rbegin();
+	for (auto i = map2D.begin<1>(); i; ++i, ++j)
+		assert((i->key == *j && i->value == (*j == keys[0] ? 0 : -*j)));
+	assert((j == sorted.rend()));
+	return 0;
+}
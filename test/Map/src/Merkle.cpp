@@ -0,0 +1,96 @@
+#include "DS/Map.hpp"
+#include <cassert>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace DS;
+
+// Hash counting its calls
+struct CountingHash {
+	static inline std::uint64_t calls{0};
+
+	std::size_t
+	operator()(int i) const noexcept
+	{
+		++calls;
+		return std::hash<int>{}(i);
+	}
+};
+
+using Replica = Map<int, int, std::less<>, Augment<Merkle<CountingHash>>>;
+
+// Keys told different by diff, checking that their elements do differ
+std::vector<int>
+TestDiff(Replica& a, Replica& b)
+{
+	std::vector<int> keys;
+	Replica::diff(a, b, [&](auto i, auto j) {
+		assert((i || j));
+		assert((!i || !j || i->key == j->key && i->value != j->value));
+		keys.push_back(i ? i->key : j->key);
+	});
+	assert((std::is_sorted(keys.begin(), keys.end())));
+	return keys;
+}
+
+int main(int argc, char* argv[])
+{
+	int const itemCount{std::stoi(argv[1])};
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, itemCount * 4);
+
+	// replicas built in different orders have different shapes but the same root hash
+	Replica a, b;
+	for (int i{0}; i < itemCount; ++i)
+		a.tryPut(i * 4, i);
+	for (int i{itemCount}; i-- > 0;)
+		b.tryPut(i * 4, i);
+	assert((a.aggregate() == b.aggregate() && a.aggregate() != 0));
+	assert((TestDiff(a, b).empty()));
+
+	// a few changes are found without walking the equal ranges
+	std::map<int, bool> changed;
+	while (changed.size() < 16) {
+		int const key{distrib(gen)};
+		if (changed.contains(key))
+			continue;
+		changed[key] = true;
+		if (auto i = b.get(key)) {
+			if (key % 3) {
+				i.set(-1);
+				b.refresh(i);
+			} else
+				b.remove(key);
+		} else
+			b.tryPut(key, key);
+	}
+	assert((a.aggregate() != b.aggregate()));
+	CountingHash::calls = 0;
+	auto keys = TestDiff(a, b);
+	assert((keys.size() == changed.size() && std::equal(keys.begin(), keys.end(), changed.begin(), [](int k, auto const& c) { return k == c.first; })));
+	assert((CountingHash::calls < static_cast<std::uint64_t>(itemCount) / 4));
+	// both ways
+	keys = TestDiff(b, a);
+	assert((keys.size() == changed.size()));
+
+	// reconciling b with a makes them equal again
+	for (auto const& [key, _] : changed) {
+		if (auto i = a.get(key)) {
+			auto j = b.tryPut(key).first;
+			j.set(i->value);
+			b.refresh(j);
+		} else
+			b.remove(key);
+	}
+	assert((a.aggregate() == b.aggregate() && TestDiff(a, b).empty()));
+
+	// ranges missing from one side are reported whole
+	auto upper = b.splitAt(itemCount * 2);
+	keys = TestDiff(a, b);
+	assert((keys.size() == upper.size() && keys.front() == upper.begin()->key));
+	Replica empty;
+	assert((TestDiff(empty, a).size() == a.size() && TestDiff(a, empty).size() == a.size()));
+	return 0;
+}
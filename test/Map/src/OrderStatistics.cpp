@@ -0,0 +1,48 @@
+#include "DS/Map.hpp"
+#include "DS/Test/Balance.hpp"
+#include <random>
+
+using namespace DS;
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 4096);
+
+	Map<int, int, std::less<>, std::greater<>> map2D;
+	auto* containerSize2D = reinterpret_cast<std::byte*>(&map2D);
+	auto** rootNode2D = reinterpret_cast<TNode<2>**>(containerSize2D + sizeof(std::uint64_t));
+	for (int i{0}; i < 1024; ++i) {
+		map2D.put(distrib(gen));
+		assert((DS::Test::TestCount<2, 0>(rootNode2D[0]) == map2D.size()));
+		assert((DS::Test::TestCount<2, 1>(rootNode2D[1]) == map2D.size()));
+	}
+
+	std::uint64_t i{0};
+	for (auto it = map2D.begin<0>(); it != map2D.end<0>(); ++it, ++i) {
+		assert((map2D.at<0>(i) == it));
+		assert((map2D.at<1>(map2D.size() - i - 1) == it));
+		assert((map2D.rank<0>(it->key) == i));
+		assert((map2D.rank<1>(it->key) == map2D.size() - i - 1));
+	}
+	assert(!map2D.at<0>(map2D.size()));
+	assert(!map2D.at<1>(map2D.size()));
+
+	for (int j{0}; j < 256; ++j) {
+		int lo = distrib(gen);
+		int hi = distrib(gen);
+		std::uint64_t expected{0};
+		for (auto const& e : map2D)
+			expected += lo <= e.key && e.key < hi;
+		assert((map2D.count<0>(lo, hi) == expected));
+	}
+
+	while (map2D) {
+		map2D.remove(map2D.at(std::uniform_int_distribution<std::uint64_t>{0, map2D.size() - 1}(gen)));
+		assert((DS::Test::TestCount<2, 0>(rootNode2D[0]) == map2D.size()));
+		assert((DS::Test::TestCount<2, 1>(rootNode2D[1]) == map2D.size()));
+	}
+
+	return 0;
+}
@@ -0,0 +1,80 @@
+#include "DS/Map.hpp"
+#include "DS/Test/Balance.hpp"
+#include <random>
+
+using namespace DS;
+
+template <std::size_t M>
+void
+TestTree(auto const& map)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<M>* const*>(reinterpret_cast<std::byte const*>(&map) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<M, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<M, N>(rootNode[N]) == map.size()))), ...);
+		(DS::Test::TestThread<M, N>(rootNode[N]), ...);
+	}(std::make_index_sequence<M>{});
+}
+
+template <std::size_t N = 0>
+bool
+Equal(auto const& a, auto const& b)
+{
+	if (a.size() != b.size())
+		return false;
+	for (auto i = a.template begin<N>(), j = b.template begin<N>(); i; ++i, ++j) {
+		if (i->key != j->key || i.hasValue() != j.hasValue())
+			return false;
+		if (i.hasValue() && i->value != j->value)
+			return false;
+	}
+	return true;
+}
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+
+	using Map2D = Map<int, int, std::less<>, std::greater<>>;
+	for (int sizeA : {0, 1, 100, 10000}) {
+		for (int sizeB : {1, 7, 3000, 20000}) {
+			std::uniform_int_distribution<> distrib(0, 30000);
+			Map2D a, b;
+			for (int i{0}; i < sizeA; ++i) {
+				int x = distrib(gen);
+				if (x % 3)
+					a.put(x).set(x);
+				else
+					a.put(x);
+			}
+			for (int i{0}; i < sizeB; ++i) {
+				int y = distrib(gen);
+				if (y % 2)
+					b.put(y).set(-y);
+				else
+					b.put(y);
+			}
+
+			for (unsigned threads : {2u, 8u}) {
+				auto difference = Map2D::Difference<>{threads}(a, b);
+				TestTree<2>(difference);
+				assert(Equal(difference, Map2D::Difference<>{}(a, b)));
+
+				auto intersection = Map2D::Intersection<LeftSelector<int>, 1>{threads}(a, b);
+				TestTree<2>(intersection);
+				assert(Equal<1>(intersection, Map2D::Intersection<LeftSelector<int>, 1>{}(a, b)));
+
+				auto join = Map2D::Join<RightSelector<int>>{threads}(a, b);
+				TestTree<2>(join);
+				assert(Equal(join, Map2D::Join<RightSelector<int>>{}(a, b)));
+
+				auto union_ = Map2D::Union<RightSelector<int>>{threads}(b, a);
+				TestTree<2>(union_);
+				assert(Equal(union_, Map2D::Union<RightSelector<int>>{}(b, a)));
+			}
+		}
+	}
+
+	return 0;
+}
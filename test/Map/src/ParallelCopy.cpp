@@ -0,0 +1,112 @@
+#include "DS/Map.hpp"
+#include "DS/Test/Balance.hpp"
+#include "DS/Test/Heap.hpp"
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+using namespace DS;
+
+template <std::size_t M>
+void
+TestTree(auto const& map, auto const& original)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<M>* const*>(reinterpret_cast<std::byte const*>(&map) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<M, N>(rootNode[N]), ...);
+		(DS::Test::TestThread<M, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<M, N>(rootNode[N]) == original.size()))), ...);
+	}(std::make_index_sequence<M>{});
+	assert((map.size() == original.size()));
+	auto j = original.begin();
+	for (auto i = map.begin(); i; ++i, ++j)
+		assert((i->key == j->key && i->value == j->value));
+	assert((!j));
+}
+
+// Value failing to copy after a number of copies
+struct Fragile {
+	static inline int copies{-1};
+	int value;
+
+	explicit Fragile(int value) noexcept
+			: value(value)
+	{}
+
+	Fragile(Fragile const& other)
+			: value(other.value)
+	{
+		if (copies >= 0 && !copies--)
+			throw std::runtime_error("copy");
+	}
+
+	bool
+	operator==(Fragile const& other) const noexcept
+	{ return value == other.value; }
+};
+
+int main(int argc, char* argv[])
+{
+	int const itemCount{std::stoi(argv[1])};
+
+	Map<int, int> map;
+	for (int i{0}; i < itemCount; ++i)
+		map.put(i * 7 % itemCount).set(i);
+	for (unsigned threads : {1u, 2u, 8u}) {
+		auto const t0{std::chrono::steady_clock::now()};
+		Map<int, int> copy(map, threads);
+		auto const t1{std::chrono::steady_clock::now()};
+		TestTree<1>(copy, map);
+		auto const t2{std::chrono::steady_clock::now()};
+		copy.clear(threads);
+		auto const t3{std::chrono::steady_clock::now()};
+		assert((!copy && !copy.begin()));
+		copy.put(1).set(1);
+		assert((copy.size() == 1));
+		std::cout << threads << " threads, copy: " << std::chrono::duration<float>(t1 - t0).count()
+			<< "s clear: " << std::chrono::duration<float>(t3 - t2).count() << "s" << std::endl;
+	}
+
+	// the other indices are rebuilt on the copy
+	Map<int, int, std::less<>, std::greater<>> map2D;
+	for (int i{0}; i < itemCount / 16; ++i)
+		map2D.put(i * 7 % itemCount).set(i);
+	DS::Test::Soil<MNode<int, int, std::less<>, std::greater<>>>(itemCount / 16);
+	Map<int, int, std::less<>, std::greater<>> copy2D(map2D, 4);
+	TestTree<2>(copy2D, map2D);
+
+	// copied nodes split and remove ranges like the original ones
+	auto upper2D = map2D.splitAt(itemCount / 2);
+	auto copyUpper2D = copy2D.splitAt(itemCount / 2);
+	TestTree<2>(copy2D, map2D);
+	TestTree<2>(copyUpper2D, upper2D);
+	map2D.remove(map2D.lowerBound(itemCount / 8), map2D.lowerBound(itemCount / 4));
+	copy2D.remove(copy2D.lowerBound(itemCount / 8), copy2D.lowerBound(itemCount / 4));
+	TestTree<2>(copy2D, map2D);
+
+	// a failing copy releases what it has copied
+	Map<int, Fragile> fragile;
+	for (int i{0}; i < itemCount / 4; ++i)
+		fragile.put(i).set(i);
+	for (unsigned threads : {1u, 4u}) {
+		Fragile::copies = itemCount / 8;
+		try {
+			Map<int, Fragile> copy(fragile, threads);
+			assert(false);
+		} catch (std::runtime_error const&) {}
+	}
+	Fragile::copies = -1;
+	Map<int, Fragile> copy(fragile, 4);
+	TestTree<1>(copy, fragile);
+
+	// trees handed to the background thread, pooled blocks come back to the shared lists once it is done
+	for (int t{0}; t < 4; ++t) {
+		auto* reclaimed = new Map<int, int, std::less<>, SlabPool<>, BackgroundReclaimer>();
+		for (int i{0}; i < itemCount; ++i)
+			reclaimed->put(i).set(i);
+		auto const t0{std::chrono::steady_clock::now()};
+		delete reclaimed;
+		std::cout << "background reclaim: " << std::chrono::duration<float>(std::chrono::steady_clock::now() - t0).count() << "s" << std::endl;
+	}
+	return 0;
+}
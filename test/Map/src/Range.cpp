@@ -0,0 +1,87 @@
+#include "DS/Map.hpp"
+#include "DS/Test/Balance.hpp"
+#include "DS/Test/Heap.hpp"
+#include <map>
+#include <random>
+
+using namespace DS;
+
+template <std::size_t N>
+void
+TestTree(TNode<2> const* root, std::uint64_t size)
+{
+	DS::Test::TestBalance<2, N>(root);
+	DS::Test::TestThread<2, N>(root);
+	assert((DS::Test::TestCount<2, N>(root) == size));
+}
+
+struct ByValue {
+	bool
+	operator()(std::pair<int, int> const& a, std::pair<int, int> const& b) const noexcept
+	{ return a.second < b.second || (a.second == b.second && a.first < b.first); }
+
+	bool
+	operator()(std::pair<int, int> const& a, int b) const noexcept
+	{ return a.second < b; }
+
+	bool
+	operator()(int a, std::pair<int, int> const& b) const noexcept
+	{ return a < b.second; }
+};
+
+struct ById {
+	bool
+	operator()(std::pair<int, int> const& a, std::pair<int, int> const& b) const noexcept
+	{ return a.first < b.first; }
+};
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 1 << 12);
+
+	// events ordered by id, indexed by time
+	Map<std::pair<int, int>, std::string, ById, ByValue> events;
+	auto* containerSize2D = reinterpret_cast<std::byte*>(&events);
+	auto** rootNode2D = reinterpret_cast<TNode<2>**>(containerSize2D + sizeof(std::uint64_t));
+	std::map<int, int> expected;
+	for (int id{0}; id < 8192; ++id) {
+		int time = distrib(gen);
+		events.put(id, time).set(std::to_string(id));
+		expected.emplace(id, time);
+	}
+
+	// all the events at a time
+	for (int t{0}; t < 64; ++t) {
+		std::uint64_t count{0};
+		for (auto const& [id, time] : expected)
+			count += time == t;
+		auto [b, e] = events.equalRange<1>(t);
+		for (; b != e; ++b, --count)
+			assert((b->key.second == t && b->value == std::to_string(b->key.first)));
+		assert((count == 0));
+	}
+
+	// evict the windows that passed from a copy, allocated from soiled blocks
+	DS::Test::Soil<MNode<std::pair<int, int>, std::string, ById, ByValue>>(expected.size());
+	events = Map<std::pair<int, int>, std::string, ById, ByValue>(events);
+	for (int now{64}; events; now += 64) {
+		auto last = events.lowerBound<1>(now);
+		std::uint64_t count{0};
+		for (auto it = expected.begin(); it != expected.end();) {
+			if (it->second < now) {
+				it = expected.erase(it);
+				++count;
+			} else
+				++it;
+		}
+		assert((events.remove<1>(events.begin<1>(), last) == count));
+		assert((events.size() == expected.size()));
+		TestTree<0>(rootNode2D[0], events.size());
+		TestTree<1>(rootNode2D[1], events.size());
+		for (auto it = events.begin(); it != events.end(); ++it)
+			assert((it->key.second >= now && expected.at(it->key.first) == it->key.second && it->value == std::to_string(it->key.first)));
+	}
+	return 0;
+}
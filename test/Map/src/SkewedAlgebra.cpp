@@ -0,0 +1,72 @@
+#include "DS/Map.hpp"
+#include "DS/Test/Balance.hpp"
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace DS;
+
+template <std::size_t M>
+void
+TestTree(auto const& map)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<M>* const*>(reinterpret_cast<std::byte const*>(&map) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<M, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<M, N>(rootNode[N]) == map.size()))), ...);
+	}(std::make_index_sequence<M>{});
+}
+
+template <typename M>
+bool
+Equal(M const& map, std::map<int, int> const& expected)
+{
+	return map.size() == expected.size() && std::equal(map.begin(), map.end(), expected.begin(), [](auto const& e, auto const& p) {
+		return e.key == p.first && e.value == p.second;
+	});
+}
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 1 << 16);
+
+	std::map<int, int> small, large;
+	Map<int, int, std::less<>, std::greater<>> mapSmall, mapLarge;
+	for (int i{0}; i < 100; ++i) {
+		int x = distrib(gen);
+		if (small.emplace(x, i).second)
+			mapSmall.put(x).set(i);
+	}
+	for (int i{0}; i < 1 << 15; ++i) {
+		int y = distrib(gen);
+		if (large.emplace(y, -i).second)
+			mapLarge.put(y).set(-i);
+	}
+	for (auto const& [x, v] : small) {
+		if (x % 2 && large.emplace(x, -x).second)
+			mapLarge.put(x).set(-x);
+	}
+
+	auto byKey = [](auto const& l, auto const& r) { return l.first < r.first; };
+	std::map<int, int> expected;
+	std::set_intersection(small.begin(), small.end(), large.begin(), large.end(), std::inserter(expected, expected.end()), byKey);
+	auto intersection = Map<int, int, std::less<>, std::greater<>>::Intersection<LeftSelector<int>>{}(mapSmall, mapLarge);
+	TestTree<2>(intersection);
+	assert(Equal(intersection, expected));
+
+	expected.clear();
+	std::set_intersection(large.begin(), large.end(), small.begin(), small.end(), std::inserter(expected, expected.end()), byKey);
+	intersection = Map<int, int, std::less<>, std::greater<>>::Intersection<LeftSelector<int>, 1>{}(mapLarge, mapSmall);
+	TestTree<2>(intersection);
+	assert(Equal(intersection, expected));
+
+	expected.clear();
+	std::set_difference(small.begin(), small.end(), large.begin(), large.end(), std::inserter(expected, expected.end()), byKey);
+	auto difference = Map<int, int, std::less<>, std::greater<>>::Difference<>{}(mapSmall, mapLarge);
+	TestTree<2>(difference);
+	assert(Equal(difference, expected));
+
+	return 0;
+}
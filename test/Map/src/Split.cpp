@@ -0,0 +1,126 @@
+#include "DS/Map.hpp"
+#include "DS/Test/Balance.hpp"
+#include "DS/Test/Heap.hpp"
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace DS;
+
+template <std::size_t M>
+void
+TestTree(auto const& map, std::map<int, int> const& expected)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<M>* const*>(reinterpret_cast<std::byte const*>(&map) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<M, N>(rootNode[N]), ...);
+		(DS::Test::TestThread<M, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<M, N>(rootNode[N]) == expected.size()))), ...);
+	}(std::make_index_sequence<M>{});
+	assert((map.size() == expected.size()));
+	auto e = expected.begin();
+	for (auto i = map.begin(); i; ++i, ++e)
+		assert((i->key == e->first && i->value == e->second));
+	assert((e == expected.end()));
+	auto r = expected.rbegin();
+	for (auto i = map.rbegin(); i; ++i, ++r)
+		assert((i->key == r->first));
+	assert((r == expected.rend()));
+}
+
+// Orders by the last digit only, so that keys of different shards can collide
+struct ByDigit {
+	bool
+	operator()(int a, int b) const noexcept
+	{ return a % 10 < b % 10; }
+};
+
+int main(int argc, char* argv[])
+{
+	int const testCount{std::stoi(argv[1])};
+	int const itemCount{std::stoi(argv[2])};
+
+	std::mt19937 gen(testCount);
+	std::uniform_int_distribution<> distrib(0, itemCount * 4);
+
+	for (int t = 0; t < testCount; ++t) {
+		Map<int, int> map;
+		std::map<int, int> expected;
+		for (int i = 0; i < itemCount; ++i) {
+			int k = distrib(gen);
+			if (!map.get(k))
+				map.put(k).set(-k);
+			expected.emplace(k, -k);
+		}
+		TestTree<1>(map, expected);
+
+		// reshard into ranges and glue them back
+		std::vector<int> bounds(8);
+		for (int& b : bounds)
+			b = distrib(gen);
+		std::sort(bounds.begin(), bounds.end(), std::greater<>());
+		std::vector<Map<int, int>> shards;
+		for (int b : bounds) {
+			shards.push_back(map.splitAt(b));
+			std::map<int, int> upper(expected.lower_bound(b), expected.end());
+			expected.erase(expected.lower_bound(b), expected.end());
+			TestTree<1>(map, expected);
+			TestTree<1>(shards.back(), upper);
+		}
+		std::map<int, int> all;
+		for (auto const& [k, v] : expected)
+			all.emplace(k, v);
+		while (!shards.empty()) {
+			for (auto i = shards.back().begin(); i; ++i)
+				all.emplace(i->key, i->value);
+			assert(map.concat(std::move(shards.back())));
+			assert((shards.back().size() == 0 && !shards.back().begin()));
+			shards.pop_back();
+			TestTree<1>(map, all);
+		}
+
+		// overlapping ranges are refused and leave both untouched
+		auto upper = map.splitAt(itemCount * 2);
+		std::map<int, int> upperExpected(all.lower_bound(itemCount * 2), all.end());
+		all.erase(all.lower_bound(itemCount * 2), all.end());
+		upper.put(0).set(0);
+		upperExpected.emplace(0, 0);
+		assert((!map.size() || !map.concat(std::move(upper))));
+		TestTree<1>(map, all);
+		TestTree<1>(upper, upperExpected);
+	}
+
+	// secondary indices follow the split and drop the collisions of a concatenation
+	Map<int, int, std::less<>, ByDigit> digits;
+	std::map<int, int> expected;
+	for (int k = 0; k < 10; ++k) {
+		digits.put(k * 11).set(k);
+		expected.emplace(k * 11, k);
+	}
+	auto upper = digits.splitAt(50);
+	std::map<int, int> upperExpected(expected.lower_bound(50), expected.end());
+	expected.erase(expected.lower_bound(50), expected.end());
+	TestTree<2>(digits, expected);
+	TestTree<2>(upper, upperExpected);
+	assert((!digits.get<1>(66) && upper.get<1>(66)->value == 6));
+
+	Map<int, int, std::less<>, ByDigit> tail;
+	tail.put(100).set(100);
+	tail.put(105).set(105); // collides with 55
+	tail.put(107).set(107); // collides with 77
+	assert(upper.concat(std::move(tail)));
+	upperExpected.emplace(100, 100);
+	TestTree<2>(upper, upperExpected);
+	assert(digits.concat(std::move(upper))); // 100 collides with 0
+	upperExpected.erase(100);
+	expected.merge(upperExpected);
+	TestTree<2>(digits, expected);
+
+	// so do the secondary indices of a copy
+	DS::Test::Soil<MNode<int, int, std::less<>, ByDigit>>(expected.size());
+	Map<int, int, std::less<>, ByDigit> copy(digits);
+	auto copyUpper = copy.splitAt(50);
+	TestTree<2>(copy, std::map<int, int>(expected.begin(), expected.lower_bound(50)));
+	TestTree<2>(copyUpper, std::map<int, int>(expected.lower_bound(50), expected.end()));
+	return 0;
+}
@@ -0,0 +1,115 @@
+#include "DS/Map.hpp"
+#include "DS/Test/Balance.hpp"
+#include <bit>
+#include <numeric>
+
+using namespace DS;
+
+// Output counting the bytes inserted
+struct Counter : Stream::Output {
+	std::size_t size{0};
+
+	std::size_t
+	writeBytes(std::byte const*, std::size_t n) override
+	{ return size += n, n; }
+};
+
+// Less counting its calls
+struct CallingLess {
+	static inline std::uint64_t calls{0};
+
+	bool
+	operator()(int a, int b) const
+	{ return ++calls, a < b; }
+};
+
+struct Tag;
+using Counting = Counters<2, Tag>;
+using Index = Map<int, int, std::less<>, std::greater<>, Counting>;
+
+std::uint64_t
+Sum(auto const& counters)
+{ return std::accumulate(std::begin(counters), std::end(counters), std::uint64_t{0}); }
+
+int main(int argc, char* argv[])
+{
+	int const itemCount{std::stoi(argv[1])};
+
+	// the counters compile away without a Stats policy
+	static_assert(sizeof(Map<int, int, std::less<>, std::greater<>>) == sizeof(Index));
+	static_assert(std::is_same_v<CountedAt<0, std::less<>>, std::less<>>);
+
+	{
+		Index map;
+		for (int i{0}; i < itemCount; ++i)
+			map.put(i).set(i);
+		auto const s = Index::stats();
+		for (std::size_t n : {0, 1}) {
+			// the first one is put as the root, the second index is checked for a collision before it is put to
+			assert((s.descents[n][1] == itemCount - 1 && s.descents[n][0] == (n ? itemCount - 1 : 0)));
+			assert((Sum(s.depths[n]) == Sum(s.descents[n])));
+			assert((s.comparisons[n] > 0));
+			// ascending keys are put to the right of the first index and to the left of the second one
+			assert((s.rotations[n][n ? 3 : 2] == 0 && s.rotations[n][n ? 2 : 3] == 0));
+			assert((s.rotations[n][n ? 0 : 1] > 0));
+		}
+		assert((s.allocations == itemCount && s.deallocations == 0));
+		assert((s.allocatedBytes >= itemCount * sizeof(int) * 2));
+
+		Counting::reset();
+		for (int i{0}; i < itemCount; ++i)
+			assert((map.get(i)->value == i));
+		assert((!map.get(itemCount)));
+		auto const g = Index::stats();
+		assert((g.descents[0][0] == itemCount + 1 && g.descents[1][0] == 0));
+		assert((Sum(g.depths[0]) == itemCount + 1 && Sum(g.rotations[0]) == 0));
+		// an AVL tree is less than 1.45 log n deep, a get compares once per node visited
+		std::uint64_t visited{0};
+		for (std::size_t d = 0; d < Counting::MaxDepth; ++d) {
+			assert((!g.depths[0][d] || d <= std::bit_width(unsigned(itemCount)) * 3 / 2 + 1));
+			visited += d * g.depths[0][d];
+		}
+		assert((g.comparisons[0] == visited && g.allocations == 0));
+
+		Counting::reset();
+		for (int i{0}; i < itemCount; i += 2)
+			map.remove(i);
+		auto const r = Index::stats();
+		assert((map.size() == itemCount / 2));
+		assert((r.descents[0][2] >= itemCount / 2 && r.descents[1][2] >= itemCount / 2));
+		assert((r.deallocations == itemCount / 2));
+		DS::Test::TestBalance<2, 0>(*reinterpret_cast<TNode<2>* const*>(reinterpret_cast<std::byte const*>(&map) + sizeof(std::uint64_t)));
+	}
+	auto const s = Index::stats();
+	assert((s.deallocations == itemCount));
+
+	{
+		// tryPut descends once, to find the element or to put it
+		struct OnceTag;
+		Map<int, int, std::less<>, Counters<1, OnceTag>> map;
+		for (int n{0}; n < 2; ++n) {
+			for (int i{0}; i < itemCount; ++i)
+				assert((map.tryPut(i, i).second == !n));
+		}
+		auto const o = Counters<1, OnceTag>::read();
+		assert((o.descents[0][0] == itemCount && o.descents[0][1] == itemCount - 1));
+		assert((Sum(o.depths[0]) == Sum(o.descents[0])));
+	}
+
+	{
+		// each call of a comparator returning bool is counted, up to two per comparison
+		struct BoolTag;
+		Map<int, int, CallingLess, Counters<1, BoolTag>> map;
+		for (int i{0}; i < itemCount; ++i)
+			map.put((i * 7) % itemCount).set(i);
+		for (int i{0}; i <= itemCount; ++i)
+			map.get(i);
+		map.remove(itemCount / 2);
+		assert((Counters<1, BoolTag>::read().comparisons[0] == CallingLess::calls && CallingLess::calls > 0));
+	}
+
+	Counter output;
+	output << s;
+	assert((output.size == sizeof(std::uint64_t) * (1 + 2 * (1 + 4 + 3 + Counting::MaxDepth) + 3)));
+	return 0;
+}
@@ -0,0 +1,59 @@
+#include "DS/Map.hpp"
+#include "DS/Test/Balance.hpp"
+#include <map>
+#include <random>
+
+using namespace DS;
+
+struct ByMod {
+	bool
+	operator()(int a, int b) const noexcept
+	{ return a % 1000 < b % 1000; }
+};
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 4096);
+
+	Map<std::string, int> counter;
+	std::map<std::string, int> expected;
+	for (int i{0}; i < 1 << 14; ++i) {
+		auto word = std::to_string(distrib(gen));
+		++counter.getOrPut(std::string_view(word));
+		++expected[word];
+	}
+	assert((counter.size() == expected.size()));
+	for (auto const& [word, count] : expected)
+		assert((counter.get(word)->value == count));
+
+	auto [i, put] = counter.tryPut("key", 1);
+	assert((put && i.hasValue() && i->key == "key" && i->value == 1));
+	auto [j, again] = counter.tryPut("key", 2);
+	assert((!again && j == i && j->value == 1));
+
+	counter.put("empty");
+	auto [k, found] = counter.tryPut("empty", 3);
+	assert((!found && !k.hasValue()));
+	assert((counter.getOrPut("empty", 4) == 4));
+
+	// a miss on the first comparator can still hit another one
+	Map<int, int, std::less<>, ByMod> map2D;
+	auto* containerSize2D = reinterpret_cast<std::byte*>(&map2D);
+	auto** rootNode2D = reinterpret_cast<TNode<2>**>(containerSize2D + sizeof(std::uint64_t));
+	std::map<int, int> byMod;
+	for (int n{0}; n < 4096; ++n) {
+		int key = distrib(gen);
+		auto [it, created] = map2D.tryPut(key, key);
+		auto [e, inserted] = byMod.emplace(key % 1000, key);
+		assert((created == inserted && it->key == e->second && it->value == e->second));
+		assert((map2D.size() == byMod.size()));
+		DS::Test::TestBalance<2, 0>(rootNode2D[0]);
+		DS::Test::TestBalance<2, 1>(rootNode2D[1]);
+		DS::Test::TestThread<2, 0>(rootNode2D[0]);
+		assert((DS::Test::TestCount<2, 0>(rootNode2D[0]) == map2D.size()));
+		assert((DS::Test::TestCount<2, 1>(rootNode2D[1]) == map2D.size()));
+	}
+	return 0;
+}
@@ -0,0 +1,166 @@
+#include "DS/PersistentMap.hpp"
+#include <cassert>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace DS;
+
+// Allocator counting the live nodes
+struct Counting : Allocator {
+	static inline std::atomic<long> live{0};
+
+	static void*
+	allocate(std::size_t size)
+	{
+		++live;
+		return Allocator::allocate(size);
+	}
+
+	static void
+	deallocate(void* ptr) noexcept
+	{
+		--live;
+		Allocator::deallocate(ptr);
+	}
+};
+
+// Value failing to copy after a number of copies
+struct Fragile {
+	static inline int copies{-1};
+	int value;
+
+	explicit Fragile(int value) noexcept
+			: value(value)
+	{}
+
+	Fragile(Fragile const& other)
+			: value(other.value)
+	{
+		if (copies >= 0 && !copies--)
+			throw std::runtime_error("copy");
+	}
+};
+
+using Index = PersistentMap<int, int, std::less<>, Counting>;
+
+// Height of the AVL tree t
+int
+TestBalance(auto const* t)
+{
+	if (!t)
+		return 0;
+	int const l = TestBalance(t->l);
+	int const r = TestBalance(t->r);
+	assert((l - r <= 1 && r - l <= 1 && t->height == 1 + std::max(l, r)));
+	return t->height;
+}
+
+// Entries of s, checking their order
+void
+TestSnapshot(Index::Snapshot const& s, auto const& value)
+{
+	std::uint64_t n{0};
+	int last{-1};
+	for (auto i = s.begin(); i != s.end(); ++i, ++n) {
+		assert((last < i->key && i->value == value(i->key)));
+		last = i->key;
+	}
+	assert((n == s.size()));
+}
+
+int main(int argc, char* argv[])
+{
+	int const itemCount{std::stoi(argv[1])};
+	unsigned const readers{static_cast<unsigned>(std::stoi(argv[2]))};
+
+	{
+		Index map;
+		for (int i{0}; i < itemCount; ++i)
+			assert((map.put(i * 7 % itemCount, i * 7 % itemCount)));
+		auto const full = map.snapshot();
+		// the versions share the nodes that are not on the changed path
+		assert((map.put(itemCount, itemCount) && Counting::live <= itemCount + 64));
+		assert((map.remove(itemCount) && Counting::live <= itemCount + 64));
+		for (int i{0}; i < itemCount; i += 2)
+			assert((map.remove(i)));
+		assert((!map.remove(0) && map.size() == itemCount / 2));
+		for (int i{1}; i < itemCount; i += 2)
+			assert((!map.put(i, -i)));
+		auto const odd = map.snapshot();
+
+		// older versions are not changed by the later updates
+		assert((full.size() == itemCount && odd.size() == itemCount / 2));
+		TestSnapshot(full, [](int k) { return k; });
+		TestSnapshot(odd, [](int k) { return -k; });
+		TestBalance(full.root());
+		TestBalance(odd.root());
+		assert((full.get(itemCount / 2)->value == itemCount / 2 && !odd.get(0) && odd.get(1)->value == -1));
+		assert((odd.lowerBound(itemCount / 2 + 1)->key == (itemCount / 2 + 1) / 2 * 2 + 1));
+		assert((!odd.lowerBound(itemCount)));
+		map.clear();
+		assert((!map && !map.snapshot() && !map.snapshot().begin()));
+	}
+	assert((Counting::live == 0));
+
+	// a failing copy leaves the map as it is
+	{
+		PersistentMap<int, Fragile, std::less<>, Counting> fragile;
+		for (int i{0}; i < itemCount / 16; ++i)
+			fragile.put(i, i);
+		auto const before = fragile.snapshot();
+		int failed{0};
+		for (int c{0}; c < 64; ++c) {
+			Fragile::copies = c;
+			bool removed{false};
+			try {
+				removed = fragile.remove(c);
+				assert((removed));
+			} catch (std::runtime_error const&) {
+				++failed;
+			}
+			Fragile::copies = -1;
+			auto const s = fragile.snapshot();
+			std::uint64_t n{0};
+			for (auto i = s.begin(); i; ++i, ++n)
+				assert((i->value.value == i->key));
+			assert((n == s.size() && s.size() == before.size() - (c + 1 - failed) && !s.get(c) == removed));
+		}
+		assert((failed > 0 && failed < 64 && before.size() == itemCount / 16));
+		for (int i{0}; i < itemCount / 16; ++i)
+			assert((before.get(i)->value.value == i));
+	}
+	assert((Counting::live == 0));
+
+	// readers take snapshots while the writer slides a window of keys, each one sees a complete version
+	{
+		Index map;
+		int const window{itemCount / 10};
+		std::atomic<bool> done{false};
+		std::vector<std::thread> threads;
+		for (unsigned t = 0; t < readers; ++t) {
+			threads.emplace_back([&] {
+				while (!done.load(std::memory_order::acquire)) {
+					auto const s = map.snapshot();
+					TestSnapshot(s, [](int k) { return k * 2; });
+					assert((s.size() <= static_cast<std::uint64_t>(window) + 1));
+					if (s) {
+						auto const first = s.begin()->key;
+						assert((s.get(first + static_cast<int>(s.size()) - 1)));
+					}
+				}
+			});
+		}
+		for (int i{0}; i < itemCount; ++i) {
+			map.put(i, i * 2);
+			if (i >= window)
+				map.remove(i - window);
+		}
+		done.store(true, std::memory_order::release);
+		for (auto& t : threads)
+			t.join();
+		assert((map.size() == static_cast<std::uint64_t>(window)));
+	}
+	assert((Counting::live == 0));
+	return 0;
+}
@@ -0,0 +1,49 @@
+#include "DS/PersistentSet.hpp"
+#include <cassert>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace DS;
+
+int main(int argc, char* argv[])
+{
+	int const itemCount{std::stoi(argv[1])};
+
+	PersistentSet<std::string, std::greater<>, SlabPool<>> set;
+	std::set<std::string, std::greater<>> expected;
+	std::vector<decltype(set)::Snapshot> snapshots;
+	std::vector<decltype(expected)> versions;
+	for (int i{0}; i < itemCount; ++i) {
+		auto const key = std::to_string(i * 7919 % (itemCount / 2));
+		if (i % 3)
+			assert((set.put(key) == expected.insert(key).second));
+		else
+			assert((set.remove(key) == (expected.erase(key) == 1)));
+		assert((set.size() == expected.size()));
+		if (i % (itemCount / 8) == 0) {
+			snapshots.push_back(set.snapshot());
+			versions.push_back(expected);
+		}
+	}
+
+	// every snapshot keeps its own version, in the order of the comparator
+	for (std::size_t v = 0; v < snapshots.size(); ++v) {
+		auto const& s = snapshots[v];
+		assert((s.size() == versions[v].size()));
+		auto j = versions[v].begin();
+		for (auto i = s.begin(); i; ++i, ++j)
+			assert((i->key == *j));
+		assert((j == versions[v].end()));
+		for (auto const& key : versions[v])
+			assert((s.get(key) && s.get(std::string_view(key))->key == key));
+		if (!versions[v].empty()) {
+			auto const& last = *versions[v].rbegin();
+			assert((s.lowerBound(last)->key == last && !++s.lowerBound(last)));
+		}
+	}
+	snapshots.clear();
+	set.clear();
+	assert((!set && !set.snapshot()));
+	return 0;
+}
@@ -0,0 +1,168 @@
+#include "DS/Set.hpp"
+#include "DS/Test/Balance.hpp"
+#include <algorithm>
+#include <array>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace DS;
+
+struct Counting : Allocator {
+	static inline long live{0};
+
+	static void*
+	allocate(std::size_t size)
+	{
+		++live;
+		return Allocator::allocate(size);
+	}
+
+	static void
+	deallocate(void* ptr) noexcept
+	{
+		--live;
+		Allocator::deallocate(ptr);
+	}
+};
+
+template <std::size_t M, typename L = Pointers>
+void
+TestTree(auto const& set)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<M, L>* const*>(reinterpret_cast<std::byte const*>(&set) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<M, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<M, N>(rootNode[N]) == set.size()))), ...);
+	}(std::make_index_sequence<M>{});
+}
+
+template <typename K, typename ... Cs>
+void
+TestPool(K (*key)(int))
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 1 << 14);
+
+	std::set<int> expected;
+	Set<K, Cs ...> set;
+	for (int i{0}; i < 1 << 13; ++i) {
+		int x = distrib(gen);
+		expected.insert(x);
+		set.put(key(x));
+	}
+	for (int i{0}; i < 1 << 12; ++i) {
+		int x = distrib(gen);
+		assert((set.remove(key(x)) == (expected.erase(x) == 1)));
+	}
+	TestTree<2, LinksOf<Cs ...>>(set);
+	assert((set.size() == expected.size()));
+
+	Set<K, Cs ...> copy(set);
+	TestTree<2, LinksOf<Cs ...>>(copy);
+	auto i = copy.begin();
+	for (int x : expected)
+		assert((*i++ == key(x)));
+}
+
+// Nodes released by a thread after the cache of A is gone go to the other threads
+template <typename K, typename A>
+void
+TestExit()
+{
+	std::vector<K const*> released;
+	std::thread([&] {
+		// constructed before, so destroyed after the cache of A
+		thread_local Set<K, std::less<>, A> set;
+		for (int i{0}; i < 1 << 10; ++i)
+			released.push_back(&*set.put(K{i}));
+	}).join();
+	std::sort(released.begin(), released.end());
+	Set<K, std::less<>, A> set;
+	for (int i{0}; i < 1 << 10; ++i)
+		assert((std::binary_search(released.begin(), released.end(), &*set.put(K{i}))));
+}
+
+int main()
+{
+	{
+		Set<int, std::less<>, std::greater<>, Counting> set;
+		for (int i{0}; i < 1000; ++i)
+			set.put(i);
+		assert((Counting::live == 1000));
+		Set<int, std::less<>, std::greater<>, Counting> copy(set);
+		assert((Counting::live == 2000));
+		for (int i{0}; i < 1000; i += 2)
+			set.remove(i);
+		assert((Counting::live == 1500));
+	}
+	assert((Counting::live == 0));
+
+	TestPool<int, std::less<>, std::greater<>, SlabPool<>>([](int x) { return x; });
+	{
+		// Nodes allocated by one thread are released by another
+		Set<int, std::less<>, std::greater<>, SlabPool<>> a, b;
+		for (int i{0}; i < 1 << 14; ++i)
+			(i % 3 ? a : b).put(i);
+		auto joined = Set<int, std::less<>, std::greater<>, SlabPool<>>::Union<LeftSelector<int>>{2}(a, b);
+		TestTree<2>(joined);
+		assert((joined.size() == 1 << 14));
+		auto difference = Set<int, std::less<>, std::greater<>, SlabPool<>>::Difference<>{2}(joined, b);
+		TestTree<2>(difference);
+		assert((difference.size() == a.size()));
+	}
+	// Blocks larger than MaxBlock are pooled by powers of 2, the ones larger than half a slab get a slab of their own
+	TestPool<std::array<int, 64>, std::less<>, std::greater<>, SlabPool<1 << 12, 128>>([](int x) {
+		std::array<int, 64> a{};
+		a.fill(x);
+		return a;
+	});
+	TestPool<std::array<int, 600>, std::less<>, std::greater<>, SlabPool<1 << 12, 128>>([](int x) {
+		std::array<int, 600> a{};
+		a.fill(x);
+		return a;
+	});
+	TestExit<int, SlabPool<1 << 15>>();
+	TestExit<std::array<int, 64>, SlabPool<1 << 15, 128>>();
+
+	// Compact nodes are linked by 32 bit handles
+	static_assert(sizeof(TNode<1, LinksOf<Compact<>>>) * 2 == sizeof(TNode<1>));
+	static_assert(sizeof(SNode<std::uint32_t, std::less<>, Compact<>>) == 16);
+	TestPool<int, std::less<>, std::greater<>, Compact<>>([](int x) { return x; });
+	{
+		Set<std::uint32_t, std::less<>, std::greater<>, Compact<1 << 16>> a, b;
+		for (std::uint32_t i{0}; i < 1 << 16; ++i)
+			(i % 3 ? a : b).put(i);
+		auto joined = decltype(a)::Union<LeftSelector<std::uint32_t>>{4}(a, b);
+		TestTree<2, LinksOf<Compact<1 << 16>>>(joined);
+		assert((joined.size() == 1 << 16));
+		auto difference = decltype(a)::Difference<>{4}(joined, b);
+		TestTree<2, LinksOf<Compact<1 << 16>>>(difference);
+		assert((difference.size() == a.size() && *difference.begin() == 1));
+	}
+	// the slabs of the blocks larger than half a slab are released and their handles reused
+	for (int i{0}; i < 2; ++i) {
+		TestPool<std::array<int, 64>, std::less<>, std::greater<>, Compact<1 << 12, 16, 128>>([](int x) {
+			std::array<int, 64> a{};
+			a.fill(x);
+			return a;
+		});
+		TestPool<std::array<int, 600>, std::less<>, std::greater<>, Compact<1 << 12, 16, 128>>([](int x) {
+			std::array<int, 600> a{};
+			a.fill(x);
+			return a;
+		});
+	}
+	// blocks larger than MaxBlock share the slabs, more of them than there are slab handles fit
+	TestPool<std::array<int, 160>, std::less<>, std::greater<>, Compact<>>([](int x) {
+		std::array<int, 160> a{};
+		a.fill(x);
+		return a;
+	});
+	TestExit<int, Compact<1 << 20, 8, 512, struct Exit>>();
+	TestExit<std::array<int, 64>, Compact<1 << 12, 16, 128, struct Exit>>();
+
+	return 0;
+}
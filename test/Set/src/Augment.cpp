@@ -0,0 +1,189 @@
+#include "DS/Set.hpp"
+#include "DS/Test/Balance.hpp"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace DS;
+
+struct Sum {
+	static long
+	identity() noexcept
+	{ return 0; }
+
+	static long
+	combine(long a, long b) noexcept
+	{ return a + b; }
+
+	static long
+	of(int key) noexcept
+	{ return key; }
+};
+
+// Keys in the order of the index, to test a monoid that does not commute
+struct Digits {
+	static std::string
+	identity()
+	{ return {}; }
+
+	static std::string
+	combine(std::string const& a, std::string const& b)
+	{ return a + b; }
+
+	static std::string
+	of(int key)
+	{ return std::to_string(key % 10); }
+};
+
+struct Interval {
+	int start;
+	int end;
+};
+
+struct ByStart {
+	bool
+	operator()(Interval const& a, Interval const& b) const noexcept
+	{ return a.start < b.start; }
+
+	bool
+	operator()(Interval const& a, int b) const noexcept
+	{ return a.start < b; }
+
+	bool
+	operator()(int a, Interval const& b) const noexcept
+	{ return a < b.start; }
+};
+
+struct MaxEnd {
+	static int
+	identity() noexcept
+	{ return std::numeric_limits<int>::min(); }
+
+	static int
+	combine(int a, int b) noexcept
+	{ return std::max(a, b); }
+
+	static int
+	of(Interval const& i) noexcept
+	{ return i.end; }
+};
+
+template <std::size_t M>
+void
+TestTree(auto const& set)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<M>* const*>(reinterpret_cast<std::byte const*>(&set) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<M, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<M, N>(rootNode[N]) == set.size()))), ...);
+	}(std::make_index_sequence<M>{});
+}
+
+int main()
+{
+	static_assert(sizeof(SNode<int, std::less<>>) == sizeof(SNode<int, std::less<>, Augment<>>));
+
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 1 << 12);
+
+	// sums on the first index and digits in the descending order on the second one
+	using Augmented = Set<int, std::less<>, std::greater<>, Augment<Sum, Digits>>;
+	Augmented set;
+	std::set<int> expected;
+	auto check = [&](Augmented& s, std::set<int> const& e) {
+		TestTree<2>(s);
+		for (int i = 0; i < 16; ++i) {
+			int lo = distrib(gen);
+			int hi = distrib(gen);
+			long sum{0};
+			for (auto j = e.lower_bound(lo); j != e.end() && *j < hi; ++j)
+				sum += *j;
+			assert((s.aggregate(lo, hi) == sum));
+			std::string digits;
+			for (auto j = e.rbegin(); j != e.rend(); ++j) {
+				if (*j <= hi && *j > lo)
+					digits += std::to_string(*j % 10);
+			}
+			assert((s.template aggregate<1>(hi, lo) == digits));
+		}
+		long sum{0};
+		for (int k : e)
+			sum += k;
+		assert((s.aggregate() == sum));
+	};
+	for (int i = 0; i < 2048; ++i) {
+		int k = distrib(gen);
+		if (i % 3) {
+			set.put(k);
+			expected.insert(k);
+		} else {
+			set.remove(k);
+			expected.erase(k);
+		}
+		if (i % 64 == 0)
+			check(set, expected);
+	}
+	check(set, expected);
+
+	// prefix sums reaching a bound
+	long bound = set.aggregate() / 2;
+	auto median = set.search([&](long sum) { return sum >= bound; });
+	long prefix{0};
+	for (int k : expected) {
+		prefix += k;
+		if (prefix >= bound) {
+			assert((*median == k));
+			break;
+		}
+	}
+	assert((!set.search([](long sum) { return sum < 0; })));
+
+	// range removal, copies, algebra and hinted puts keep the aggregates
+	int lo = distrib(gen), hi = distrib(gen);
+	if (hi < lo)
+		std::swap(lo, hi);
+	set.remove(set.lowerBound(lo), set.lowerBound(hi));
+	expected.erase(expected.lower_bound(lo), expected.lower_bound(hi));
+	check(set, expected);
+	Augmented copy(set);
+	copy.put(copy.rbegin(), 1 << 13);
+	auto copyExpected = expected;
+	copyExpected.insert(1 << 13);
+	check(copy, copyExpected);
+	check(set, expected);
+	Augmented other;
+	std::set<int> otherExpected;
+	for (int i = 0; i < 512; ++i) {
+		int k = distrib(gen);
+		other.put(k);
+		otherExpected.insert(k);
+	}
+	auto united = Augmented::Union<LeftSelector<int>>{}(set, other);
+	auto unitedExpected = expected;
+	unitedExpected.insert(otherExpected.begin(), otherExpected.end());
+	check(united, unitedExpected);
+
+	// interval tree, the first interval ending after x contains x if any interval does
+	Set<Interval, ByStart, Augment<MaxEnd>> intervals;
+	std::vector<Interval> all;
+	for (int i = 0; i < 1024; ++i) {
+		int start = distrib(gen);
+		Interval interval{start, start + distrib(gen) % 64 + 1};
+		auto size = intervals.size();
+		intervals.put(interval);
+		if (intervals.size() > size)
+			all.push_back(interval);
+	}
+	assert((intervals.size() == all.size()));
+	for (int x = 0; x < 1 << 12; ++x) {
+		auto i = intervals.search([x](int end) { return end > x; });
+		bool stabbed = std::any_of(all.begin(), all.end(), [x](Interval const& i) { return i.start <= x && x < i.end; });
+		assert((stabbed == (i && i->start <= x)));
+	}
+	return 0;
+}
@@ -0,0 +1,152 @@
+#include "DS/Set.hpp"
+#include "DS/Map.hpp"
+#include "DS/Test/Balance.hpp"
+#include <cassert>
+#include <random>
+#include <set>
+
+using namespace DS;
+
+template <typename B>
+using Index = Set<int, std::less<>, std::greater<>, B, Counters<2, B>>;
+
+// Rebalancing events counted on the Nth index
+template <typename B, std::size_t N>
+std::uint64_t
+Rotations()
+{
+	auto const snapshot = Counters<2, B>::read();
+	std::uint64_t n{0};
+	for (auto c : snapshot.rotations[N])
+		n += c;
+	return n;
+}
+
+template <typename B>
+void
+TestTree(Index<B> const& set, std::set<int> const& expected)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<2>* const*>(reinterpret_cast<std::byte const*>(&set) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		if constexpr (std::same_as<B, WAVL>)
+			((assert((!rootNode[N] || DS::Test::TestRank<2, N>(rootNode[N]) == rootNode[N]->template height<N>()))), ...);
+		else if constexpr (std::same_as<B, WeightBalanced>)
+			(DS::Test::TestWeight<2, N>(rootNode[N]), ...);
+		else
+			(DS::Test::TestBalance<2, N>(rootNode[N]), ...);
+		(DS::Test::TestThread<2, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<2, N>(rootNode[N]) == expected.size()))), ...);
+	}(std::make_index_sequence<2>{});
+	auto e = expected.begin();
+	for (auto i = set.begin(); i; ++i, ++e)
+		assert((*i == *e));
+	assert((e == expected.end()));
+	auto r = expected.rbegin();
+	for (auto i = set.template begin<1>(); i; ++i, ++r)
+		assert((*i == *r));
+	assert((r == expected.rend()));
+}
+
+template <typename B>
+void
+TestPolicy(int itemCount)
+{
+	std::mt19937 gen(itemCount);
+	std::uniform_int_distribution<> distrib(0, itemCount * 2);
+
+	Index<B> set;
+	std::set<int> expected;
+	for (int i{0}; i < itemCount; ++i) {
+		int const k{distrib(gen)};
+		set.put(k);
+		expected.insert(k);
+	}
+	TestTree(set, expected);
+
+	// a WAVL remove rebalances each index at most once, by a single or a double rotation
+	for (int i{0}; i < itemCount * 4; ++i) {
+		int const k{distrib(gen)};
+		if (distrib(gen) % 4) {
+			auto const rotations = Rotations<B, 0>() + Rotations<B, 1>();
+			assert((set.remove(k) == (expected.erase(k) == 1)));
+			if constexpr (std::same_as<B, WAVL>)
+				assert((Rotations<B, 0>() + Rotations<B, 1>() - rotations <= 2));
+		} else {
+			set.put(k);
+			expected.insert(k);
+		}
+		if (i % (itemCount / 8 + 1) == 0)
+			TestTree(set, expected);
+	}
+	TestTree(set, expected);
+
+	// joins keep the trees balanced by the same policy
+	for (int i{0}; i < itemCount; ++i) {
+		int const k{distrib(gen)};
+		set.put(k);
+		expected.insert(k);
+	}
+	for (int b : {itemCount * 2 - 8, itemCount, 8}) {
+		Index<B> upper = set.splitAt(b);
+		std::set<int> upperExpected(expected.lower_bound(b), expected.end());
+		expected.erase(expected.lower_bound(b), expected.end());
+		TestTree(set, expected);
+		TestTree(upper, upperExpected);
+		assert((set.concat(std::move(upper))));
+		expected.merge(upperExpected);
+		TestTree(set, expected);
+	}
+	Index<B> other;
+	std::set<int> otherExpected;
+	for (int i{0}; i < itemCount / 8; ++i) {
+		int const k{distrib(gen) * 2};
+		other.put(k);
+		otherExpected.insert(k);
+	}
+	std::set<int> united(expected);
+	united.insert(otherExpected.begin(), otherExpected.end());
+	TestTree(typename Index<B>::template Union<LeftSelector<int>>{4}(set, other), united);
+	set.subtract(other);
+	std::erase_if(expected, [&](int k) { return otherExpected.contains(k); });
+	TestTree(set, expected);
+	set.remove(set.begin(), set.lowerBound(itemCount));
+	expected.erase(expected.begin(), expected.lower_bound(itemCount));
+	TestTree(set, expected);
+	Index<B> copy(set);
+	TestTree(copy, expected);
+
+	// order statistics read the counts the same way
+	for (std::size_t i{0}; i < expected.size(); i += 7)
+		assert((*copy.at(i) == *std::next(expected.begin(), i)));
+}
+
+int main(int argc, char* argv[])
+{
+	int const itemCount{std::stoi(argv[1])};
+	TestPolicy<AVL>(itemCount);
+	TestPolicy<WAVL>(itemCount);
+	TestPolicy<WeightBalanced>(itemCount);
+
+	// a delete heavy map rebalances once at most on each remove
+	Map<int, int, std::less<>, WAVL, Counters<1, WAVL>> map;
+	std::mt19937 gen(itemCount);
+	std::uniform_int_distribution<> distrib(0, itemCount - 1);
+	for (int i{0}; i < itemCount; ++i)
+		map.tryPut(i, i);
+	auto rotations = [] {
+		std::uint64_t n{0};
+		for (auto c : Counters<1, WAVL>::read().rotations[0])
+			n += c;
+		return n;
+	};
+	for (int i{0}; i < itemCount * 4; ++i) {
+		int const k{distrib(gen)};
+		if (i % 3) {
+			auto const before = rotations();
+			map.remove(k);
+			assert((rotations() - before <= 1 && !map.get(k)));
+		} else
+			assert((map.tryPut(k, k).first->value == k));
+	}
+	return 0;
+}
@@ -0,0 +1,85 @@
+#include "DS/Set.hpp"
+#include "DS/Test/Balance.hpp"
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace DS;
+
+template <std::size_t M>
+void
+TestTree(auto const& set)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<M>* const*>(reinterpret_cast<std::byte const*>(&set) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<M, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<M, N>(rootNode[N]) == set.size()))), ...);
+	}(std::make_index_sequence<M>{});
+}
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 4096);
+
+	for (int n{0}; n < 130; ++n) {
+		Set<int, std::less<>, std::greater<>>::BulkBuilder<> builder;
+		for (int i{0}; i < n; ++i)
+			builder.put(i);
+		auto set2D = builder.build();
+		assert((set2D.size() == n));
+		TestTree<2>(set2D);
+		assert((std::equal(set2D.begin<0>(), set2D.end<0>(), set2D.rbegin<1>())));
+		for (int i{0}; i < n; ++i)
+			assert((*set2D.at(i) == i));
+	}
+
+	{
+		Set<int>::BulkBuilder<> builder;
+		builder.put(1);
+		bool thrown{false};
+		try {
+			builder.put(1);
+		} catch (Set<int>::Exception const&) {
+			thrown = true;
+		}
+		assert(thrown);
+	}
+
+	std::set<int> a, b;
+	Set<int, std::less<>, std::greater<>> setA, setB;
+	for (int i{0}; i < 1024; ++i) {
+		int x = distrib(gen);
+		a.insert(x);
+		setA.put(x);
+		int y = distrib(gen);
+		b.insert(y);
+		setB.put(y);
+	}
+
+	std::vector<int> expected;
+	std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+	auto difference = Set<int, std::less<>, std::greater<>>::Difference<>{}(setA, setB);
+	TestTree<2>(difference);
+	assert((difference.size() == expected.size() && std::equal(difference.begin(), difference.end(), expected.begin())));
+
+	expected.clear();
+	std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+	auto intersection = Set<int, std::less<>, std::greater<>>::Intersection<LeftSelector<int>>{}(setA, setB);
+	TestTree<2>(intersection);
+	assert((intersection.size() == expected.size() && std::equal(intersection.begin(), intersection.end(), expected.begin())));
+
+	expected.clear();
+	std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+	auto union_ = Set<int, std::less<>, std::greater<>>::Union<LeftSelector<int>>{}(setA, setB);
+	TestTree<2>(union_);
+	assert((union_.size() == expected.size() && std::equal(union_.begin(), union_.end(), expected.begin())));
+
+	auto join = Set<int, std::less<>, std::greater<>>::Join<LeftSelector<int>, 1>{}(setA, setB);
+	TestTree<2>(join);
+	assert((join.size() == a.size() && std::equal(join.begin(), join.end(), a.begin())));
+
+	return 0;
+}
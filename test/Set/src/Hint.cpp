@@ -0,0 +1,85 @@
+#include "DS/Set.hpp"
+#include "DS/Test/Balance.hpp"
+#include <random>
+#include <set>
+
+using namespace DS;
+
+std::uint64_t comparisons{0};
+
+struct Less {
+	bool
+	operator()(int a, int b) const noexcept
+	{
+		++comparisons;
+		return a < b;
+	}
+};
+
+template <std::size_t N, std::size_t M>
+void
+TestTree(TNode<M> const* root, std::uint64_t size)
+{
+	DS::Test::TestBalance<M, N>(root);
+	DS::Test::TestThread<M, N>(root);
+	assert((DS::Test::TestCount<M, N>(root) == size));
+}
+
+int main()
+{
+	// ascending keys appended after the last one
+	Set<int, Less> set1D;
+	auto* containerSize1D = reinterpret_cast<std::byte*>(&set1D);
+	auto** rootNode1D = reinterpret_cast<TNode<1>**>(containerSize1D + sizeof(std::uint64_t));
+	auto last = set1D.put(0);
+	comparisons = 0;
+	for (int i{1}; i < 1 << 16; ++i)
+		last = set1D.put(last, i);
+	assert((comparisons == (1 << 16) - 1));
+	assert((set1D.size() == 1 << 16 && *last == (1 << 16) - 1));
+	TestTree<0>(rootNode1D[0], set1D.size());
+
+	// descending keys prepended before the first one
+	for (int i{-1}; i > -(1 << 16); --i)
+		set1D.put(set1D.begin(), i);
+	assert((comparisons == 2 * ((1 << 16) - 1) + (1 << 16) - 1));
+	TestTree<0>(rootNode1D[0], set1D.size());
+
+	// elsewhere, hints fall back to put
+	assert((*set1D.put(set1D.at(100), 1 << 20) == 1 << 20));
+	assert((*set1D.put(set1D.rbegin(), 1 << 19) == 1 << 19));
+	assert((set1D.put(set1D.at(100), 0) == set1D.get(0)));
+	assert((set1D.size() == (1 << 17) + 1));
+	TestTree<0>(rootNode1D[0], set1D.size());
+
+	// end() stands for the last element and rend() for the first one
+	comparisons = 0;
+	for (int i{(1 << 20) + 1}; i <= (1 << 20) + 1024; ++i)
+		assert((*set1D.put(set1D.end(), i) == i));
+	for (int i{-(1 << 16)}; i > -(1 << 16) - 1024; --i)
+		assert((*set1D.put(set1D.rend(), i) == i));
+	assert((comparisons == 1024 + 2 * 1024));
+	assert((set1D.size() == (1 << 17) + 1 + 2048));
+	TestTree<0>(rootNode1D[0], set1D.size());
+
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 1 << 20);
+
+	// hinting on the second comparator, a collision on the other one rejects the key
+	Set<int, std::less<>, std::greater<>, Less> set3D;
+	auto* containerSize3D = reinterpret_cast<std::byte*>(&set3D);
+	auto** rootNode3D = reinterpret_cast<TNode<3>**>(containerSize3D + sizeof(std::uint64_t));
+	std::set<int> expected;
+	for (int i{0}; i < 4096; ++i) {
+		int key = distrib(gen);
+		auto it = set3D.put(set3D.begin<1>(), key);
+		expected.insert(key);
+		assert((*it == key && set3D.size() == expected.size()));
+		TestTree<0>(rootNode3D[0], set3D.size());
+		TestTree<1>(rootNode3D[1], set3D.size());
+		TestTree<2>(rootNode3D[2], set3D.size());
+	}
+	assert(std::equal(expected.begin(), expected.end(), set3D.begin()));
+	return 0;
+}
@@ -0,0 +1,142 @@
+#include "DS/Set.hpp"
+#include "DS/Test/Balance.hpp"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+
+using namespace DS;
+
+using Index = Set<int, std::less<>, std::greater<>>;
+
+void
+TestTree(Index const& set, std::set<int> const& expected)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<2>* const*>(reinterpret_cast<std::byte const*>(&set) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<2, N>(rootNode[N]), ...);
+		(DS::Test::TestThread<2, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<2, N>(rootNode[N]) == expected.size()))), ...);
+	}(std::make_index_sequence<2>{});
+	auto e = expected.begin();
+	for (auto i = set.begin(); i; ++i, ++e)
+		assert((*i == *e));
+	assert((e == expected.end()));
+	auto r = expected.rbegin();
+	for (auto i = set.begin<1>(); i; ++i, ++r)
+		assert((*i == *r));
+	assert((r == expected.rend()));
+}
+
+// Addresses of the keys, to check that the nodes are relinked rather than copied
+std::map<int, int const*>
+Addresses(Index const& set)
+{
+	std::map<int, int const*> addresses;
+	for (auto i = set.begin(); i; ++i)
+		addresses.emplace(*i, &*i);
+	return addresses;
+}
+
+bool
+Kept(Index const& set, std::map<int, int const*> const& addresses)
+{
+	for (auto i = set.begin(); i; ++i) {
+		if (addresses.at(*i) != &*i)
+			return false;
+	}
+	return true;
+}
+
+// Takes the right key until its third call, which throws
+struct ThrowingSelector {
+	static inline int calls{0};
+
+	int const&
+	operator()(int const&, int const& r) const
+	{
+		if (++calls == 3)
+			throw std::runtime_error("selector");
+		return r;
+	}
+};
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 1 << 15);
+
+	for (int count : {64, 1 << 12, 1 << 14}) {
+		Index a, b;
+		std::set<int> expectedA, expectedB;
+		for (int i = 0; i < 1 << 13; ++i) {
+			int k = distrib(gen);
+			a.put(k);
+			expectedA.insert(k);
+		}
+		for (int i = 0; i < count; ++i) {
+			int k = distrib(gen);
+			b.put(k);
+			expectedB.insert(k);
+		}
+		auto addressesA = Addresses(a);
+		auto addressesB = Addresses(b);
+
+		Index both(a);
+		both.retain(b);
+		std::set<int> expected;
+		std::set_intersection(expectedA.begin(), expectedA.end(), expectedB.begin(), expectedB.end(), std::inserter(expected, expected.end()));
+		TestTree(both, expected);
+
+		a.subtract(b);
+		expected.clear();
+		std::set_difference(expectedA.begin(), expectedA.end(), expectedB.begin(), expectedB.end(), std::inserter(expected, expected.end()));
+		TestTree(a, expected);
+		assert(Kept(a, addressesA));
+
+		// the common keys come from b, the nodes of a are kept for the rest
+		a.merge<RightSelector<int>>(std::move(b));
+		assert((b.size() == 0 && !b.begin()));
+		expected.insert(expectedB.begin(), expectedB.end());
+		TestTree(a, expected);
+		for (int k : expectedB)
+			addressesA[k] = addressesB[k];
+		assert(Kept(a, addressesA));
+
+		a.subtract(a);
+		TestTree(a, {});
+	}
+
+	// a throwing selector leaves the union, with the nodes of a for the keys left to select
+	for (int count : {64, 1 << 12}) {
+		Index a, b;
+		std::set<int> expected;
+		for (int i = 0; i < 1 << 12; ++i) {
+			int k = distrib(gen) % (1 << 13);
+			a.put(k);
+			expected.insert(k);
+		}
+		for (int i = 0; i < count; ++i) {
+			int k = distrib(gen) % (1 << 13);
+			b.put(k);
+			expected.insert(k);
+		}
+		ThrowingSelector::calls = 0;
+		bool thrown{false};
+		try {
+			a.merge<ThrowingSelector>(std::move(b));
+		} catch (std::runtime_error const&) {
+			thrown = true;
+		}
+		assert((thrown && ThrowingSelector::calls == 3));
+		assert((b.size() == 0 && !b.begin()));
+		TestTree(a, expected);
+		b.put(0);
+		a.merge<ThrowingSelector>(std::move(b));
+		expected.insert(0);
+		TestTree(a, expected);
+	}
+	return 0;
+}
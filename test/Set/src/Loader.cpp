@@ -0,0 +1,143 @@
+#include "DS/Set.hpp"
+#include "DS/Test/Balance.hpp"
+#include <algorithm>
+#include <random>
+#include <set>
+
+using namespace DS;
+
+// Orders by the tens, so that keys collide on it
+struct ByTens {
+	bool
+	operator()(int a, int b) const noexcept
+	{ return a / 10 < b / 10; }
+};
+
+struct Point {
+	int x;
+	int y;
+
+	auto
+	operator<=>(Point const&) const = default;
+};
+
+struct ByX {
+	bool
+	operator()(Point const& a, Point const& b) const noexcept
+	{ return a.x < b.x; }
+};
+
+struct ByY {
+	bool
+	operator()(Point const& a, Point const& b) const noexcept
+	{ return a.y < b.y; }
+};
+
+using Points = Set<Point, std::less<>, ByX, ByY>;
+
+template <std::size_t M>
+void
+TestTree(auto const& set, std::set<int> const& expected)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<M>* const*>(reinterpret_cast<std::byte const*>(&set) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<M, N>(rootNode[N]), ...);
+		(DS::Test::TestThread<M, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<M, N>(rootNode[N]) == expected.size()))), ...);
+	}(std::make_index_sequence<M>{});
+	assert((set.size() == expected.size()));
+	auto e = expected.begin();
+	for (auto i = set.begin(); i; ++i, ++e)
+		assert((*i == *e));
+	assert((e == expected.end()));
+}
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 1 << 16);
+
+	for (int count : {1, 2, 100, 1 << 14}) {
+		Set<int, std::less<>, std::greater<>> set;
+		std::set<int> expected;
+		{
+			decltype(set)::Loader loader(set);
+			for (int i{0}; i < count; ++i) {
+				int k = distrib(gen);
+				loader.put(k);
+				expected.insert(k);
+			}
+			assert((set.size() == expected.size()));
+		}
+		TestTree<2>(set, expected);
+		auto r = expected.rbegin();
+		for (auto i = set.begin<1>(); i; ++i, ++r)
+			assert((*i == *r));
+		assert((r == expected.rend()));
+
+		// the lowest key of each ten is kept, whatever the order they are put in
+		std::vector<int> keys(expected.begin(), expected.end());
+		std::shuffle(keys.begin(), keys.end(), gen);
+		Set<int, std::less<>, ByTens> tens;
+		{
+			decltype(tens)::Loader loader(tens);
+			for (int k : keys)
+				loader.put(k);
+		}
+		std::set<int> lowest;
+		for (int k : expected) {
+			if (lowest.empty() || *lowest.rbegin() / 10 != k / 10)
+				lowest.insert(k);
+		}
+		TestTree<2>(tens, lowest);
+	}
+
+	// a point colliding only with a point dropped before it is kept, as by puts in ascending order
+	std::uniform_int_distribution<> coordinate(0, 15);
+	for (int count : {3, 16, 64, 256}) {
+		std::set<Point> points;
+		if (count == 3)
+			points = {{1, 1}, {1, 2}, {3, 2}};
+		while (points.size() < static_cast<std::size_t>(count))
+			points.insert({coordinate(gen), coordinate(gen)});
+		Points expected;
+		for (auto const& p : points)
+			expected.put(p);
+		auto test = [&](Points const& set) {
+			auto* const* rootNode = reinterpret_cast<TNode<3>* const*>(reinterpret_cast<std::byte const*>(&set) + sizeof(std::uint64_t));
+			[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+				(DS::Test::TestBalance<3, N>(rootNode[N]), ...);
+				(DS::Test::TestThread<3, N>(rootNode[N]), ...);
+				((assert((DS::Test::TestCount<3, N>(rootNode[N]) == expected.size()))), ...);
+			}(std::make_index_sequence<3>{});
+			assert((set.size() == expected.size() && std::equal(set.begin(), set.end(), expected.begin())));
+		};
+
+		Points loaded;
+		{
+			Points::Loader loader(loaded);
+			for (auto const& p : points)
+				loader.put(p);
+		}
+		test(loaded);
+		Points::BulkBuilder<> builder;
+		for (auto const& p : points)
+			builder.put(p);
+		test(builder.build());
+		if (count == 3)
+			assert((expected.size() == 2 && *expected.at(1) == Point{3, 2}));
+
+		// the union keeps the points of both operands as if they were put in ascending order
+		Points lower, upper;
+		for (auto const& p : points)
+			(p.x < 8 ? lower : upper).put(p);
+		std::set<Point> operands(lower.begin(), lower.end());
+		operands.insert(upper.begin(), upper.end());
+		expected.clear();
+		for (auto const& p : operands)
+			expected.put(p);
+		test(Points::Union<LeftSelector<Point>>{}(lower, upper));
+	}
+	return 0;
+}
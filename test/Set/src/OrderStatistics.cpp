@@ -0,0 +1,48 @@
+#include "DS/Set.hpp"
+#include "DS/Test/Balance.hpp"
+#include <random>
+
+using namespace DS;
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 4096);
+
+	Set<int, std::less<>, std::greater<>> set2D;
+	auto* containerSize2D = reinterpret_cast<std::byte*>(&set2D);
+	auto** rootNode2D = reinterpret_cast<TNode<2>**>(containerSize2D + sizeof(std::uint64_t));
+	for (int i{0}; i < 1024; ++i) {
+		set2D.put(distrib(gen));
+		assert((DS::Test::TestCount<2, 0>(rootNode2D[0]) == set2D.size()));
+		assert((DS::Test::TestCount<2, 1>(rootNode2D[1]) == set2D.size()));
+	}
+
+	std::uint64_t i{0};
+	for (auto it = set2D.begin<0>(); it != set2D.end<0>(); ++it, ++i) {
+		assert((set2D.at<0>(i) == it));
+		assert((set2D.at<1>(set2D.size() - i - 1) == it));
+		assert((set2D.rank<0>(*it) == i));
+		assert((set2D.rank<1>(*it) == set2D.size() - i - 1));
+	}
+	assert(!set2D.at<0>(set2D.size()));
+	assert(!set2D.at<1>(set2D.size()));
+
+	for (int j{0}; j < 256; ++j) {
+		int lo = distrib(gen);
+		int hi = distrib(gen);
+		std::uint64_t expected{0};
+		for (auto k : set2D)
+			expected += lo <= k && k < hi;
+		assert((set2D.count<0>(lo, hi) == expected));
+	}
+
+	while (set2D) {
+		set2D.remove(*set2D.at(std::uniform_int_distribution<std::uint64_t>{0, set2D.size() - 1}(gen)));
+		assert((DS::Test::TestCount<2, 0>(rootNode2D[0]) == set2D.size()));
+		assert((DS::Test::TestCount<2, 1>(rootNode2D[1]) == set2D.size()));
+	}
+
+	return 0;
+}
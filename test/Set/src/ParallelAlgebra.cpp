@@ -0,0 +1,67 @@
+#include "DS/Set.hpp"
+#include "DS/Test/Balance.hpp"
+#include <random>
+
+using namespace DS;
+
+template <std::size_t M>
+void
+TestTree(auto const& set)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<M>* const*>(reinterpret_cast<std::byte const*>(&set) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<M, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<M, N>(rootNode[N]) == set.size()))), ...);
+		(DS::Test::TestThread<M, N>(rootNode[N]), ...);
+	}(std::make_index_sequence<M>{});
+}
+
+template <std::size_t N = 0>
+bool
+Equal(auto const& a, auto const& b)
+{
+	if (a.size() != b.size())
+		return false;
+	for (auto i = a.template begin<N>(), j = b.template begin<N>(); i; ++i, ++j)
+		if (*i != *j)
+			return false;
+	return true;
+}
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+
+	using Set2D = Set<int, std::less<>, std::greater<>>;
+	for (int sizeA : {0, 1, 100, 10000}) {
+		for (int sizeB : {1, 7, 3000, 20000}) {
+			std::uniform_int_distribution<> distrib(0, 30000);
+			Set2D a, b;
+			for (int i{0}; i < sizeA; ++i)
+				a.put(distrib(gen));
+			for (int i{0}; i < sizeB; ++i)
+				b.put(distrib(gen));
+
+			for (unsigned threads : {2u, 8u}) {
+				auto difference = Set2D::Difference<>{threads}(a, b);
+				TestTree<2>(difference);
+				assert(Equal(difference, Set2D::Difference<>{}(a, b)));
+
+				auto intersection = Set2D::Intersection<LeftSelector<int>>{threads}(a, b);
+				TestTree<2>(intersection);
+				assert(Equal(intersection, Set2D::Intersection<LeftSelector<int>>{}(a, b)));
+
+				auto join = Set2D::Join<LeftSelector<int>, 1>{threads}(b, a);
+				TestTree<2>(join);
+				assert(Equal<1>(join, Set2D::Join<LeftSelector<int>, 1>{}(b, a)));
+
+				auto union_ = Set2D::Union<RightSelector<int>>{threads}(a, b);
+				TestTree<2>(union_);
+				assert(Equal(union_, Set2D::Union<RightSelector<int>>{}(a, b)));
+			}
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,91 @@
+#include "DS/Set.hpp"
+#include "DS/Test/Balance.hpp"
+#include "DS/Test/Heap.hpp"
+#include <random>
+#include <set>
+
+using namespace DS;
+
+template <std::size_t N>
+void
+TestTree(TNode<2> const* root, std::uint64_t size)
+{
+	DS::Test::TestBalance<2, N>(root);
+	DS::Test::TestThread<2, N>(root);
+	assert((DS::Test::TestCount<2, N>(root) == size));
+}
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 1 << 16);
+
+	for (int j{0}; j < 16; ++j) {
+		Set<int, std::less<>, std::greater<>> set2D;
+		auto* containerSize2D = reinterpret_cast<std::byte*>(&set2D);
+		auto** rootNode2D = reinterpret_cast<TNode<2>**>(containerSize2D + sizeof(std::uint64_t));
+		std::set<int> expected;
+		for (int i{0}; i < 4096; ++i) {
+			int k = distrib(gen);
+			set2D.put(k);
+			expected.insert(k);
+		}
+		if (j % 2) {
+			// every other set is replaced by its copy, allocated from soiled blocks
+			DS::Test::Soil<SNode<int, std::less<>, std::greater<>>>(expected.size());
+			set2D = Set<int, std::less<>, std::greater<>>(set2D);
+		}
+
+		for (int i{0}; i < 64 && set2D; ++i) {
+			int lo = distrib(gen);
+			// short ranges are split out, long ones relink the trees
+			int hi = lo + std::uniform_int_distribution<>(0, i % 4 ? 256 : 1 << 14)(gen);
+
+			auto l = set2D.lowerBound(lo);
+			auto u = set2D.upperBound(lo);
+			auto el = expected.lower_bound(lo);
+			auto eu = expected.upper_bound(lo);
+			assert(((l ? *l : -1) == (el != expected.end() ? *el : -1)));
+			assert(((u ? *u : -1) == (eu != expected.end() ? *eu : -1)));
+			auto [b, e] = set2D.equalRange(lo);
+			assert(((b != e) == expected.contains(lo)));
+			assert((b == l && e == u));
+
+			if (i % 2) {
+				// (lo, hi] in the descending order
+				auto first = expected.upper_bound(lo);
+				auto last = expected.upper_bound(hi);
+				std::uint64_t count = std::distance(first, last);
+				assert((set2D.remove<1>(set2D.lowerBound<1>(hi), set2D.lowerBound<1>(lo)) == count));
+				expected.erase(first, last);
+			} else if (i % 8 == 6) {
+				// [lo, end)
+				std::uint64_t count = std::distance(el, expected.end());
+				assert((set2D.remove(set2D.lowerBound(lo), set2D.end()) == count));
+				expected.erase(el, expected.end());
+			} else {
+				auto last = expected.lower_bound(hi);
+				std::uint64_t count = std::distance(el, last);
+				assert((set2D.remove(set2D.lowerBound(lo), set2D.lowerBound(hi)) == count));
+				expected.erase(el, last);
+			}
+
+			assert((set2D.size() == expected.size()));
+			TestTree<0>(rootNode2D[0], set2D.size());
+			TestTree<1>(rootNode2D[1], set2D.size());
+			assert(std::equal(expected.begin(), expected.end(), set2D.begin()));
+			assert(std::equal(expected.rbegin(), expected.rend(), set2D.begin<1>()));
+		}
+	}
+
+	Set<int> set1D;
+	for (int i{0}; i < 1024; ++i)
+		set1D.put(i);
+	assert((set1D.remove(set1D.at(100), set1D.at(100)) == 0));
+	assert((set1D.remove(set1D.at(200), set1D.at(100)) == 0));
+	assert((set1D.remove(set1D.at(100), set1D.at(110)) == 10));
+	assert((set1D.remove(set1D.begin(), set1D.end()) == 1014));
+	assert((!set1D && !set1D.lowerBound(0) && !set1D.upperBound(0)));
+	return 0;
+}
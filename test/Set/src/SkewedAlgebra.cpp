@@ -0,0 +1,62 @@
+#include "DS/Set.hpp"
+#include "DS/Test/Balance.hpp"
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace DS;
+
+template <std::size_t M>
+void
+TestTree(auto const& set)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<M>* const*>(reinterpret_cast<std::byte const*>(&set) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<M, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<M, N>(rootNode[N]) == set.size()))), ...);
+	}(std::make_index_sequence<M>{});
+}
+
+int main()
+{
+	std::random_device rd;
+	std::mt19937 gen(rd());
+	std::uniform_int_distribution<> distrib(0, 1 << 16);
+
+	std::set<int> small, large;
+	Set<int, std::less<>, std::greater<>> setSmall, setLarge;
+	for (int i{0}; i < 100; ++i) {
+		int x = distrib(gen);
+		small.insert(x);
+		setSmall.put(x);
+	}
+	for (int i{0}; i < 1 << 15; ++i) {
+		int y = distrib(gen);
+		large.insert(y);
+		setLarge.put(y);
+	}
+	for (int x : small) {
+		if (x % 2) {
+			large.insert(x);
+			setLarge.put(x);
+		}
+	}
+
+	std::vector<int> expected;
+	std::set_intersection(small.begin(), small.end(), large.begin(), large.end(), std::back_inserter(expected));
+	auto intersection = Set<int, std::less<>, std::greater<>>::Intersection<LeftSelector<int>>{}(setSmall, setLarge);
+	TestTree<2>(intersection);
+	assert((intersection.size() == expected.size() && std::equal(intersection.begin(), intersection.end(), expected.begin())));
+	intersection = Set<int, std::less<>, std::greater<>>::Intersection<RightSelector<int>, 1>{}(setLarge, setSmall);
+	TestTree<2>(intersection);
+	assert((intersection.size() == expected.size() && std::equal(intersection.begin(), intersection.end(), expected.begin())));
+
+	expected.clear();
+	std::set_difference(small.begin(), small.end(), large.begin(), large.end(), std::back_inserter(expected));
+	auto difference = Set<int, std::less<>, std::greater<>>::Difference<>{}(setSmall, setLarge);
+	TestTree<2>(difference);
+	assert((difference.size() == expected.size() && std::equal(difference.begin(), difference.end(), expected.begin())));
+
+	return 0;
+}
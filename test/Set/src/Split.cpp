@@ -0,0 +1,102 @@
+#include "DS/Set.hpp"
+#include "DS/Test/Balance.hpp"
+#include "DS/Test/Heap.hpp"
+#include <cassert>
+#include <random>
+#include <set>
+
+using namespace DS;
+
+struct Sum {
+	static long
+	identity() noexcept
+	{ return 0; }
+
+	static long
+	combine(long a, long b) noexcept
+	{ return a + b; }
+
+	static long
+	of(int key) noexcept
+	{ return key; }
+};
+
+using Index = Set<int, std::less<>, std::greater<>, Augment<Sum>>;
+
+void
+TestTree(Index const& set, std::set<int> const& expected)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<2>* const*>(reinterpret_cast<std::byte const*>(&set) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<2, N>(rootNode[N]), ...);
+		(DS::Test::TestThread<2, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<2, N>(rootNode[N]) == expected.size()))), ...);
+	}(std::make_index_sequence<2>{});
+	auto e = expected.begin();
+	for (auto i = set.begin(); i; ++i, ++e)
+		assert((*i == *e));
+	assert((e == expected.end()));
+	auto r = expected.rbegin();
+	for (auto i = set.begin<1>(); i; ++i, ++r)
+		assert((*i == *r));
+	assert((r == expected.rend()));
+	long sum{0};
+	for (int k : expected)
+		sum += k;
+	assert((const_cast<Index&>(set).aggregate() == sum));
+}
+
+int main(int argc, char* argv[])
+{
+	int const testCount{std::stoi(argv[1])};
+	int const itemCount{std::stoi(argv[2])};
+
+	std::mt19937 gen(testCount);
+	std::uniform_int_distribution<> distrib(0, itemCount * 4);
+
+	for (int t = 0; t < testCount; ++t) {
+		Index set;
+		std::set<int> expected;
+		for (int i = 0; i < itemCount; ++i) {
+			int k = distrib(gen);
+			set.put(k);
+			expected.insert(k);
+		}
+
+		// a few elements off either end are detached from the other index, the rest relinks it
+		for (int b : {itemCount * 4 - 8, itemCount * 2, 8}) {
+			Index upper = set.splitAt(b);
+			std::set<int> upperExpected(expected.lower_bound(b), expected.end());
+			expected.erase(expected.lower_bound(b), expected.end());
+			TestTree(set, expected);
+			TestTree(upper, upperExpected);
+			assert(set.concat(std::move(upper)));
+			expected.merge(upperExpected);
+			TestTree(set, expected);
+		}
+
+		// copies and set algebra results split the same way
+		DS::Test::Soil<SNode<int, std::less<>, std::greater<>, Augment<Sum>>>(expected.size());
+		Index copy(set);
+		Index copyUpper = copy.splitAt(itemCount * 2);
+		TestTree(copy, std::set<int>(expected.begin(), expected.lower_bound(itemCount * 2)));
+		TestTree(copyUpper, std::set<int>(expected.lower_bound(itemCount * 2), expected.end()));
+		DS::Test::Soil<SNode<int, std::less<>, std::greater<>, Augment<Sum>>>(expected.size());
+		Index united = Index::Union<LeftSelector<int>>{4}(copyUpper, copy);
+		Index unitedUpper = united.splitAt(itemCount * 3);
+		TestTree(united, std::set<int>(expected.begin(), expected.lower_bound(itemCount * 3)));
+		TestTree(unitedUpper, std::set<int>(expected.lower_bound(itemCount * 3), expected.end()));
+
+		// splitting on the second index cuts the lower keys
+		Index lower = set.splitAt<1>(itemCount);
+		std::set<int> lowerExpected(expected.begin(), expected.upper_bound(itemCount));
+		expected.erase(expected.begin(), expected.upper_bound(itemCount));
+		TestTree(set, expected);
+		TestTree(lower, lowerExpected);
+		assert(!lower.concat<1>(std::move(set)));
+		assert(set.concat<1>(std::move(lower)));
+		expected.merge(lowerExpected);
+		TestTree(set, expected);
+	}
+	return 0;
+}
@@ -0,0 +1,137 @@
+#include "DS/Set.hpp"
+#include "DS/Test/Balance.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace DS;
+
+std::uint64_t comparisons{0};
+
+struct TwoWay {
+	bool
+	operator()(std::string const& a, std::string const& b) const noexcept
+	{
+		++comparisons;
+		return a < b;
+	}
+};
+
+struct ThreeWay {
+	std::weak_ordering
+	operator()(std::string const& a, std::string const& b) const noexcept
+	{
+		++comparisons;
+		return a <=> b;
+	}
+};
+
+// Orders by length first, to have a second three-way index
+struct ByLength {
+	std::strong_ordering
+	operator()(std::string const& a, std::string const& b) const noexcept
+	{
+		if (auto const order = a.size() <=> b.size(); order != 0)
+			return order;
+		return a <=> b;
+	}
+};
+
+template <std::size_t M>
+void
+TestTree(auto const& set)
+{
+	auto* const* rootNode = reinterpret_cast<TNode<M>* const*>(reinterpret_cast<std::byte const*>(&set) + sizeof(std::uint64_t));
+	[&]<std::size_t ... N>(std::index_sequence<N ...>) {
+		(DS::Test::TestBalance<M, N>(rootNode[N]), ...);
+		(DS::Test::TestThread<M, N>(rootNode[N]), ...);
+		((assert((DS::Test::TestCount<M, N>(rootNode[N]) == set.size()))), ...);
+	}(std::make_index_sequence<M>{});
+}
+
+template <typename S>
+float
+Run(char const* name, std::vector<std::string> const& keys)
+{
+	auto const t0{std::chrono::steady_clock::now()};
+	S set;
+	for (auto const& k : keys)
+		set.put(k);
+	std::uint64_t found{0};
+	for (auto const& k : keys)
+		found += static_cast<bool>(set.get(k));
+	for (auto const& k : keys)
+		set.remove(k);
+	auto const t1{std::chrono::steady_clock::now()};
+	assert((found == keys.size() && set.size() == 0));
+
+	float const t{std::chrono::duration_cast<std::chrono::duration<float>>(t1 - t0).count()};
+	std::cout << name << '\t' << t << 's' << std::endl;
+	return t;
+}
+
+int main(int argc, char* argv[])
+{
+	int const testCount{std::stoi(argv[1])};
+	int const itemCount{std::stoi(argv[2])};
+
+	std::mt19937 gen(testCount);
+	std::uniform_int_distribution<> distrib('a', 'z');
+	// long common prefixes make every comparison expensive
+	std::vector<std::string> keys(itemCount);
+	for (auto& k : keys) {
+		k = "/var/lib/data/";
+		for (int i{0}; i < 8; ++i)
+			k.push_back(static_cast<char>(distrib(gen)));
+	}
+
+	// three-way comparators build the same trees as two-way ones, in fewer comparisons
+	std::set<std::string> expected;
+	Set<std::string, ThreeWay, ByLength> set3W;
+	Set<std::string, TwoWay> set2W;
+	std::uint64_t threeWay{0}, twoWay{0};
+	for (int i{0}; i < 4096; ++i) {
+		auto const& k = keys[i % keys.size()];
+		expected.insert(k);
+		comparisons = 0;
+		set3W.put(k);
+		threeWay += comparisons;
+		comparisons = 0;
+		set2W.put(k);
+		twoWay += comparisons;
+	}
+	TestTree<2>(set3W);
+	assert((set3W.size() == expected.size() && std::equal(expected.begin(), expected.end(), set3W.begin())));
+	assert(std::equal(expected.begin(), expected.end(), set2W.begin()));
+	assert(std::is_sorted(set3W.begin<1>(), set3W.end<1>(), [](auto const& a, auto const& b) { return ByLength{}(a, b) < 0; }));
+	for (auto const& k : expected) {
+		comparisons = 0;
+		assert((*set3W.get(k) == k && *set3W.get<1>(k) == k));
+		threeWay += comparisons;
+		comparisons = 0;
+		assert((*set2W.get(k) == k));
+		twoWay += comparisons;
+	}
+	assert((threeWay < twoWay));
+	assert((set3W.rank(*expected.begin()) == 0 && set3W.lowerBound(std::string{}) == set3W.begin()));
+	for (auto const& k : expected)
+		set3W.remove(k);
+	assert((set3W.size() == 0));
+
+	float twoWayTotal{0}, lessTotal{0}, threeWayTotal{0};
+	for (int t = 0; t < testCount; ++t) {
+		std::shuffle(keys.begin(), keys.end(), gen);
+		twoWayTotal += Run<Set<std::string, TwoWay>>("TwoWay", keys);
+		lessTotal += Run<Set<std::string, std::less<>>>("less<>", keys);
+		threeWayTotal += Run<Set<std::string, ThreeWay>>("ThreeWay", keys);
+	}
+	std::cout
+		<< "Average\tTwoWay " << twoWayTotal / testCount << "s\tless<> " << lessTotal / testCount
+		<< "s\tThreeWay " << threeWayTotal / testCount << 's' << std::endl;
+	return 0;
+}
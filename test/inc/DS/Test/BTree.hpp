@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../../../../src/DS/BNode.tpp"
+#include <cassert>
+
+namespace DS::Test {
+
+/**
+ * @brief	Check the order, the fill, the counts, the depth and the leaf links of a B+ tree index.
+ * @param	lo, hi Bounds of the keys of t, if not null
+ * @param	depth Depth of the leaves, set by the first leaf
+ * @param	prev Last visited leaf
+ * @return	Number of keys in t
+ */
+template <typename Cmp, typename K, typename P, typename ... Cs>
+std::uint64_t
+TestBTree(BNode<K, P, Cs ...> const* t, K const* lo, K const* hi, bool root, int& depth, BLeaf<K, P, Cs ...> const*& prev, int level = 0)
+{
+	Cmp cmp;
+	if (t->leaf) {
+		auto const* l = static_cast<BLeaf<K, P, Cs ...> const*>(t);
+		assert((root ? l->size > 0 : l->size >= BNode<K, P, Cs ...>::LeafMin));
+		assert((l->size <= BNode<K, P, Cs ...>::LeafSize));
+		for (std::uint32_t i = 0; i + 1 < l->size; ++i)
+			assert((cmp(static_cast<K const&>(l->keys[i]), static_cast<K const&>(l->keys[i + 1]))));
+		assert((!lo || !cmp(static_cast<K const&>(l->keys[0]), *lo)));
+		assert((!hi || cmp(static_cast<K const&>(l->keys[l->size - 1]), *hi)));
+		assert((l->prev == prev));
+		assert((!prev || prev->next == l));
+		if (depth < 0)
+			depth = level;
+		assert((depth == level));
+		prev = l;
+		return l->size;
+	}
+	auto const* n = static_cast<BInner<K, P, Cs ...> const*>(t);
+	assert((root ? n->size > 1 : n->size >= BNode<K, P, Cs ...>::InnerMin));
+	assert((n->size <= BNode<K, P, Cs ...>::InnerSize));
+	std::uint64_t count{0};
+	for (std::uint32_t c = 0; c < n->size; ++c) {
+		auto cnt = TestBTree<Cmp>(
+			static_cast<BNode<K, P, Cs ...> const*>(n->children[c]),
+			c ? &static_cast<K const&>(n->keys[c - 1]) : lo,
+			c + 1 < n->size ? &static_cast<K const&>(n->keys[c]) : hi,
+			false, depth, prev, level + 1);
+		assert((cnt == n->counts[c]));
+		count += cnt;
+	}
+	return count;
+}
+
+template <typename Cmp, typename K, typename P, typename ... Cs>
+std::uint64_t
+TestBTree(BNode<K, P, Cs ...> const* t)
+{
+	if (!t)
+		return 0;
+	int depth{-1};
+	BLeaf<K, P, Cs ...> const* prev{nullptr};
+	auto count = TestBTree<Cmp>(t, static_cast<K const*>(nullptr), static_cast<K const*>(nullptr), true, depth, prev);
+	assert((prev->next == nullptr));
+	return count;
+}
+
+}//namespace DS::Test
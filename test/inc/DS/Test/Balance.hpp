@@ -5,9 +5,9 @@
 
 namespace DS::Test {
 
-template <std::size_t M, std::size_t N>
+template <std::size_t M, std::size_t N, typename L>
 int
-TestBalance(DS::TNode<M> const* t, int depth = 0) {
+TestBalance(DS::TNode<M, L> const* t, int depth = 0) {
 	if (t) {
 		++depth;
 		int leftDepth = t->d[N].hasLeft ? TestBalance<M, N>(t->template left<N>(), depth) : depth;
@@ -35,4 +35,61 @@ TestBalance(DS::TNode<M> const* t, int depth = 0) {
 	return 0;
 }
 
+template <std::size_t M, std::size_t N, typename L>
+int
+TestRank(DS::TNode<M, L> const* t) {
+	if (t) {
+		int leftRank = t->d[N].hasLeft ? TestRank<M, N>(t->template left<N>()) : 0;
+		int rightRank = t->d[N].hasRight ? TestRank<M, N>(t->template right<N>()) : 0;
+		int rank = leftRank + t->template leftDiff<N>();
+		assert((t->d[N].balance == 1 || t->d[N].balance == 2 || t->d[N].balance == 4 || t->d[N].balance == 5));
+		assert((rank == rightRank + t->template rightDiff<N>()));
+		assert((t->d[N].hasLeft || t->d[N].hasRight || rank == 1));
+		return rank;
+	}
+	return 0;
+}
+
+template <std::size_t M, std::size_t N, typename L>
+void
+TestWeight(DS::TNode<M, L> const* t) {
+	if (t) {
+		std::uint64_t leftWeight = t->template leftCount<N>() + 1;
+		std::uint64_t rightWeight = t->template rightCount<N>() + 1;
+		assert((leftWeight <= DS::WeightBalanced::Delta * rightWeight));
+		assert((rightWeight <= DS::WeightBalanced::Delta * leftWeight));
+		if (t->d[N].hasLeft)
+			TestWeight<M, N>(t->template left<N>());
+		if (t->d[N].hasRight)
+			TestWeight<M, N>(t->template right<N>());
+	}
+}
+
+template <std::size_t M, std::size_t N, typename L>
+std::uint64_t
+TestCount(DS::TNode<M, L> const* t) {
+	if (t) {
+		std::uint64_t leftCount = t->d[N].hasLeft ? TestCount<M, N>(t->template left<N>()) : 0;
+		std::uint64_t rightCount = t->d[N].hasRight ? TestCount<M, N>(t->template right<N>()) : 0;
+		assert((t->d[N].cnt == leftCount + rightCount + 1));
+		return t->d[N].cnt;
+	}
+	return 0;
+}
+
+template <std::size_t M, std::size_t N, typename L>
+void
+TestThread(DS::TNode<M, L> const* t, DS::TNode<M, L> const* P = nullptr, DS::TNode<M, L> const* S = nullptr) {
+	if (t) {
+		if (t->d[N].hasLeft)
+			TestThread<M, N>(t->template left<N>(), P, t);
+		else
+			assert((t->template left<N>() == P));
+		if (t->d[N].hasRight)
+			TestThread<M, N>(t->template right<N>(), t, S);
+		else
+			assert((t->template right<N>() == S));
+	}
+}
+
 }//namespace DS::Test
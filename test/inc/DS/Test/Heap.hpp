@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstring>
+#include <new>
+#include <vector>
+
+namespace DS::Test {
+
+// Free n blocks of the size of Node with every bit set, for the next nodes to be allocated from
+template <typename Node>
+void
+Soil(std::size_t n)
+{
+	std::vector<void*> blocks(n);
+	for (auto& b : blocks)
+		std::memset(b = ::operator new(sizeof(Node)), 0xFF, sizeof(Node));
+	for (auto* b : blocks)
+		::operator delete(b);
+}
+
+}//namespace DS::Test